@@ -1176,6 +1176,9 @@ void ACrab::UpdateAI()
         }
     }
 
+    // Only look around for enemies and gold every few frames, unless engaged, alarmed or hurt
+    bool sense = g_MovableMan.ScheduleAISensing(this, IsAIUrgent() || m_DeviceState == AIMING || m_DeviceState == FIRING || m_DeviceState == THROWING);
+
     ////////////////////////////////////////////////
     // AI MODES
 
@@ -1331,7 +1334,7 @@ void ACrab::UpdateAI()
         {
             Vector newGoldPos;
             // Scan for gold, slightly more than the facing direction arc
-            if (LookForGold(100, m_SightDistance / 2, newGoldPos))
+            if (sense && LookForGold(100, m_SightDistance / 2, newGoldPos))
             {
                 // Start digging when gold is spotted and tool is ready
                 m_DeviceState = DIGGING;
@@ -1435,7 +1438,7 @@ void ACrab::UpdateAI()
         }
 */
         // Narrow FOV range scan, 10 degrees each direction
-        pSeenMO = LookForMOs(10, g_MaterialGrass, false);
+        pSeenMO = sense ? LookForMOs(10, g_MaterialGrass, false) : 0;
         // Saw something!
         if (pSeenMO)
         {
@@ -1648,7 +1651,7 @@ void ACrab::UpdateAI()
             m_ControlStates[AIM_DOWN] = true;
 */
         // Wide FOV range scan, 25 degrees each direction
-        pSeenMO = LookForMOs(25, g_MaterialGrass, false);
+        pSeenMO = sense ? LookForMOs(25, g_MaterialGrass, false) : 0;
         // Saw something!
         if (pSeenMO)
         {
@@ -1681,7 +1684,7 @@ void ACrab::UpdateAI()
         m_ControlStates[aimAngleDiff > 0 ? AIM_UP : AIM_DOWN] = true;
 */
         // Narrow focused FOV range scan
-        pSeenMO = LookForMOs(10, g_MaterialGrass, false);
+        pSeenMO = sense ? LookForMOs(10, g_MaterialGrass, false) : 0;
 
         // Saw the enemy actor again through the sights!
         if (pSeenMO)
@@ -1735,7 +1738,7 @@ void ACrab::UpdateAI()
         m_Controller.m_AnalogAim.CapMagnitude(1.0);
 
         // Narrow focused FOV range scan
-        pSeenMO = LookForMOs(8, g_MaterialGrass, false);
+        pSeenMO = sense ? LookForMOs(8, g_MaterialGrass, false) : 0;
         // Still seeing enemy actor through the sights, keep firing!
         if (pSeenMO)
             pSeenActor = dynamic_cast<Actor *>(pSeenMO->GetRootParent());
@@ -541,6 +541,7 @@ void ADoor::MaterialDrawOverride(bool enable)
                 floodfill(g_SceneMan.GetTerrain()->GetMaterialBitmap(), fillX, fillY, g_MaterialAir);
                 // Register that we changed the material layer of the terrain
                 g_SceneMan.GetTerrain()->AddUpdatedMaterialArea(m_pDoor->GetBoundingBox());
+                g_MovableMan.RegisterTerrainChange(m_pDoor->GetBoundingBox());
             }
         }
         m_MaterialDrawOverride = enable;
@@ -916,6 +917,7 @@ bool ADoor::EraseDoorMaterial()
         floodfill(g_SceneMan.GetTerrain()->GetMaterialBitmap(), fillX, fillY, g_MaterialAir);
         // Register that we changed the material layer of the terrain
         g_SceneMan.GetTerrain()->AddUpdatedMaterialArea(m_pDoor->GetBoundingBox());
+        g_MovableMan.RegisterTerrainChange(m_pDoor->GetBoundingBox());
         return true;
     }
 
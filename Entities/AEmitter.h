@@ -167,6 +167,17 @@ ENTITYALLOCATION(AEmitter)
     bool IsEmitting() const { return m_EmitEnabled; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  CanSleep
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether this MO has nothing going on that needs it to be
+//                  updated every frame while it lies still. Never while emitting.
+// Arguments:       None.
+// Return value:    Whether this could be put to sleep if it stays still long enough.
+
+    virtual bool CanSleep() const { return !m_EmitEnabled && Attachable::CanSleep(); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          ResetEmissionTimers
 //////////////////////////////////////////////////////////////////////////////////////////
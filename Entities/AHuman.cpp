@@ -1940,6 +1940,9 @@ void AHuman::UpdateAI()
         }
     }
 
+    // Only look around for enemies and gold every few frames, unless engaged, alarmed or hurt
+    bool sense = g_MovableMan.ScheduleAISensing(this, IsAIUrgent() || m_DeviceState == AIMING || m_DeviceState == FIRING || m_DeviceState == THROWING);
+
     ////////////////////////////////////////////////
     // AI MODES
 
@@ -2095,7 +2098,7 @@ void AHuman::UpdateAI()
         {
             Vector newGoldPos;
             // Scan for gold, slightly more than the facing direction arc
-            if (LookForGold(100, m_SightDistance / 2, newGoldPos))
+            if (sense && LookForGold(100, m_SightDistance / 2, newGoldPos))
             {
                 // Start digging when gold is spotted and tool is ready
                 m_DeviceState = DIGGING;
@@ -2202,7 +2205,7 @@ void AHuman::UpdateAI()
         }
 */
         // Narrow FOV range scan, 10 degrees each direction
-        pSeenMO = LookForMOs(10, g_MaterialGrass, false);
+        pSeenMO = sense ? LookForMOs(10, g_MaterialGrass, false) : 0;
         // Saw something!
         if (pSeenMO)
         {
@@ -2441,7 +2444,7 @@ void AHuman::UpdateAI()
             m_ControlStates[AIM_DOWN] = true;
 */
         // Wide FOV range scan, 25 degrees each direction
-        pSeenMO = LookForMOs(25, g_MaterialGrass, false);
+        pSeenMO = sense ? LookForMOs(25, g_MaterialGrass, false) : 0;
         // Saw something!
         if (pSeenMO)
         {
@@ -2499,7 +2502,7 @@ void AHuman::UpdateAI()
         m_ControlStates[aimAngleDiff > 0 ? AIM_UP : AIM_DOWN] = true;
 */
         // Narrow focused FOV range scan
-        pSeenMO = LookForMOs(10, g_MaterialGrass, false);
+        pSeenMO = sense ? LookForMOs(10, g_MaterialGrass, false) : 0;
 
         // Saw the enemy actor again through the sights!
         if (pSeenMO)
@@ -2572,7 +2575,7 @@ void AHuman::UpdateAI()
         m_Controller.m_AnalogAim.CapMagnitude(1.0);
 
         // Narrow focused FOV range scan
-        pSeenMO = LookForMOs(8, g_MaterialGrass, false);
+        pSeenMO = sense ? LookForMOs(8, g_MaterialGrass, false) : 0;
         // Still seeing enemy actor through the sights, keep firing!
         if (pSeenMO)
             pSeenActor = dynamic_cast<Actor *>(pSeenMO->GetRootParent());
@@ -2606,7 +2609,7 @@ void AHuman::UpdateAI()
         m_Controller.m_AnalogAim.CapMagnitude(1.0);
 
         // Narrow focused FOV range scan
-        pSeenMO = LookForMOs(18, g_MaterialGrass, false);
+        pSeenMO = sense ? LookForMOs(18, g_MaterialGrass, false) : 0;
         // Still seeing enemy actor through the sights, keep aiming the throw!
         if (pSeenMO)
             pSeenActor = dynamic_cast<Actor *>(pSeenMO->GetRootParent());
@@ -28,6 +28,7 @@
 #include "MOPixel.h"
 #include "Scene.h"
 #include "SettingsMan.h"
+#include "PerformanceMan.h"
 
 #include "GUI/GUI.h"
 #include "GUI/GUIFont.h"
@@ -102,6 +103,8 @@ void Actor::Clear()
     m_LastAlarmPos.Reset();
     m_SightDistance = 450;
     m_Perceptiveness = 0.5;
+    m_LastAISenseFrame = 0;
+    m_AIUpdateTime = 0;
     m_CharHeight = 0;
     m_HolsterOffset.Reset();
     m_ViewPoint.Reset();
@@ -1341,9 +1344,8 @@ bool Actor::UpdateAIScripted()
 
     // Call the defined function, but only after first checking if it and this instance's Lua representation exists
 
-	g_FrameMan.StartPerformanceMeasurement(FrameMan::PERF_ACTORS_AI);
+    // The time taken is measured by the Controller, for the legacy C++ AI as well
 	error = g_LuaMan.RunScriptString("if " + m_ScriptPresetName + ".UpdateAI and " + m_ScriptObjectName + " then " + m_ScriptPresetName + ".UpdateAI(" + m_ScriptObjectName + "); end");
-	g_FrameMan.StopPerformanceMeasurement(FrameMan::PERF_ACTORS_AI);
 
     if (error < 0)
         return false;
@@ -773,6 +773,26 @@ ENTITYALLOCATION(Actor)
     virtual void ClearAIWaypoints() { m_pMOMoveTarget = 0; m_Waypoints.clear(); m_MovePath.clear(); m_MoveTarget = m_Pos; m_MoveVector.Reset(); }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetMOMoveTarget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the MO the AI of this is currently moving toward, if any.
+// Arguments:       None.
+// Return value:    The MO, or 0 if none. Ownership is NOT transferred!
+
+    const MovableObject * GetMOMoveTarget() const { return m_pMOMoveTarget; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetMOMoveTarget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the MO the AI of this is currently moving toward.
+// Arguments:       The MO, or 0 for none. Ownership is NOT transferred!
+// Return value:    None.
+
+    void SetMOMoveTarget(const MovableObject *pTarget) { m_pMOMoveTarget = pTarget; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  GetLastAIWaypoint
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -904,6 +924,57 @@ ENTITYALLOCATION(Actor)
     virtual Vector GetAlarmPoint() { if (m_AlarmTimer.GetElapsedSimTimeMS() > g_TimerMan.GetDeltaTimeMS()) { return Vector(); } return m_LastAlarmPos; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsAIUrgent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether this is in a situation where its AI needs to look around
+//                  every frame, like being alarmed or hurt since the last frame.
+// Arguments:       None.
+// Return value:    Whether the AI sensing of this shouldn't be skipped this frame.
+
+    bool IsAIUrgent() const { return m_Health < m_PrevHealth || !m_AlarmTimer.IsPastSimTimeLimit(); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetLastAISenseFrame
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the sim update frame number this last ran its AI sensing in.
+// Arguments:       None.
+// Return value:    The frame number, as given by MovableMan::GetSimUpdateFrameNumber.
+
+    unsigned int GetLastAISenseFrame() const { return m_LastAISenseFrame; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetLastAISenseFrame
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the sim update frame number this last ran its AI sensing in.
+// Arguments:       The frame number, as given by MovableMan::GetSimUpdateFrameNumber.
+// Return value:    None.
+
+    void SetLastAISenseFrame(unsigned int frame) { m_LastAISenseFrame = frame; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetAIUpdateTime
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how long the AI update of this has been taking lately.
+// Arguments:       None.
+// Return value:    The smoothed time of one AI update, in microseconds.
+
+    float GetAIUpdateTime() const { return m_AIUpdateTime; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AddAIUpdateTime
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Folds how long the latest AI update of this took into the smoothed time.
+// Arguments:       The time the update took, in microseconds.
+// Return value:    None.
+
+    void AddAIUpdateTime(int64_t time) { m_AIUpdateTime += ((float)time - m_AIUpdateTime) * 0.1F; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual Method:  AddInventoryItem
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1404,6 +1475,10 @@ protected:
     float m_SightDistance;
     // How perceptive this is of alarming events going on around him, 0.0 - 1.0
     float m_Perceptiveness;
+    // The sim update frame number the AI last ran its sensing in, see MovableMan::ScheduleAISensing
+    unsigned int m_LastAISenseFrame;
+    // Smoothed time of one AI update, in microseconds
+    float m_AIUpdateTime;
     // About How tall is the Actor, in pixels?
     float m_CharHeight;
     // Speed at which the m_AimAngle will change, in radians/s.
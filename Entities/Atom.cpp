@@ -18,6 +18,7 @@
 #include "PresetMan.h"
 #include "DDTTools.h"
 #include "Actor.h"
+#include <mutex>
 
 using namespace std;
 
@@ -28,6 +29,8 @@ const string Atom::ClassName = "Atom";
 std::vector<void *> Atom::m_AllocatedPool;
 int Atom::m_PoolAllocBlockCount = 200;
 int Atom::m_InstancesInUse = 0;
+// Guards the pool, since scripts running on worker threads create and delete MOs too
+static mutex s_PoolMutex;
 
 // This forms a circle around the Atom's offset center, to check for key color pixels in order to determine the normal at the Atom's position
 //const Vector Atom::m_sNormalChecks[NormalCheckCount] = { Vector(0, -3), Vector(1, -3), Vector(2, -2), Vector(3, -1), Vector(3, 0), Vector(3, 1), Vector(2, 2), Vector(1, 3), Vector(0, 3), Vector(-1, 3), Vector(-2, 2), Vector(-3, 1), Vector(-3, 0), Vector(-3, -1), Vector(-2, -2), Vector(-1, -3) };
@@ -114,9 +117,12 @@ void Atom::FillPool(int fillAmount)
     // If concrete class, fill up the pool with pre-allocated memory blocks the size of the type
     if (fillAmount > 0)
     {
-        // As many as we're asked to make
-        for (int i = 0; i < fillAmount; ++i)
-            m_AllocatedPool.push_back(malloc(sizeof(Atom)));
+        // Carve them all out of one contiguous block, so the Atom:s of a group that get
+        // created together also end up next to each other in memory. Pushed in reverse so
+        // they get handed out in ascending address order
+        char *pBlock = (char *)malloc(fillAmount * sizeof(Atom));
+        for (int i = fillAmount - 1; i >= 0; --i)
+            m_AllocatedPool.push_back(pBlock + i * sizeof(Atom));
     }
 }
 
@@ -129,6 +135,8 @@ void Atom::FillPool(int fillAmount)
 
 void * Atom::GetPoolMemory()
 {
+    lock_guard<mutex> poolLock(s_PoolMutex);
+
     // If the pool is empty, then fill it up again with as many instances as we are set to
     if (m_AllocatedPool.empty())
         FillPool(m_PoolAllocBlockCount > 0 ? m_PoolAllocBlockCount : 10);
@@ -156,6 +164,7 @@ int Atom::ReturnPoolMemory(void *pReturnedMemory)
     if (!pReturnedMemory)
         return false;
 
+    lock_guard<mutex> poolLock(s_PoolMutex);
     m_AllocatedPool.push_back(pReturnedMemory);
 
     // Keep track of the number of instaces passed in
@@ -462,15 +471,14 @@ bool Atom::IsIgnoringMOID(MOID which)
     if (which == m_IgnoreMOID)
         return true;
 
-    // First check if we are ignoring the team of the MO we hit, or if it's an AtomGroup and we're ignoring all those
-    const MovableObject *pHitMO = g_MovableMan.GetMOFromID(which);
-    pHitMO = pHitMO ? pHitMO->GetRootParent() : 0;
+    // First check if we are ignoring the team of the MO we hit, which the MOID index knows without looking up the MO itself
+    if (m_pOwnerMO && m_pOwnerMO->IgnoresTeamHits() && g_MovableMan.MOIDIgnoresTeamHits(which) && m_pOwnerMO->GetTeam() == g_MovableMan.GetMOIDTeam(which))
+        return true;
+
+    // Then if it's an AtomGroup and we're ignoring all those
+    const MovableObject *pHitMO = m_pOwnerMO ? g_MovableMan.GetMOFromID(g_MovableMan.GetRootMOID(which)) : 0;
     if (m_pOwnerMO && pHitMO)
     {
-        // Team hits ignored?
-        if (m_pOwnerMO->IgnoresTeamHits() && pHitMO->IgnoresTeamHits() && m_pOwnerMO->GetTeam() == pHitMO->GetTeam())
-            return true;
-
         // AtomGroup hits ignored?
         if ((m_pOwnerMO->IgnoresAtomGroupHits() && dynamic_cast<const MOSRotating *>(pHitMO)) ||
             (pHitMO->IgnoresAtomGroupHits() && dynamic_cast<const MOSRotating *>(m_pOwnerMO)))
@@ -1002,15 +1002,9 @@ protected:
 
     // This forms a circle around the Atom's offset center, to check for key color pixels in order to determine the normal at the Atom's position
     static const int m_sNormalChecks[NormalCheckCount][2];
-    Vector m_Offset;
-    // This offset is before altering the m_Offset for use in composite groups
-    Vector m_OriginalOffset;
-    Vector m_Normal;
-    Material const * m_pMaterial;
-    // Identifying ID for adding and removing atoms from AtomGroups
-    int m_SubgroupID;
 
-    // Bresenham line algo vars
+    // Bresenham line algo vars. These are what StepForward touches every step, so they
+    // are kept together at the front, away from the bulky hit data further down
     int m_IntPos[2];
     int m_PrevIntPos[2];
     int m_TrailPos[2];
@@ -1025,6 +1019,14 @@ protected:
     float m_StepRatio;
     Vector m_SegTraj;
     float m_SegProgress;
+    // The material of this Atom
+    Material const * m_pMaterial;
+    Vector m_Offset;
+    // This offset is before altering the m_Offset for use in composite groups
+    Vector m_OriginalOffset;
+    Vector m_Normal;
+    // Identifying ID for adding and removing atoms from AtomGroups
+    int m_SubgroupID;
 
     // Temporary disabling of terrain collisions for this. Will be re-enabled once out of terrain again.
     bool m_MOHitsDisabled;
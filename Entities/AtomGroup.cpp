@@ -17,6 +17,7 @@
 #include "MovableObject.h"
 #include "MOSRotating.h"
 #include <deque>
+#include <vector>
 #include <map>
 #include <set>
 
@@ -103,7 +104,8 @@ int AtomGroup::Create(const AtomGroup &reference)
 
     int subID = 0;
     m_SubGroups.clear();
-    for (list<Atom *>::const_iterator itr = reference.m_Atoms.begin(); itr != reference.m_Atoms.end(); ++itr)
+    m_Atoms.reserve(reference.m_Atoms.size());
+    for (vector<Atom *>::const_iterator itr = reference.m_Atoms.begin(); itr != reference.m_Atoms.end(); ++itr)
     {
         Atom *pAtomCopy = new Atom(**itr);
 		pAtomCopy->SetIgnoreMOIDsByGroup(&m_IgnoreMOIDs);
@@ -116,10 +118,10 @@ int AtomGroup::Create(const AtomGroup &reference)
         if (subID != 0)
         {
             // Try to find the group
-            map<int, list<Atom *> >::iterator subItr = m_SubGroups.find(subID);
+            map<int, vector<Atom *> >::iterator subItr = m_SubGroups.find(subID);
             // No atom added to that group yet, so it doesn't exist, so make it
             if (subItr == m_SubGroups.end())
-                subItr = (m_SubGroups.insert(pair<int, list<Atom *> >(subID, list<Atom *>()))).first;
+                subItr = (m_SubGroups.insert(pair<int, vector<Atom *> >(subID, vector<Atom *>()))).first;
             // Add Atom to the list of that group
             subItr->second.push_back(pAtomCopy);
         }
@@ -575,7 +577,7 @@ int AtomGroup::Save(Writer &writer) const
     // Only write out atoms if they were manually specified
 //    if (!m_AutoGenerate)
 //    {
-        for (list<Atom *>::const_iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
+        for (vector<Atom *>::const_iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
         {
             writer.NewProperty("AddAtom");
             writer << **itr;
@@ -639,7 +641,7 @@ int AtomGroup::Save(ostream &stream) const
     stream << m_sClass.GetName() << " ";
 
     stream << m_Atoms[0].size() << " ";
-    for (list<Atom *>::const_iterator itr = m_Atoms[0].begin(); itr != m_Atoms[0].end(); ++itr)
+    for (vector<Atom *>::const_iterator itr = m_Atoms[0].begin(); itr != m_Atoms[0].end(); ++itr)
         stream << **itr << " ";
 
     stream << m_PathCount << " ";
@@ -657,7 +659,7 @@ int AtomGroup::Save(ostream &stream) const
 
 void AtomGroup::Destroy(bool notInherited)
 {
-    for (list<Atom *>::const_iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
+    for (vector<Atom *>::const_iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
         delete *itr;
 
     if (!notInherited)
@@ -706,7 +708,7 @@ float AtomGroup::CalculateMaxRadius()
 {
     float magnitude, longest = 0;
 
-    for (list<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
+    for (vector<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
     {
         magnitude = (*aItr)->GetOffset().GetMagnitude();
         if (magnitude > longest)
@@ -733,7 +735,7 @@ float AtomGroup::GetMomentOfInertia()
         }
         float distMass = m_pOwnerMO->GetMass() / m_Atoms.size();
         float radius = 0;
-        for (list<Atom *>::const_iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
+        for (vector<Atom *>::const_iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
         {
             radius = (*itr)->GetOffset().GetMagnitude() * g_FrameMan.GetMPP();
             m_MomInertia += distMass * radius * radius;
@@ -756,7 +758,7 @@ float AtomGroup::GetMomentOfInertia()
 void AtomGroup::SetOwner(MOSRotating *newOwner)
 {
     m_pOwnerMO = newOwner;
-    for (list<Atom *>::const_iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
+    for (vector<Atom *>::const_iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
         (*itr)->SetOwner(m_pOwnerMO);
 }
 
@@ -767,17 +769,17 @@ void AtomGroup::SetOwner(MOSRotating *newOwner)
 // Description:     Adds a list of new Atom:s to the internal list that makes up this group.
 //                  Ownership of all Atom:s in the list IS NOT transferred!
 
-void AtomGroup::AddAtoms(const std::list<Atom *> &atomList, int subID, const Vector &offset, const Matrix &offsetRotation)
+void AtomGroup::AddAtoms(const std::vector<Atom *> &atomList, int subID, const Vector &offset, const Matrix &offsetRotation)
 {
     Atom *pAtom;
 
     // Try to find existing subgroup with that ID to add to
-    map<int, list<Atom *> >::iterator subItr = m_SubGroups.find(subID);
+    map<int, vector<Atom *> >::iterator subItr = m_SubGroups.find(subID);
     // Couldn't find any, so make a new one for the new ID so we can add to it
     if (subItr == m_SubGroups.end())
-        subItr = (m_SubGroups.insert(pair<int, list<Atom *> >(subID, list<Atom *>()))).first;
+        subItr = (m_SubGroups.insert(pair<int, vector<Atom *> >(subID, vector<Atom *>()))).first;
 
-    for (list<Atom *>::const_iterator itr = atomList.begin(); itr != atomList.end(); ++itr)
+    for (vector<Atom *>::const_iterator itr = atomList.begin(); itr != atomList.end(); ++itr)
     {
         pAtom = new Atom(**itr);
         pAtom->SetSubID(subID);
@@ -802,14 +804,14 @@ void AtomGroup::AddAtoms(const std::list<Atom *> &atomList, int subID, const Vec
 bool AtomGroup::UpdateSubAtoms(int subID, const Vector &newOffset, const Matrix &newOffsetRotation)
 {
     // Try to find existing subgroup with that ID to update
-    map<int, list<Atom *> >::iterator subItr = m_SubGroups.find(subID);
+    map<int, vector<Atom *> >::iterator subItr = m_SubGroups.find(subID);
     // Couldn't find any, so quit
     if (subItr == m_SubGroups.end())
         return false;
 
     DAssert(!subItr->second.empty(), "Found empty atom subgroup list!?");
 
-    for (list<Atom *>::const_iterator aItr = subItr->second.begin(); aItr != subItr->second.end(); ++aItr)
+    for (vector<Atom *>::const_iterator aItr = subItr->second.begin(); aItr != subItr->second.end(); ++aItr)
     {
         // Re-set ID just to make sure
         (*aItr)->SetSubID(subID);
@@ -829,17 +831,13 @@ bool AtomGroup::UpdateSubAtoms(int subID, const Vector &newOffset, const Matrix
 bool AtomGroup::RemoveAtoms(int removeID)
 {
     bool removedAny = false;
-    list<Atom *>::iterator eraseItr;
 
-    for (list<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end();)
+    for (vector<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end();)
     {
         if ((*aItr)->GetSubID() == removeID)
         {
-            // This hanky panky necessary to not invalidate the aItr iterator
             delete (*aItr);
-            eraseItr = aItr;
-            aItr++;
-            m_Atoms.erase(eraseItr);
+            aItr = m_Atoms.erase(aItr);
             removedAny = true;
         }
         else
@@ -862,17 +860,13 @@ bool AtomGroup::RemoveAtoms(int removeID)
 bool AtomGroup::RemoveAllButAtoms(int removeAllButID)
 {
     bool removedAny = false;
-    list<Atom *>::iterator eraseItr;
 
-    for (list<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end();)
+    for (vector<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end();)
     {
         if ((*aItr)->GetSubID() != removeAllButID)
         {
-            // This hanky panky necessary to not invalidate the aItr iterator
             delete (*aItr);
-            eraseItr = aItr;
-            aItr++;
-            m_Atoms.erase(eraseItr);
+            aItr = m_Atoms.erase(aItr);
             removedAny = true;
         }
         else
@@ -880,8 +874,8 @@ bool AtomGroup::RemoveAllButAtoms(int removeAllButID)
     }
 
     // Remove the entries int he SubGroup map
-    map<int, list<Atom *> >::iterator eraseMapItr;
-    for (map<int, list<Atom *> >::iterator mItr = m_SubGroups.begin(); mItr != m_SubGroups.end();)
+    map<int, vector<Atom *> >::iterator eraseMapItr;
+    for (map<int, vector<Atom *> >::iterator mItr = m_SubGroups.begin(); mItr != m_SubGroups.end();)
     {
         if (mItr->first != removeAllButID)
         {
@@ -905,7 +899,7 @@ bool AtomGroup::RemoveAllButAtoms(int removeAllButID)
 
 void AtomGroup::AddMOIDToIgnore(MOID ignore)
 {
-    /*for (list<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
+    /*for (vector<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
         (*aItr)->AddMOIDToIgnore(ignore);*/
 	// m_IgnoreMOIDs is passed to every atom which belongs to this group to avoid messing with every single atom
 	// when adding or removing ignored MOs
@@ -923,7 +917,7 @@ void AtomGroup::AddMOIDToIgnore(MOID ignore)
 
 void AtomGroup::ClearMOIDIgnoreList()
 {
-    /*for (list<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
+    /*for (vector<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
         (*aItr)->ClearMOIDIgnoreList();*/
 	// m_IgnoreMOIDs is passed to every atom which belongs to this group to avoid messing with every single atom
 	// when adding or removing ignored MOs
@@ -960,17 +954,22 @@ float AtomGroup::Travel(const float travelTime,
         return travelTime;
     }
 
-    return Travel(m_pOwnerMO->m_Pos,
-                  m_pOwnerMO->m_Vel,
-                  m_pOwnerMO->m_Rotation,
-                  m_pOwnerMO->m_AngularVel,
-                  m_pOwnerMO->m_DidWrap,
-                  m_pOwnerMO->m_TravelImpulse,
-                  m_pOwnerMO->GetMass(),
-                  travelTime,
-                  callOnBounce,
-                  callOnSink,
-                  scenePreLocked);
+    g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ATOMGROUP_TRAVEL);
+
+    float timeLeft = Travel(m_pOwnerMO->m_Pos,
+                            m_pOwnerMO->m_Vel,
+                            m_pOwnerMO->m_Rotation,
+                            m_pOwnerMO->m_AngularVel,
+                            m_pOwnerMO->m_DidWrap,
+                            m_pOwnerMO->m_TravelImpulse,
+                            m_pOwnerMO->GetMass(),
+                            travelTime,
+                            callOnBounce,
+                            callOnSink,
+                            scenePreLocked);
+
+    g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ATOMGROUP_TRAVEL);
+    return timeLeft;
 }
 
 
@@ -1088,12 +1087,12 @@ float AtomGroup::Travel(Vector &position,
     float segRatio, preHitRot, radMag, retardation;
     bool hitStep, newDir, halted = false, hitMOs = m_pOwnerMO->m_HitsMOs;
     Atom *pFastestAtom = 0;
-    map<MOID, list<Atom *> > hitMOAtoms;
-    map<MOID, list<Atom *> >::iterator mapMOItr;
-    list<Atom *> hitTerrAtoms;
-    list<Atom *> penetratingAtoms;
-    list<Atom *> hitResponseAtoms;
-    list<Atom *>::iterator aItr;
+    map<MOID, vector<Atom *> > hitMOAtoms;
+    map<MOID, vector<Atom *> >::iterator mapMOItr;
+    vector<Atom *> hitTerrAtoms;
+    vector<Atom *> penetratingAtoms;
+    vector<Atom *> hitResponseAtoms;
+    vector<Atom *>::iterator aItr;
     Vector linSegTraj, startOff, targetOff, atomTraj, tempVec, tempVel, preHitPos, hitNormal;
     MOID tempMOID = g_NoMOID;
     HitData hitData;
@@ -1276,9 +1275,9 @@ float AtomGroup::Travel(Vector &position,
                         // and insert into the map of MO-hitting Atom:s.
                         if (mapMOItr == hitMOAtoms.end())
                         {
-                            list<Atom *> newDeque;
+                            vector<Atom *> newDeque;
                             newDeque.push_back(*aItr);
-                            hitMOAtoms.insert(pair<MOID, list<Atom *> >(tempMOID, newDeque));
+                            hitMOAtoms.insert(pair<MOID, vector<Atom *> >(tempMOID, newDeque));
                         }
                         // If another Atom of this group has already hit this same MO
                         // during this step, go ahead and add the new atom to the
@@ -1692,7 +1691,7 @@ Vector AtomGroup::PushTravel(Vector &position,
     deque<pair<Atom *, Vector> > hitTerrAtoms;
     deque<pair<Atom *, Vector> > penetratingAtoms;
     deque<pair<Atom *, Vector> >::iterator aoItr;
-    list<Atom *>::iterator aItr;
+    vector<Atom *>::iterator aItr;
     // First Vector is the impulse force in kg * m/s, the second is force point,
     // or its offset from the origin of the AtomGroup.
     deque<pair<Vector, Vector> > impulseForces;
@@ -2391,7 +2390,7 @@ bool AtomGroup::InTerrain()
     bool penetrates = false;
     Vector aPos;
 // TODO: UNCOMMENT
-    for (list<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end() && !penetrates; ++aItr)
+    for (vector<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end() && !penetrates; ++aItr)
     {
         aPos = (m_pOwnerMO->GetPos() + ((*aItr)->GetOffset().GetXFlipped(m_pOwnerMO->m_HFlipped) * m_pOwnerMO->GetRotMatrix())).GetFloored();
         if (g_SceneMan.GetTerrMatter(aPos.m_X, aPos.m_Y) != g_MaterialAir)
@@ -2424,7 +2423,7 @@ float AtomGroup::RatioInTerrain()
     int inTerrain = 0;
     Vector aPos;
 
-    for (list<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
+    for (vector<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
     {
         aPos = (m_pOwnerMO->GetPos() + ((*aItr)->GetOffset().GetXFlipped(m_pOwnerMO->m_HFlipped) * m_pOwnerMO->GetRotMatrix())).GetFloored();
         if (g_SceneMan.GetTerrMatter(aPos.m_X, aPos.m_Y) != g_MaterialAir)
@@ -2447,8 +2446,8 @@ bool AtomGroup::ResolveTerrainIntersection(Vector &position, Matrix &rotation, u
     SLICK_PROFILE(0xFF335546);
 
     Vector atomOffset, atomPos, atomNormal, clearPos, exitDirection, atomExitVector, totalExitVector;
-    list<Atom *>::iterator aItr;
-    list<Atom *> intersectingAtoms;
+    vector<Atom *>::iterator aItr;
+    vector<Atom *> intersectingAtoms;
     MOID hitMaterial = g_MaterialAir;
     float strengthThreshold = strongerThan != g_MaterialAir ? g_SceneMan.GetMaterialFromID(strongerThan)->strength : 0;
     bool rayHit = false;
@@ -2551,8 +2550,8 @@ bool AtomGroup::ResolveMOSIntersection(Vector &position, Matrix &rotation)
         return true;
 
     Vector atomOffset, atomPos, atomNormal, clearPos, exitDirection, atomExitVector, totalExitVector;
-    list<Atom *>::iterator aItr;
-    list<Atom *> intersectingAtoms;
+    vector<Atom *>::iterator aItr;
+    vector<Atom *> intersectingAtoms;
     MOID hitMOID = g_NoMOID, currentMOID = g_NoMOID;
     MovableObject *pIntersectedMO = 0;
     MOSRotating *pIntersectedMOS = 0;
@@ -2733,7 +2732,7 @@ void AtomGroup::Draw(BITMAP *pTargetBitmap,
 {
     acquire_bitmap(pTargetBitmap);
     Vector aPos, normal;
-    for (list<Atom *>::const_iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
+    for (vector<Atom *>::const_iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
     {
         if (!useLimbPos)
             aPos = (m_pOwnerMO->GetPos() + ((*aItr)->GetOffset().GetXFlipped(m_pOwnerMO->m_HFlipped)
@@ -19,6 +19,7 @@
 #include "LimbPath.h"
 #include "Timer.h"
 #include <deque>
+#include <vector>
 
 namespace RTE
 {
@@ -260,7 +261,7 @@ ENTITYALLOCATION(AtomGroup)
 // Arguments:       None.
 // Return value:    A reference to the list.
 
-    const std::list<Atom *> & GetAtomList() const { return m_Atoms; }
+    const std::vector<Atom *> & GetAtomList() const { return m_Atoms; }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -370,7 +371,7 @@ ENTITYALLOCATION(AtomGroup)
 // Arguments:       Whether or not this should check for collisions with MOs or not.
 // Return value:    None.
 
-    void SetToHitMOs(bool hitMOs) { for (std::list<Atom *>::iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
+    void SetToHitMOs(bool hitMOs) { for (std::vector<Atom *>::iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
                                         (*itr)->SetToHitMOs(hitMOs); }
 */
 
@@ -446,7 +447,7 @@ ENTITYALLOCATION(AtomGroup)
 //                  The rotation of the placed atoms around the above offset.
 // Return value:    None.
 
-    void AddAtoms(const std::list<Atom *> &atomList, int subID = 0, const Vector &offset = Vector(), const Matrix &offsetRotation = Matrix());
+    void AddAtoms(const std::vector<Atom *> &atomList, int subID = 0, const Vector &offset = Vector(), const Matrix &offsetRotation = Matrix());
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -730,10 +731,11 @@ private:
     // Depth, or how deep into the bitmap of the owning MO's graphical representation
     // the Atom:s of this AtomGroup are located, in pixels.
     int m_Depth;
-    // List of Atoms that constitute the group. Owned by this
-    std::list<Atom *> m_Atoms;
+    // The Atoms that constitute the group, kept in a contiguous array since Travel walks
+    // all of them several times per step. Owned by this
+    std::vector<Atom *> m_Atoms;
     // Sub groupings of atoms, not owned in here. Point to atoms owned in m_Atoms.
-    std::map<int, std::list<Atom *> > m_SubGroups;
+    std::map<int, std::vector<Atom *> > m_SubGroups;
     // Moment of Inertia for this AtomGroup
     float m_MomInertia;
     // The owner of this AtomGroup. The owner is obviously not owned by this AtomGroup.
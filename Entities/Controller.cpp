@@ -16,6 +16,7 @@
 #include "ConsoleMan.h"
 #include "DDTTools.h"
 #include "Actor.h"
+#include "MovableMan.h"
 
 using namespace std;
 
@@ -553,10 +554,14 @@ void Controller::Update()
         // Update the AI state of the Actor we're controlling
         if (m_pControlled)
         {
+            int64_t startTime = g_TimerMan.GetAbsoulteTime();
+
             // Try to use any scripted AI defined for this Actor
             if (!m_pControlled->UpdateAIScripted())
                 // if can't, fall back on the legacy C++ implementation
                 m_pControlled->UpdateAI();
+
+            g_MovableMan.AddAIUpdateTime(m_pControlled, g_TimerMan.GetAbsoulteTime() - startTime);
         }
     }
 }
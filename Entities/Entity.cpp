@@ -15,6 +15,7 @@
 #include "PresetMan.h"
 #include "ConsoleMan.h"
 #include "DataModule.h"
+#include <mutex>
 
 using namespace std;
 
@@ -24,6 +25,9 @@ namespace RTE
 Entity::ClassInfo * Entity::ClassInfo::m_sClassHead = 0;
 
 Entity::ClassInfo Entity::m_sClass("Entity");
+long Entity::m_sPresetGroupChanges = 0;
+// Guards the pools of all classes, since scripts running on worker threads create and delete entities too
+static mutex s_PoolMutex;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -123,6 +127,8 @@ void * Entity::ClassInfo::GetPoolMemory()
 {
     DAssert(IsConcrete(), "Trying to get pool memory of an abstract Entity class!");
 
+    lock_guard<mutex> poolLock(s_PoolMutex);
+
     // If the pool is empty, then fill it up again with as many instances as we are set to
     if (m_AllocatedPool.empty())
         FillPool(m_PoolAllocBlockCount > 0 ? m_PoolAllocBlockCount : 10);
@@ -150,6 +156,7 @@ int Entity::ClassInfo::ReturnPoolMemory(void *pReturnedMemory)
     if (!pReturnedMemory)
         return false;
 
+    lock_guard<mutex> poolLock(s_PoolMutex);
     m_AllocatedPool.push_back(pReturnedMemory);
 
     // Keep track of the number of instaces passed in
@@ -477,6 +484,20 @@ bool Entity::IsInGroup(const string &whichGroup)
     if (!whichGroup.empty() && m_LastGroupSearch == whichGroup)
         return m_LastGroupResult;
 
+    // Save the search result for quicker response next time
+    m_LastGroupSearch = whichGroup;
+    return m_LastGroupResult = HasGroup(whichGroup);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          HasGroup
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Shows whether this is part of a specific group or not, without using
+//                  or updating the last search.
+
+bool Entity::HasGroup(const string &whichGroup) const
+{
     // Searched for Any or All yeilds ALL
     if (whichGroup == "Any" || whichGroup == "All")
         return true;
@@ -488,16 +509,9 @@ bool Entity::IsInGroup(const string &whichGroup)
     for (list<string>::const_iterator itr = m_Groups.begin(); itr != m_Groups.end(); ++itr)
     {
         if (whichGroup == *itr)
-        {
-            // Save the search result for quicker response next time
-            m_LastGroupSearch = whichGroup;
-            return m_LastGroupResult = true;
-        }
+            return true;
     }
-
-    // Save the search result for quicker response next time
-    m_LastGroupSearch = whichGroup;
-    return m_LastGroupResult = false;
+    return false;
 }
 
 
@@ -624,7 +624,18 @@ public:
 //                  ignored.
 // Return value:    None.
 
-    void AddToGroup(std::string newGroup) { m_Groups.push_back(newGroup); m_Groups.sort(); m_Groups.unique(); m_LastGroupSearch.clear(); }
+    void AddToGroup(std::string newGroup) { m_Groups.push_back(newGroup); m_Groups.sort(); m_Groups.unique(); m_LastGroupSearch.clear(); if (m_IsOriginalPreset) { ++m_sPresetGroupChanges; } }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static method:   GetPresetGroupChanges
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a count that goes up every time an original preset is added to a
+//                  group, so anything caching group lookups can tell when to redo them.
+// Arguments:       None.
+// Return value:    The number of group changes to original presets so far.
+
+    static long GetPresetGroupChanges() { return m_sPresetGroupChanges; }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -647,6 +658,18 @@ public:
 
     bool IsInGroup(const std::string &whichGroup);
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          HasGroup
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Shows whether this is part of a specific group or not, without using
+//                  or updating the last search like IsInGroup does. Safe to call from
+//                  several threads at once.
+// Arguments:       A string which describes the group to check for.
+// Return value:    Whether this Entity is in the specified group or not.
+
+    bool HasGroup(const std::string &whichGroup) const;
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Friend operator: Entity Reader extraction
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -692,6 +715,8 @@ protected:
     // Member variables
     // Type description of this Entity
     static Entity::ClassInfo m_sClass;
+    // How many times an original preset has been added to a group
+    static long m_sPresetGroupChanges;
     // The name of the Preset data this was cloned from, if any
     std::string m_PresetName;
     // Whether this is to be added to the PresetMan as an original preset instance.
@@ -279,6 +279,20 @@ int GameActivity::ReadProperty(std::string propName, Reader &reader)
         reader >> m_GoldSwitchEnabled;
 	else if (propName == "RequireClearPathToOrbitSwitchEnabled")
         reader >> m_RequireClearPathToOrbitSwitchEnabled;
+    else if (propName == "FogOfWarEnabled")
+        reader >> m_FogOfWarEnabled;
+    else if (propName == "RequireClearPathToOrbit")
+        reader >> m_RequireClearPathToOrbit;
+    else if (propName == "StartingGold")
+        reader >> m_StartingGold;
+    else if (propName == "Team1Tech")
+        reader >> m_TeamTech[TEAM_1];
+    else if (propName == "Team2Tech")
+        reader >> m_TeamTech[TEAM_2];
+    else if (propName == "Team3Tech")
+        reader >> m_TeamTech[TEAM_3];
+    else if (propName == "Team4Tech")
+        reader >> m_TeamTech[TEAM_4];
     else
         // See if the base class(es) can find a match instead
         return Activity::ReadProperty(propName, reader);
@@ -301,6 +315,22 @@ int GameActivity::Save(Writer &writer) const
     writer << m_CPUTeam;
     writer.NewProperty("DeliveryDelay");
     writer << m_DeliveryDelay;
+    writer.NewProperty("FogOfWarEnabled");
+    writer << m_FogOfWarEnabled;
+    writer.NewProperty("RequireClearPathToOrbit");
+    writer << m_RequireClearPathToOrbit;
+    writer.NewProperty("StartingGold");
+    writer << m_StartingGold;
+    for (int team = TEAM_1; team < MAXTEAMCOUNT; ++team)
+    {
+        if (!m_TeamTech[team].empty())
+        {
+            char propName[16];
+            sprintf(propName, "Team%dTech", team + 1);
+            writer.NewProperty(propName);
+            writer << m_TeamTech[team];
+        }
+    }
 
     return 0;
 }
@@ -590,6 +590,17 @@ ENTITYALLOCATION(HDFirearm)
     virtual bool IsReloading() { return m_Reloading; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  CanSleep
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether this MO has nothing going on that needs it to be
+//                  updated every frame while it lies still. Never while reloading.
+// Arguments:       None.
+// Return value:    Whether this could be put to sleep if it stays still long enough.
+
+    virtual bool CanSleep() const { return !m_Reloading && HeldDevice::CanSleep(); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  DoneReloading
 //////////////////////////////////////////////////////////////////////////////////////////
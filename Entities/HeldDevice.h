@@ -489,6 +489,17 @@ ENTITYALLOCATION(HeldDevice)
     virtual bool IsReloading() { return false; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  CanSleep
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether this MO has nothing going on that needs it to be
+//                  updated every frame while it lies still. Never while activated.
+// Arguments:       None.
+// Return value:    Whether this could be put to sleep if it stays still long enough.
+
+    virtual bool CanSleep() const { return !m_Activated && Attachable::CanSleep(); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  DoneReloading
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -45,6 +45,8 @@ BITMAP * MOSRotating::m_spTempBitmapS128 = 0;
 BITMAP * MOSRotating::m_spTempBitmapS256 = 0;
 BITMAP * MOSRotating::m_spTempBitmapS512 = 0;
 
+RotatedSpriteCache MOSRotating::m_sRotatedSpriteCache;
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          Clear
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -194,6 +196,7 @@ void MOSRotating::Clear()
     m_Recoiled = false;
     m_RecoilForce.Reset();
     m_RecoilOffset.Reset();
+    m_SleepAngle = 0;
     m_Emitters.clear();
     m_Attachables.clear();
     m_Gibs.clear();
@@ -1332,6 +1335,71 @@ void MOSRotating::RestDetection()
 }
 
 
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  CanSleep
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether this MO has nothing going on that needs it to be
+//                  updated every frame while it lies still, including anything attached.
+
+bool MOSRotating::CanSleep() const
+{
+    if (!MOSprite::CanSleep())
+        return false;
+
+    // Anything attached that is busy, like a bleeding wound, keeps this awake too
+    for (list<AEmitter *>::const_iterator eItr = m_Emitters.begin(); eItr != m_Emitters.end(); ++eItr)
+    {
+        if (!(*eItr)->CanSleep())
+            return false;
+    }
+    for (list<Attachable *>::const_iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
+    {
+        if (!(*aItr)->CanSleep())
+            return false;
+    }
+
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  SleepDetection
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Puts this MO to sleep if it has been able to sleep and hasn't moved or
+//                  turned for long enough.
+
+void MOSRotating::SleepDetection(int sleepDelay)
+{
+    // Turning counts as moving
+    if (!m_Asleep && fabs(m_Rotation.GetRadAngle() - m_SleepAngle) >= 0.05f)
+    {
+        m_SleepAngle = m_Rotation.GetRadAngle();
+        m_SleepTimer.Reset();
+    }
+
+    MOSprite::SleepDetection(sleepDelay);
+
+    if (m_Asleep)
+    {
+        m_SleepAngle = m_Rotation.GetRadAngle();
+        m_AngularVel = 0;
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  SleepDisturbed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether something has happened to this sleeping MO since it
+//                  fell asleep that means it needs to be woken up.
+
+bool MOSRotating::SleepDisturbed() const
+{
+    return MOSprite::SleepDisturbed() || m_AngularVel != 0 || m_Rotation.GetRadAngle() != m_SleepAngle;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  IsOnScenePoint
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1860,6 +1928,21 @@ void MOSRotating::Draw(BITMAP *pTargetBitmap,
     if (m_Recoiled)
         spritePos += m_RecoilOffset;
 
+    // See if there's an already rotated copy of this frame to use instead of doing it all live. The cached frames are rotated
+    // to the nearest of a set of angles, which is fine to look at, but the material and MOID silhouettes have to match the
+    // object's actual rotation for collisions, settling and hit detection, so those are always rotated exactly
+    BITMAP *pRotated = 0;
+    if (mode == g_DrawColor || mode == g_DrawTrans)
+    {
+        bool flipped = m_HFlipped && pFlipBitmap;
+        pRotated = m_sRotatedSpriteCache.GetRotated(m_aSprite[m_Frame],
+                                                    flipped,
+                                                    flipped ? m_aSprite[m_Frame]->w + m_SpriteOffset.m_X : -(m_SpriteOffset.m_X),
+                                                    -(m_SpriteOffset.m_Y),
+                                                    m_Rotation.GetAllegroAngle(),
+                                                    m_Scale);
+    }
+
     // If we're drawing a material silhouette, then create an intermediate material bitmap as well
     if (mode != g_DrawColor && mode != g_DrawTrans)
     {
@@ -1951,9 +2034,25 @@ void MOSRotating::Draw(BITMAP *pTargetBitmap,
 	}
 
 
+    //////////////////
+    // CACHED
+    if (pRotated)
+    {
+        int drawX = 0, drawY = 0;
+        for (int i = 0; i < passes; ++i)
+        {
+            // The pivot point is in the middle of the cached bitmap
+            drawX = aDrawPos[i].GetFloorIntX() - (pRotated->w / 2);
+            drawY = aDrawPos[i].GetFloorIntY() - (pRotated->h / 2);
+            if (mode == g_DrawColor)
+                draw_sprite(pTargetBitmap, pRotated, drawX, drawY);
+            else
+                draw_trans_sprite(pTargetBitmap, pRotated, drawX, drawY);
+        }
+    }
     //////////////////
     // FLIPPED
-    if (m_HFlipped && pFlipBitmap)
+    else if (m_HFlipped && pFlipBitmap)
     {
         // Don't size the intermediate bitmaps to the m_Scale, because the scaling happens after they are done
         clear_to_color(pFlipBitmap, keyColor);
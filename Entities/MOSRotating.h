@@ -15,6 +15,7 @@
 // Inclusions of header files
 
 #include "MOSprite.h"
+#include "RotatedSpriteCache.h"
 
 namespace RTE
 {
@@ -750,6 +751,40 @@ ENTITYALLOCATION(MOSRotating)
     virtual void RestDetection();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  CanSleep
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether this MO has nothing going on that needs it to be
+//                  updated every frame while it lies still, including anything attached.
+// Arguments:       None.
+// Return value:    Whether this could be put to sleep if it stays still long enough.
+
+    virtual bool CanSleep() const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  SleepDetection
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Puts this MO to sleep if it has been able to sleep and hasn't moved or
+//                  turned for long enough.
+// Arguments:       How long, in ms sim time, this has to stay still to fall asleep.
+//                  0 means never.
+// Return value:    None.
+
+    virtual void SleepDetection(int sleepDelay);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  SleepDisturbed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether something has happened to this sleeping MO since it
+//                  fell asleep that means it needs to be woken up.
+// Arguments:       None.
+// Return value:    Whether this should be woken up.
+
+    virtual bool SleepDisturbed() const;
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  IsOnScenePoint
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -856,6 +891,28 @@ ENTITYALLOCATION(MOSRotating)
                       bool onlyPhysical = false) const;
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static method:   SetRotatedSpriteCacheBudget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets how much memory the cache of pre-rotated sprite frames shared by
+//                  all MOSRotatings may use.
+// Arguments:       The budget in bytes. 0 disables the cache and always draws live.
+// Return value:    None.
+
+    static void SetRotatedSpriteCacheBudget(long budget) { m_sRotatedSpriteCache.SetBudget(budget); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static method:   ClearRotatedSpriteCache
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Frees all the pre-rotated sprite frames. Must be done before the
+//                  sprite bitmaps themselves are freed.
+// Arguments:       None.
+// Return value:    None.
+
+    static void ClearRotatedSpriteCache() { m_sRotatedSpriteCache.Clear(); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  GetGibWoundLimit
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1149,6 +1206,8 @@ protected:
     Vector m_RecoilForce;
     // The vector that the recoil offsets the sprite when m_Recoiled is true.
     Vector m_RecoilOffset;
+    // The rotation angle this was at when it last started staying still, or fell asleep
+    float m_SleepAngle;
     // The list of AEmitters currently attached to this MOSRotating, and owned here as well
     std::list<AEmitter *> m_Emitters;
     // The list of general Attachables currently attached and Owned by this.
@@ -1199,6 +1258,8 @@ protected:
     static BITMAP *m_spTempBitmapS128;
     static BITMAP *m_spTempBitmapS256;
     static BITMAP *m_spTempBitmapS512;
+    // Flipped, rotated and scaled sprite frames shared between all MOSRotatings, so Draw doesn't have to redo the pivoting each time
+    static RotatedSpriteCache m_sRotatedSpriteCache;
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Private member variable and method declarations
@@ -16,6 +16,7 @@
 #include "SceneMan.h"
 #include "SettingsMan.h"
 #include "LuaMan.h"
+#include "PerformanceMan.h"
 #include "Atom.h"
 
 
@@ -26,7 +27,20 @@ namespace RTE
 
 ABSTRACTCLASSINFO(MovableObject, SceneObject)
 
-unsigned long int MovableObject::m_UniqueIDCounter = 1;
+std::atomic<unsigned long int> MovableObject::m_UniqueIDCounter(1);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static method:  GetNextUniqueID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Returns the next unique id for MO's and increments unique ID counter
+
+unsigned long int MovableObject::GetNextUniqueID()
+{
+    // Objects made by scripts on the lanes get ids in the same order however the lanes were spread over threads
+    unsigned long int laneID = g_LuaMan.TakeScriptUniqueID();
+    return laneID ? laneID : ++m_UniqueIDCounter;
+}
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          Clear
@@ -51,6 +65,9 @@ void MovableObject::Clear()
     m_ImpulseForces.clear();
     m_AgeTimer.Reset();
     m_RestTimer.Reset();
+    m_Asleep = false;
+    m_SleepPos.Reset();
+    m_SleepTimer.Reset();
     m_Lifetime = 0;
     m_Sharpness = 1.0;
 //    m_MaterialId = 0;
@@ -78,6 +95,8 @@ void MovableObject::Clear()
     m_ScriptPath.clear();
     m_ScriptPresetName.clear();
     m_ScriptObjectName.clear();
+    m_ScriptThreadSafe = false;
+    m_ScriptLane = -1;
     m_ScreenEffectFile.Reset();
     m_pScreenEffect = 0;
 	m_EffectRotAngle = 0;
@@ -211,6 +230,7 @@ int MovableObject::Create(const MovableObject &reference)
     m_HUDVisible = reference.m_HUDVisible;
     m_ScriptPath = reference.m_ScriptPath;
     m_ScriptPresetName = reference.m_ScriptPresetName;
+    m_ScriptThreadSafe = reference.m_ScriptThreadSafe;
     // Should be unique to the object, will be created lazily upon first UpdateScript
 //    m_ScriptObjectName
     if (reference.m_pScreenEffect)
@@ -337,6 +357,8 @@ int MovableObject::ReadProperty(std::string propName, Reader &reader)
         // Read in the Lua script function definitions for this preset
         LoadScripts(m_ScriptPath);
     }
+    else if (propName == "ScriptThreadSafe")
+        reader >> m_ScriptThreadSafe;
     else if (propName == "ScreenEffect")
     {
         reader >> m_ScreenEffectFile;
@@ -440,6 +462,8 @@ int MovableObject::Save(Writer &writer) const
     {
         writer.NewProperty("ScriptPath");
         writer << m_ScriptPath;
+        writer.NewProperty("ScriptThreadSafe");
+        writer << m_ScriptThreadSafe;
     }
     writer.NewProperty("ScreenEffect");
     writer << m_ScreenEffectFile;
@@ -468,11 +492,20 @@ void MovableObject::Destroy(bool notInherited)
     // Clean up the existence of this in the script state
     if (!m_ScriptObjectName.empty())
     {
-        // Call the scripted destruction function, but only after first checking if it and this instance's Lua representation really exists
-        g_LuaMan.RunScriptString("if " + m_ScriptPresetName + " and " + m_ScriptPresetName + ".Destroy and " + m_ScriptObjectName + " then " + m_ScriptPresetName + ".Destroy(" + m_ScriptObjectName + "); end");
-        // Assign nil to the variable that held this' representation in Lua
-        g_LuaMan.RunScriptString("if " + m_ScriptObjectName + " then " + m_ScriptObjectName + " = nil; end");
+        // The master state can't be used from a script lane's thread, so have the representation removed after the batch
+        if (g_LuaMan.InScriptLane())
+            g_LuaMan.DeferScriptObjectRemoval(m_ScriptObjectName, -1);
+        else
+        {
+            // Call the scripted destruction function, but only after first checking if it and this instance's Lua representation really exists
+            g_LuaMan.RunScriptString("if " + m_ScriptPresetName + " and " + m_ScriptPresetName + ".Destroy and " + m_ScriptObjectName + " then " + m_ScriptPresetName + ".Destroy(" + m_ScriptObjectName + "); end");
+            // Assign nil to the variable that held this' representation in Lua
+            g_LuaMan.RunScriptString("if " + m_ScriptObjectName + " then " + m_ScriptObjectName + " = nil; end");
+        }
     }
+    // Same for a representation on a script lane
+    if (m_ScriptLane >= 0)
+        g_LuaMan.DestroyParallelScriptObject(this);
 
     if (!notInherited)
         SceneObject::Destroy();
@@ -642,6 +675,57 @@ bool MovableObject::IsAtRest()
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  CanSleep
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether this MO has nothing going on that needs it to be
+//                  updated every frame while it lies still.
+
+bool MovableObject::CanSleep() const
+{
+    return m_ScriptPath.empty() && m_Lifetime == 0 && !m_ToDelete && m_Forces.empty() && m_ImpulseForces.empty();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  SleepDetection
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Puts this MO to sleep if it has been able to sleep and hasn't moved for
+//                  long enough.
+
+void MovableObject::SleepDetection(int sleepDelay)
+{
+    if (m_Asleep)
+        return;
+
+    // Any real movement or reason to stay awake restarts the wait
+    if (sleepDelay <= 0 || !CanSleep() || fabs(m_Pos.m_X - m_SleepPos.m_X) >= 1.0f || fabs(m_Pos.m_Y - m_SleepPos.m_Y) >= 1.0f)
+    {
+        m_SleepPos = m_Pos;
+        m_SleepTimer.Reset();
+    }
+    else if (m_SleepTimer.IsPastSimMS(sleepDelay))
+    {
+        m_Asleep = true;
+        m_SleepPos = m_Pos;
+        m_Vel.Reset();
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  SleepDisturbed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether something has happened to this sleeping MO since it
+//                  fell asleep that means it needs to be woken up.
+
+bool MovableObject::SleepDisturbed() const
+{
+    // Velocity was zeroed when falling asleep, so anything nonzero was put there by someone else
+    return !CanSleep() || !m_Vel.IsZero() || m_Pos.m_X != m_SleepPos.m_X || m_Pos.m_Y != m_SleepPos.m_Y;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  OnMOHit
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -857,8 +941,9 @@ int MovableObject::UpdateScript()
     }
 
     // Call the defined function, but only after first checking if it and this instance's Lua representation exists
-    if ((error = g_LuaMan.RunScriptString("if " + m_ScriptPresetName + ".Update and " + m_ScriptObjectName + " then " + m_ScriptPresetName + ".Update(" + m_ScriptObjectName + "); end")) < 0)
-        return error;
+	g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_SCRIPTS);
+    error = g_LuaMan.RunScriptString("if " + m_ScriptPresetName + ".Update and " + m_ScriptObjectName + " then " + m_ScriptPresetName + ".Update(" + m_ScriptObjectName + "); end");
+	g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_SCRIPTS);
 
     return error;
 }
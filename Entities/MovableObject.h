@@ -17,6 +17,7 @@
 #include <string>
 #include <set>
 #include <deque>
+#include <atomic>
 #include "SceneObject.h"
 #include "Vector.h"
 #include "Matrix.h"
@@ -994,7 +995,7 @@ ENTITYALLOCATION(MovableObject)
 // Arguments:       The name of the group to look for.
 // Return value:    Whetehr the object in the group was found carried by this.
 
-    virtual bool HasObjectInGroup(std::string groupName) const { return const_cast<MovableObject *>(this)->IsInGroup(groupName); }
+    virtual bool HasObjectInGroup(std::string groupName) const { return HasGroup(groupName); }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1132,7 +1133,7 @@ ENTITYALLOCATION(MovableObject)
 // Arguments:       None.
 // Return value:    None.
 
-    virtual void NotResting() { m_RestTimer.Reset(); m_ToSettle = false; }
+    virtual void NotResting() { m_RestTimer.Reset(); m_ToSettle = false; WakeUp(); }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1146,6 +1147,65 @@ ENTITYALLOCATION(MovableObject)
     virtual bool IsAtRest();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  CanSleep
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether this MO has nothing going on that needs it to be
+//                  updated every frame while it lies still, ie no scripts, lifetime or
+//                  pending forces.
+// Arguments:       None.
+// Return value:    Whether this could be put to sleep if it stays still long enough.
+
+    virtual bool CanSleep() const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  SleepDetection
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Puts this MO to sleep if it has been able to sleep and hasn't moved for
+//                  long enough. A sleeping MO is not traveled or updated by MovableMan
+//                  until something disturbs it. IsAsleep() retrieves the answer.
+// Arguments:       How long, in ms sim time, this has to stay still to fall asleep.
+//                  0 means never.
+// Return value:    None.
+
+    virtual void SleepDetection(int sleepDelay);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  SleepDisturbed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether something has happened to this sleeping MO since it
+//                  fell asleep that means it needs to be woken up, like getting forces
+//                  applied or being moved by a script.
+// Arguments:       None.
+// Return value:    Whether this should be woken up.
+
+    virtual bool SleepDisturbed() const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsAsleep
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether this MO is currently asleep and being skipped by
+//                  the travel and update passes of MovableMan.
+// Arguments:       None.
+// Return value:    Whether this is asleep.
+
+    bool IsAsleep() const { return m_Asleep; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WakeUp
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Wakes this MO up if it is asleep, and restarts the time it has to stay
+//                  still to fall asleep again.
+// Arguments:       None.
+// Return value:    None.
+
+    void WakeUp() { m_Asleep = false; m_SleepPos = m_Pos; m_SleepTimer.Reset(); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          IsUpdated
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1470,6 +1530,69 @@ ENTITYALLOCATION(MovableObject)
     virtual int UpdateScript();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsScriptThreadSafe
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether this has a script whose Update may be run on one of the
+//                  LuaMan script lanes, alongside the scripts of other objects.
+// Arguments:       None.
+// Return value:    Whether this has a script and its preset is marked ScriptThreadSafe.
+
+    bool IsScriptThreadSafe() const { return m_ScriptThreadSafe && !m_ScriptPath.empty(); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetScriptPath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the path to the Lua script file that defines this' behaviors.
+// Arguments:       None.
+// Return value:    The path, empty if this has no script.
+
+    const std::string & GetScriptPath() const { return m_ScriptPath; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetScriptPresetName
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the name of the Lua table that holds the script functions of
+//                  this' preset.
+// Arguments:       None.
+// Return value:    The table name, empty if this has no script.
+
+    const std::string & GetScriptPresetName() const { return m_ScriptPresetName; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetScriptLane
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets which LuaMan script lane holds the Lua representation of this.
+// Arguments:       None.
+// Return value:    The index of the lane, or -1 if none does yet.
+
+    int GetScriptLane() const { return m_ScriptLane; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetScriptLane
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets which LuaMan script lane holds the Lua representation of this.
+// Arguments:       The index of the lane, or -1 for none.
+// Return value:    None.
+
+    void SetScriptLane(int lane) { m_ScriptLane = lane; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetScriptRandom
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the random stream the script of this draws from while it runs on
+//                  a LuaMan script lane. Seeded by LuaMan when this is given a lane.
+// Arguments:       None.
+// Return value:    The stream.
+
+    RandomStream & GetScriptRandom() { return m_ScriptRandom; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  OnPieMenu
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1539,11 +1662,14 @@ ENTITYALLOCATION(MovableObject)
 //////////////////////////////////////////////////////////////////////////////////////////
 // Static method:  GetNextID
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Returns the next unique id for MO's and increments unique ID counter
+// Description:     Returns the next unique id for MO's and increments unique ID counter.
+//                  When called from a LuaMan script lane, it is a stand-in from the
+//                  lane's own range instead, which LuaMan swaps for a real id after the
+//                  batch.
 // Arguments:       None.
 // Return value:    Returns the next unique id.
 
-	static unsigned long int GetNextUniqueID() { return ++m_UniqueIDCounter; }
+	static unsigned long int GetNextUniqueID();
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Static method:  GetUniqueID
@@ -1702,6 +1828,26 @@ ENTITYALLOCATION(MovableObject)
 	virtual void SetProvidesPieMenuContext(bool value) { m_ProvidesPieMenuContext = value; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPieMenuActor
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the actor whose pie menu this provides context for, if any.
+// Arguments:       None.
+// Return value:    The actor, or 0 if none. Ownership is NOT transferred!
+
+	Actor * GetPieMenuActor() const { return m_pPieMenuActor; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetPieMenuActor
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the actor whose pie menu this provides context for.
+// Arguments:       The actor, or 0 for none. Ownership is NOT transferred!
+// Return value:    None.
+
+	void SetPieMenuActor(Actor *pActor) { m_pPieMenuActor = pActor; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Protected member variable and method declarations
 
@@ -1755,7 +1901,8 @@ protected:
     // Member variables
     static Entity::ClassInfo m_sClass;
 	// Global counter with unique ID's
-	static unsigned long int m_UniqueIDCounter;
+	// Atomic since the scripts on LuaMan's lanes create objects from several threads at once
+	static std::atomic<unsigned long int> m_UniqueIDCounter;
     // The type of MO this is, either Actor, Item, or Particle
     int m_MOType;
     float m_Mass; // In metric kilograms (kg).
@@ -1781,6 +1928,12 @@ protected:
     std::deque<std::pair<Vector, Vector> > m_ImpulseForces; // First in kg * m/s, second vector in meters.
     Timer m_AgeTimer;
     Timer m_RestTimer;
+    // Whether this is asleep and skipped by the travel and update passes until disturbed
+    bool m_Asleep;
+    // Where this was when it last started staying still, or fell asleep
+    Vector m_SleepPos;
+    // How long this has stayed still
+    Timer m_SleepTimer;
 
     unsigned long m_Lifetime;
     // The sharpness factor that gets added to single pixel hit impulses in
@@ -1840,6 +1993,12 @@ protected:
     std::string m_ScriptPresetName;
     // The ID name unique to this' object instance representation in the Lua state.
     std::string m_ScriptObjectName;
+    // Whether the script Update of this' preset only changes this, and so may run on a LuaMan script lane
+    bool m_ScriptThreadSafe;
+    // The LuaMan script lane that holds this' Lua representation, -1 if none
+    int m_ScriptLane;
+    // What the script of this draws from while it runs on a script lane
+    RandomStream m_ScriptRandom;
 
     // Special post processing flash effect file and Bitmap. Shuold be loaded from a 32bpp bitmap
     ContentFile m_ScreenEffectFile;
@@ -22,6 +22,8 @@
 #include "MOSprite.h"
 #include "Atom.h"
 
+#include <climits>
+
 using namespace std;
 
 struct RECT
@@ -528,19 +530,19 @@ int SLTerrain::SaveData(string pathBase)
         return -1;
 
     // Save the bitmap of the material bitmap
-    if (SceneLayer::SaveData(pathBase + " Mat.bmp") < 0)
+    if (SceneLayer::SaveData(pathBase + " Mat.lz4") < 0)
     {
         DDTAbort("Failed to write the material bitmap data saving an SLTerrain!");
         return -1;
     }
     // Then the foreground color layer
-    if (m_pFGColor->SaveData(pathBase + " FG.bmp") < 0)
+    if (m_pFGColor->SaveData(pathBase + " FG.lz4") < 0)
     {
         DDTAbort("Failed to write the FG color bitmap data saving an SLTerrain!");
         return -1;
     }
     // Then the background color layer
-    if (m_pBGColor->SaveData(pathBase + " BG.bmp") < 0)
+    if (m_pBGColor->SaveData(pathBase + " BG.lz4") < 0)
     {
         DDTAbort("Failed to write the BG color bitmap data saving an SLTerrain!");
         return -1;
@@ -940,8 +942,6 @@ deque<MOPixel *> SLTerrain::EraseSilhouette(BITMAP *pSprite,
 {
     SLICK_PROFILE(0xFF654842);
 
-// TODO: OPTIMIZE THIS, IT'S A TIME HOG. MAYBE JSUT STAMP THE OUTLINE AND SAMPLE SOME RANDOM PARTICLES?
-
     AAssert(pSprite, "Null BITMAP passed to SLTerrain::EraseSilhouette");
 
     deque<MOPixel *> MOPDeque;
@@ -953,8 +953,6 @@ deque<MOPixel *> SLTerrain::EraseSilhouette(BITMAP *pSprite,
 
     int halfWidth = pSprite->w / 2;
     int halfHeight = pSprite->h / 2;
-    double SinA = sin(rotation.GetRadAngle());
-    double CosA = cos(rotation.GetRadAngle());
     int maxWidth = (pSprite->w + abs(pivot.m_X - halfWidth)) * scale;
     int maxHeight = (pSprite->h + abs(pivot.m_Y - halfHeight)) * scale;
     int maxDiameter = sqrt((float)(maxWidth * maxWidth + maxHeight * maxHeight)) * 2;
@@ -978,91 +976,146 @@ deque<MOPixel *> SLTerrain::EraseSilhouette(BITMAP *pSprite,
     clear_bitmap(pTempBitmap);
     pivot_scaled_sprite(pTempBitmap, pSprite, pTempBitmap->w / 2, pTempBitmap->h / 2, pivot.m_X, pivot.m_Y,  ftofix(rotation.GetAllegroAngle()), ftofix(scale));
 
-    // Do the test of intersection between color pixels of the test bitmap and non-air pixels of the terrain
-    // Generate and collect MOPixels that represent the terrain overlap and clear the same pixels out of the terrain
-    int testX, testY, terrX, terrY;
-    MOPixel *pPixel = 0;
-	Material const * sceneMat = g_SceneMan.GetMaterialFromID(g_MaterialAir); 
-	Material const * spawnMat = g_SceneMan.GetMaterialFromID(g_MaterialAir);
+    // What will become debris, collected during the scan and created all at once after it
+    struct DebrisPixel
+    {
+        int m_X;
+        int m_Y;
+        unsigned char m_Color;
+        unsigned char m_Material;
+    };
+    vector<DebrisPixel> debris;
+    if (makeMOPs)
+        debris.reserve(min(maxMOPs, pTempBitmap->w * pTempBitmap->h / (skipMOP + 1) + 1));
+
+    BITMAP *pColorBitmap = m_pFGColor->GetBitmap();
+    const int terrWidth = m_pMainBitmap->w;
+    const int terrHeight = m_pMainBitmap->h;
     halfWidth = pTempBitmap->w / 2;
     halfHeight = pTempBitmap->h / 2;
-    unsigned char testPixel = 0, matPixel = 0, colorPixel = 0;
+    const int startX = pos.m_X - halfWidth;
+    const int startY = pos.m_Y - halfHeight;
+
+    // Bounding boxes of what actually got erased, in unwrapped terrain coordinates
+    int matMinX = INT_MAX, matMinY = INT_MAX, matMaxX = INT_MIN, matMaxY = INT_MIN;
+    int colorMinX = INT_MAX, colorMinY = INT_MAX, colorMaxX = INT_MIN, colorMaxY = INT_MIN;
 
-    for (testY = 0; testY < pTempBitmap->h; ++testY)
+    // Do the test of intersection between color pixels of the test bitmap and non-air pixels of the terrain,
+    // one row span at a time so the wrapping and row lookups are only done once per row
+    for (int testY = 0; testY < pTempBitmap->h; ++testY)
     {
-        for (testX = 0; testX < pTempBitmap->w; ++testX)
+        int terrY = startY + testY;
+        if (terrY < 0 || terrY >= terrHeight)
         {
-            terrX = pos.m_X - halfWidth + testX;
-            terrY = pos.m_Y - halfHeight + testY;
-
-            // Make sure we're checking within bounds
-            if (terrX < 0) {
-                if (m_WrapX)
-                    while (terrX < 0)
-                        terrX += m_pMainBitmap->w;
-                else
-                    continue;
-            }
-            if (terrY < 0) {
-                if (m_WrapY)
-                    while (terrY < 0)
-                        terrY += m_pMainBitmap->h;
-                else
-                    continue;
-            }
-            if (terrX >= m_pMainBitmap->w) {
-                if (m_WrapX)
-                    terrX %= m_pMainBitmap->w;
-                else
-                    continue;
-            }
-            if (terrY >= m_pMainBitmap->h) {
-                if (m_WrapY)
-                    terrY %= m_pMainBitmap->h;
-                else
-                    continue;
-            }
+            if (!m_WrapY)
+                continue;
+            terrY %= terrHeight;
+            if (terrY < 0)
+                terrY += terrHeight;
+        }
+
+        const unsigned char *pTestRow = pTempBitmap->line[testY];
+        unsigned char *pMatRow = m_pMainBitmap->line[terrY];
+        unsigned char *pColorRow = pColorBitmap->line[terrY];
+
+        // Trim the span down to the part of the row the sprite actually covers
+        int spanStart = 0;
+        int spanEnd = pTempBitmap->w;
+        while (spanStart < spanEnd && pTestRow[spanStart] == g_KeyColor)
+            ++spanStart;
+        while (spanEnd > spanStart && pTestRow[spanEnd - 1] == g_KeyColor)
+            --spanEnd;
+        if (!m_WrapX)
+        {
+            spanStart = max(spanStart, -startX);
+            spanEnd = min(spanEnd, terrWidth - startX);
+        }
+        if (spanStart >= spanEnd)
+            continue;
+
+        int terrX = (startX + spanStart) % terrWidth;
+        if (terrX < 0)
+            terrX += terrWidth;
+
+        for (int testX = spanStart; testX < spanEnd; ++testX, ++terrX)
+        {
+            if (terrX >= terrWidth)
+                terrX -= terrWidth;
 
-            testPixel = getpixel(pTempBitmap, testX, testY);
-            matPixel = getpixel(m_pMainBitmap, terrX, terrY);
-            colorPixel = getpixel(m_pFGColor->GetBitmap(), terrX, terrY);
+            if (pTestRow[testX] == g_KeyColor)
+                continue;
 
-            if (testPixel != g_KeyColor)
+            unsigned char matPixel = pMatRow[terrX];
+            unsigned char colorPixel = pColorRow[terrX];
+
+            // Only add debris if we're not due to skip any
+            if (makeMOPs && matPixel != g_MaterialAir && colorPixel != g_KeyColor && ++skipCount > skipMOP && debris.size() < maxMOPs)
             {
-                // Only add PixelMO if we're not due to skip any
-                if (makeMOPs && matPixel != g_MaterialAir && colorPixel != g_KeyColor && ++skipCount > skipMOP && MOPDeque.size() < maxMOPs)
-                {
-                    skipCount = 0;
-                    sceneMat = g_SceneMan.GetMaterialFromID(matPixel);
-                    spawnMat = sceneMat->spawnMaterial ? g_SceneMan.GetMaterialFromID(sceneMat->spawnMaterial) : sceneMat;
-                    // Create the MOPixel based off the Terrain data.
-                    pPixel = new MOPixel(colorPixel,
-                                         spawnMat->pixelDensity,
-                                         Vector(terrX, terrY),
-                                         Vector(),
-                                         new Atom(Vector(), spawnMat->id, 0, colorPixel, 2),
-                                         0);
-
-                    pPixel->SetToHitMOs(false);
-                    MOPDeque.push_back(pPixel);
-                    pPixel = 0;
-                }
+                skipCount = 0;
+                DebrisPixel newDebris = { terrX, terrY, colorPixel, matPixel };
+                debris.push_back(newDebris);
+            }
 
-                // Clear the terrain pixels
-                if (matPixel != g_MaterialAir)
-                    putpixel(m_pMainBitmap, terrX, terrY, g_MaterialAir);
-				if (colorPixel != g_KeyColor)
-				{
-					putpixel(m_pFGColor->GetBitmap(), terrX, terrY, g_KeyColor);
-					g_SceneMan.RegisterTerrainChange(terrX, terrY, 1, 1, g_KeyColor, false);
-				}
+            // Clear the terrain pixels
+            if (matPixel != g_MaterialAir)
+            {
+                pMatRow[terrX] = g_MaterialAir;
+                matMinX = min(matMinX, startX + testX);
+                matMaxX = max(matMaxX, startX + testX);
+                matMinY = min(matMinY, startY + testY);
+                matMaxY = max(matMaxY, startY + testY);
             }
-        }    
+            if (colorPixel != g_KeyColor)
+            {
+                pColorRow[terrX] = g_KeyColor;
+                colorMinX = min(colorMinX, startX + testX);
+                colorMaxX = max(colorMaxX, startX + testX);
+                colorMinY = min(colorMinY, startY + testY);
+                colorMaxY = max(colorMaxY, startY + testY);
+            }
+        }
+    }
+
+    // Let the clients know about the erased area all at once; the seam crossing is split up by the registration
+    if (colorMinX <= colorMaxX)
+    {
+        int boxWidth = colorMaxX - colorMinX + 1;
+        int boxHeight = colorMaxY - colorMinY + 1;
+        g_SceneMan.RegisterTerrainChange(colorMinX, colorMinY, boxWidth, boxHeight, g_KeyColor, false);
+        // The registration crops vertically, so hand it the part that wrapped around separately
+        if (m_WrapY && colorMinY < 0)
+            g_SceneMan.RegisterTerrainChange(colorMinX, colorMinY + terrHeight, boxWidth, boxHeight, g_KeyColor, false);
+        else if (m_WrapY && colorMaxY >= terrHeight)
+            g_SceneMan.RegisterTerrainChange(colorMinX, colorMinY - terrHeight, boxWidth, boxHeight, g_KeyColor, false);
     }
 
     // Add a box to the updated areas list to show there's been change to the materials layer
-// TODO: improve fit/tightness of box here
-    m_UpdatedMateralAreas.push_back(Box(pos - pivot, maxWidth, maxHeight));
+    if (matMinX <= matMaxX)
+        m_UpdatedMateralAreas.push_back(Box(Vector(matMinX, matMinY), matMaxX - matMinX + 1, matMaxY - matMinY + 1));
+
+    // Now create all the debris in one go, based off the terrain data
+    const Material *pSceneMat = 0;
+    const Material *pSpawnMat = 0;
+    unsigned char lastMaterial = g_MaterialAir;
+    MOPixel *pPixel = 0;
+    for (vector<DebrisPixel>::iterator dItr = debris.begin(); dItr != debris.end(); ++dItr)
+    {
+        // Runs of the same material are common, so only look it up when it changes
+        if (!pSpawnMat || dItr->m_Material != lastMaterial)
+        {
+            lastMaterial = dItr->m_Material;
+            pSceneMat = g_SceneMan.GetMaterialFromID(lastMaterial);
+            pSpawnMat = pSceneMat->spawnMaterial ? g_SceneMan.GetMaterialFromID(pSceneMat->spawnMaterial) : pSceneMat;
+        }
+        pPixel = new MOPixel(dItr->m_Color,
+                             pSpawnMat->pixelDensity,
+                             Vector(dItr->m_X, dItr->m_Y),
+                             Vector(),
+                             new Atom(Vector(), pSpawnMat->id, 0, dItr->m_Color, 2),
+                             0);
+        pPixel->SetToHitMOs(false);
+        MOPDeque.push_back(pPixel);
+    }
 
     return MOPDeque;
 
@@ -33,6 +33,9 @@
 #include "Arm.h"
 #include "HeldDevice.h"
 
+#include <chrono>
+#include <future>
+
 using namespace std;
 
 namespace RTE
@@ -444,6 +447,9 @@ void Scene::Clear()
     {
         m_UnseenPixelSize[team].Reset();
         m_apUnseenLayer[team] = 0;
+        m_apUnseenMask[team] = 0;
+        m_UnseenDirtyCells[team].clear();
+        m_UnseenDirty[team] = false;
         m_SeenPixels[team].clear();
         m_CleanedPixels[team].clear();
         m_ScanScheduled[team] = false;
@@ -535,6 +541,16 @@ int Scene::Create(const Scene &reference)
         else
             m_UnseenPixelSize[team] = reference.m_UnseenPixelSize[team];
 
+        // Copy the unseen mask along with any changes it has that haven't made it onto the cloned bitmap yet
+        if (reference.m_apUnseenMask[team])
+        {
+            const bitmask_t *pRefMask = reference.m_apUnseenMask[team];
+            m_apUnseenMask[team] = bitmask_create(pRefMask->w, pRefMask->h);
+            memcpy(m_apUnseenMask[team]->bits, pRefMask->bits, pRefMask->h * ((pRefMask->w - 1) / BITW_LEN + 1) * sizeof(BITW));
+            m_UnseenDirtyCells[team] = reference.m_UnseenDirtyCells[team];
+            m_UnseenDirty[team] = reference.m_UnseenDirty[team];
+        }
+
         // Always copy the scan scheduling flags
         m_ScanScheduled[team] = reference.m_ScanScheduled[team];
     }
@@ -570,12 +586,14 @@ int Scene::Create(const Scene &reference)
 // Description:     Actually loads previously specified/created data into memory. Has
 //                  to be done before using this SceneLayer.
 
-int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
+int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits, void (*fpProgressCallback)(std::string, bool))
 {
     DAssert(m_pTerrain, "Terrain not instantiated before trying to load its data!");
 
     ///////////////////////////////////
     // Load Terrain's data
+    if (fpProgressCallback)
+        fpProgressCallback("Loading terrain of " + GetPresetName(), true);
     if (m_pTerrain->LoadData() < 0)
     {
         DDTAbort("Loading Terrain " + m_pTerrain->GetPresetName() + "\'s data failed!");
@@ -609,6 +627,9 @@ int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
                 return -1;
             }
         }
+
+        // All unseen queries go through the packed mask, so make it match what was just loaded
+        RebuildUnseenMask(team);
     }
 
 	m_SelectedAssemblies.clear();
@@ -619,6 +640,9 @@ int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
     // But don't if we are only loading the scene bitmap layer data
     if (placeObjects)
     {
+        if (fpProgressCallback)
+            fpProgressCallback("Placing objects", true);
+
 		Actor * pBrains[Activity::MAXTEAMCOUNT];
 		for (int i=0; i < Activity::MAXTEAMCOUNT; i++)
 			pBrains[i] = 0;
@@ -830,7 +854,7 @@ int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
                         {
                             // Learn which team placed this thing so we can reveal for them only
                             int ownerTeam = pTO->GetTeam();
-                            if (ownerTeam != Activity::NOTEAM && m_apUnseenLayer[ownerTeam] && m_apUnseenLayer[ownerTeam]->GetBitmap())
+                            if (ownerTeam != Activity::NOTEAM && m_apUnseenLayer[ownerTeam] && m_apUnseenMask[ownerTeam])
                             {
                                 // Translate to the scaled unseen layer's coordinates
                                 Vector scale = m_apUnseenLayer[ownerTeam]->GetScaleInverse();
@@ -838,18 +862,18 @@ int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
                                 int scaledY = floorf((pTO->GetPos().m_Y - (float)(pTO->GetFGColorBitmap()->h / 2)) * scale.m_Y);
                                 int scaledW = ceilf(pTO->GetFGColorBitmap()->w * scale.m_X);
                                 int scaledH = ceilf(pTO->GetFGColorBitmap()->h * scale.m_Y);
-                                // Fill the box with key color for the owner ownerTeam, revealing the area that this thing is on
-                                rectfill(m_apUnseenLayer[ownerTeam]->GetBitmap(), scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, g_KeyColor);
+                                // Reveal the box for the owner ownerTeam, the area that this thing is on
+                                SetUnseenBox(ownerTeam, scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, false);
                                 // Expand the box a little so the whole placed object is going to be hidden
                                 scaledX -= 1;
                                 scaledY -= 1;
                                 scaledW += 2;
                                 scaledH += 2;
-                                // Fill the box with BLACK for all the other teams so they can't see the new developments here!
+                                // Hide the box for all the other teams so they can't see the new developments here!
                                 for (int t = Activity::TEAM_1; t < Activity::MAXTEAMCOUNT; ++t)
                                 {
-                                    if (t != ownerTeam && m_apUnseenLayer[t] && m_apUnseenLayer[t]->GetBitmap())
-                                        rectfill(m_apUnseenLayer[t]->GetBitmap(), scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, g_BlackColor);
+                                    if (t != ownerTeam && m_apUnseenLayer[t] && m_apUnseenMask[t])
+                                        SetUnseenBox(t, scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, true);
                                 }
                             }
                         }
@@ -887,6 +911,8 @@ int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
 
 // TODO: CLEAN AIR IN AN AFTER EACH OBJECT PLACED, becuase the items refuse to be placed in a hollowness otherwise?
         // Clear the air out of objects placed
+        if (fpProgressCallback)
+            fpProgressCallback("Cleaning air", true);
         m_pTerrain->CleanAir();
     }
 
@@ -902,21 +928,48 @@ int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
     // Pathfinding init
     if (initPathfinding)
     {
-        // Create the pathfinding stuff based on the current scene
-        m_pPathFinder = new PathFinder(this, 20, 2000);
-        // Update all the pathfinding data
-        m_pPathFinder->RecalculateAllCosts();
+        if (fpProgressCallback)
+            fpProgressCallback("Building pathfinding data", true);
+
+        // Create the pathfinding stuff based on the current scene. The node costs come straight from the cache if the terrain is the same as
+        // last time, otherwise they're calculated in the background while the background layers load. That only reads the terrain, which is
+        // done changing by now. The cache files are read and written here on this thread, so they're never touched while other files are
+        m_pPathFinder = new PathFinder(this, 20, 2000, false);
+        future<void> costsCalculated;
+        if (!m_pPathFinder->LoadCachedCosts())
+            costsCalculated = async(launch::async, &PathFinder::RecalculateAllCosts, m_pPathFinder);
 
         // Load Background layers' data
+        bool layersLoaded = true;
         for (list<SceneLayer *>::iterator slItr = m_BackLayerList.begin(); slItr != m_BackLayerList.end(); ++slItr)
         {
             DAssert((*slItr), "Background layer not instantiated before trying to load its data!");
+            if (fpProgressCallback)
+                fpProgressCallback("Loading background layer " + (*slItr)->GetPresetName(), false);
+            // These are only ever drawn, so they can be held compressed and decoded piecemeal as they come into view
+            (*slItr)->SetStreamed(g_SettingsMan.StreamBackgroundLayers());
             if ((*slItr)->LoadData() < 0)
             {
                 g_ConsoleMan.PrintString("ERROR: Loading background layer " + (*slItr)->GetPresetName() + "\'s data failed!");
-                return -1;
+                layersLoaded = false;
+                break;
+            }
+        }
+
+        // Keep reporting while waiting on the pathfinding so whoever is listening doesn't stall
+        if (costsCalculated.valid())
+        {
+            while (costsCalculated.wait_for(chrono::milliseconds(50)) != future_status::ready)
+            {
+                if (fpProgressCallback)
+                    fpProgressCallback("Building pathfinding data", false);
             }
+            costsCalculated.get();
+            m_pPathFinder->SaveCachedCosts();
         }
+
+        if (!layersLoaded)
+            return -1;
     }
 
     return 0;
@@ -1026,7 +1079,8 @@ int Scene::SaveData(string pathBase)
 
     // Don't bother saving background layers to disk, as they are never altered
 
-    // Save unseen layers' data
+    // Save unseen layers' data, making sure they're up to date with their masks first
+    UpdateUnseenLayers();
     char str[64];
     for (int team = Activity::TEAM_1; team < Activity::MAXTEAMCOUNT; ++team)
     {
@@ -1034,7 +1088,7 @@ int Scene::SaveData(string pathBase)
         {
             sprintf(str, "T%d", team);
             // Save unseen layer data to disk
-            if (m_apUnseenLayer[team]->SaveData(pathBase + " US" + str + ".bmp") < 0)
+            if (m_apUnseenLayer[team]->SaveData(pathBase + " US" + str + ".lz4") < 0)
             {
                 g_ConsoleMan.PrintString("ERROR: Saving unseen layer " + m_apUnseenLayer[team]->GetPresetName() + "\'s data failed!");
                 return -1;
@@ -1251,6 +1305,12 @@ int Scene::ClearData()
                 return -1;
             }
         }
+
+        // The mask is rebuilt from the layer when the data is loaded again
+        if (m_apUnseenMask[team])
+            bitmask_free(m_apUnseenMask[team]);
+        m_apUnseenMask[team] = 0;
+        m_UnseenDirty[team] = false;
     }
 
     return 0;
@@ -1751,6 +1811,12 @@ void Scene::Destroy(bool notInherited)
     delete m_apUnseenLayer[Activity::TEAM_3];
     delete m_apUnseenLayer[Activity::TEAM_4];
 
+    for (int team = Activity::TEAM_1; team < Activity::MAXTEAMCOUNT; ++team)
+    {
+        if (m_apUnseenMask[team])
+            bitmask_free(m_apUnseenMask[team]);
+    }
+
 	//if (m_PreviewBitmapOwned)
 	destroy_bitmap(m_pPreviewBitmap);
 	m_pPreviewBitmap = 0;
@@ -1803,6 +1869,7 @@ void Scene::FillUnseenLayer(Vector pixelSize, int team, bool createNow)
         m_apUnseenLayer[team]->Create(pUnseenBitmap, true, Vector(), WrapsX(), WrapsY(), Vector(1.0, 1.0));
         // Calculate how many times smaller the unseen map is compared to the entire terrain's dimensions, and set it as the scale factor on the Unseen layer
         m_apUnseenLayer[team]->SetScaleFactor(Vector((float)GetTerrain()->GetBitmap()->w / (float)m_apUnseenLayer[team]->GetBitmap()->w, (float)GetTerrain()->GetBitmap()->h / (float)m_apUnseenLayer[team]->GetBitmap()->h));
+        RebuildUnseenMask(team);
     }
 }
 
@@ -1822,6 +1889,7 @@ void Scene::SetUnseenLayer(SceneLayer *pNewLayer, int team)
     m_apUnseenLayer[team] = pNewLayer;
     // Calculate how many times smaller the unseen map is compared to the entire terrain's dimensions, and set it as the scale factor on the Unseen layer
     m_apUnseenLayer[team]->SetScaleFactor(Vector((float)GetTerrain()->GetBitmap()->w / (float)m_apUnseenLayer[team]->GetBitmap()->w, (float)GetTerrain()->GetBitmap()->h / (float)m_apUnseenLayer[team]->GetBitmap()->h));
+    RebuildUnseenMask(team);
 }
 
 
@@ -1874,14 +1942,14 @@ void Scene::ClearSeenPixels(int team)
 
 bool Scene::CleanOrphanPixel(int posX, int posY, NeighborDirection checkingFrom, int team)
 {
-    if (team == Activity::NOTEAM || !m_apUnseenLayer[team])
+    if (team == Activity::NOTEAM || !m_apUnseenLayer[team] || !m_apUnseenMask[team])
         return false;
 
     // Do any necessary wrapping
     m_apUnseenLayer[team]->WrapPosition(posX, posY, false);
 
     // First check the actual position of the checked pixel, it may already been seen.
-    if (getpixel(m_apUnseenLayer[team]->GetBitmap(), posX, posY) == g_KeyColor)
+    if (!IsUnseenPixel(team, posX, posY))
         return false;
 
     // Ok, not seen, so check surrounding pixels for 'support', ie unseen ones that will keep this also unseen
@@ -1892,61 +1960,62 @@ bool Scene::CleanOrphanPixel(int posX, int posY, NeighborDirection checkingFrom,
         testPosX = posX + 1;
         testPosY = posY;
         m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_KeyColor ? 1 : 0;
+        support += IsUnseenPixel(team, testPosX, testPosY) ? 1 : 0;
     }
     if (checkingFrom != W)
     {
         testPosX = posX - 1;
         testPosY = posY;
         m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_KeyColor ? 1 : 0;
+        support += IsUnseenPixel(team, testPosX, testPosY) ? 1 : 0;
     }
     if (checkingFrom != S)
     {
         testPosX = posX;
         testPosY = posY + 1;
         m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_KeyColor ? 1 : 0;
+        support += IsUnseenPixel(team, testPosX, testPosY) ? 1 : 0;
     }
     if (checkingFrom != N)
     {
         testPosX = posX;
         testPosY = posY - 1;
         m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_KeyColor ? 1 : 0;
+        support += IsUnseenPixel(team, testPosX, testPosY) ? 1 : 0;
     }
     if (checkingFrom != SE)
     {
         testPosX = posX + 1;
         testPosY = posY + 1;
         m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_KeyColor ? 0.5f : 0;
+        support += IsUnseenPixel(team, testPosX, testPosY) ? 0.5f : 0;
     }
     if (checkingFrom != SW)
     {
         testPosX = posX - 1;
         testPosY = posY + 1;
         m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_KeyColor ? 0.5f : 0;
+        support += IsUnseenPixel(team, testPosX, testPosY) ? 0.5f : 0;
     }
     if (checkingFrom != NW)
     {
         testPosX = posX - 1;
         testPosY = posY - 1;
         m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_KeyColor ? 0.5f : 0;
+        support += IsUnseenPixel(team, testPosX, testPosY) ? 0.5f : 0;
     }
     if (checkingFrom != NE)
     {
         testPosX = posX + 1;
         testPosY = posY - 1;
         m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_KeyColor ? 0.5f : 0;
+        support += IsUnseenPixel(team, testPosX, testPosY) ? 0.5f : 0;
     }
 
     // Orphaned enough to remove?
     if (support <= 2.5)
     {
+        bitmask_clearbit(m_apUnseenMask[team], posX, posY);
         putpixel(m_apUnseenLayer[team]->GetBitmap(), posX, posY, g_KeyColor);
         m_CleanedPixels[team].push_back(Vector(posX, posY));
         return true;
@@ -1956,6 +2025,183 @@ bool Scene::CleanOrphanPixel(int posX, int posY, NeighborDirection checkingFrom,
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetUnseenPixel
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Marks a single pixel of a team's unseen layer as seen or unseen.
+
+bool Scene::SetUnseenPixel(int team, int posX, int posY, bool unseen)
+{
+    bitmask_t *pMask = m_apUnseenMask[team];
+    if (!pMask || posX < 0 || posX >= pMask->w || posY < 0 || posY >= pMask->h)
+        return false;
+
+    if ((bitmask_getbit(pMask, posX, posY) != 0) == unseen)
+        return false;
+
+    if (unseen)
+        bitmask_setbit(pMask, posX, posY);
+    else
+        bitmask_clearbit(pMask, posX, posY);
+
+    MarkUnseenDirty(team, posX, posY, posX, posY);
+
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetUnseenBox
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Marks a box of a team's unseen layer as seen or unseen, a whole mask
+//                  word at a time.
+
+void Scene::SetUnseenBox(int team, int x1, int y1, int x2, int y2, bool unseen)
+{
+    bitmask_t *pMask = m_apUnseenMask[team];
+    if (!pMask)
+        return;
+
+    if (x1 > x2)
+        swap(x1, x2);
+    if (y1 > y2)
+        swap(y1, y2);
+
+    // Clip to the mask, the same way rectfill would
+    x1 = max(x1, 0);
+    y1 = max(y1, 0);
+    x2 = min(x2, pMask->w - 1);
+    y2 = min(y2, pMask->h - 1);
+    if (x1 > x2 || y1 > y2)
+        return;
+
+    // The mask is stored as columns of BITW_LEN pixel wide words, so go column by column and
+    // apply the part of the word that is inside the box to every row with one operation
+    for (int wordX = x1 / BITW_LEN; wordX <= x2 / BITW_LEN; ++wordX)
+    {
+        int firstBit = wordX == x1 / BITW_LEN ? x1 & BITW_MASK : 0;
+        int lastBit = wordX == x2 / BITW_LEN ? x2 & BITW_MASK : BITW_LEN - 1;
+        BITW wordMask = (~(BITW)0 >> (BITW_LEN - 1 - lastBit + firstBit)) << firstBit;
+
+        BITW *pWord = pMask->bits + wordX * pMask->h + y1;
+        for (int y = y1; y <= y2; ++y, ++pWord)
+        {
+            if (unseen)
+                *pWord |= wordMask;
+            else
+                *pWord &= ~wordMask;
+        }
+    }
+
+    MarkUnseenDirty(team, x1, y1, x2, y2);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MarkUnseenDirty
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Marks the cells of a team's unseen mask under a box as changed.
+
+void Scene::MarkUnseenDirty(int team, int x1, int y1, int x2, int y2)
+{
+    const bitmask_t *pMask = m_apUnseenMask[team];
+    int cellCols = (pMask->w + UNSEENDIRTYCELLSIZE - 1) / UNSEENDIRTYCELLSIZE;
+    int cellRows = (pMask->h + UNSEENDIRTYCELLSIZE - 1) / UNSEENDIRTYCELLSIZE;
+    vector<bool> &cells = m_UnseenDirtyCells[team];
+    if ((int)cells.size() != cellCols * cellRows)
+        cells.assign(cellCols * cellRows, false);
+
+    for (int cellY = y1 / UNSEENDIRTYCELLSIZE; cellY <= y2 / UNSEENDIRTYCELLSIZE; ++cellY)
+    {
+        for (int cellX = x1 / UNSEENDIRTYCELLSIZE; cellX <= x2 / UNSEENDIRTYCELLSIZE; ++cellX)
+            cells[cellY * cellCols + cellX] = true;
+    }
+    m_UnseenDirty[team] = true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateUnseenLayers
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Copies the changed regions of the unseen masks onto the unseen layers'
+//                  bitmaps, so they can be drawn or saved.
+
+void Scene::UpdateUnseenLayers()
+{
+    for (int team = Activity::TEAM_1; team < Activity::MAXTEAMCOUNT; ++team)
+    {
+        if (!m_UnseenDirty[team] || !m_apUnseenMask[team] || !m_apUnseenLayer[team] || !m_apUnseenLayer[team]->GetBitmap())
+            continue;
+
+        const bitmask_t *pMask = m_apUnseenMask[team];
+        BITMAP *pBitmap = m_apUnseenLayer[team]->GetBitmap();
+        vector<bool> &cells = m_UnseenDirtyCells[team];
+        int cellCols = (pMask->w + UNSEENDIRTYCELLSIZE - 1) / UNSEENDIRTYCELLSIZE;
+        int pixel;
+        // Only go over the cells that changed, so reveals far apart on a big map don't drag everything in between along
+        for (int cell = 0; cell < (int)cells.size(); ++cell)
+        {
+            if (!cells[cell])
+                continue;
+            cells[cell] = false;
+
+            int left = (cell % cellCols) * UNSEENDIRTYCELLSIZE;
+            int top = (cell / cellCols) * UNSEENDIRTYCELLSIZE;
+            int right = min(left + UNSEENDIRTYCELLSIZE, pMask->w);
+            int bottom = min(top + UNSEENDIRTYCELLSIZE, pMask->h);
+            for (int y = top; y < bottom; ++y)
+            {
+                for (int x = left; x < right; ++x)
+                {
+                    // Only touch pixels that disagree with the mask, so custom unseen colors and reveal flashes are left alone
+                    pixel = getpixel(pBitmap, x, y);
+                    if (bitmask_getbit(pMask, x, y))
+                    {
+                        if (pixel == g_KeyColor)
+                            putpixel(pBitmap, x, y, g_BlackColor);
+                    }
+                    else if (pixel != g_KeyColor)
+                        putpixel(pBitmap, x, y, g_KeyColor);
+                }
+            }
+        }
+
+        m_UnseenDirty[team] = false;
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RebuildUnseenMask
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Recreates a team's unseen mask from the current contents of its unseen
+//                  layer's bitmap.
+
+void Scene::RebuildUnseenMask(int team)
+{
+    if (m_apUnseenMask[team])
+        bitmask_free(m_apUnseenMask[team]);
+    m_apUnseenMask[team] = 0;
+    m_UnseenDirty[team] = false;
+    // The cells were laid out for the old mask, which may have been a different size
+    m_UnseenDirtyCells[team].clear();
+
+    if (!m_apUnseenLayer[team] || !m_apUnseenLayer[team]->GetBitmap())
+        return;
+
+    BITMAP *pBitmap = m_apUnseenLayer[team]->GetBitmap();
+    m_apUnseenMask[team] = bitmask_create(pBitmap->w, pBitmap->h);
+    for (int y = 0; y < pBitmap->h; ++y)
+    {
+        for (int x = 0; x < pBitmap->w; ++x)
+        {
+            if (getpixel(pBitmap, x, y) != g_KeyColor)
+                bitmask_setbit(m_apUnseenMask[team], x, y);
+        }
+    }
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetDimensions
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -3113,6 +3359,9 @@ void Scene::Update()
 
     m_PathfindingUpdated = false;
 
+    // Bring the unseen layers' bitmaps up to date with whatever was revealed or hidden since last time
+    UpdateUnseenLayers();
+
 	if (g_SettingsMan.BlipOnRevealUnseen())
 	{
 		// Highlight the pixels that have been revealed on the unseen maps
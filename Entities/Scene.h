@@ -25,6 +25,7 @@
 #include "ActivityMan.h"
 #include "Box.h"
 #include "BunkerAssembly.h"
+#include "BitMask/bitmask.h"
 //#include "MovableMan.h"
 
 namespace RTE
@@ -404,10 +405,14 @@ ENTITYALLOCATION(Scene)
 //                  Whether to do pathfinding init, which should be avoided if we are only
 //                  loading and saving purposes of MetaMan, for example.
 //					Whether to place actors and deployments (doors not affected).
+//                  A function pointer to a function that will be called and sent a string
+//                  with information about the stage the loading is at. It also gets called
+//                  repeatedly while the main thread waits on the background stages, so it
+//                  can keep the UI and any network connections serviced.
 // Return value:    An error return value signaling sucess or any particular failure.
 //                  Anything below 0 is an error signal.
 
-    virtual int LoadData(bool placeObjects = true, bool initPathfinding = true, bool placeUnits = true);
+    virtual int LoadData(bool placeObjects = true, bool initPathfinding = true, bool placeUnits = true, void (*fpProgressCallback)(std::string, bool) = 0);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -752,6 +757,76 @@ ENTITYALLOCATION(Scene)
     SceneLayer * GetUnseenLayer(int team = Activity::TEAM_1) const { return team != Activity::NOTEAM ? m_apUnseenLayer[team] : 0; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetUnseenMask
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the bit-packed copy of a team's unseen layer, one bit per unseen
+//                  layer pixel. A set bit means the pixel is still unseen.
+// Arguments:       Which team to get the unseen mask for.
+// Return value:    A pointer to the mask, or 0 if the team has no unseen layer.
+//                  Ownership is NOT transferred!
+
+    const bitmask_t * GetUnseenMask(int team = Activity::TEAM_1) const { return team != Activity::NOTEAM ? m_apUnseenMask[team] : 0; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsUnseenPixel
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Checks whether a pixel of a team's unseen layer is still unseen.
+// Arguments:       Which team's unseen layer to check.
+//                  The coordinates of the pixel, in the unseen layer's scale.
+// Return value:    Whether the pixel is unseen. Pixels off the layer count as unseen,
+//                  and nothing is unseen for a team without an unseen layer.
+
+    bool IsUnseenPixel(int team, int posX, int posY) const
+    {
+        const bitmask_t *pMask = team != Activity::NOTEAM ? m_apUnseenMask[team] : 0;
+        if (!pMask)
+            return false;
+        if (posX < 0 || posX >= pMask->w || posY < 0 || posY >= pMask->h)
+            return true;
+        return bitmask_getbit(pMask, posX, posY) != 0;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetUnseenPixel
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Marks a single pixel of a team's unseen layer as seen or unseen. The
+//                  unseen layer's bitmap is updated the next time UpdateUnseenLayers is
+//                  called.
+// Arguments:       Which team's unseen layer to change.
+//                  The coordinates of the pixel, in the unseen layer's scale.
+//                  Whether the pixel should be unseen or seen.
+// Return value:    Whether the pixel was on the layer and actually changed state.
+
+    bool SetUnseenPixel(int team, int posX, int posY, bool unseen);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetUnseenBox
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Marks a box of a team's unseen layer as seen or unseen, a whole mask
+//                  word at a time. The corners are inclusive, like rectfill.
+// Arguments:       Which team's unseen layer to change.
+//                  The corners of the box, in the unseen layer's scale.
+//                  Whether the box should be unseen or seen.
+// Return value:    None.
+
+    void SetUnseenBox(int team, int x1, int y1, int x2, int y2, bool unseen);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateUnseenLayers
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Copies the changed regions of the unseen masks onto the unseen layers'
+//                  bitmaps, so they can be drawn or saved.
+// Arguments:       None.
+// Return value:    None.
+
+    void UpdateUnseenLayers();
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetSeenPixels
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1454,6 +1529,14 @@ protected:
     Vector m_UnseenPixelSize[Activity::MAXTEAMCOUNT];
     // Layers representing the unknown areas for each team
     SceneLayer *m_apUnseenLayer[Activity::MAXTEAMCOUNT];
+    // Bit-packed copies of the unseen layers, which all the unseen queries and changes go through - OWNED HERE
+    bitmask_t *m_apUnseenMask[Activity::MAXTEAMCOUNT];
+    // The size of the square cells the unseen masks are divided into to keep track of what has changed
+    enum { UNSEENDIRTYCELLSIZE = 32 };
+    // Which cells of each unseen mask have changed since they were last copied onto its layer's bitmap, row by row
+    std::vector<bool> m_UnseenDirtyCells[Activity::MAXTEAMCOUNT];
+    // Whether each unseen mask has any changes not yet copied onto its layer's bitmap
+    bool m_UnseenDirty[Activity::MAXTEAMCOUNT];
     // Which pixels of the unseen map have just been revealed this frame, in the coordinates of the unseen map
     std::list<Vector> m_SeenPixels[Activity::MAXTEAMCOUNT];
     // Pixels on the unseen map deemed to be orphans and cleaned up, will be moved to seen pixels next update
@@ -1500,6 +1583,29 @@ private:
     void Clear();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RebuildUnseenMask
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Recreates a team's unseen mask from the current contents of its unseen
+//                  layer's bitmap. Any non-key color pixel counts as unseen.
+// Arguments:       Which team's unseen mask to rebuild.
+// Return value:    None.
+
+    void RebuildUnseenMask(int team);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MarkUnseenDirty
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Marks the cells of a team's unseen mask under a box as changed, so
+//                  only they get copied onto the layer's bitmap by UpdateUnseenLayers.
+// Arguments:       Which team's unseen mask changed.
+//                  The corners of the box, inclusive and already clipped to the mask.
+// Return value:    None.
+
+    void MarkUnseenDirty(int team, int x1, int y1, int x2, int y2);
+
+
     // Disallow the use of some implicit methods.
     Scene(const Scene &reference) { DDTAbort("Tried to use forbidden method"); }
     void operator=(const Scene &rhs) { DDTAbort("Tried to use forbidden method"); }
@@ -13,6 +13,10 @@
 
 #include "SceneLayer.h"
 #include "ContentFile.h"
+#include "ConsoleMan.h"
+#include "lz4.h"
+
+#include <fstream>
 
 using namespace std;
 
@@ -33,6 +37,7 @@ void SceneLayer::Clear()
     m_BitmapFile.Reset();
     m_pMainBitmap = 0;
     m_MainBitmapOwned = false;
+    m_SavedChecksum = 0;
     m_DrawTrans = true;
     m_Offset.Reset();
     m_ScrollInfo.SetXY(1.0, 1.0);
@@ -46,6 +51,14 @@ void SceneLayer::Clear()
     m_FillRightColor = g_KeyColor;
     m_FillUpColor = g_KeyColor;
     m_FillDownColor = g_KeyColor;
+    m_Streamed = false;
+    m_StreamedWidth = 0;
+    m_StreamedHeight = 0;
+    m_StreamedTileCols = 0;
+    m_StreamedTileRows = 0;
+    m_StreamedTiles.clear();
+    m_DecodedTileCount = 0;
+    m_TileUseCounter = 0;
 }
 
 
@@ -186,6 +199,8 @@ int SceneLayer::Create(const SceneLayer &reference)
     // If no bitmap to copy, has to load the data (LoadData) to create this in the copied to SL
     else
         m_MainBitmapOwned = false;
+    // Same pixels and same file, so the copy is as unchanged as the original
+    m_SavedChecksum = reference.m_SavedChecksum;
 
     m_DrawTrans = reference.m_DrawTrans;
     m_Offset = reference.m_Offset;
@@ -201,6 +216,7 @@ int SceneLayer::Create(const SceneLayer &reference)
     m_FillRightColor = reference.m_FillRightColor;
     m_FillUpColor = reference.m_FillUpColor;
     m_FillDownColor = reference.m_FillDownColor;
+    m_Streamed = reference.m_Streamed;
 
     return 0;
 }
@@ -239,6 +255,13 @@ int SceneLayer::LoadData()
     m_FillUpColor = m_WrapY ? g_KeyColor : _getpixel(m_pMainBitmap, m_pMainBitmap->w / 2, 0);
     m_FillDownColor = m_WrapY ? g_KeyColor : _getpixel(m_pMainBitmap, m_pMainBitmap->w / 2, m_pMainBitmap->h - 1);
 
+    // Remember what the file held, so SaveData can tell whether anything actually changed
+    m_SavedChecksum = GetDataChecksum();
+
+    // Only keep the compressed tiles around if this is to be streamed; they get decoded again as they're drawn
+    if (m_Streamed)
+        CompressToTiles();
+
     return 0;
 }
 
@@ -256,19 +279,88 @@ int SceneLayer::SaveData(string bitmapPath)
     // Save out the bitmap
     if (m_pMainBitmap)
     {
-        PALETTE palette;
-        get_palette(palette);
-        if (save_bmp(bitmapPath.c_str(), m_pMainBitmap, palette) != 0)
-            return -1;
+        string oldPath = m_BitmapFile.GetDataPath();
+        // Loaded data that is still the same as what's in the file it's being saved to doesn't need to be written again
+        unsigned long long checksum = GetDataChecksum();
+        if (bitmapPath == oldPath && checksum == m_SavedChecksum && m_SavedChecksum != 0)
+            return 0;
+
+        if (ContentFile::IsCompressedBitmapPath(bitmapPath))
+        {
+            if (!ContentFile::SaveCompressedBitmap(bitmapPath, m_pMainBitmap))
+                return -1;
+        }
+        else
+        {
+            PALETTE palette;
+            get_palette(palette);
+            if (save_bmp(bitmapPath.c_str(), m_pMainBitmap, palette) != 0)
+                return -1;
+        }
 
         // Set the new path to point to the new file location - only if there was a successful save of the bitmap
         m_BitmapFile.SetDataPath(bitmapPath);
+        m_SavedChecksum = checksum;
+
+        // The same layer saved in another format before, like the .bmp files of older saves, is left orphaned by the new file, so remove it
+        string::size_type oldExtension = oldPath.rfind('.');
+        string::size_type newExtension = bitmapPath.rfind('.');
+        if (oldPath != bitmapPath && oldPath.find('#') == string::npos && oldExtension != string::npos && newExtension != string::npos &&
+            oldPath.substr(0, oldExtension) == bitmapPath.substr(0, newExtension))
+            delete_file(oldPath.c_str());
+    }
+    // Data that isn't loaded can't have changed since it was last saved, so there is no need to load and re-encode it.
+    // If it's being saved under a new name, just copy the existing file over, keeping whatever format it's already in
+    else if (IsFileData())
+    {
+        string oldPath = m_BitmapFile.GetDataPath();
+        // Can't copy things out of datafiles
+        if (oldPath.find('#') != string::npos || oldPath.rfind('.') == string::npos)
+            return 0;
+
+        string newPath = bitmapPath.substr(0, bitmapPath.rfind('.')) + oldPath.substr(oldPath.rfind('.'));
+        if (newPath != oldPath)
+        {
+            ifstream sourceFile(oldPath.c_str(), ios::binary);
+            ofstream destFile(newPath.c_str(), ios::binary);
+            if (!sourceFile.good() || !destFile.good() || !(destFile << sourceFile.rdbuf()))
+                return -1;
+
+            m_BitmapFile.SetDataPath(newPath);
+        }
     }
 
     return 0;
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetDataChecksum
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Calculates a checksum of all the pixels of the main bitmap.
+
+unsigned long long SceneLayer::GetDataChecksum() const
+{
+    if (!m_pMainBitmap)
+        return 0;
+
+    // 64 bit FNV-1a over every row, plus the dimensions so a resized layer never matches
+    const unsigned long long prime = 1099511628211ULL;
+    unsigned long long checksum = 14695981039346656037ULL;
+    int rowBytes = m_pMainBitmap->w * ((bitmap_color_depth(m_pMainBitmap) + 7) / 8);
+    checksum = (checksum ^ (unsigned long long)m_pMainBitmap->w) * prime;
+    checksum = (checksum ^ (unsigned long long)m_pMainBitmap->h) * prime;
+    for (int y = 0; y < m_pMainBitmap->h; ++y)
+    {
+        const unsigned char *pRow = m_pMainBitmap->line[y];
+        for (int x = 0; x < rowBytes; ++x)
+            checksum = (checksum ^ pRow[x]) * prime;
+    }
+    // 0 means unknown
+    return checksum ? checksum : 1;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  ClearData
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -276,6 +368,8 @@ int SceneLayer::SaveData(string bitmapPath)
 
 int SceneLayer::ClearData()
 {
+    ClearStreamedTiles();
+
     if (m_pMainBitmap && m_MainBitmapOwned)
         destroy_bitmap(m_pMainBitmap);
     m_pMainBitmap = 0;
@@ -361,6 +455,7 @@ void SceneLayer::Destroy(bool notInherited)
 {
     if (m_MainBitmapOwned)
         destroy_bitmap(m_pMainBitmap);
+    ClearStreamedTiles();
 
     if (!notInherited)
         Entity::Destroy();
@@ -377,8 +472,8 @@ void SceneLayer::SetScaleFactor(const Vector newScale)
 {
     m_ScaleFactor = newScale;
     m_ScaleInverse.SetXY(1.0f / newScale.m_X, 1.0f / newScale.m_Y);
-    if (m_pMainBitmap)
-        m_ScaledDimensions.SetXY(m_pMainBitmap->w * newScale.m_X, m_pMainBitmap->h * newScale.m_Y);
+    if (m_pMainBitmap || IsStreamed())
+        m_ScaledDimensions.SetXY(GetBitmapWidth() * newScale.m_X, GetBitmapHeight() * newScale.m_Y);
 }
 
 
@@ -391,7 +486,7 @@ void SceneLayer::SetScaleFactor(const Vector newScale)
 unsigned char SceneLayer::GetPixel(const int pixelX, const int pixelY)
 {
     // Make sure it's within the boundaries of the bitmap.
-    if (pixelX < 0 || pixelX >= m_pMainBitmap->w || pixelY < 0 || pixelY >= m_pMainBitmap->h)
+    if (pixelX < 0 || pixelX >= GetBitmapWidth() || pixelY < 0 || pixelY >= GetBitmapHeight())
         return 0;
 //    AAssert(m_pTerrain->GetBitmap()->m_LockCount > 0, "Trying to access unlocked terrain bitmap");
 //    DAssert(is_inside_bitmap(m_pMainBitmap, pixelX, pixelY, 0), "Trying to access pixel outside of SceneLayer's bitmap's boundaries!");
@@ -412,9 +507,9 @@ void SceneLayer::SetPixel(const int pixelX, const int pixelY, const unsigned cha
 
     // Make sure it's within the boundaries of the bitmap.
     if (pixelX < 0 ||
-       pixelX >= m_pMainBitmap->w ||
+       pixelX >= GetBitmapWidth() ||
        pixelY < 0 ||
-       pixelY >= m_pMainBitmap->h)
+       pixelY >= GetBitmapHeight())
        return;
 //    AAssert(m_pTerrain->GetBitmap()->m_LockCount > 0, "Trying to access unlocked terrain bitmap");
 //    DAssert(is_inside_bitmap(m_pMainBitmap, pixelX, pixelY, 0), "Trying to access pixel outside of SceneLayer's bitmap's boundaries!");
@@ -432,8 +527,8 @@ void SceneLayer::SetPixel(const int pixelX, const int pixelY, const unsigned cha
 bool SceneLayer::ForceBounds(int &posX, int &posY, bool scaled) const
 {
     bool wrapped = false;
-    int width = scaled ? m_ScaledDimensions.GetFloorIntX() : m_pMainBitmap->w;
-    int height = scaled ? m_ScaledDimensions.GetFloorIntY() : m_pMainBitmap->h;
+    int width = scaled ? m_ScaledDimensions.GetFloorIntX() : GetBitmapWidth();
+    int height = scaled ? m_ScaledDimensions.GetFloorIntY() : GetBitmapHeight();
 
     if (posX < 0) {
         if (m_WrapX)
@@ -510,8 +605,8 @@ bool SceneLayer::ForceBounds(Vector &pos, bool scaled) const
 bool SceneLayer::WrapPosition(int &posX, int &posY, bool scaled) const
 {
     bool wrapped = false;
-    int width = scaled ? m_ScaledDimensions.GetFloorIntX() : m_pMainBitmap->w;
-    int height = scaled ? m_ScaledDimensions.GetFloorIntY() : m_pMainBitmap->h;
+    int width = scaled ? m_ScaledDimensions.GetFloorIntX() : GetBitmapWidth();
+    int height = scaled ? m_ScaledDimensions.GetFloorIntY() : GetBitmapHeight();
 
     if (m_WrapX) {
         if (posX < 0) {
@@ -593,7 +688,7 @@ void SceneLayer::Draw(BITMAP *pTargetBitmap, Box& targetBox, const Vector &scrol
 {
     SLICK_PROFILE(0xFF687233);
 
-    DAssert(m_pMainBitmap, "Data of this SceneLayer has not been loaded before trying to draw!");
+    DAssert(m_pMainBitmap || IsStreamed(), "Data of this SceneLayer has not been loaded before trying to draw!");
 
     int sourceX = 0;
     int sourceY = 0;
@@ -634,43 +729,40 @@ void SceneLayer::Draw(BITMAP *pTargetBitmap, Box& targetBox, const Vector &scrol
     // Set the clipping rectangle of the target bitmap to match the specified target box
     set_clip_rect(pTargetBitmap, targetBox.GetCorner().m_X, targetBox.GetCorner().m_Y, targetBox.GetCorner().m_X + targetBox.GetWidth() - 1, targetBox.GetCorner().m_Y + targetBox.GetHeight() - 1);
 
-    // Choose the correct blitting function based on transparency setting
-    void (*pfBlit)(BITMAP *source, BITMAP *dest, int source_x, int source_y, int dest_x, int dest_y, int width, int height) = m_DrawTrans ? &masked_blit : &blit;
-
     // See if this SceneLayer is wider AND higher than the target bitmap; then use simple wrapping logic - oterhwise need to tile
-    if (m_pMainBitmap->w >= pTargetBitmap->w && m_pMainBitmap->h >= pTargetBitmap->h)
+    if (GetBitmapWidth() >= pTargetBitmap->w && GetBitmapHeight() >= pTargetBitmap->h)
     {
         sourceX     = offsetX;
         sourceY     = offsetY;
-        sourceW     = m_pMainBitmap->w - offsetX;
-        sourceH     = m_pMainBitmap->h - offsetY;
+        sourceW     = GetBitmapWidth() - offsetX;
+        sourceH     = GetBitmapHeight() - offsetY;
         destX       = targetBox.GetCorner().m_X;
         destY       = targetBox.GetCorner().m_Y;
-        pfBlit(m_pMainBitmap, pTargetBitmap, sourceX, sourceY, destX, destY, sourceW, sourceH);
+        BlitLayer(pTargetBitmap, sourceX, sourceY, destX, destY, sourceW, sourceH);
 
         sourceX     = 0;
         sourceY     = offsetY;
         sourceW     = offsetX;
-        sourceH     = m_pMainBitmap->h - offsetY;
-        destX       = targetBox.GetCorner().m_X + m_pMainBitmap->w - offsetX;
+        sourceH     = GetBitmapHeight() - offsetY;
+        destX       = targetBox.GetCorner().m_X + GetBitmapWidth() - offsetX;
         destY       = targetBox.GetCorner().m_Y;
-        pfBlit(m_pMainBitmap, pTargetBitmap, sourceX, sourceY, destX, destY, sourceW, sourceH);
+        BlitLayer(pTargetBitmap, sourceX, sourceY, destX, destY, sourceW, sourceH);
 
         sourceX     = offsetX;
         sourceY     = 0;
-        sourceW     = m_pMainBitmap->w - offsetX;
+        sourceW     = GetBitmapWidth() - offsetX;
         sourceH     = offsetY;
         destX       = targetBox.GetCorner().m_X;
-        destY       = targetBox.GetCorner().m_Y + m_pMainBitmap->h - offsetY;
-        pfBlit(m_pMainBitmap, pTargetBitmap, sourceX, sourceY, destX, destY, sourceW, sourceH);
+        destY       = targetBox.GetCorner().m_Y + GetBitmapHeight() - offsetY;
+        BlitLayer(pTargetBitmap, sourceX, sourceY, destX, destY, sourceW, sourceH);
 
         sourceX     = 0;
         sourceY     = 0;
         sourceW     = offsetX;
         sourceH     = offsetY;
-        destX       = targetBox.GetCorner().m_X + m_pMainBitmap->w - offsetX;
-        destY       = targetBox.GetCorner().m_Y + m_pMainBitmap->h - offsetY;
-        pfBlit(m_pMainBitmap, pTargetBitmap, sourceX, sourceY, destX, destY, sourceW, sourceH);
+        destX       = targetBox.GetCorner().m_X + GetBitmapWidth() - offsetX;
+        destY       = targetBox.GetCorner().m_Y + GetBitmapHeight() - offsetY;
+        BlitLayer(pTargetBitmap, sourceX, sourceY, destX, destY, sourceW, sourceH);
     }
     // Target bitmap is larger in some dimension, so need to draw this tiled as many times as necessary to cover the whole target
     else
@@ -700,19 +792,19 @@ void SceneLayer::Draw(BITMAP *pTargetBitmap, Box& targetBox, const Vector &scrol
             {
                 sourceX     = 0;
                 sourceY     = 0;
-                sourceW     = m_pMainBitmap->w;
-                sourceH     = m_pMainBitmap->h;
+                sourceW     = GetBitmapWidth();
+                sourceH     = GetBitmapHeight();
                 // If the unwrapped and untiled direction can't cover the target area, place it in the middle of the target bitmap, and leave the excess perimeter on each side untouched
-                destX       = (!m_WrapX && screenLargerThanSceneX) ? ((pTargetBitmap->w / 2) - (m_pMainBitmap->w / 2)) : (targetBox.GetCorner().m_X + tiledOffsetX - offsetX);
-                destY       = (!m_WrapY && screenLargerThanSceneY) ? ((pTargetBitmap->h / 2) - (m_pMainBitmap->h / 2)) : (targetBox.GetCorner().m_Y + tiledOffsetY - offsetY);
-                pfBlit(m_pMainBitmap, pTargetBitmap, sourceX, sourceY, destX, destY, sourceW, sourceH);
+                destX       = (!m_WrapX && screenLargerThanSceneX) ? ((pTargetBitmap->w / 2) - (GetBitmapWidth() / 2)) : (targetBox.GetCorner().m_X + tiledOffsetX - offsetX);
+                destY       = (!m_WrapY && screenLargerThanSceneY) ? ((pTargetBitmap->h / 2) - (GetBitmapHeight() / 2)) : (targetBox.GetCorner().m_Y + tiledOffsetY - offsetY);
+                BlitLayer(pTargetBitmap, sourceX, sourceY, destX, destY, sourceW, sourceH);
 
-                tiledOffsetX += m_pMainBitmap->w;
+                tiledOffsetX += GetBitmapWidth();
             }
             // Only tile if we're supposed to wrap widthwise
             while (m_WrapX && toCoverX > tiledOffsetX);
 
-            tiledOffsetY += m_pMainBitmap->h;
+            tiledOffsetY += GetBitmapHeight();
         }
         // Only tile if we're supposed to wrap heightwise
         while (m_WrapY && toCoverY > tiledOffsetY);
@@ -724,7 +816,7 @@ void SceneLayer::Draw(BITMAP *pTargetBitmap, Box& targetBox, const Vector &scrol
             if (m_FillLeftColor != g_KeyColor && offsetX != 0)
                 rectfill(pTargetBitmap, targetBox.GetCorner().m_X, targetBox.GetCorner().m_Y, targetBox.GetCorner().m_X - offsetX, targetBox.GetCorner().m_Y + targetBox.GetHeight(), m_FillLeftColor);
             if (m_FillRightColor != g_KeyColor)
-                rectfill(pTargetBitmap, (targetBox.GetCorner().m_X - offsetX) + m_pMainBitmap->w, targetBox.GetCorner().m_Y, targetBox.GetCorner().m_X + targetBox.GetWidth(), targetBox.GetCorner().m_Y + targetBox.GetHeight(), m_FillRightColor);
+                rectfill(pTargetBitmap, (targetBox.GetCorner().m_X - offsetX) + GetBitmapWidth(), targetBox.GetCorner().m_Y, targetBox.GetCorner().m_X + targetBox.GetWidth(), targetBox.GetCorner().m_Y + targetBox.GetHeight(), m_FillRightColor);
         }
 
         if (!m_WrapY && !screenLargerThanSceneY && m_ScrollRatio.m_Y < 0)
@@ -732,7 +824,7 @@ void SceneLayer::Draw(BITMAP *pTargetBitmap, Box& targetBox, const Vector &scrol
             if (m_FillUpColor != g_KeyColor && offsetY != 0)
                 rectfill(pTargetBitmap, targetBox.GetCorner().m_X, targetBox.GetCorner().m_Y, targetBox.GetCorner().m_X + targetBox.GetWidth(), targetBox.GetCorner().m_Y - offsetY, m_FillUpColor);
             if (m_FillDownColor != g_KeyColor)
-                rectfill(pTargetBitmap, targetBox.GetCorner().m_X, (targetBox.GetCorner().m_Y - offsetY) + m_pMainBitmap->h, targetBox.GetCorner().m_X + targetBox.GetWidth(), targetBox.GetCorner().m_Y + targetBox.GetHeight(), m_FillDownColor);
+                rectfill(pTargetBitmap, targetBox.GetCorner().m_X, (targetBox.GetCorner().m_Y - offsetY) + GetBitmapHeight(), targetBox.GetCorner().m_X + targetBox.GetWidth(), targetBox.GetCorner().m_Y + targetBox.GetHeight(), m_FillDownColor);
         }
     }
 
@@ -835,8 +927,8 @@ void SceneLayer::DrawScaled(BITMAP *pTargetBitmap, Box &targetBox, const Vector
         // Upper left
         sourceX     = 0;
         sourceY     = 0;
-        sourceW     = m_pMainBitmap->w;
-        sourceH     = m_pMainBitmap->h;
+        sourceW     = GetBitmapWidth();
+        sourceH     = GetBitmapHeight();
         destX       = targetBox.GetCorner().m_X - offsetX;
         destY       = targetBox.GetCorner().m_Y - offsetY;
         destW       = sourceW * m_ScaleFactor.m_X + 1;
@@ -847,7 +939,7 @@ void SceneLayer::DrawScaled(BITMAP *pTargetBitmap, Box &targetBox, const Vector
         sourceX     = 0;
         sourceY     = 0;
         sourceW     = sourceOffset.m_X;
-        sourceH     = m_pMainBitmap->h;
+        sourceH     = GetBitmapHeight();
         destX       = targetBox.GetCorner().m_X + m_ScaledDimensions.m_X - offsetX;
         destY       = targetBox.GetCorner().m_Y - offsetY;
         destW       = sourceW * m_ScaleFactor.m_X + 1;
@@ -857,7 +949,7 @@ void SceneLayer::DrawScaled(BITMAP *pTargetBitmap, Box &targetBox, const Vector
         // Lower left
         sourceX     = 0;
         sourceY     = 0;
-        sourceW     = m_pMainBitmap->w;
+        sourceW     = GetBitmapWidth();
         sourceH     = sourceOffset.m_Y;
         destX       = targetBox.GetCorner().m_X - offsetX;
         destY       = targetBox.GetCorner().m_Y + m_ScaledDimensions.m_Y - offsetY;
@@ -904,8 +996,8 @@ void SceneLayer::DrawScaled(BITMAP *pTargetBitmap, Box &targetBox, const Vector
             {
                 sourceX     = 0;
                 sourceY     = 0;
-                sourceW     = m_pMainBitmap->w;
-                sourceH     = m_pMainBitmap->h;
+                sourceW     = GetBitmapWidth();
+                sourceH     = GetBitmapHeight();
                 // If the unwrapped and untiled direction can't cover the target area, place it in the middle of the target bitmap, and leave the excess perimeter on each side untouched
                 destX       = (!m_WrapX && screenLargerThanSceneX) ? ((pTargetBitmap->w / 2) - (m_ScaledDimensions.m_X / 2)) : (targetBox.GetCorner().m_X + tiledOffsetX - offsetX);
                 destY       = (!m_WrapY && screenLargerThanSceneY) ? ((pTargetBitmap->h / 2) - (m_ScaledDimensions.m_Y / 2)) : (targetBox.GetCorner().m_Y + tiledOffsetY - offsetY);
@@ -931,7 +1023,7 @@ void SceneLayer::DrawScaled(BITMAP *pTargetBitmap, Box &targetBox, const Vector
             if (m_FillLeftColor != g_KeyColor && offsetX != 0)
                 rectfill(pTargetBitmap, targetBox.GetCorner().m_X, targetBox.GetCorner().m_Y, targetBox.GetCorner().m_X - offsetX, targetBox.GetCorner().m_Y + targetBox.GetHeight(), m_FillLeftColor);
             if (m_FillRightColor != g_KeyColor)
-                rectfill(pTargetBitmap, (targetBox.GetCorner().m_X - offsetX) + m_pMainBitmap->w, targetBox.GetCorner().m_Y, targetBox.GetCorner().m_X + targetBox.GetWidth(), targetBox.GetCorner().m_Y + targetBox.GetHeight(), m_FillRightColor);
+                rectfill(pTargetBitmap, (targetBox.GetCorner().m_X - offsetX) + GetBitmapWidth(), targetBox.GetCorner().m_Y, targetBox.GetCorner().m_X + targetBox.GetWidth(), targetBox.GetCorner().m_Y + targetBox.GetHeight(), m_FillRightColor);
         }
 
         if (!m_WrapY && !screenLargerThanSceneY && m_ScrollRatio.m_Y < 0)
@@ -939,7 +1031,7 @@ void SceneLayer::DrawScaled(BITMAP *pTargetBitmap, Box &targetBox, const Vector
             if (m_FillUpColor != g_KeyColor && offsetY != 0)
                 rectfill(pTargetBitmap, targetBox.GetCorner().m_X, targetBox.GetCorner().m_Y, targetBox.GetCorner().m_X + targetBox.GetWidth(), targetBox.GetCorner().m_Y - offsetY, m_FillUpColor);
             if (m_FillDownColor != g_KeyColor)
-                rectfill(pTargetBitmap, targetBox.GetCorner().m_X, (targetBox.GetCorner().m_Y - offsetY) + m_pMainBitmap->h, targetBox.GetCorner().m_X + targetBox.GetWidth(), targetBox.GetCorner().m_Y + targetBox.GetHeight(), m_FillDownColor);
+                rectfill(pTargetBitmap, targetBox.GetCorner().m_X, (targetBox.GetCorner().m_Y - offsetY) + GetBitmapHeight(), targetBox.GetCorner().m_X + targetBox.GetWidth(), targetBox.GetCorner().m_Y + targetBox.GetHeight(), m_FillDownColor);
         }
 */
     }
@@ -948,6 +1040,216 @@ void SceneLayer::DrawScaled(BITMAP *pTargetBitmap, Box &targetBox, const Vector
     set_clip_rect(pTargetBitmap, 0, 0, pTargetBitmap->w - 1, pTargetBitmap->h - 1);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CompressToTiles
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Cuts the loaded main bitmap up into compressed tiles and then destroys
+//                  it, leaving the data of this layer streamed.
+
+bool SceneLayer::CompressToTiles()
+{
+    // Only plain 8bpp layers drawn unscaled can be streamed, and it's not worth it for small ones
+    if (!m_pMainBitmap || !m_MainBitmapOwned || bitmap_color_depth(m_pMainBitmap) != 8 || m_ScaleFactor.m_X != 1.0 || m_ScaleFactor.m_Y != 1.0 ||
+        m_pMainBitmap->w * m_pMainBitmap->h <= 4 * STREAMTILESIZE * STREAMTILESIZE)
+        return false;
+
+    ClearStreamedTiles();
+
+    m_StreamedWidth = m_pMainBitmap->w;
+    m_StreamedHeight = m_pMainBitmap->h;
+    m_StreamedTileCols = (m_StreamedWidth + STREAMTILESIZE - 1) / STREAMTILESIZE;
+    m_StreamedTileRows = (m_StreamedHeight + STREAMTILESIZE - 1) / STREAMTILESIZE;
+    m_StreamedTiles.resize(m_StreamedTileCols * m_StreamedTileRows);
+
+    char *pRaw = new char[STREAMTILESIZE * STREAMTILESIZE];
+    for (int tileY = 0; tileY < m_StreamedTileRows; ++tileY)
+    {
+        for (int tileX = 0; tileX < m_StreamedTileCols; ++tileX)
+        {
+            int tileW = DMin(STREAMTILESIZE, m_StreamedWidth - tileX * STREAMTILESIZE);
+            int tileH = DMin(STREAMTILESIZE, m_StreamedHeight - tileY * STREAMTILESIZE);
+            for (int row = 0; row < tileH; ++row)
+                memcpy(pRaw + row * tileW, m_pMainBitmap->line[tileY * STREAMTILESIZE + row] + tileX * STREAMTILESIZE, tileW);
+
+            StreamedTile &tile = m_StreamedTiles[tileY * m_StreamedTileCols + tileX];
+            tile.m_Compressed.resize(LZ4_compressBound(tileW * tileH));
+            int compressedSize = LZ4_compress_default(pRaw, &tile.m_Compressed[0], tileW * tileH, tile.m_Compressed.size());
+            tile.m_Compressed.resize(compressedSize);
+            tile.m_pDecoded = 0;
+            tile.m_LastUsed = 0;
+        }
+    }
+    delete[] pRaw;
+
+    destroy_bitmap(m_pMainBitmap);
+    m_pMainBitmap = 0;
+    m_MainBitmapOwned = false;
+
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ClearStreamedTiles
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys all the compressed and decoded tiles of this.
+
+void SceneLayer::ClearStreamedTiles()
+{
+    for (vector<StreamedTile>::iterator tItr = m_StreamedTiles.begin(); tItr != m_StreamedTiles.end(); ++tItr)
+    {
+        if (tItr->m_pDecoded)
+            destroy_bitmap(tItr->m_pDecoded);
+    }
+    m_StreamedTiles.clear();
+    m_StreamedWidth = 0;
+    m_StreamedHeight = 0;
+    m_StreamedTileCols = 0;
+    m_StreamedTileRows = 0;
+    m_DecodedTileCount = 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetStreamedTile
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a decoded tile of a streamed layer, decoding it if needed and
+//                  evicting the least recently drawn tile if too many are decoded.
+
+BITMAP * SceneLayer::GetStreamedTile(int tileX, int tileY) const
+{
+    StreamedTile &tile = m_StreamedTiles[tileY * m_StreamedTileCols + tileX];
+    tile.m_LastUsed = ++m_TileUseCounter;
+    if (tile.m_pDecoded)
+        return tile.m_pDecoded;
+
+    // Make room by throwing out whichever decoded tile was drawn the longest ago
+    if (m_DecodedTileCount >= GetMaxDecodedTiles())
+    {
+        StreamedTile *pOldest = 0;
+        for (vector<StreamedTile>::iterator tItr = m_StreamedTiles.begin(); tItr != m_StreamedTiles.end(); ++tItr)
+        {
+            if (tItr->m_pDecoded && &(*tItr) != &tile && (!pOldest || tItr->m_LastUsed < pOldest->m_LastUsed))
+                pOldest = &(*tItr);
+        }
+        if (pOldest)
+        {
+            destroy_bitmap(pOldest->m_pDecoded);
+            pOldest->m_pDecoded = 0;
+            m_DecodedTileCount--;
+        }
+    }
+
+    int tileW = DMin(STREAMTILESIZE, m_StreamedWidth - tileX * STREAMTILESIZE);
+    int tileH = DMin(STREAMTILESIZE, m_StreamedHeight - tileY * STREAMTILESIZE);
+    tile.m_pDecoded = create_bitmap_ex(8, tileW, tileH);
+    AAssert(tile.m_pDecoded, "Failed to allocate BITMAP for a streamed SceneLayer tile");
+
+    // The rows are stored back to back, so decode into one block and spread it out onto the bitmap's rows
+    char *pRaw = new char[tileW * tileH];
+    if (!tile.m_Compressed.empty() && LZ4_decompress_safe(&tile.m_Compressed[0], pRaw, tile.m_Compressed.size(), tileW * tileH) == tileW * tileH)
+    {
+        for (int row = 0; row < tileH; ++row)
+            memcpy(tile.m_pDecoded->line[row], pRaw + row * tileW, tileW);
+    }
+    // Leave a hole rather than garbage if the data is broken, and drop it so this is only reported once
+    else
+    {
+        if (!tile.m_Compressed.empty())
+            g_ConsoleMan.PrintString("ERROR: Failed to decode a tile of streamed layer " + GetPresetName() + "!");
+        tile.m_Compressed.clear();
+        clear_to_color(tile.m_pDecoded, g_KeyColor);
+    }
+    delete[] pRaw;
+
+    m_DecodedTileCount++;
+    return tile.m_pDecoded;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetMaxDecodedTiles
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many tiles of a streamed layer may be decoded at once.
+
+int SceneLayer::GetMaxDecodedTiles() const
+{
+    // A network server draws a full screen for each player, otherwise the resolution is split between the screens
+    int screenCount = g_FrameMan.GetStoreNetworkBackBuffer() ? MAXSCREENCOUNT : g_FrameMan.GetScreenCount();
+    int tileCount = 0;
+    for (int screen = 0; screen < screenCount; ++screen)
+    {
+        // A screen not lined up with the tiles overlaps one more of them each way
+        int tileCols = (g_FrameMan.GetPlayerFrameBufferWidth(screen) + STREAMTILESIZE - 1) / STREAMTILESIZE + 1;
+        int tileRows = (g_FrameMan.GetPlayerFrameBufferHeight(screen) + STREAMTILESIZE - 1) / STREAMTILESIZE + 1;
+        tileCount += tileCols * tileRows;
+    }
+    return DMax(2 * tileCount, (int)MINDECODEDTILES);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          BlitLayer
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Blits a rectangle of this layer's data to a target bitmap, masked or
+//                  not according to m_DrawTrans.
+
+void SceneLayer::BlitLayer(BITMAP *pTargetBitmap, int sourceX, int sourceY, int destX, int destY, int width, int height) const
+{
+    if (!IsStreamed())
+    {
+        if (m_DrawTrans)
+            masked_blit(m_pMainBitmap, pTargetBitmap, sourceX, sourceY, destX, destY, width, height);
+        else
+            blit(m_pMainBitmap, pTargetBitmap, sourceX, sourceY, destX, destY, width, height);
+        return;
+    }
+
+    // Clip the source rectangle to the layer, like blit would
+    if (sourceX < 0)
+    {
+        destX -= sourceX;
+        width += sourceX;
+        sourceX = 0;
+    }
+    if (sourceY < 0)
+    {
+        destY -= sourceY;
+        height += sourceY;
+        sourceY = 0;
+    }
+    width = DMin(width, m_StreamedWidth - sourceX);
+    height = DMin(height, m_StreamedHeight - sourceY);
+    if (width <= 0 || height <= 0)
+        return;
+
+    for (int tileY = sourceY / STREAMTILESIZE; tileY <= (sourceY + height - 1) / STREAMTILESIZE; ++tileY)
+    {
+        // The part of this tile row that is inside the source rectangle
+        int top = DMax(sourceY, tileY * STREAMTILESIZE);
+        int bottom = DMin(sourceY + height, (tileY + 1) * STREAMTILESIZE);
+        int tileDestY = destY + top - sourceY;
+        // Don't decode anything that won't end up inside the target's clipping rectangle anyway
+        if (tileDestY >= pTargetBitmap->cb || tileDestY + bottom - top <= pTargetBitmap->ct)
+            continue;
+
+        for (int tileX = sourceX / STREAMTILESIZE; tileX <= (sourceX + width - 1) / STREAMTILESIZE; ++tileX)
+        {
+            int left = DMax(sourceX, tileX * STREAMTILESIZE);
+            int right = DMin(sourceX + width, (tileX + 1) * STREAMTILESIZE);
+            int tileDestX = destX + left - sourceX;
+            if (tileDestX >= pTargetBitmap->cr || tileDestX + right - left <= pTargetBitmap->cl)
+                continue;
+
+            BITMAP *pTile = GetStreamedTile(tileX, tileY);
+            if (m_DrawTrans)
+                masked_blit(pTile, pTargetBitmap, left - tileX * STREAMTILESIZE, top - tileY * STREAMTILESIZE, tileDestX, tileDestY, right - left, bottom - top);
+            else
+                blit(pTile, pTargetBitmap, left - tileX * STREAMTILESIZE, top - tileY * STREAMTILESIZE, tileDestX, tileDestY, right - left, bottom - top);
+        }
+    }
+}
+
 /* not neccessary
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          LoadContour
@@ -975,11 +1277,11 @@ void SceneLayer::InitScrollRatios()
         if (m_ScrollInfo.m_X == -1.0 || m_ScrollInfo.m_X == 1.0)
             m_ScrollRatio.m_X = 1.0;
         else if (m_ScrollInfo.m_X == g_FrameMan.GetPlayerScreenWidth())
-            m_ScrollRatio.m_X = m_pMainBitmap->w - g_FrameMan.GetPlayerScreenWidth();
-        else if (m_pMainBitmap->w == g_FrameMan.GetPlayerScreenWidth())
+            m_ScrollRatio.m_X = GetBitmapWidth() - g_FrameMan.GetPlayerScreenWidth();
+        else if (GetBitmapWidth() == g_FrameMan.GetPlayerScreenWidth())
             m_ScrollRatio.m_X = 1.0f / (float)(m_ScrollInfo.m_X - g_FrameMan.GetPlayerScreenWidth());
         else
-            m_ScrollRatio.m_X = (float)(m_pMainBitmap->w - g_FrameMan.GetPlayerScreenWidth()) /
+            m_ScrollRatio.m_X = (float)(GetBitmapWidth() - g_FrameMan.GetPlayerScreenWidth()) /
                                 (float)(m_ScrollInfo.m_X - g_FrameMan.GetPlayerScreenWidth());
     }
 
@@ -990,16 +1292,16 @@ void SceneLayer::InitScrollRatios()
         if (m_ScrollInfo.m_Y == -1.0 || m_ScrollInfo.m_Y == 1.0)
             m_ScrollRatio.m_Y = 1.0;
         else if (m_ScrollInfo.m_Y == g_FrameMan.GetPlayerScreenHeight())
-            m_ScrollRatio.m_Y = m_pMainBitmap->h - g_FrameMan.GetPlayerScreenHeight();
-        else if (m_pMainBitmap->h == g_FrameMan.GetPlayerScreenHeight())
+            m_ScrollRatio.m_Y = GetBitmapHeight() - g_FrameMan.GetPlayerScreenHeight();
+        else if (GetBitmapHeight() == g_FrameMan.GetPlayerScreenHeight())
             m_ScrollRatio.m_Y = 1.0f / (float)(m_ScrollInfo.m_Y - g_FrameMan.GetPlayerScreenHeight());
         else
-            m_ScrollRatio.m_Y = (float)(m_pMainBitmap->h - g_FrameMan.GetPlayerScreenHeight()) /
+            m_ScrollRatio.m_Y = (float)(GetBitmapHeight() - g_FrameMan.GetPlayerScreenHeight()) /
                                 (float)(m_ScrollInfo.m_Y - g_FrameMan.GetPlayerScreenHeight());
     }
 
     // Establish the scaled dimensions of this
-    m_ScaledDimensions.SetXY(m_pMainBitmap->w * m_ScaleFactor.m_X, m_pMainBitmap->h * m_ScaleFactor.m_Y);
+    m_ScaledDimensions.SetXY(GetBitmapWidth() * m_ScaleFactor.m_X, GetBitmapHeight() * m_ScaleFactor.m_Y);
 }
 
 
@@ -1012,11 +1314,11 @@ void SceneLayer::UpdateScrollRatiosForNetworkPlayer(int player)
 		if (m_ScrollInfo.m_X == -1.0 || m_ScrollInfo.m_X == 1.0)
 			m_ScrollRatio.m_X = 1.0;
 		else if (m_ScrollInfo.m_X == g_FrameMan.GetPlayerFrameBufferWidth(player))
-			m_ScrollRatio.m_X = m_pMainBitmap->w - g_FrameMan.GetPlayerFrameBufferWidth(player);
-		else if (m_pMainBitmap->w == g_FrameMan.GetPlayerFrameBufferWidth(player))
+			m_ScrollRatio.m_X = GetBitmapWidth() - g_FrameMan.GetPlayerFrameBufferWidth(player);
+		else if (GetBitmapWidth() == g_FrameMan.GetPlayerFrameBufferWidth(player))
 			m_ScrollRatio.m_X = 1.0f / (float)(m_ScrollInfo.m_X - g_FrameMan.GetPlayerFrameBufferWidth(player));
 		else
-			m_ScrollRatio.m_X = (float)(m_pMainBitmap->w - g_FrameMan.GetPlayerFrameBufferWidth(player)) /
+			m_ScrollRatio.m_X = (float)(GetBitmapWidth() - g_FrameMan.GetPlayerFrameBufferWidth(player)) /
 			(float)(m_ScrollInfo.m_X - g_FrameMan.GetPlayerFrameBufferWidth(player));
 	}
 
@@ -1027,16 +1329,16 @@ void SceneLayer::UpdateScrollRatiosForNetworkPlayer(int player)
 		if (m_ScrollInfo.m_Y == -1.0 || m_ScrollInfo.m_Y == 1.0)
 			m_ScrollRatio.m_Y = 1.0;
 		else if (m_ScrollInfo.m_Y == g_FrameMan.GetPlayerFrameBufferHeight(player))
-			m_ScrollRatio.m_Y = m_pMainBitmap->h - g_FrameMan.GetPlayerFrameBufferHeight(player);
-		else if (m_pMainBitmap->h == g_FrameMan.GetPlayerFrameBufferHeight(player))
+			m_ScrollRatio.m_Y = GetBitmapHeight() - g_FrameMan.GetPlayerFrameBufferHeight(player);
+		else if (GetBitmapHeight() == g_FrameMan.GetPlayerFrameBufferHeight(player))
 			m_ScrollRatio.m_Y = 1.0f / (float)(m_ScrollInfo.m_Y - g_FrameMan.GetPlayerFrameBufferHeight(player));
 		else
-			m_ScrollRatio.m_Y = (float)(m_pMainBitmap->h - g_FrameMan.GetPlayerFrameBufferHeight(player)) /
+			m_ScrollRatio.m_Y = (float)(GetBitmapHeight() - g_FrameMan.GetPlayerFrameBufferHeight(player)) /
 			(float)(m_ScrollInfo.m_Y - g_FrameMan.GetPlayerFrameBufferHeight(player));
 	}
 
 	// Establish the scaled dimensions of this
-	m_ScaledDimensions.SetXY(m_pMainBitmap->w * m_ScaleFactor.m_X, m_pMainBitmap->h * m_ScaleFactor.m_Y);
+	m_ScaledDimensions.SetXY(GetBitmapWidth() * m_ScaleFactor.m_X, GetBitmapHeight() * m_ScaleFactor.m_Y);
 }
 
 
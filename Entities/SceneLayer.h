@@ -17,6 +17,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 using std::string;
 
 #include "DDTTools.h"
@@ -321,6 +322,30 @@ ENTITYALLOCATION(SceneLayer)
 	size_t GetBitmapHash() const { return m_BitmapFile.GetHash(); }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetStreamed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets whether this SceneLayer should keep its data as compressed tiles
+//                  that only get decoded as they are drawn, instead of as one whole BITMAP.
+//                  Only meant for layers that are only ever drawn, like the background
+//                  layers of a Scene. Has to be set before LoadData to have any effect.
+// Arguments:       Whether to stream the data of this layer.
+// Return value:    None.
+
+    void SetStreamed(bool streamed) { m_Streamed = streamed; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsStreamed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether the loaded data of this SceneLayer is held as compressed
+//                  tiles. If so, GetBitmap will return 0.
+// Arguments:       None.
+// Return value:    Whether the data of this is streamed.
+
+    bool IsStreamed() const { return m_Streamed && !m_StreamedTiles.empty(); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetOffset
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -618,6 +643,112 @@ protected:
 	void UpdateScrollRatiosForNetworkPlayer(int player);
 
 
+    // The size of the square tiles that streamed layers are cut up into, and the fewest of
+    // them that may be decoded per layer at any one time
+    enum { STREAMTILESIZE = 256, MINDECODEDTILES = 16 };
+
+    // One tile of a streamed layer
+    struct StreamedTile
+    {
+        // The LZ4 compressed rows of the tile
+        std::vector<char> m_Compressed;
+        // The decoded tile, 0 if it isn't currently decoded. Owned
+        BITMAP *m_pDecoded;
+        // When this was last drawn, in terms of m_TileUseCounter
+        unsigned long m_LastUsed;
+    };
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetBitmapWidth
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the width of the layer's data, whether it's streamed or not.
+// Arguments:       None.
+// Return value:    The width in pixels.
+
+    int GetBitmapWidth() const { return m_pMainBitmap ? m_pMainBitmap->w : m_StreamedWidth; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetBitmapHeight
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the height of the layer's data, whether it's streamed or not.
+// Arguments:       None.
+// Return value:    The height in pixels.
+
+    int GetBitmapHeight() const { return m_pMainBitmap ? m_pMainBitmap->h : m_StreamedHeight; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CompressToTiles
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Cuts the loaded main bitmap up into compressed tiles and then destroys
+//                  it, leaving the data of this layer streamed.
+// Arguments:       None.
+// Return value:    Whether the bitmap was turned into tiles.
+
+    bool CompressToTiles();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ClearStreamedTiles
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys all the compressed and decoded tiles of this.
+// Arguments:       None.
+// Return value:    None.
+
+    void ClearStreamedTiles();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetStreamedTile
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a decoded tile of a streamed layer, decoding it if needed and
+//                  evicting the least recently drawn tile if too many are decoded.
+// Arguments:       The tile's column and row.
+// Return value:    The decoded tile. Ownership is NOT transferred!
+
+    BITMAP * GetStreamedTile(int tileX, int tileY) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetMaxDecodedTiles
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many tiles of a streamed layer may be decoded at once, which
+//                  is enough to cover all the player screens at the current resolution
+//                  twice over, so scrolling doesn't keep evicting tiles still in view.
+// Arguments:       None.
+// Return value:    The number of tiles.
+
+    int GetMaxDecodedTiles() const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetDataChecksum
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Calculates a checksum of all the pixels of the main bitmap, to tell
+//                  whether they've changed since they were last loaded or saved.
+// Arguments:       None.
+// Return value:    The checksum, or 0 if there is no main bitmap.
+
+    unsigned long long GetDataChecksum() const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          BlitLayer
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Blits a rectangle of this layer's data to a target bitmap, masked or
+//                  not according to m_DrawTrans. Streamed layers only decode the tiles
+//                  that end up inside the target's clipping rectangle.
+// Arguments:       The bitmap to blit to.
+//                  The source rectangle's corner in the layer.
+//                  Where the corner should land on the target.
+//                  The size of the rectangle.
+// Return value:    None.
+
+    void BlitLayer(BITMAP *pTargetBitmap, int sourceX, int sourceY, int destX, int destY, int width, int height) const;
+
+
     // Member variables
     static Entity::ClassInfo m_sClass;
 
@@ -626,6 +757,8 @@ protected:
     BITMAP *m_pMainBitmap;
     // Whether main bitmap is owned by this
     bool m_MainBitmapOwned;
+    // Checksum of the main bitmap's pixels as they are in the file m_BitmapFile points to, or 0 if not known
+    unsigned long long m_SavedChecksum;
     bool m_DrawTrans;
     Vector m_Offset;
     // The original scrollinfo with special encoded info that is then made into the actual scroll ratios
@@ -642,6 +775,21 @@ protected:
     int m_FillUpColor;
     int m_FillDownColor;
 
+    // Whether this should hold its data as compressed tiles after LoadData
+    bool m_Streamed;
+    // The dimensions of the data when it's streamed and there is no main bitmap
+    int m_StreamedWidth;
+    int m_StreamedHeight;
+    // How many tile columns and rows the streamed data is cut into
+    int m_StreamedTileCols;
+    int m_StreamedTileRows;
+    // The tiles of the streamed data, row by row. Decoded lazily while drawing, hence mutable
+    mutable std::vector<StreamedTile> m_StreamedTiles;
+    // How many of the above are currently decoded
+    mutable int m_DecodedTileCount;
+    // Ticks each time a tile is drawn, to find the least recently drawn one
+    mutable unsigned long m_TileUseCounter;
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Private member variable and method declarations
@@ -40,6 +40,25 @@ GUIFont::GUIFont(std::string Name)
     m_CurrentBitmap = 0;
 
     m_CharIndexCap = 256;
+
+    m_TextRunPixels = 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          TextKey::operator<
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Orders the keys for the text run and measurement lookups.
+
+bool GUIFont::TextKey::operator<(const TextKey &rhs) const
+{
+    if (m_Color != rhs.m_Color)
+        return m_Color < rhs.m_Color;
+    if (m_Shadow != rhs.m_Shadow)
+        return m_Shadow < rhs.m_Shadow;
+    if (m_Kerning != rhs.m_Kerning)
+        return m_Kerning < rhs.m_Kerning;
+    return m_Text < rhs.m_Text;
 }
 
 
@@ -54,6 +73,9 @@ bool GUIFont::Load(GUIScreen *Screen, const std::string Filename)
 
     m_Screen = Screen;
 
+    // Anything cached was laid out with the old font
+    ClearTextCache();
+
     // Load the font image
     m_Font = m_Screen->CreateBitmap(Filename);
     if (!m_Font)
@@ -146,16 +168,15 @@ bool GUIFont::Load(GUIScreen *Screen, const std::string Filename)
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Draws text to a bitmap.
 
-void GUIFont::Draw(GUIBitmap *Bitmap, int X, int Y, const std::string Text, Uint32 Shadow)
+void GUIFont::Draw(GUIBitmap *Bitmap, int X, int Y, const std::string &Text, Uint32 Shadow)
 {
-    unsigned char c;
-    int i;
-    RECT Rect;
     GUIBitmap *Surf = m_CurrentBitmap;
-    int initX = X;
     
     assert(Surf);
 
+    if (Text.empty())
+        return;
+
     // Make the shadow color
     FontColor *FSC = 0;
     if (Shadow) {
@@ -165,6 +186,87 @@ void GUIFont::Draw(GUIBitmap *Bitmap, int X, int Y, const std::string Text, Uint
             FSC = GetFontColor(Shadow);
         }
     }
+    GUIBitmap *ShadowSurf = FSC ? FSC->m_Bitmap : 0;
+
+    // Runs are rendered with masked blits, which only work between bitmaps of the same depth
+    if (!m_Screen || Surf->GetColorDepth() != Bitmap->GetColorDepth()) {
+        DrawGlyphs(Bitmap, X, Y, Text, Surf, ShadowSurf);
+        return;
+    }
+
+    TextKey Key;
+    Key.m_Color = m_CurrentColor;
+    Key.m_Shadow = ShadowSurf ? Shadow : 0;
+    Key.m_Kerning = m_Kerning;
+    Key.m_Text = Text;
+
+    map<TextKey, list<TextRun>::iterator>::iterator it = m_TextRunLookup.find(Key);
+    if (it == m_TextRunLookup.end()) {
+        // Only measure it the first time, most text that is drawn once is never drawn again
+        TextRun Run;
+        Run.m_Key = Key;
+        Run.m_Bitmap = 0;
+        if (!MeasureGlyphs(Text, Run.m_Width, Run.m_Height) || (long)Run.m_Width * Run.m_Height > MaxTextRunPixels / 8)
+            Run.m_Width = Run.m_Height = 0;
+
+        EvictTextRuns(MaxTextRuns - 1, MaxTextRunPixels);
+        m_TextRuns.push_front(Run);
+        m_TextRunLookup[Key] = m_TextRuns.begin();
+        DrawGlyphs(Bitmap, X, Y, Text, Surf, ShadowSurf);
+        return;
+    }
+
+    // Move to the front as the most recently drawn
+    m_TextRuns.splice(m_TextRuns.begin(), m_TextRuns, it->second);
+    TextRun &Run = m_TextRuns.front();
+
+    // Runs that can't be cached are left with no size
+    if (Run.m_Width <= 0 || Run.m_Height <= 0) {
+        DrawGlyphs(Bitmap, X, Y, Text, Surf, ShadowSurf);
+        return;
+    }
+
+    // Drawn a second time, so render it
+    if (!Run.m_Bitmap) {
+        long Pixels = (long)Run.m_Width * Run.m_Height;
+        EvictTextRuns(MaxTextRuns, MaxTextRunPixels - Pixels);
+
+        GUIBitmap *RunBitmap = m_Screen->CreateBitmap(Run.m_Width, Run.m_Height);
+        if (!RunBitmap || RunBitmap->GetColorDepth() != Surf->GetColorDepth()) {
+            if (RunBitmap) {
+                RunBitmap->Destroy();
+                delete RunBitmap;
+            }
+            Run.m_Width = Run.m_Height = 0;
+            DrawGlyphs(Bitmap, X, Y, Text, Surf, ShadowSurf);
+            return;
+        }
+
+        // Clear it to the same transparent color as the font's background
+        RunBitmap->DrawRectangle(0, 0, Run.m_Width, Run.m_Height, Surf->GetPixel(Surf->GetWidth()-1, 0), true);
+        DrawGlyphs(RunBitmap, 0, 0, Text, Surf, ShadowSurf);
+
+        Run.m_Bitmap = RunBitmap;
+        m_TextRunPixels += Pixels;
+    }
+
+    RECT Rect;
+    SetRect(&Rect, 0, 0, Run.m_Width, Run.m_Height);
+    Run.m_Bitmap->DrawTrans(Bitmap, X, Y, &Rect);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DrawGlyphs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws text to a bitmap one character at a time.
+
+void GUIFont::DrawGlyphs(GUIBitmap *Bitmap, int X, int Y, const std::string &Text, GUIBitmap *Surf, GUIBitmap *ShadowSurf)
+{
+    unsigned char c;
+    int i;
+    RECT Rect;
+    int initX = X;
 
     // Go through every character
     for(i=0; i<Text.length(); i++) {
@@ -188,8 +290,8 @@ void GUIFont::Draw(GUIBitmap *Bitmap, int X, int Y, const std::string Text, Uint
         SetRect(&Rect, offX, offY, offX+CharWidth, offY+m_FontHeight);
 
         // Draw the shadow
-        if (Shadow && FSC)
-            FSC->m_Bitmap->DrawTrans(Bitmap, X+1, Y+1, &Rect);
+        if (ShadowSurf)
+            ShadowSurf->DrawTrans(Bitmap, X+1, Y+1, &Rect);
         // Draw the main color
         Surf->DrawTrans(Bitmap, X, Y, &Rect);
 
@@ -199,12 +301,55 @@ void GUIFont::Draw(GUIBitmap *Bitmap, int X, int Y, const std::string Text, Uint
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MeasureGlyphs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Calculates the size of the area DrawGlyphs touches, shadow included.
+
+bool GUIFont::MeasureGlyphs(const std::string &Text, int &Width, int &Height)
+{
+    unsigned char c;
+    int i;
+    int X = 0;
+    int Y = 0;
+
+    Width = 0;
+    Height = 0;
+
+    // Walk the characters just like DrawGlyphs does
+    for(i=0; i<Text.length(); i++) {
+        c = Text.at(i);
+
+        if (c == '\n') {
+            Y += m_FontHeight;
+            X = 0;
+        }
+        if (c == '\t') {
+            X += m_Characters[' '].m_Width * 4;
+        }
+        if (c < 32 || c >= m_CharIndexCap)
+            continue;
+
+        if (X < 0)
+            return false;
+
+        int CharWidth = m_Characters[c].m_Width;
+        Width = GUI_MAX(Width, X + CharWidth + 1);
+        Height = GUI_MAX(Height, Y + m_FontHeight + 1);
+
+        X += CharWidth + m_Kerning;
+    }
+
+    return true;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          DrawAligned
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Draws text to a bitmap aligned.
 
-void GUIFont::DrawAligned(GUIBitmap *Bitmap, int X, int Y, const std::string Text, int HAlign, int VAlign, int MaxWidth, Uint32 Shadow)
+void GUIFont::DrawAligned(GUIBitmap *Bitmap, int X, int Y, const std::string &Text, int HAlign, int VAlign, int MaxWidth, Uint32 Shadow)
 {
     string TextLine = Text;
     int lineStartPos = 0;
@@ -246,8 +391,8 @@ void GUIFont::DrawAligned(GUIBitmap *Bitmap, int X, int Y, const std::string Tex
                 lineEndPos = lastSpacePos;
                 // Get the new, shorter line
                 TextLine = Text.substr(lineStartPos, lineEndPos - lineStartPos);
-                // Figure the new line width, in pixels
-                lineWidth = CalculateWidth(TextLine);
+                // Figure the new line width, in pixels, without filling the cache with every shortened line
+                lineWidth = MeasureWidth(TextLine);
             }
             while (lineWidth > MaxWidth);
 
@@ -316,7 +461,34 @@ void GUIFont::SetColor(Uint32 Color)
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Calculates the width of a piece of text.
 
-int GUIFont::CalculateWidth(const std::string Text)
+int GUIFont::CalculateWidth(const std::string &Text)
+{
+    TextKey Key;
+    Key.m_Color = 0;
+    Key.m_Shadow = 0;
+    Key.m_Kerning = m_Kerning;
+    Key.m_Text = Text;
+
+    map<TextKey, int>::iterator it = m_WidthCache.find(Key);
+    if (it != m_WidthCache.end())
+        return it->second;
+
+    // Start over rather than grow without end
+    if (m_WidthCache.size() >= MaxMeasurements)
+        m_WidthCache.clear();
+
+    int Width = MeasureWidth(Text);
+    m_WidthCache[Key] = Width;
+    return Width;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MeasureWidth
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Calculates the width of a piece of text without using the cache.
+
+int GUIFont::MeasureWidth(const std::string &Text)
 {
     unsigned char c;
     int i;
@@ -377,11 +549,31 @@ int GUIFont::CalculateWidth(const char Character)
 //                  max width.
 // Arguments:       Text, and the max width.
 
-int GUIFont::CalculateHeight(const std::string Text, int MaxWidth)
+int GUIFont::CalculateHeight(const std::string &Text, int MaxWidth)
 {
     if (Text.empty())
         return 0;
 
+    // Without wrapping it's just the number of lines
+    if (MaxWidth <= 0) {
+        int Height = m_FontHeight;
+        for (string::const_iterator it = Text.begin(); it != Text.end(); it++) {
+            if (*it == '\n')
+                Height += m_FontHeight;
+        }
+        return Height;
+    }
+
+    TextKey Key;
+    Key.m_Color = MaxWidth;
+    Key.m_Shadow = 0;
+    Key.m_Kerning = m_Kerning;
+    Key.m_Text = Text;
+
+    map<TextKey, int>::iterator CacheItr = m_HeightCache.find(Key);
+    if (CacheItr != m_HeightCache.end())
+        return CacheItr->second;
+
     unsigned char c;
     int i;
     int Width = 0;
@@ -422,6 +614,11 @@ int GUIFont::CalculateHeight(const std::string Text, int MaxWidth)
         }
     }
 
+    // Start over rather than grow without end
+    if (m_HeightCache.size() >= MaxMeasurements)
+        m_HeightCache.clear();
+    m_HeightCache[Key] = Height;
+
     return Height;
 }
 
@@ -548,4 +745,40 @@ void GUIFont::Destroy(void)
     }
 
     m_ColorCache.clear();
+
+    ClearTextCache();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ClearTextCache
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys all the cached text runs and measurements.
+
+void GUIFont::ClearTextCache(void)
+{
+    EvictTextRuns(0, 0);
+    m_WidthCache.clear();
+    m_HeightCache.clear();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          EvictTextRuns
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys the least recently drawn text runs until the cache is within
+//                  the given limits.
+
+void GUIFont::EvictTextRuns(int MaxRuns, long MaxPixels)
+{
+    while (!m_TextRuns.empty() && ((int)m_TextRuns.size() > MaxRuns || m_TextRunPixels > MaxPixels)) {
+        TextRun &Oldest = m_TextRuns.back();
+        if (Oldest.m_Bitmap) {
+            m_TextRunPixels -= (long)Oldest.m_Width * Oldest.m_Height;
+            Oldest.m_Bitmap->Destroy();
+            delete Oldest.m_Bitmap;
+        }
+        m_TextRunLookup.erase(Oldest.m_Key);
+        m_TextRuns.pop_back();
+    }
 }
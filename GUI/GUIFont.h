@@ -11,6 +11,9 @@
 //                  www.shplorb.com/~jackal
 
 
+#include <map>
+#include <list>
+
 namespace RTE
 {
 
@@ -56,6 +59,13 @@ public:
         GUIBitmap    *m_Bitmap;
     } FontColor;
 
+    // Limits of the text run and measurement caches
+    enum {
+        MaxTextRuns = 512,
+        MaxTextRunPixels = 512 * 1024,
+        MaxMeasurements = 2048
+    };
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Constructor:     GUIFont
@@ -97,10 +107,12 @@ public:
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          Draw
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Draws text to a bitmap.
+// Description:     Draws text to a bitmap. Text that gets drawn again with the same
+//                  color, shadow and kerning is rendered once into a cached bitmap and
+//                  then drawn with a single blit.
 // Arguments:       Bitmap, Position, Text, Color, Drop-shadow, 0 = none.
 
-    void Draw(GUIBitmap *Bitmap, int X, int Y, const std::string Text, Uint32 Shadow = 0);
+    void Draw(GUIBitmap *Bitmap, int X, int Y, const std::string &Text, Uint32 Shadow = 0);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -109,7 +121,7 @@ public:
 // Description:     Draws text to a bitmap aligned.
 // Arguments:       Bitmap, Position, Text.
 
-    void DrawAligned(GUIBitmap *Bitmap, int X, int Y, const std::string Text, int HAlign, int VAlign = Top, int maxWidth = 0, Uint32 Shadow = 0);
+    void DrawAligned(GUIBitmap *Bitmap, int X, int Y, const std::string &Text, int HAlign, int VAlign = Top, int maxWidth = 0, Uint32 Shadow = 0);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -127,7 +139,7 @@ public:
 // Description:     Calculates the width of a piece of text.
 // Arguments:       Text.
 
-    int CalculateWidth(const std::string Text);
+    int CalculateWidth(const std::string &Text);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -146,7 +158,7 @@ public:
 //                  max width.
 // Arguments:       Text, and the max width. If 0, no wrapping is done.
 
-    int CalculateHeight(const std::string Text, int MaxWidth = 0);
+    int CalculateHeight(const std::string &Text, int MaxWidth = 0);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -195,11 +207,77 @@ public:
     void SetKerning(int newKerning = 1) { m_Kerning = newKerning; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ClearTextCache
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys all the cached text runs and measurements.
+// Arguments:       None.
+
+    void ClearTextCache(void);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Private member variable and method declarations
 
 private:
 
+    // What a cached text run or measurement was made with
+    struct TextKey {
+        Uint32        m_Color;
+        Uint32        m_Shadow;
+        int            m_Kerning;
+        std::string    m_Text;
+
+        bool operator<(const TextKey &rhs) const;
+    };
+
+    // A text run, measured the first time it's drawn and rendered the second
+    struct TextRun {
+        TextKey        m_Key;
+        int            m_Width;
+        int            m_Height;
+        GUIBitmap    *m_Bitmap;
+    };
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DrawGlyphs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws text to a bitmap one character at a time.
+// Arguments:       Bitmap, Position, Text, Font color bitmap, Shadow color bitmap or 0.
+
+    void DrawGlyphs(GUIBitmap *Bitmap, int X, int Y, const std::string &Text, GUIBitmap *Surf, GUIBitmap *ShadowSurf);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MeasureGlyphs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Calculates the size of the area DrawGlyphs touches, shadow included.
+// Arguments:       Text, Width and Height to fill out.
+// Returns:         False if any of the text would be drawn left of the starting point.
+
+    bool MeasureGlyphs(const std::string &Text, int &Width, int &Height);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MeasureWidth
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Calculates the width of a piece of text without using the cache.
+// Arguments:       Text.
+
+    int MeasureWidth(const std::string &Text);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          EvictTextRuns
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys the least recently drawn text runs until the cache is within
+//                  the given limits.
+// Arguments:       Max number of runs, Max number of pixels of rendered runs.
+
+    void EvictTextRuns(int MaxRuns, long MaxPixels);
+
+
     GUIBitmap        *m_Font;
     GUIScreen        *m_Screen;
     std::vector<FontColor >    m_ColorCache;
@@ -215,6 +293,15 @@ private:
 
     int                m_Kerning;            // Spacing between characters
     int                m_Leading;            // Spacing between lines
+
+    // Text runs, most recently drawn first, and their lookup
+    std::list<TextRun>    m_TextRuns;
+    std::map<TextKey, std::list<TextRun>::iterator>    m_TextRunLookup;
+    // Pixels taken up by the rendered text runs
+    long            m_TextRunPixels;
+    // Cached CalculateWidth and CalculateHeight results, the key color holds the max width
+    std::map<TextKey, int>    m_WidthCache;
+    std::map<TextKey, int>    m_HeightCache;
 };
 
 
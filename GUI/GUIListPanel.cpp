@@ -325,14 +325,10 @@ void GUIListPanel::BuildBitmap(bool UpdateBase, bool UpdateText)
         m_Skin->BuildStandardRect(m_FrameBitmap, "Listbox", 0, 0, m_Width, m_Height, false, true);
     }
 
-    if (UpdateText) {
-        m_BaseBitmap->Draw(m_DrawBitmap, 0, 0, 0);
-
-        // Draw the text onto the drawing bitmap
-        BuildDrawBitmap();
-
-        m_FrameBitmap->DrawTrans(m_DrawBitmap, 0, 0, 0);
-    }
+    // Leave redrawing the items to the next Draw, so any number of changes between two frames
+    // only cost one redraw, and a list that doesn't change costs nothing but the blit
+    if (UpdateText)
+        Invalidate();
 }
 
 
@@ -476,6 +472,16 @@ void GUIListPanel::BuildDrawBitmap(void)
 
 void GUIListPanel::Draw(GUIScreen *Screen)
 {
+    // Redraw the items if anything changed since the last time
+    if (!IsValid()) {
+        m_BaseBitmap->Draw(m_DrawBitmap, 0, 0, 0);
+
+        // Draw the text onto the drawing bitmap
+        BuildDrawBitmap();
+
+        m_FrameBitmap->DrawTrans(m_DrawBitmap, 0, 0, 0);
+    }
+
     // Draw the base
     m_DrawBitmap->Draw(Screen->GetBitmap(), m_X, m_Y, 0);
 
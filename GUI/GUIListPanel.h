@@ -509,7 +509,7 @@ protected:
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          BuildBitmap
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Build the bitmap.
+// Description:     Build the bitmap. Redrawing the items is left to the next Draw.
 // Arguments:       UpdateBase, UpdateText.
 
     void BuildBitmap(bool UpdateBase, bool UpdateText);
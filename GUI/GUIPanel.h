@@ -151,7 +151,8 @@ public:
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          Invalidate
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Invalidates the panel
+// Description:     Invalidates the panel, so panels that keep their drawing in a bitmap
+//                  rebuild it before they're next drawn.
 // Arguments:       None.
 
     void Invalidate(void);
@@ -38,6 +38,7 @@
 #include <algorithm>
 #include <string>
 #include <list>
+#include <fstream>
 
 #include "Reader.h"
 #include "Writer.h"
@@ -150,6 +151,18 @@ int g_StationOffsetX, g_StationOffsetY;
 
 std::string g_LoadSingleModule = "";
 
+// Benchmark mode settings, all set from the command line. Benchmark mode is only active if the update count is above 0
+int g_BenchmarkUpdates = 0;
+unsigned int g_BenchmarkSeed = 0;
+std::string g_BenchmarkScene = "";
+std::string g_BenchmarkActivityType = "";
+std::string g_BenchmarkActivityName = "";
+std::string g_BenchmarkScript = "";
+std::string g_BenchmarkOutput = "Benchmark.ini";
+// Input log to play back in place of the benchmark setup, and whether to draw while doing so
+std::string g_ReplayPath = "";
+bool g_ReplayDraw = false;
+
 MainMenuGUI *g_pMainMenuGUI = 0;
 ScenarioGUI *g_pScenarioGUI = 0;
 GUIControlManager *g_pLoadingGUI = 0;
@@ -242,7 +255,11 @@ void _LoadingSplashProgressReport(std::string reportString, bool newItem = false
 
         // Quit if we're commanded to during loading
         if (g_Quit)
+        {
+            // The presentation thread may still be running from before the load
+            g_FrameMan.StopPresent();
             exit(0);
+        }
     }
 }
 
@@ -324,11 +341,31 @@ void LoadingSplashProgressReport(std::string reportString, bool newItem = false)
 
 		// Quit if we're commanded to during loading
 		if (g_Quit)
+		{
+			g_FrameMan.StopPresent();
 			exit(0);
+		}
 	}
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// This gets called while a Scene is loading, to report on it and keep things serviced meanwhile.
+// Scenes load in the middle of a frame, with the pathfinding being built in the background, so
+// unlike the loading splash this leaves the screen, input, loading log and quitting alone
+
+void SceneLoadProgressReport(std::string reportString, bool newItem = false)
+{
+	// Only the start of each stage is worth a line in the console (which also echoes it to the command line if logging there)
+	if (newItem)
+		g_ConsoleMan.PrintString(reportString);
+
+	// Keep taking in what the clients send while the scene loads, it gets acted on once the loading is done
+	if (g_NetworkServer.IsServerModeEnabled())
+		g_NetworkServer.KeepAlive();
+}
+
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Finding and loading all DataModule:s
@@ -1105,9 +1142,9 @@ bool PlayIntroTitle()
         g_ConsoleMan.Update();
 
 #if __USE_SOUND_GORILLA
-		g_FrameMan.StartPerformanceMeasurement(FrameMan::PERF_SOUND);
+		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_SOUND);
 		g_AudioMan.Update();
-		g_FrameMan.StopPerformanceMeasurement(FrameMan::PERF_SOUND);
+		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_SOUND);
 #endif
 
         if (sectionSwitch)
@@ -2380,12 +2417,12 @@ bool RunGameLoop()
             {
 				serverUpdated = false;
                 SLICK_PROFILENAME("Simulation Update", 0xFFFFFF00);
-				g_FrameMan.NewPerformanceSample();
+				g_PerformanceMan.NewPerformanceSample();
 
                 // Advance the simulation time by the fixed amount
                 g_TimerMan.UpdateSim();
 
-				g_FrameMan.StartPerformanceMeasurement(FrameMan::PERF_SIM_TOTAL);
+				g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_SIM_TOTAL);
 				g_UInputMan.Update();
 				// It is vital that server is updated after input manager but before activity because unput manager will clear 
 				// received pressed and released events on next update.
@@ -2397,15 +2434,15 @@ bool RunGameLoop()
 				g_FrameMan.Update();
 				g_AudioMan.Update();
 				g_LuaMan.Update();
-				g_FrameMan.StartPerformanceMeasurement(FrameMan::PERF_ACTIVITY);
+				g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTIVITY);
 				g_ActivityMan.Update();
-				g_FrameMan.StopPerformanceMeasurement(FrameMan::PERF_ACTIVITY);
+				g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ACTIVITY);
 				g_MovableMan.Update();
 
 				g_ActivityMan.LateUpdateGlobalScripts();
 
 				g_ConsoleMan.Update();
-				g_FrameMan.StopPerformanceMeasurement(FrameMan::PERF_SIM_TOTAL);
+				g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_SIM_TOTAL);
 
                 if (!g_InActivity)
                 {
@@ -2423,11 +2460,14 @@ bool RunGameLoop()
 						else
 							g_IntroState = MAINTOSCENARIO;
 					}
+					// The menus draw straight to the 32bpp buffer, so get any pipelined frame out of the way
+					g_FrameMan.FlushPresent();
 					PlayIntroTitle();
                 }
                 // Resetting the simulation
                 if (g_ResetActivity)
                 {
+                    g_FrameMan.FlushPresent();
                     // Reset and quit if user quit during reset loading
                     if (!ResetActivity())
                         break;
@@ -2489,6 +2529,231 @@ bool RunGameLoop()
     return true;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Sets up the activity recorded in an input log to be started exactly as it was
+
+bool SetupReplayActivity()
+{
+    InputRecorder &recorder = g_UInputMan.GetInputRecorder();
+    if (!recorder.StartReplay(g_ReplayPath))
+    {
+        g_ConsoleMan.PrintString("ERROR: Could not read input log " + g_ReplayPath + "!");
+        return false;
+    }
+
+    // Read the start activity back in exactly as it was saved when the recording started
+    const InputRecorder::SessionInfo &session = recorder.GetSession();
+    string activityPath = InputRecorder::GetActivityFilePath(session);
+    {
+        std::ofstream activityFile(activityPath.c_str());
+        activityFile << session.m_ActivityData;
+    }
+    Activity *pActivity = 0;
+    const Entity::ClassInfo *pClass = Entity::ClassInfo::GetClass(session.m_ActivityClass);
+    Entity *pEntity = pClass ? pClass->NewInstance() : 0;
+    if (pEntity)
+    {
+        Reader reader(activityPath.c_str(), false, 0, true);
+        if (reader.IsOK() && pEntity->Create(reader) >= 0)
+            pActivity = dynamic_cast<Activity *>(pEntity);
+        if (!pActivity)
+            delete pEntity;
+    }
+    delete_file(activityPath.c_str());
+    if (!pActivity)
+    {
+        g_ConsoleMan.PrintString("ERROR: Couldn't read the " + session.m_ActivityClass + " named " + session.m_ActivityName + " recorded in " + g_ReplayPath + "!");
+        return false;
+    }
+    g_ActivityMan.SetStartActivity(pActivity);
+
+    if (!session.m_SceneName.empty())
+        g_SceneMan.SetSceneToLoad(session.m_SceneName, session.m_PlaceObjects, session.m_PlaceUnits);
+    g_TimerMan.SetDeltaTimeSecs(session.m_DeltaTimeSecs);
+    g_ActivityMan.SetActivitySeed(session.m_Seed);
+
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Headless benchmark run: a fixed number of fixed-delta sim updates with a fixed seed and
+// no rendering, with the per-phase timings dumped to a file when done. When replaying an
+// input log, the log decides the setup and runs until it's out of updates instead.
+
+bool RunBenchmark()
+{
+    bool replay = !g_ReplayPath.empty();
+    if (replay)
+    {
+        if (!SetupReplayActivity())
+        {
+            g_ConsoleMan.SaveAllText("LogConsole.txt");
+            return false;
+        }
+    }
+    else
+    {
+        if (!g_BenchmarkScene.empty())
+            g_SceneMan.SetSceneToLoad(g_BenchmarkScene);
+        if (!g_BenchmarkActivityName.empty())
+        {
+            g_ActivityMan.SetDefaultActivityType(g_BenchmarkActivityType);
+            g_ActivityMan.SetDefaultActivityName(g_BenchmarkActivityName);
+        }
+
+        // Seed the activity so everything it places comes out the same every run
+        g_ActivityMan.SetActivitySeed(g_BenchmarkSeed);
+    }
+    if (!ResetActivity())
+    {
+        g_ConsoleMan.PrintString("ERROR: Benchmark activity failed to start!");
+        g_ConsoleMan.SaveAllText("LogConsole.txt");
+        return false;
+    }
+
+    // The scripted spawns for the benchmark scenario
+    if (!g_BenchmarkScript.empty() && g_LuaMan.RunScriptFile(g_BenchmarkScript) < 0)
+    {
+        g_ConsoleMan.PrintString("ERROR: Benchmark script " + g_BenchmarkScript + " failed to run!");
+        g_ConsoleMan.SaveAllText("LogConsole.txt");
+        return false;
+    }
+
+    long peakActors = 0;
+    long peakItems = 0;
+    long peakParticles = 0;
+
+    g_TimerMan.PauseSim(false);
+    // Throw away whatever was measured while starting the activity
+    g_PerformanceMan.NewPerformanceSample();
+    g_PerformanceMan.ResetStatistics();
+    int64_t startTime = g_TimerMan.GetAbsoulteTime();
+
+    InputRecorder &recorder = g_UInputMan.GetInputRecorder();
+    int update = 0;
+    for (; (replay ? recorder.IsReplaying() && (g_BenchmarkUpdates <= 0 || update < g_BenchmarkUpdates) : update < g_BenchmarkUpdates) && !g_Quit; ++update)
+    {
+        // Always advance by exactly one delta time, no matter how long the last update actually took
+        g_TimerMan.UpdateSimFixed();
+
+        g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_SIM_TOTAL);
+        if (replay)
+        {
+            g_UInputMan.Update();
+            // Feed the network input that arrived during this update the same way the server did
+            const std::vector<InputRecorder::InputEvent> &events = recorder.GetReplayEvents();
+            for (std::vector<InputRecorder::InputEvent>::const_iterator eItr = events.begin(); eItr != events.end(); ++eItr)
+            {
+                if (eItr->m_Type == InputRecorder::EVENT_NETWORKINPUT && eItr->m_Data.size() == sizeof(NetworkClient::MsgInput))
+                {
+                    NetworkClient::MsgInput msg;
+                    memcpy(&msg, &eItr->m_Data[0], sizeof(msg));
+                    g_NetworkServer.ProcessInputMessage(eItr->m_Player, msg);
+                }
+            }
+        }
+        g_FrameMan.Update();
+        g_LuaMan.Update();
+        g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTIVITY);
+        g_ActivityMan.Update();
+        g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ACTIVITY);
+        g_MovableMan.Update();
+        g_ActivityMan.LateUpdateGlobalScripts();
+        g_ConsoleMan.Update();
+        g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_SIM_TOTAL);
+
+        if (replay && g_ReplayDraw)
+        {
+            g_FrameMan.Draw();
+            g_FrameMan.FlipFrameBuffers();
+        }
+
+        g_PerformanceMan.NewPerformanceSample();
+
+        peakActors = std::max(peakActors, g_MovableMan.GetActorCount());
+        peakItems = std::max(peakItems, g_MovableMan.GetItemCount());
+        peakParticles = std::max(peakParticles, g_MovableMan.GetParticleCount());
+    }
+
+    int64_t totalTime = g_TimerMan.GetAbsoulteTime() - startTime;
+
+    // Dump the results in the same format as all other data files, so they're easy to pick apart by tools
+    Writer writer(g_BenchmarkOutput);
+    if (!writer.WriterOK())
+    {
+        g_ConsoleMan.PrintString("ERROR: Could not write benchmark results to " + g_BenchmarkOutput + "!");
+        return false;
+    }
+
+    writer.ObjectStart("Benchmark");
+    writer.NewProperty("Scene");
+    writer << (g_SceneMan.GetScene() ? g_SceneMan.GetScene()->GetPresetName() : std::string("None"));
+    writer.NewProperty("Activity");
+    writer << (g_ActivityMan.GetActivity() ? g_ActivityMan.GetActivity()->GetPresetName() : std::string("None"));
+    if (replay)
+    {
+        writer.NewProperty("Replay");
+        writer << g_ReplayPath;
+    }
+    writer.NewProperty("Seed");
+    writer << g_ActivityMan.GetActivitySeed();
+    writer.NewProperty("SimUpdates");
+    writer << update;
+    writer.NewProperty("DeltaTimeMS");
+    writer << g_TimerMan.GetDeltaTimeMS();
+    writer.NewProperty("RealTimeMS");
+    writer << (double)totalTime / 1000.0;
+    writer.NewProperty("UpdatesPerSecond");
+    writer << (totalTime > 0 ? (double)update * 1000000.0 / (double)totalTime : 0.0);
+    writer.NewProperty("ActorCount");
+    writer << g_MovableMan.GetActorCount();
+    writer.NewProperty("ItemCount");
+    writer << g_MovableMan.GetItemCount();
+    writer.NewProperty("ParticleCount");
+    writer << g_MovableMan.GetParticleCount();
+    writer.NewProperty("PeakActorCount");
+    writer << peakActors;
+    writer.NewProperty("PeakItemCount");
+    writer << peakItems;
+    writer.NewProperty("PeakParticleCount");
+    writer << peakParticles;
+    writer.NewProperty("StateHash");
+    writer << g_MovableMan.GetSimStateHash();
+    for (int pc = 0; pc < g_PerformanceMan.GetCounterCount(); ++pc)
+    {
+        writer.NewProperty("AddCounter");
+        writer.ObjectStart("PerformanceCounter");
+        writer.NewProperty("Name");
+        writer << g_PerformanceMan.GetCounterName(pc);
+        if (g_PerformanceMan.GetCounterParent(pc) >= 0)
+        {
+            writer.NewProperty("Parent");
+            writer << g_PerformanceMan.GetCounterName(g_PerformanceMan.GetCounterParent(pc));
+        }
+        writer.NewProperty("TotalMS");
+        writer << (double)g_PerformanceMan.GetPerformanceCounterTotal(pc) / 1000.0;
+        writer.NewProperty("AverageMS");
+        writer << (update > 0 ? (double)g_PerformanceMan.GetPerformanceCounterTotal(pc) / 1000.0 / (double)update : 0.0);
+        writer.NewProperty("MinMS");
+        writer << (double)g_PerformanceMan.GetPerformanceCounterMin(pc) / 1000.0;
+        writer.NewProperty("MaxMS");
+        writer << (double)g_PerformanceMan.GetPerformanceCounterMax(pc) / 1000.0;
+        writer.NewProperty("P50MS");
+        writer << (double)g_PerformanceMan.GetPerformanceCounterPercentile(pc, 50) / 1000.0;
+        writer.NewProperty("P99MS");
+        writer << (double)g_PerformanceMan.GetPerformanceCounterPercentile(pc, 99) / 1000.0;
+        writer.ObjectEnd();
+    }
+    writer.ObjectEnd();
+
+    g_ConsoleMan.PrintString("Benchmark results written to " + g_BenchmarkOutput);
+    g_ConsoleMan.SaveAllText("LogConsole.txt");
+
+    return true;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Command-line argument handling, returns false if app should quit right after this
 // The appExitVar is what the program should exit with if this returns false
@@ -2511,6 +2776,11 @@ bool HandleMainArgs(int argc, char *argv[], int &appExitVar)
             {
                 g_LogToCli = true;
             }
+            // Draw every update of a replay, to profile the rendering too
+            else if (strcmp(argv[i], "-replaydraw") == 0)
+            {
+                g_ReplayDraw = true;
+            }
             else if (i + 1 < argc)
             {
                 if (strcmp(argv[i], "-server") == 0 && i + 1 < argc)
@@ -2523,6 +2793,42 @@ bool HandleMainArgs(int argc, char *argv[], int &appExitVar)
                 {
                     g_LoadSingleModule = argv[++i];
                 }
+                // Headless benchmark mode, runs the given number of sim updates and quits
+                else if (strcmp(argv[i], "-benchmark") == 0 && i + 1 < argc)
+                {
+                    g_BenchmarkUpdates = atoi(argv[++i]);
+                }
+                else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+                {
+                    g_BenchmarkSeed = strtoul(argv[++i], 0, 10);
+                }
+                else if (strcmp(argv[i], "-scene") == 0 && i + 1 < argc)
+                {
+                    g_BenchmarkScene = argv[++i];
+                }
+                else if (strcmp(argv[i], "-activity") == 0 && i + 2 < argc)
+                {
+                    g_BenchmarkActivityType = argv[++i];
+                    g_BenchmarkActivityName = argv[++i];
+                }
+                else if (strcmp(argv[i], "-benchmarkscript") == 0 && i + 1 < argc)
+                {
+                    g_BenchmarkScript = argv[++i];
+                }
+                else if (strcmp(argv[i], "-benchmarkout") == 0 && i + 1 < argc)
+                {
+                    g_BenchmarkOutput = argv[++i];
+                }
+                // Log the input of every activity started to a file
+                else if (strcmp(argv[i], "-record") == 0 && i + 1 < argc)
+                {
+                    g_UInputMan.GetInputRecorder().SetRecordPath(argv[++i]);
+                }
+                // Headless replay of an input log as fast as possible, benchmarking it like above
+                else if (strcmp(argv[i], "-replay") == 0 && i + 1 < argc)
+                {
+                    g_ReplayPath = argv[++i];
+                }
             }
         }
     }
@@ -2598,6 +2904,7 @@ int main(int argc, char *argv[])
     new LuaMan();
     new SettingsMan();
     new TimerMan();
+    new PerformanceMan();
     new PresetMan();
     new FrameMan();
     new AudioMan();
@@ -2633,6 +2940,7 @@ int main(int argc, char *argv[])
     if (!HandleMainArgs(argc, argv, exitVar))
         return exitVar;
     g_TimerMan.Create();
+    g_PerformanceMan.Create();
     g_PresetMan.Create();
     g_FrameMan.Create();
     g_AudioMan.Create();
@@ -2643,6 +2951,9 @@ int main(int argc, char *argv[])
     g_ActivityMan.Create();
     g_MovableMan.Create();
     g_MetaMan.Create();
+    MOSRotating::SetRotatedSpriteCacheBudget((long)g_SettingsMan.GetRotatedSpriteCacheMegabytes() * 1024 * 1024);
+    g_LuaMan.SetParallelScriptThreads(g_SettingsMan.GetParallelScriptThreads());
+    g_SceneMan.SetLoadProgressCallback(&SceneLoadProgressReport);
 
 	// [CHRISK] STEAM SUPPORT
 #if defined(STEAM_BUILD)
@@ -2700,20 +3011,27 @@ int main(int argc, char *argv[])
 	}
 
     InitMainMenu();
-    if (g_SettingsMan.PlayIntro() && !g_NetworkServer.IsServerModeEnabled())
-        PlayIntroTitle();
 
-	// NETWORK Create multiplayer lobby activity to start as default if server is running
-	if (g_NetworkServer.IsServerModeEnabled())
-	{
-		EnterMultiplayerLobby();
-	}
+    // Benchmark and replay modes skip the menus entirely and quit as soon as the run is done
+    if (g_BenchmarkUpdates > 0 || !g_ReplayPath.empty())
+        exitVar = RunBenchmark() ? 0 : 2;
+    else
+    {
+        exitVar = 0;
 
-    // If we fail to start/reset the activity, then revert to the intro/menu
-    if (!ResetActivity())
-        PlayIntroTitle();
+        if (g_SettingsMan.PlayIntro() && !g_NetworkServer.IsServerModeEnabled())
+            PlayIntroTitle();
+
+        // NETWORK Create multiplayer lobby activity to start as default if server is running
+        if (g_NetworkServer.IsServerModeEnabled())
+            EnterMultiplayerLobby();
+
+        // If we fail to start/reset the activity, then revert to the intro/menu
+        if (!ResetActivity())
+            PlayIntroTitle();
 	
-    RunGameLoop();
+        RunGameLoop();
+    }
 
     ///////////////////////////////////////////////////////////////////
     // Clean up
@@ -2735,9 +3053,11 @@ int main(int argc, char *argv[])
     g_PresetMan.Destroy();
     g_UInputMan.Destroy();
     g_FrameMan.Destroy();
+    g_PerformanceMan.Destroy();
     g_TimerMan.Destroy();
     g_SettingsMan.Destroy();
     g_LuaMan.Destroy();
+    MOSRotating::ClearRotatedSpriteCache();
     ContentFile::FreeAllLoaded();
     g_ConsoleMan.Destroy();
 
@@ -2761,6 +3081,6 @@ int main(int argc, char *argv[])
 	OsxUtil::Destroy();
 #endif // defined(__APPLE__)
 	
-    return 0;
+    return exitVar;
 }
 END_OF_MAIN();
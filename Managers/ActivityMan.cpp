@@ -25,6 +25,8 @@
 #include "AHuman.h"
 #include "ACRocket.h"
 #include "HeldDevice.h"
+#include "TimerMan.h"
+#include "Writer.h"
 
 #include "GUI/GUI.h"
 #include "GUI/GUIFont.h"
@@ -32,6 +34,7 @@
 
 #include "BuyMenuGUI.h"
 #include "SceneEditorGUI.h"
+#include <fstream>
 
 extern bool g_ResetActivity;
 extern bool g_ResumeActivity;
@@ -374,6 +377,14 @@ int Activity::ReadProperty(std::string propName, Reader &reader)
         reader >> m_TeamIcons[TEAM_3];
     else if (propName == "Team4Icon")
         reader >> m_TeamIcons[TEAM_4];
+    else if (propName == "Team1AISkill")
+        reader >> m_TeamAISkillLevels[TEAM_1];
+    else if (propName == "Team2AISkill")
+        reader >> m_TeamAISkillLevels[TEAM_2];
+    else if (propName == "Team3AISkill")
+        reader >> m_TeamAISkillLevels[TEAM_3];
+    else if (propName == "Team4AISkill")
+        reader >> m_TeamAISkillLevels[TEAM_4];
 	else if (propName == "CraftsOrbitAtTheEdge")
 		reader >> m_CraftsOrbitAtTheEdge;
     else
@@ -482,6 +493,8 @@ int Activity::Save(Writer &writer) const
         writer << m_TeamNames[TEAM_1];
         writer.NewProperty("Team1Icon");
         m_TeamIcons[TEAM_1].SavePresetCopy(writer);
+        writer.NewProperty("Team1AISkill");
+        writer << m_TeamAISkillLevels[TEAM_1];
     }
     if (m_TeamActive[Activity::TEAM_2])
     {
@@ -491,6 +504,8 @@ int Activity::Save(Writer &writer) const
         writer << m_TeamNames[TEAM_2];
         writer.NewProperty("Team2Icon");
         m_TeamIcons[TEAM_2].SavePresetCopy(writer);
+        writer.NewProperty("Team2AISkill");
+        writer << m_TeamAISkillLevels[TEAM_2];
     }
     if (m_TeamActive[Activity::TEAM_3])
     {
@@ -500,6 +515,8 @@ int Activity::Save(Writer &writer) const
         writer << m_TeamNames[TEAM_3];
         writer.NewProperty("Team3Icon");
         m_TeamIcons[TEAM_3].SavePresetCopy(writer);
+        writer.NewProperty("Team3AISkill");
+        writer << m_TeamAISkillLevels[TEAM_3];
     }
     if (m_TeamActive[Activity::TEAM_4])
     {
@@ -509,6 +526,8 @@ int Activity::Save(Writer &writer) const
         writer << m_TeamNames[TEAM_4];
         writer.NewProperty("Team4Icon");
         m_TeamIcons[TEAM_4].SavePresetCopy(writer);
+        writer.NewProperty("Team4AISkill");
+        writer << m_TeamAISkillLevels[TEAM_4];
     }
 
     return 0;
@@ -1643,6 +1662,8 @@ void ActivityMan::Clear()
     m_pActivity = 0;
     m_LastMusicPath = "";
     m_LastMusicPos = 0;
+    m_ActivitySeed = 0;
+    m_FixedActivitySeed = false;
 }
 
 
@@ -1720,11 +1741,50 @@ int ActivityMan::StartActivity(Activity *pActivity)
     m_pActivity = dynamic_cast<Activity *>(m_pStartActivity->Clone());
     // Setup the players
     m_pActivity->SetupPlayers();
+    // The log of the activity being replaced ends here, so nothing polled while the new one loads gets logged as a frame of it
+    InputRecorder &recorder = g_UInputMan.GetInputRecorder();
+    if (recorder.IsRecording())
+        recorder.Stop();
+    // Restart all the random streams, so everything the activity does from here on follows from the one seed
+    if (!m_FixedActivitySeed)
+        m_ActivitySeed = (unsigned int)time(0);
+    SeedRand(m_ActivitySeed);
     // and START THAT BITCH
     error = m_pActivity->Start();
 
     if (error >= 0)
+    {
         g_ConsoleMan.PrintString("SYSTEM: Activity \"" + m_pActivity->GetPresetName() + "\" was successfully started");
+
+        // Log the input of the whole activity if asked to, along with everything needed to start it again the same way
+        if (!recorder.GetRecordPath().empty() && !recorder.IsReplaying())
+        {
+            InputRecorder::SessionInfo session;
+            session.m_Seed = m_ActivitySeed;
+            session.m_DeltaTimeSecs = g_TimerMan.GetDeltaTimeSecs();
+            session.m_SceneName = g_SceneMan.GetScene() ? g_SceneMan.GetScene()->GetPresetName() : "";
+            session.m_PlaceObjects = g_SceneMan.GetPlaceObjectsOnLoad();
+            session.m_PlaceUnits = g_SceneMan.GetPlaceUnitsOnLoad();
+            session.m_ActivityClass = m_pStartActivity->GetClassName();
+            session.m_ActivityName = m_pStartActivity->GetPresetName();
+            // The whole start activity goes into the log, so every setting the setup screens made on it comes back on replay
+            session.m_ActivityModule = g_PresetMan.GetDataModuleName(max(0, m_pStartActivity->GetModuleID()));
+            string activityPath = InputRecorder::GetActivityFilePath(session);
+            {
+                Writer writer(activityPath.c_str());
+                writer << m_pStartActivity;
+            }
+            ifstream activityFile(activityPath.c_str());
+            session.m_ActivityData.assign(istreambuf_iterator<char>(activityFile), istreambuf_iterator<char>());
+            activityFile.close();
+            delete_file(activityPath.c_str());
+
+            if (!session.m_ActivityData.empty() && recorder.StartRecording(session))
+                g_ConsoleMan.PrintString("SYSTEM: Recording input to " + recorder.GetRecordPath());
+            else
+                g_ConsoleMan.PrintString("ERROR: Could not record input to " + recorder.GetRecordPath() + "!");
+        }
+    }
     else
     {
         g_ConsoleMan.PrintString("ERROR: Activity \"" + m_pActivity->GetPresetName() + "\" was NOT started due to errors!");
@@ -1372,6 +1372,38 @@ public:
     std::string GetDefaultActivityName() const { return m_DefaultActivityName; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetActivitySeed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes every activity started from now on seed the random streams
+//                  with a specific value, so that it plays out the same each time.
+// Arguments:       The seed to start activities with.
+// Return value:    None.
+
+    void SetActivitySeed(unsigned int seed) { m_ActivitySeed = seed; m_FixedActivitySeed = true; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ClearActivitySeed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Goes back to starting each activity with a fresh seed from the clock.
+// Arguments:       None.
+// Return value:    None.
+
+    void ClearActivitySeed() { m_FixedActivitySeed = false; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetActivitySeed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the seed the current activity was started with, so that it can
+//                  be started again the exact same way.
+// Arguments:       None.
+// Return value:    The seed of the current activity.
+
+    unsigned int GetActivitySeed() const { return m_ActivitySeed; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          SetStartActivity
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1518,6 +1550,10 @@ protected:
     std::string m_LastMusicPath;
     // What the last position of the in-game music track was before pause, in seconds
     double m_LastMusicPos;
+    // The seed the random streams were started with when the current activity started
+    unsigned int m_ActivitySeed;
+    // Whether m_ActivitySeed should be reused for every activity start instead of a fresh one
+    bool m_FixedActivitySeed;
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Private member variable and method declarations
@@ -12,6 +12,8 @@
 // Inclusions of header files
 
 #include <mutex>
+#include <thread>
+#include <condition_variable>
 
 #include "FrameMan.h"
 #include "PresetMan.h"
@@ -20,6 +22,7 @@
 #include "AudioMan.h"
 #include "SceneMan.h"
 #include "SettingsMan.h"
+#include "PerformanceMan.h"
 #include "BuyMenuGUI.h"
 #include "SceneEditorGUI.h"
 #include "MovableMan.h"
@@ -40,6 +43,10 @@
 
 // I know this is a crime, but if I include it in FrameMan.h the whole thing will collapse due to int redefinitions in Allegro
 std::mutex ScreenRelativeEffectsMutex[MAXSCREENCOUNT];
+// Same goes for the presentation thread and what guards the frame handoff to it
+std::thread PresentThread;
+std::mutex PresentMutex;
+std::condition_variable PresentCondition;
 
 using std::list;
 using std::pair;
@@ -417,6 +424,15 @@ void FrameMan::Clear()
     m_NewNxFullscreen = 1;
     m_PostProcessing = false;
     m_PostPixelGlow = false;
+    m_PipelinedPresent = false;
+    m_pPresentBuffer8 = 0;
+    m_PresentScreenEffects.clear();
+    m_PresentGlowBoxes.clear();
+    m_PresentPrimed = false;
+    m_PresentStaged = false;
+    m_PresentPending = false;
+    m_PresentThreadQuit = false;
+    m_GlowRandom.Seed(0, 0);
     m_pYellowGlow = 0;
     m_YellowGlowHash = 0;
     m_pRedGlow = 0;
@@ -667,30 +683,6 @@ int FrameMan::Create()
         m_PlayerScreenHeight = m_pPlayerScreen->h;
     }
 
-	m_Sample = 0;
-
-	for (int c = 0; c < PERF_COUNT; ++c)
-	{
-		for (int i = 0; i < MAXSAMPLES; ++i)
-		{
-			m_PerfData[c][i] = 0;
-			m_PerfPercentages[c][i] = 0;
-		}
-		m_PerfMeasureStart[c] = 0;
-		m_PerfMeasureStop[c] = 0;
-	}
-
-	//Set up performance counter's names
-	m_PerfCounterNames[PERF_SIM_TOTAL] = "Total";
-	m_PerfCounterNames[PERF_ACTORS_PASS1] = "Act Travel";
-    m_PerfCounterNames[PERF_PARTICLES_PASS1] = "Prt Travel";
-	m_PerfCounterNames[PERF_ACTORS_PASS2] = "Act Update";
-    m_PerfCounterNames[PERF_PARTICLES_PASS2] = "Prt Update";
-	m_PerfCounterNames[PERF_ACTORS_AI] = "Act AI";
-    m_PerfCounterNames[PERF_ACTIVITY] = "Activity";
-#if __USE_SOUND_GORILLA
-	m_PerfCounterNames[PERF_SOUND] = "Sound";
-#endif
     return 0;
 }
 
@@ -763,6 +755,8 @@ int FrameMan::ReadProperty(std::string propName, Reader &reader)
         reader >> m_PostProcessing;
     else if (propName == "PostPixelGlow")
         reader >> m_PostPixelGlow;
+    else if (propName == "PipelinedPresent")
+        reader >> m_PipelinedPresent;
     else if (propName == "PixelsPerMeter")
     {
         reader >> m_PPM;
@@ -858,6 +852,8 @@ int FrameMan::Save(Writer &writer) const
     writer << m_PostProcessing;
     writer.NewProperty("PostPixelGlow");
     writer << m_PostPixelGlow;
+    writer.NewProperty("PipelinedPresent");
+    writer << m_PipelinedPresent;
     writer.NewProperty("PixelsPerMeter");
     writer << m_PPM;
     writer.NewProperty("HSplitScreen");
@@ -876,7 +872,11 @@ int FrameMan::Save(Writer &writer) const
 
 void FrameMan::Destroy()
 {
+    // Stop the presentation thread before pulling the buffers out from under it
+    StopPresent();
+
     destroy_bitmap(m_pBackBuffer8);
+    destroy_bitmap(m_pPresentBuffer8);
 	for (int i = 0; i < MAXSCREENCOUNT; i++)
 	{
 		for (int f = 0; f < 2; f++)
@@ -1506,6 +1506,27 @@ int FrameMan::SwitchWindowMultiplier(int multiplier)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          QuadHasGlowColor
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Checks four packed 8bpp pixels at once for any of the palette indices
+//                  that PostProcess puts glows on, using the classic SWAR zero-byte test.
+
+static inline bool QuadHasGlowColor(unsigned int quad)
+{
+    // A byte of (quad ^ color) is zero wherever the pixel equals the color
+    unsigned int yellow = quad ^ (0x01010101U * g_YellowGlowColor);
+    unsigned int yellow98 = quad ^ (0x01010101U * 98);
+    unsigned int yellow120 = quad ^ (0x01010101U * 120);
+    unsigned int blue = quad ^ (0x01010101U * 166);
+
+    return (((yellow - 0x01010101U) & ~yellow) |
+            ((yellow98 - 0x01010101U) & ~yellow98) |
+            ((yellow120 - 0x01010101U) & ~yellow120) |
+            ((blue - 0x01010101U) & ~blue)) & 0x80808080U;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          PostProcess
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1513,62 +1534,132 @@ int FrameMan::SwitchWindowMultiplier(int multiplier)
 //                  processing effects on top like glows etc. Only works in 32bpp mode.
 
 void FrameMan::PostProcess()
+{
+    PostProcessFrame(m_pBackBuffer8, m_PostScreenEffects, m_PostScreenGlowBoxes);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DrawScreenBlended
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws a sprite onto a 32bpp memory bitmap with the same result as
+//                  draw_trans_sprite under set_screen_blender(strength, ...), but without
+//                  touching Allegro's blender state. That is global, and the main thread
+//                  keeps drawing with its own blenders while the presentation thread runs.
+
+static void DrawScreenBlended(BITMAP *pTarget, BITMAP *pSprite, int posX, int posY, int strength)
+{
+    int startX = MAX(pTarget->cl - posX, 0);
+    int startY = MAX(pTarget->ct - posY, 0);
+    int endX = MIN(pTarget->cr - posX, pSprite->w);
+    int endY = MIN(pTarget->cb - posY, pSprite->h);
+    bool sprite32 = bitmap_color_depth(pSprite) == 32;
+    unsigned long n = strength ? strength + 1 : 0;
+
+    for (int y = startY; y < endY; ++y)
+    {
+        uint32_t *pDest = (uint32_t *)pTarget->line[posY + y] + posX;
+        for (int x = startX; x < endX; ++x)
+        {
+            // 8bpp sprites go in unconverted, same as in Allegro's own 32bpp sprite blitter
+            unsigned long source = sprite32 ? ((uint32_t *)pSprite->line[y])[x] : pSprite->line[y][x];
+            if (source == MASK_COLOR_32)
+                continue;
+
+            unsigned long dest = pDest[x];
+            unsigned long screened = makecol32(255 - ((255 - getr32(source)) * (255 - getr32(dest))) / 256,
+                                               255 - ((255 - getg32(source)) * (255 - getg32(dest))) / 256,
+                                               255 - ((255 - getb32(source)) * (255 - getb32(dest))) / 256);
+            unsigned long rb = ((screened & 0xFF00FF) - (dest & 0xFF00FF)) * n / 256 + dest;
+            unsigned long g = ((screened & 0xFF00) - (dest & 0xFF00)) * n / 256 + (dest & 0xFF00);
+            pDest[x] = (uint32_t)((rb & 0xFF00FF) | (g & 0xFF00));
+        }
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          PostProcessFrame
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Copies a finished 8bpp frame into the 32bpp back buffer and adds the
+//                  glows and screen effects that were gathered while drawing it.
+
+void FrameMan::PostProcessFrame(BITMAP *pSourceBuffer8, list<PostEffect> &screenEffects, list<Box> &glowBoxes)
 {
     SLICK_PROFILE(0xFF354556);
 
     if (!m_PostProcessing)
         return;
 
-    // First copy the current 8bpp backbuffer to the 32bpp buffer; we'll add effects to it
-    blit(m_pBackBuffer8, m_pBackBuffer32, 0, 0, 0, 0, m_pBackBuffer8->w, m_pBackBuffer8->h);
+    // First copy the finished 8bpp frame to the 32bpp buffer; we'll add effects to it
+    blit(pSourceBuffer8, m_pBackBuffer32, 0, 0, 0, 0, pSourceBuffer8->w, pSourceBuffer8->h);
 
-	// Set the screen blender mode for glows
-//    set_alpha_blender();
-    set_screen_blender(128, 128, 128, 128);
+    // Everything below is screen blended with DrawScreenBlended, since this may run on the presentation thread and set_screen_blender isn't safe there
 
 //    acquire_bitmap(m_pBackBuffer8);
 //    acquire_bitmap(m_pBackBuffer32);
 
-    // Randomly sample the entire backbuffer, looking for pixels to put a glow on
-    // NOTE THIS IS SLOW, especially on higher resolutions!
+    // Scan the glow boxes of the backbuffer, looking for pixels to put a glow on
     if (m_PostPixelGlow)
     {
-        int x = 0, y = 0, startX = 0, startY = 0, endX = 0, endY = 0, testpixel = 0;
+        int x = 0, y = 0, i = 0, run = 0, startX = 0, startY = 0, endX = 0, endY = 0, testpixel = 0;
+        unsigned int quad = 0;
+        unsigned char *pRow = 0;
+
+        m_YellowGlowPixels.clear();
+        m_BlueGlowPixels.clear();
 
-        for (list<Box>::iterator bItr = m_PostScreenGlowBoxes.begin(); bItr != m_PostScreenGlowBoxes.end(); ++bItr)
+        for (list<Box>::iterator bItr = glowBoxes.begin(); bItr != glowBoxes.end(); ++bItr)
         {
             startX = (*bItr).m_Corner.m_X;
             startY = (*bItr).m_Corner.m_Y;
             endX = startX + (*bItr).m_Width;
             endY = startY + (*bItr).m_Height;
-            testpixel = 0;
 
             // Sanity check a little at least
-            if (startX < 0 || startX >= m_pBackBuffer8->w || startY < 0 || startY >= m_pBackBuffer8->h ||
-                endX < 0 || endX >= m_pBackBuffer8->w || endY < 0 || endY >= m_pBackBuffer8->h)
+            if (startX < 0 || startX >= pSourceBuffer8->w || startY < 0 || startY >= pSourceBuffer8->h ||
+                endX < 0 || endX >= pSourceBuffer8->w || endY < 0 || endY >= pSourceBuffer8->h)
                 continue;
 
 // TODO: REMOVE TEMP DEBUG
 //            rect(m_pBackBuffer32, startX, startY, endX, endY, g_RedColor);
 
+            // Go along each row four pixels at a time, and only look at the individual pixels when any of the four is a glow color
             for (y = startY; y < endY; ++y)
             {
-                for (x = startX; x < endX; ++x)
+                pRow = pSourceBuffer8->line[y];
+                for (x = startX; x < endX; x += 4)
                 {
-                    testpixel = _getpixel(m_pBackBuffer8, x, y);
-
-                    // YELLOW
-                    if ((testpixel == g_YellowGlowColor && PosRand() < 0.9) || testpixel == 98 || (testpixel == 120 && PosRand() < 0.7))// || testpixel == 39 || testpixel == 86 || testpixel == 47 || testpixel == 48 || testpixel == 116)
-                        draw_trans_sprite(m_pBackBuffer32, m_pYellowGlow, x - 2, y - 2);
-                    // RED
-        //            if (testpixel == 13)
-        //                draw_trans_sprite(m_pBackBuffer32, m_pRedGlow, x - 2, y - 2);
-                    // BLUE
-                    if (testpixel == 166)
-                        draw_trans_sprite(m_pBackBuffer32, m_pBlueGlow, x - 2, y - 2);
+                    run = endX - x < 4 ? endX - x : 4;
+                    if (run == 4)
+                    {
+                        memcpy(&quad, pRow + x, 4);
+                        if (!QuadHasGlowColor(quad))
+                            continue;
+                    }
+
+                    for (i = x; i < x + run; ++i)
+                    {
+                        testpixel = pRow[i];
+                        // YELLOW
+                        if ((testpixel == g_YellowGlowColor && m_GlowRandom.PosRand() < 0.9) || testpixel == 98 || (testpixel == 120 && m_GlowRandom.PosRand() < 0.7))// || testpixel == 39 || testpixel == 86 || testpixel == 47 || testpixel == 48 || testpixel == 116)
+                            m_YellowGlowPixels.push_back(pair<int, int>(i, y));
+                        // RED
+            //            if (testpixel == 13)
+            //                draw_trans_sprite(m_pBackBuffer32, m_pRedGlow, i - 2, y - 2);
+                        // BLUE
+                        if (testpixel == 166)
+                            m_BlueGlowPixels.push_back(pair<int, int>(i, y));
+                    }
                 }
-            }            
+            }
         }
+
+        // Now blend all the glows of each kind in one go
+        for (std::vector<pair<int, int> >::iterator gItr = m_YellowGlowPixels.begin(); gItr != m_YellowGlowPixels.end(); ++gItr)
+            DrawScreenBlended(m_pBackBuffer32, m_pYellowGlow, (*gItr).first - 2, (*gItr).second - 2, 128);
+        for (std::vector<pair<int, int> >::iterator gItr = m_BlueGlowPixels.begin(); gItr != m_BlueGlowPixels.end(); ++gItr)
+            DrawScreenBlended(m_pBackBuffer32, m_pBlueGlow, (*gItr).first - 2, (*gItr).second - 2, 128);
     }
 /* This one is even slower than above method
     // How many samples to make
@@ -1598,13 +1689,12 @@ void FrameMan::PostProcess()
     int strength = 0;
 	float angle = 0;
 
-    for (list<PostEffect>::iterator eItr = m_PostScreenEffects.begin(); eItr != m_PostScreenEffects.end(); ++eItr)
+    for (list<PostEffect>::iterator eItr = screenEffects.begin(); eItr != screenEffects.end(); ++eItr)
     {
 		if ((*eItr).m_pBitmap)
 		{
 			pBitmap = (*eItr).m_pBitmap;
 			strength = (*eItr).m_Strength;
-			set_screen_blender(strength, strength, strength, strength);
 			effectPosX = (*eItr).m_Pos.GetFloorIntX() - (pBitmap->w / 2);
 			effectPosY = (*eItr).m_Pos.GetFloorIntY() - (pBitmap->h / 2);
 			angle = (*eItr).m_Angle;
@@ -1612,7 +1702,7 @@ void FrameMan::PostProcess()
 
 			if (angle == 0)
 			{
-				draw_trans_sprite(m_pBackBuffer32, pBitmap, effectPosX, effectPosY);
+				DrawScreenBlended(m_pBackBuffer32, pBitmap, effectPosX, effectPosY, strength);
 			}
 			else
 			{
@@ -1638,7 +1728,7 @@ void FrameMan::PostProcess()
 				m.SetRadAngle(angle);
 
 				rotate_sprite(pTargetBitmap, pBitmap, 0, 0, ftofix(m.GetAllegroAngle()));
-				draw_trans_sprite(m_pBackBuffer32, pTargetBitmap, effectPosX, effectPosY);
+				DrawScreenBlended(m_pBackBuffer32, pTargetBitmap, effectPosX, effectPosY, strength);
 			}
 		}
     }
@@ -1650,7 +1740,135 @@ void FrameMan::PostProcess()
 //    set_trans_blender(128, 128, 128, 128);
 
     // Clear the effects list for this frame
+    screenEffects.clear();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StagePresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Copies the just drawn 8bpp frame and its effect lists aside so the
+//                  presentation thread can postprocess them after the next flip.
+
+void FrameMan::StagePresent()
+{
+    if (!m_pPresentBuffer8 || m_pPresentBuffer8->w != m_pBackBuffer8->w || m_pPresentBuffer8->h != m_pBackBuffer8->h)
+    {
+        destroy_bitmap(m_pPresentBuffer8);
+        m_pPresentBuffer8 = create_bitmap_ex(8, m_pBackBuffer8->w, m_pBackBuffer8->h);
+    }
+    blit(m_pBackBuffer8, m_pPresentBuffer8, 0, 0, 0, 0, m_pBackBuffer8->w, m_pBackBuffer8->h);
+
+    // The lists get cleared at the start of each Draw anyway, so just trade them
+    m_PresentScreenEffects.swap(m_PostScreenEffects);
+    m_PresentGlowBoxes.swap(m_PostScreenGlowBoxes);
     m_PostScreenEffects.clear();
+    m_PostScreenGlowBoxes.clear();
+
+    m_PresentStaged = true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StartPresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Hands the staged frame over to the presentation thread, starting the
+//                  thread first if it isn't running yet.
+
+void FrameMan::StartPresent()
+{
+    m_PresentStaged = false;
+
+    if (!PresentThread.joinable())
+    {
+        m_PresentThreadQuit = false;
+        PresentThread = std::thread(&FrameMan::PresentLoop, this);
+    }
+
+    {
+        std::lock_guard<std::mutex> presentLock(PresentMutex);
+        m_PresentPending = true;
+    }
+    PresentCondition.notify_all();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          PresentLoop
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Body of the presentation thread. Postprocesses each handed over frame
+//                  into the 32bpp back buffer while the main thread simulates the next.
+
+void FrameMan::PresentLoop()
+{
+    std::unique_lock<std::mutex> presentLock(PresentMutex);
+    while (true)
+    {
+        while (!m_PresentPending && !m_PresentThreadQuit)
+            PresentCondition.wait(presentLock);
+
+        if (m_PresentThreadQuit)
+            break;
+
+        presentLock.unlock();
+        PostProcessFrame(m_pPresentBuffer8, m_PresentScreenEffects, m_PresentGlowBoxes);
+        m_PresentGlowBoxes.clear();
+        presentLock.lock();
+
+        m_PresentPending = false;
+        PresentCondition.notify_all();
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WaitForPresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Blocks until the presentation thread is done with the frame it was
+//                  handed, if any.
+
+void FrameMan::WaitForPresent()
+{
+    if (!PresentThread.joinable())
+        return;
+
+    std::unique_lock<std::mutex> presentLock(PresentMutex);
+    while (m_PresentPending)
+        PresentCondition.wait(presentLock);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StopPresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Stops the presentation thread and waits for it to end, if it's
+//                  running.
+
+void FrameMan::StopPresent()
+{
+    if (!PresentThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> presentLock(PresentMutex);
+        m_PresentThreadQuit = true;
+    }
+    PresentCondition.notify_all();
+    PresentThread.join();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          FlushPresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Waits out any pipelined frame and drops the one that was staged, so
+//                  the 32bpp back buffer can be used freely again.
+
+void FrameMan::FlushPresent()
+{
+    WaitForPresent();
+    m_PresentStaged = false;
+    m_PresentPrimed = false;
 }
 
 
@@ -1695,6 +1913,10 @@ void FrameMan::FlipFrameBuffers()
         else
             blit(m_pBackBuffer8, screen, 0, 0, 0, 0, m_pBackBuffer8->w, m_pBackBuffer8->h);
     }
+
+    // The previous frame is on screen now, so the 32bpp buffer is free to postprocess the staged one into
+    if (m_PresentStaged)
+        StartPresent();
 }
 
 
@@ -2053,6 +2275,9 @@ void FrameMan::Draw()
 {
     SLICK_PROFILE(0xFF684822);
 
+    // Make sure the presentation thread is done with the last frame before anything gets drawn over its buffers
+    WaitForPresent();
+
     // Count how many split screens we'll need
     int screenCount = (m_HSplit ? 2 : 1) * (m_VSplit ? 2 : 1);
 
@@ -2230,7 +2455,7 @@ void FrameMan::Draw()
                 sprintf(str, "Particles: %i", g_MovableMan.GetParticleCount());
                 GetLargeFont()->DrawAligned(&pPlayerGUIBitmap, 17, 64, str, GUIFont::Left);
 
-				sprintf(str, "Objects: %i", g_MovableMan.GetKnownObjectsCount());
+				sprintf(str, "Objects: %i (%i items asleep)", g_MovableMan.GetKnownObjectsCount(), g_MovableMan.GetSleepingCount());
 				GetLargeFont()->DrawAligned(&pPlayerGUIBitmap, 17, 74, str, GUIFont::Left);
 
                 sprintf(str, "MOIDs: %i", g_MovableMan.GetMOIDCount());
@@ -2251,74 +2476,53 @@ void FrameMan::Draw()
 				int graphHeight = 20;
 				int graphOffset = 14;
 
-				//Update current sample percentage
-				g_FrameMan.CalculateSamplePercentages();
-
-				//Draw advanced performance counters
-				for(int pc = 0 ; pc < FrameMan::PERF_COUNT; ++pc)
+				//Draw advanced performance counters, all that are registered, children indented under their parents
+				for(int pc = 0 ; pc < g_PerformanceMan.GetCounterCount(); ++pc)
 				{
 					int blockStart = yOffset + pc * blockHeight;
+					int nameOffset = xOffset + g_PerformanceMan.GetCounterDepth(pc) * 4;
 
-					GetLargeFont()->DrawAligned(&pPlayerGUIBitmap, xOffset, blockStart , m_PerfCounterNames[pc], GUIFont::Left);
+					GetLargeFont()->DrawAligned(&pPlayerGUIBitmap, nameOffset, blockStart , g_PerformanceMan.GetCounterName(pc), GUIFont::Left);
 
 					// Print percentage from PerformanceCounters::PERF_SIM_TOTAL
-					int perc = (int)((float)GetPerormanceCounterAverage(static_cast<PerformanceCounters>(pc)) / (float)GetPerormanceCounterAverage(PERF_SIM_TOTAL) * 100);
+					int64_t totalAverage = g_PerformanceMan.GetPerformanceCounterAverage(PerformanceMan::PERF_SIM_TOTAL);
+					int perc = totalAverage > 0 ? (int)((float)g_PerformanceMan.GetPerformanceCounterAverage(pc) / (float)totalAverage * 100) : 0;
 					sprintf(str, "%%: %i", perc);
 		            GetLargeFont()->DrawAligned(&pPlayerGUIBitmap, xOffset + 60, blockStart, str, GUIFont::Left);
 					
 					// Print average processing time in ms
-					sprintf(str, "T: %i", GetPerormanceCounterAverage(static_cast<PerformanceCounters>(pc)) / 1000);
+					sprintf(str, "T: %i", (int)(g_PerformanceMan.GetPerformanceCounterAverage(pc) / 1000));
 		            GetLargeFont()->DrawAligned(&pPlayerGUIBitmap, xOffset + 96, blockStart, str, GUIFont::Left);
 					
 					int graphStart = blockStart + graphOffset;
 
 					//Draw graph
 					//Draw graph backgrounds
-					pPlayerGUIBitmap.DrawRectangle(xOffset, graphStart , MAXSAMPLES, graphHeight , 240, true);
-					//pPlayerGUIBitmap.DrawLine(xOffset, graphStart, xOffset + MAXSAMPLES, graphStart, 48);
-					pPlayerGUIBitmap.DrawLine(xOffset, graphStart + graphHeight / 2, xOffset + MAXSAMPLES, graphStart + graphHeight / 2, 96);
-					//pPlayerGUIBitmap.DrawLine(xOffset, graphStart + graphHeight, xOffset + MAXSAMPLES, graphStart + graphHeight , 48);
-
-					int smpl = m_Sample;
-
-					//Custom graph for Total counter which shows update time
-					// Not used because graphs now show data in ms, but can be enabled if you need percentages
-					/*if (pc == PerformanceCounters::SIM_TOTAL)
-					{
-						m_PerfPercentages[pc][smpl] = (int)((float)m_PerfData[pc][smpl] / (1000000 / 30) * 100);
-						if (m_PerfPercentages[pc][smpl] > 100)
-							m_PerfPercentages[pc][smpl] = 100;
-					}*/
+					pPlayerGUIBitmap.DrawRectangle(xOffset, graphStart , PerformanceMan::MAXSAMPLES, graphHeight , 240, true);
+					pPlayerGUIBitmap.DrawLine(xOffset, graphStart + graphHeight / 2, xOffset + PerformanceMan::MAXSAMPLES, graphStart + graphHeight / 2, 96);
 
 					//Reset peak value
-					int peak = 0;
+					int64_t peak = 0;
 
 					//Draw sample dots
-					for (int i = 0; i < MAXSAMPLES; i++)
+					for (int i = 0; i < PerformanceMan::MAXSAMPLES; i++)
 					{
-						if (smpl < 0)
-							smpl = MAXSAMPLES - 1;
-						
-						// Show percentages in graphs
-						//int dotHeight = (int)((float)graphHeight / 100.0 * (float)m_PerfPercentages[pc][smpl]);
+						int64_t sample = g_PerformanceMan.GetPerformanceSample(pc, i);
 
 						// Show microseconds in graphs, assume that 33333 microseconds (one frame of 30 fps) is the highest value on the graph
-						int value = (int)((float)m_PerfData[pc][smpl] / (1000000 / 30) * 100);
+						int value = (int)((float)sample / (1000000 / 30) * 100);
 						if (value > 100)
 							value = 100;
 						// Calculate dot height on the graph
 						int dotHeight = (int)((float)graphHeight / 100.0 * (float)value);
-						pPlayerGUIBitmap.SetPixel(xOffset + MAXSAMPLES - i, graphStart + graphHeight - dotHeight, 13);
+						pPlayerGUIBitmap.SetPixel(xOffset + PerformanceMan::MAXSAMPLES - i, graphStart + graphHeight - dotHeight, 13);
 
-						if (peak < m_PerfData[pc][smpl])
-							peak = m_PerfData[pc][smpl];
-
-						//Move to previous sample
-						smpl--;
+						if (peak < sample)
+							peak = sample;
 					}
 
 					// Print peak values
-					sprintf(str, "Peak: %i", peak / 1000);
+					sprintf(str, "Peak: %i", (int)(peak / 1000));
 		            GetLargeFont()->DrawAligned(&pPlayerGUIBitmap, xOffset + 130, blockStart, str, GUIFont::Left);
 				}
             }
@@ -2545,7 +2749,19 @@ void FrameMan::Draw()
 
     // Do postprocessing effects, if applicable and enabled
     if (m_PostProcessing && g_InActivity && m_BPP == 32)
-        PostProcess();
+    {
+        // When pipelining, this frame gets postprocessed on the presentation thread after the flip, and the
+        // previous one, which is already done, is what gets flipped. The first frame has no predecessor so it's done here.
+        if (m_PipelinedPresent && m_PresentPrimed)
+            StagePresent();
+        else
+        {
+            PostProcess();
+            m_PresentPrimed = m_PipelinedPresent;
+        }
+    }
+    else
+        m_PresentPrimed = false;
 
     // Draw the console on top of everything
     if (FlippingWith32BPP())
@@ -50,6 +50,7 @@ enum DotGlowColor
 #include "Material.h"
 #include <map>
 #include <list>
+#include <vector>
 #include "SceneMan.h"
 
 #include "MovableMan.h"
@@ -118,23 +119,6 @@ class FrameMan:
 public:
 
 
-	// Enumeration of all available perofrmance counters
-	enum PerformanceCounters
-	{
-		PERF_SIM_TOTAL = 0,
-		PERF_ACTORS_AI,
-		PERF_ACTORS_PASS2,
-		PERF_ACTORS_PASS1,
-		PERF_PARTICLES_PASS2,
-		PERF_PARTICLES_PASS1,
-		PERF_ACTIVITY,
-#if __USE_SOUND_GORILLA
-		PERF_SOUND,
-#endif
-		PERF_COUNT
-	};
-
-
 	//////////////////////////////////////////////////////////////////////////////////////////
 	// Nested class:           GraphicalPrimitive
 	//////////////////////////////////////////////////////////////////////////////////////////
@@ -1288,6 +1272,28 @@ public:
     bool IsPixelGlowEnabled() const { return IsPostProcessing() && m_PostPixelGlow; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          EnablePipelinedPresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets whether postprocessing of a finished frame is done on a separate
+//                  thread while the next frame is being simulated. This adds a frame
+//                  of display latency.
+// Arguments:       Whether pipelined presentation should be enabled or not.
+// Return value:    None.
+
+    void EnablePipelinedPresent(bool enable = true) { if (!enable) { FlushPresent(); } m_PipelinedPresent = enable; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsPipelinedPresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether postprocessing is pipelined onto a separate thread.
+// Arguments:       None.
+// Return value:    Whether pipelined presentation is enabled or not.
+
+    bool IsPipelinedPresent() const { return m_PipelinedPresent; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetDotGlowEffect
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1465,6 +1471,39 @@ public:
     void PostProcess();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WaitForPresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Blocks until the presentation thread has finished postprocessing the
+//                  frame it was last handed, if any.
+// Arguments:       None.
+// Return value:    None.
+
+    void WaitForPresent();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StopPresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Stops the presentation thread and waits for it to end, if it's
+//                  running. Also done at exit, in case that comes without Destroy.
+// Arguments:       None.
+// Return value:    None.
+
+    void StopPresent();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          FlushPresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Waits for the presentation thread and drops any pipelined frame, so
+//                  the 32bpp back buffer can be drawn to directly, like by the menus.
+// Arguments:       None.
+// Return value:    None.
+
+    void FlushPresent();
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          ClearBackBuffer8
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1482,7 +1521,7 @@ public:
 // Arguments:       None.
 // Return value:    None.
 
-    void ClearBackBuffer32() { if (m_pBackBuffer32) clear_to_color(m_pBackBuffer32, 0); }
+    void ClearBackBuffer32() { FlushPresent(); if (m_pBackBuffer32) clear_to_color(m_pBackBuffer32, 0); }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1636,47 +1675,6 @@ public:
 
     void DrawPrimitives(int player, BITMAP *pTargetBitmap, const Vector &targetPos);
 
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          NewPerformanceSample
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Moves sample counter to next sample and clears it's values.
-// Arguments:       None.
-// Return value:    None.
-	void NewPerformanceSample()
-	{
-		m_Sample++;
-		if (m_Sample >= MAXSAMPLES)
-			m_Sample = 0;
-
-		for (int pc = 0; pc < PERF_COUNT; ++pc)
-		{
-			m_PerfData[pc][m_Sample] = 0;
-			m_PerfPercentages[pc][m_Sample] = 0;
-		}
-	}
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          StartPerformanceMeasurement
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Saves current absolute time in microseconds as a start of performance measurerement.
-// Arguments:       Counter to start measurement for.
-// Return value:    None.
-	void StartPerformanceMeasurement(PerformanceCounters counter) { m_PerfMeasureStart[counter] = g_TimerMan.GetAbsoulteTime(); }
-
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          StopPerformanceMeasurement
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Saves current absolute time in microseconds as an end of performance measurerement. 
-//					The difference is added to the value of current perofrmance sample.
-// Arguments:       Counter to stop and updated measurement for.
-// Return value:    None.
-	void StopPerformanceMeasurement(PerformanceCounters counter) 
-	{ 
-		m_PerfMeasureStop[counter] = g_TimerMan.GetAbsoulteTime(); 
-		AddPerformanceSample(counter, m_PerfMeasureStop[counter] - m_PerfMeasureStart[counter]);
-	}
-
-
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          IsValidResolution	
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1778,6 +1776,26 @@ protected:
     std::list<PostEffect> m_PostScreenEffects;
     // List of screen-relative areas that will be processed with glow
     std::list<Box> m_PostScreenGlowBoxes;
+    // Whether postprocessing and presenting a frame is pipelined on a separate thread, overlapping the next frame's simulation
+    bool m_PipelinedPresent;
+    // Copy of the last drawn 8bpp frame, which the presentation thread postprocesses into the 32bpp back buffer
+    BITMAP *m_pPresentBuffer8;
+    // The effects and glow boxes gathered while drawing the frame in m_pPresentBuffer8
+    std::list<PostEffect> m_PresentScreenEffects;
+    std::list<Box> m_PresentGlowBoxes;
+    // Whether the 32bpp back buffer holds a postprocessed frame that can be flipped in place of the current one
+    bool m_PresentPrimed;
+    // Whether a frame has been staged and should be handed to the presentation thread after the next flip
+    bool m_PresentStaged;
+    // Whether the presentation thread is working on a frame. Guarded by the present mutex in FrameMan.cpp
+    bool m_PresentPending;
+    // Tells the presentation thread to exit
+    bool m_PresentThreadQuit;
+    // Backbuffer pixels found to need a yellow or blue glow this frame, kept between frames to avoid reallocating
+    std::vector<std::pair<int, int> > m_YellowGlowPixels;
+    std::vector<std::pair<int, int> > m_BlueGlowPixels;
+    // Which glow pixels get dropped is drawn from this rather than the thread's stream, so postprocessing doesn't use up the simulation's random numbers
+    RandomStream m_GlowRandom;
 	// Temp bitmap to rotate post effects in it
 	BITMAP * m_pTempEffectBitmap_16;
 	BITMAP * m_pTempEffectBitmap_32;
@@ -1858,24 +1876,6 @@ protected:
 	std::list<PostEffect> m_ScreenRelativeEffects[MAXSCREENCOUNT];
 
 
-	//Performance data
-	//How many performance samples to store, directly affects graph size
-	const static int MAXSAMPLES = 120;
-	// How many samples to use to calculate average value displayed on screen
-	const static int AVERAGE = 10;
-
-	// Array to store perormance measurements in microseconds
-	int64_t m_PerfData[PERF_COUNT][MAXSAMPLES];
-	// Current measurement start time in microseconds
-	int64_t m_PerfMeasureStart[PERF_COUNT];
-	// Current measurement stop time in microseconds
-	int64_t m_PerfMeasureStop[PERF_COUNT];
-	// Array to store percentages from PERF_SIM_TOTAL
-	int m_PerfPercentages[PERF_COUNT][MAXSAMPLES];
-	// Perormance counter's names displayed on screen
-	string m_PerfCounterNames[PERF_COUNT];
-	// Sample counter
-	int m_Sample;
 	// Current ping value to display on screen
 	int m_CurrentPing;
 
@@ -1884,67 +1884,65 @@ protected:
 	//std::mutex m_NetworkBitmapIsLocked[MAXSCREENCOUNT];
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          AddPerformanceSample
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Adds provided value to current sample of specified performance counter
-// Arguments:       Counter to update, value to add to this counter
-// Return value:    None.
-	void AddPerformanceSample(PerformanceCounters counter, int64_t value) { m_PerfData[counter][m_Sample] += value; }
-	
+// Private member variable and method declarations
+
+private:
+
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CalculateSamplePercentages
+// Method:          Clear
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Calculates current sample's percentages from SIM_TOTAL for all performance counters 
-//					and stores them to m_PerfPercenrages.
+// Description:     Clears all the member variables of this FrameMan, effectively
+//                  resetting the members of this abstraction level only.
 // Arguments:       None.
 // Return value:    None.
-	void CalculateSamplePercentages()
-	{
-		for(int pc = 0 ; pc < FrameMan::PERF_COUNT; ++pc)
-		{
-			int perc = (int)((float)m_PerfData[pc][m_Sample] / (float)m_PerfData[pc][FrameMan::PERF_SIM_TOTAL] * 100);
-			m_PerfPercentages[pc][m_Sample] = perc;
-		}
-	}
+
+    void Clear();
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          GetPerormanceCounterAverage
+// Method:          PostProcessFrame
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Returns an average value of AVERAGE last samples for specified performance counter
-// Arguments:       None.
-// Return value:    An average value for specified counter.
-	int64_t GetPerormanceCounterAverage(PerformanceCounters counter)
-	{
-		int64_t accum = 0;
-		int smpl = m_Sample;
+// Description:     Copies a finished 8bpp frame into the 32bpp back buffer and adds the
+//                  glows and screen effects gathered while drawing it on top.
+// Arguments:       The 8bpp frame to postprocess.
+//                  The screen effects to apply. Cleared when done.
+//                  The screen areas to look for glowing pixels in.
+// Return value:    None.
 
-		for (int i = 0 ; i < AVERAGE; ++i)
-		{
-			accum += m_PerfData[counter][smpl];
+    void PostProcessFrame(BITMAP *pSourceBuffer8, std::list<PostEffect> &screenEffects, std::list<Box> &glowBoxes);
 
-			smpl--;
-			if (smpl < 0)
-				smpl = MAXSAMPLES - 1;
-		}
 
-		return accum / AVERAGE;
-	}
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StagePresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Copies the just drawn 8bpp frame and its effect lists aside for the
+//                  presentation thread to pick up after the next flip.
+// Arguments:       None.
+// Return value:    None.
+
+    void StagePresent();
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Private member variable and method declarations
+// Method:          StartPresent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Hands the staged frame to the presentation thread, starting it if
+//                  needed.
+// Arguments:       None.
+// Return value:    None.
+
+    void StartPresent();
 
-private:
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          Clear
+// Method:          PresentLoop
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Clears all the member variables of this FrameMan, effectively
-//                  resetting the members of this abstraction level only.
+// Description:     Body of the presentation thread.
 // Arguments:       None.
 // Return value:    None.
 
-    void Clear();
+    void PresentLoop();
+
 
 
     // Disallow the use of some implicit methods.
@@ -62,6 +62,12 @@ extern "C"
 //#include "boost/shared_ptr.hpp"
 
 #include <string>
+#include <set>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 using namespace std;
 using namespace luabind;
 
@@ -122,6 +128,73 @@ namespace RTE
 
 const string LuaMan::m_ClassName = "LuaMan";
 
+// Hands the batches to the helper threads and tells when they are all done with one
+static mutex ScriptLaneMutex;
+static condition_variable ScriptLaneStartCondition;
+static condition_variable ScriptLaneDoneCondition;
+// The threads that help the main thread run the lanes of each batch
+static vector<thread> s_ScriptHelpers;
+// The next lane of the current batch that no thread has claimed yet
+static atomic<int> s_NextScriptLane(0);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// A Lua state of its own, which runs the script Update of its share of each batch of
+// ScriptThreadSafe objects. Which lane an object runs on is fixed, so it doesn't matter
+// which thread runs which lane
+
+struct LuaMan::ScriptLane
+{
+    ScriptLane() { m_Index = 0; m_pState = 0; m_pObject = 0; m_Order = 0; m_NextUniqueID = 0; m_UniqueIDsLeft = 0; }
+
+    int m_Index;
+    lua_State *m_pState;
+    // Where in the batch this lane's share of it is
+    vector<int> m_Share;
+    // The preset tables that have had their functions defined in this state
+    set<string> m_LoadedPresets;
+    // The object being updated and where it is in the batch
+    MovableObject *m_pObject;
+    int m_Order;
+    // What the scripts on this lane made during the current batch, and so may change
+    set<const Entity *> m_Created;
+    // The next stand-in unique id for what this lane makes during the current batch, and how many are left
+    unsigned long int m_NextUniqueID;
+    unsigned long int m_UniqueIDsLeft;
+    // Changes held back and errors hit during the current batch
+    vector<LuaMan::ScriptCommand> m_Commands;
+    vector<string> m_Errors;
+};
+
+// The lane the calling thread is running, if any. Only LuaMan knows its type
+static thread_local void *s_pThreadScriptLane = 0;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Prints to the console, or if called from a script lane, has it printed once the batch
+// is done
+
+void ScriptPrint(const string &text)
+{
+    LuaMan::ScriptCommand command;
+    command.m_Type = LuaMan::ScriptCommand::PRINT;
+    command.m_Text = text;
+    if (!g_LuaMan.DeferScriptCommand(command))
+        g_ConsoleMan.PrintString(text);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Lets the script lane running the calling thread know that its script made an entity,
+// so it's free to change it. Passes the entity on
+
+template <class TYPE>
+TYPE * ScriptCreated(TYPE *pEntity)
+{
+    g_LuaMan.NoteScriptCreation(pEntity);
+    return pEntity;
+}
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Preset clone adapters that will return the exact pre-cast types so we don't have to do:
@@ -139,10 +212,10 @@ const string LuaMan::m_ClassName = "LuaMan";
         const Entity *pPreset = g_PresetMan.GetEntityPreset(#TYPE, preset, module); \
         if (!pPreset) \
         { \
-            g_ConsoleMan.PrintString(string("ERROR: There is no ") + string(#TYPE) + string(" of the Preset name \"") + preset + string("\" defined in the \"") + module + string("\" Data Module!")); \
+            ScriptPrint(string("ERROR: There is no ") + string(#TYPE) + string(" of the Preset name \"") + preset + string("\" defined in the \"") + module + string("\" Data Module!")); \
             return 0; \
         } \
-        return dynamic_cast<TYPE *>(pPreset->Clone()); \
+        return ScriptCreated(dynamic_cast<TYPE *>(pPreset->Clone())); \
     } \
     TYPE * Create##TYPE(std::string preset) { return Create##TYPE(preset, "All"); } \
     TYPE * Random##TYPE(std::string group, int moduleSpaceID) \
@@ -154,10 +227,10 @@ const string LuaMan::m_ClassName = "LuaMan";
             pPreset = g_PresetMan.GetRandomBuyableOfGroupFromTech("Any", #TYPE, moduleSpaceID); \
         if (!pPreset) \
         { \
-            g_ConsoleMan.PrintString(string("ERROR: Could not find any ") + string(#TYPE) + string(" defined in a Group called \"") + group + string("\" in module ") + g_PresetMan.GetDataModuleName(moduleSpaceID) + string("!")); \
+            ScriptPrint(string("ERROR: Could not find any ") + string(#TYPE) + string(" defined in a Group called \"") + group + string("\" in module ") + g_PresetMan.GetDataModuleName(moduleSpaceID) + string("!")); \
             return 0; \
         } \
-        return dynamic_cast<TYPE *>(pPreset->Clone()); \
+        return ScriptCreated(dynamic_cast<TYPE *>(pPreset->Clone())); \
     } \
     TYPE * Random##TYPE(std::string group, std::string module) \
     { \
@@ -169,10 +242,10 @@ const string LuaMan::m_ClassName = "LuaMan";
             pPreset = g_PresetMan.GetRandomBuyableOfGroupFromTech("Any", #TYPE, moduleSpaceID); \
         if (!pPreset) \
         { \
-            g_ConsoleMan.PrintString(string("ERROR: Could not find any ") + string(#TYPE) + string(" defined in a Group called \"") + group + string("\" in module ") + module + string("!")); \
+            ScriptPrint(string("ERROR: Could not find any ") + string(#TYPE) + string(" defined in a Group called \"") + group + string("\" in module ") + module + string("!")); \
             return 0; \
         } \
-        return dynamic_cast<TYPE *>(pPreset->Clone()); \
+        return ScriptCreated(dynamic_cast<TYPE *>(pPreset->Clone())); \
     } \
     TYPE * Random##TYPE(std::string group) { return Random##TYPE(group, "All"); }
 
@@ -211,9 +284,9 @@ LUAENTITYCREATE(TerrainObject)
     TYPE * Clone##TYPE(const TYPE *pThis) \
         { \
             if (pThis) \
-                return dynamic_cast<TYPE *>(pThis->Clone()); \
+                return ScriptCreated(dynamic_cast<TYPE *>(pThis->Clone())); \
             else \
-                g_ConsoleMan.PrintString(string("ERROR: Tried to clone a ") + string(#TYPE) + string(" reference that is nil!")); \
+                ScriptPrint(string("ERROR: Tried to clone a ") + string(#TYPE) + string(" reference that is nil!")); \
             return 0; \
         }
 
@@ -249,6 +322,15 @@ LUAENTITYCLONE(TerrainObject)
 
 void DeleteEntity(Entity *pEntity)
 {
+    // On a script lane, only what the script made itself can go right away, anything else may still be in use elsewhere
+    if (pEntity && g_LuaMan.InScriptLane() && !g_LuaMan.IsScriptCreation(pEntity))
+    {
+        LuaMan::ScriptCommand command;
+        command.m_Type = LuaMan::ScriptCommand::DELETEENTITY;
+        command.m_pEntity = pEntity;
+        g_LuaMan.DeferScriptCommand(command);
+        return;
+    }
     delete pEntity;
     pEntity = 0;
 }
@@ -263,14 +345,14 @@ void DeleteEntity(Entity *pEntity)
     { \
         TYPE *pTarget = dynamic_cast<TYPE *>(pEntity); \
         if (!pTarget) \
-            g_ConsoleMan.PrintString(string("ERROR: Tried to convert a non-") + string(#TYPE) + string(" Entity reference to an ") + string(#TYPE) + string(" reference!")); \
+            ScriptPrint(string("ERROR: Tried to convert a non-") + string(#TYPE) + string(" Entity reference to an ") + string(#TYPE) + string(" reference!")); \
         return pTarget; \
     } \
     const TYPE * ToConst##TYPE(const Entity *pEntity) \
     { \
         const TYPE *pTarget = dynamic_cast<const TYPE *>(pEntity); \
         if (!pTarget) \
-            g_ConsoleMan.PrintString(string("ERROR: Tried to convert a non-") + string(#TYPE) + string(" Entity reference to an ") + string(#TYPE) + string(" reference!")); \
+            ScriptPrint(string("ERROR: Tried to convert a non-") + string(#TYPE) + string(" Entity reference to an ") + string(#TYPE) + string(" reference!")); \
         return pTarget; \
     } \
     bool Is##TYPE(Entity *pEntity) { return dynamic_cast<TYPE *>(pEntity) ? true : false; }
@@ -335,35 +417,161 @@ LUAENTITYCAST(TerrainObject)
 //////////////////////////////////////////////////////////////////////////////////////////
 // Other misc adapters to eliminate/emulate default parameters etc
 
-void GibThis(MOSRotating *pThis) { pThis->GibThis(); }
+// The ones that change the engine hold the change back when called from a script lane,
+// unless it's to the object whose script is running, see LuaMan::DefersChangesTo
+
+// Holds back a change to an object if it needs to be, otherwise returns false so it gets made right away
+bool DeferChange(int type, MovableObject *pTarget, const Vector &vector = Vector(), const Vector &offset = Vector(), float value = 0)
+{
+    if (!g_LuaMan.DefersChangesTo(pTarget))
+        return false;
+    LuaMan::ScriptCommand command;
+    command.m_Type = type;
+    command.m_pTarget = pTarget;
+    command.m_Vector = vector;
+    command.m_Offset = offset;
+    command.m_Value = value;
+    return g_LuaMan.DeferScriptCommand(command);
+}
+// Holds back adding an entity if it needs to be, otherwise returns false so it gets added right away
+bool DeferAdd(int type, Entity *pEntity)
+{
+    if (!g_LuaMan.DefersChangesTo(0))
+        return false;
+    LuaMan::ScriptCommand command;
+    command.m_Type = type;
+    command.m_pEntity = pEntity;
+    return g_LuaMan.DeferScriptCommand(command);
+}
+
+void GibThis(MOSRotating *pThis, Vector impactImpulse, float internalBlast, MovableObject *pIgnoreMO)
+{
+    // Gibbing takes the object apart and adds the pieces to MovableMan, so it's held back on a lane even for the lane's own object
+    LuaMan::ScriptCommand command;
+    command.m_Type = LuaMan::ScriptCommand::GIBTHIS;
+    command.m_pTarget = pThis;
+    command.m_pEntity = pIgnoreMO;
+    command.m_Vector = impactImpulse;
+    command.m_Value = internalBlast;
+    if (!g_LuaMan.DeferScriptCommand(command))
+        pThis->GibThis(impactImpulse, internalBlast, pIgnoreMO);
+}
+void GibThis(MOSRotating *pThis) { GibThis(pThis, Vector(), 10, 0); }
+void AddForce(MovableObject *pThis, const Vector &force, const Vector &offset) { if (!DeferChange(LuaMan::ScriptCommand::ADDFORCE, pThis, force, offset)) pThis->AddForce(force, offset); }
+void AddAbsForce(MovableObject *pThis, const Vector &force, const Vector &absPos) { if (!DeferChange(LuaMan::ScriptCommand::ADDABSFORCE, pThis, force, absPos)) pThis->AddAbsForce(force, absPos); }
+void AddImpulseForce(MovableObject *pThis, const Vector &impulse, const Vector &offset) { if (!DeferChange(LuaMan::ScriptCommand::ADDIMPULSEFORCE, pThis, impulse, offset)) pThis->AddImpulseForce(impulse, offset); }
+void AddAbsImpulseForce(MovableObject *pThis, const Vector &impulse, const Vector &absPos) { if (!DeferChange(LuaMan::ScriptCommand::ADDABSIMPULSEFORCE, pThis, impulse, absPos)) pThis->AddAbsImpulseForce(impulse, absPos); }
+void SetToDelete(MovableObject *pThis, bool toDelete) { if (!DeferChange(LuaMan::ScriptCommand::SETTODELETE, pThis, Vector(), Vector(), toDelete ? 1 : 0)) pThis->SetToDelete(toDelete); }
+void SetHealth(Actor *pThis, const int setHealth) { if (!DeferChange(LuaMan::ScriptCommand::SETHEALTH, pThis, Vector(), Vector(), setHealth)) pThis->SetHealth(setHealth); }
+void PrintString(ConsoleMan &This, std::string toPrint) { ScriptPrint(toPrint); }
+bool AddTerrainObject(SceneMan &This, TerrainObject *pObject)
+{
+    // The terrain object isn't owned by the scene, so hold on to a copy of it
+    if (pObject && DeferAdd(LuaMan::ScriptCommand::ADDTERRAINOBJECT, pObject->Clone()))
+        return true;
+    return This.AddTerrainObject(pObject);
+}
+bool AddSceneObject(SceneMan &This, SceneObject *pObject)
+{
+    if (pObject && DeferAdd(LuaMan::ScriptCommand::ADDSCENEOBJECT, pObject))
+        return true;
+    return This.AddSceneObject(pObject);
+}
+// MovableMan holds these back by itself when called from a script lane
 void AddMO(MovableMan &This, MovableObject *pMO)
 {
     if (This.ValidMO(pMO))
-        g_ConsoleMan.PrintString("ERROR: Tried to add a MovableObject that already exists in the simulation! " + pMO->GetPresetName());
+        ScriptPrint("ERROR: Tried to add a MovableObject that already exists in the simulation! " + pMO->GetPresetName());
     else
         This.AddMO(pMO);
 }
 void AddActor(MovableMan &This, Actor *pActor)
 {
     if (This.IsActor(pActor))
-        g_ConsoleMan.PrintString("ERROR: Tried to add an Actor that already exists in the simulation!" + pActor->GetPresetName());
+        ScriptPrint("ERROR: Tried to add an Actor that already exists in the simulation!" + pActor->GetPresetName());
     else
         This.AddActor(pActor);
 }
 void AddItem(MovableMan &This, MovableObject *pItem)
 {
     if (This.ValidMO(pItem))
-        g_ConsoleMan.PrintString("ERROR: Tried to add an Item that already exists in the simulation!" + pItem->GetPresetName());
+        ScriptPrint("ERROR: Tried to add an Item that already exists in the simulation!" + pItem->GetPresetName());
     else
         This.AddItem(pItem);
 }
 void AddParticle(MovableMan &This, MovableObject *pParticle)
 {
     if (This.ValidMO(pParticle))
-        g_ConsoleMan.PrintString("ERROR: Tried to add a Particle that already exists in the simulation!" + pParticle->GetPresetName());
+        ScriptPrint("ERROR: Tried to add a Particle that already exists in the simulation!" + pParticle->GetPresetName());
     else
         This.AddParticle(pParticle);
 }
+// The last search shortcut of IsInGroup is written by every lookup, so lanes that may be looking at the same entity have to do without it
+bool IsInGroup(Entity &This, const string &whichGroup)
+{
+    return g_LuaMan.InScriptLane() ? This.HasGroup(whichGroup) : This.IsInGroup(whichGroup);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Guards for the bindings that change things in place. A script running on a script lane
+// may only change the object it belongs to and what it made itself during the batch.
+// Anything else raises a Lua error, since other lanes may be reading it at the same time.
+
+void CheckSharedChange()
+{
+    if (g_LuaMan.InScriptLane())
+        throw runtime_error("Thread-safe scripts can't change shared engine state, this call isn't allowed in them!");
+}
+void CheckScriptOwnership(const void *pShared) { CheckSharedChange(); }
+void CheckScriptOwnership(const Entity *pEntity)
+{
+    if (!g_LuaMan.InScriptLane() || g_LuaMan.IsScriptCreation(pEntity))
+        return;
+    // Scenes, activities and other non-movable entities are shared by everything
+    const MovableObject *pMO = dynamic_cast<const MovableObject *>(pEntity);
+    if (!pMO || g_LuaMan.DefersChangesTo(pMO))
+        throw runtime_error("Thread-safe scripts can only change their own object and what they made themselves, not " + (pEntity ? pEntity->GetModuleAndPresetName() : string("nil")) + "!");
+}
+void CheckScriptOwnership(const Controller *pController)
+{
+    // A controller that isn't attached to any actor was made by the script
+    if (pController && pController->GetControlledActor())
+        CheckScriptOwnership(pController->GetControlledActor());
+}
+
+// Wraps a member function in the guard for its object, or for shared state if it reaches beyond its object no matter what
+template <class FUNCTION, FUNCTION function, bool shared>
+struct LaneGuard;
+
+template <class TYPE, class RETURN, class... ARGS, RETURN (TYPE::*function)(ARGS...), bool shared>
+struct LaneGuard<RETURN (TYPE::*)(ARGS...), function, shared>
+{
+    static RETURN Call(TYPE *pThis, ARGS... args)
+    {
+        if (shared)
+            CheckSharedChange();
+        else
+            CheckScriptOwnership(pThis);
+        return (pThis->*function)(args...);
+    }
+};
+
+template <class TYPE, class RETURN, class... ARGS, RETURN (TYPE::*function)(ARGS...) const, bool shared>
+struct LaneGuard<RETURN (TYPE::*)(ARGS...) const, function, shared>
+{
+    static RETURN Call(const TYPE *pThis, ARGS... args)
+    {
+        if (shared)
+            CheckSharedChange();
+        else
+            CheckScriptOwnership(pThis);
+        return (pThis->*function)(args...);
+    }
+};
+
+#define LANEGUARD(FUNCTION) &LaneGuard<decltype(FUNCTION), FUNCTION, false>::Call
+#define SHAREDGUARD(FUNCTION) &LaneGuard<decltype(FUNCTION), FUNCTION, true>::Call
 
 /*
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -410,6 +618,12 @@ void LuaMan::Clear()
     m_NextPresetID = 0;
     m_NextObjectID = 0;
     m_pTempEntity = 0;
+    m_ParallelScriptThreads = -1;
+    m_ScriptLanes.clear();
+    m_pParallelBatch = 0;
+    m_ParallelBatchNumber = 0;
+    m_BusyScriptHelpers = 0;
+    m_StopScriptHelpers = false;
 
 	//Clear files list
 	for (int i = 0; i < MAX_OPEN_FILES; ++i)
@@ -425,35 +639,99 @@ int LuaMan::Create()
 {
     // Create the master state
     m_pMasterState = lua_open();
-    // Attach the master state to LuaBind
-    open(m_pMasterState);
-    // Open the lua libs for the master state
-    //luaL_openlibs(m_pMasterState);
+    InitializeState(m_pMasterState);
+
+    return 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Replacements for math.random and math.randomseed, which work the same as the stock
+// ones but draw from GetThreadRandom. That stream is seeded along with the rest of the
+// game, and each script lane draws from one of its own, where the stock ones would share
+// the CRT rand() between all threads.
+
+static int LuaMathRandom(lua_State *pState)
+{
+    lua_Number random = GetThreadRandom().PosRand();
+    switch (lua_gettop(pState))
+    {
+        case 0:
+            lua_pushnumber(pState, random);
+            break;
+        case 1:
+        {
+            int upper = luaL_checkint(pState, 1);
+            luaL_argcheck(pState, 1 <= upper, 1, "interval is empty");
+            lua_pushnumber(pState, floor(random * upper) + 1);
+            break;
+        }
+        case 2:
+        {
+            int lower = luaL_checkint(pState, 1);
+            int upper = luaL_checkint(pState, 2);
+            luaL_argcheck(pState, lower <= upper, 2, "interval is empty");
+            lua_pushnumber(pState, floor(random * (upper - lower + 1)) + lower);
+            break;
+        }
+        default:
+            return luaL_error(pState, "wrong number of arguments");
+    }
+    return 1;
+}
+
+static int LuaMathRandomSeed(lua_State *pState)
+{
+    GetThreadRandom().Seed((unsigned int)luaL_checkint(pState, 1), 0);
+    return 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          InitializeState
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Opens the libraries and registers all the bindings and manager
+//                  globals in a newly created Lua state.
+
+void LuaMan::InitializeState(lua_State *pState)
+{
+    // Attach the state to LuaBind
+    open(pState);
+    // Open the lua libs for the state
+    //luaL_openlibs(pState);
 
 	// Load only libraries we need
-	lua_pushcfunction(m_pMasterState, luaopen_base);
-	lua_pushliteral(m_pMasterState, LUA_COLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(pState, luaopen_base);
+	lua_pushliteral(pState, LUA_COLIBNAME);
+	lua_call(pState, 1, 0);
+
+	lua_pushcfunction(pState, luaopen_table);
+	lua_pushliteral(pState, LUA_TABLIBNAME);
+	lua_call(pState, 1, 0);
 
-	lua_pushcfunction(m_pMasterState, luaopen_table);
-	lua_pushliteral(m_pMasterState, LUA_TABLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(pState, luaopen_string);
+	lua_pushliteral(pState, LUA_STRLIBNAME);
+	lua_call(pState, 1, 0);
 
-	lua_pushcfunction(m_pMasterState, luaopen_string);
-	lua_pushliteral(m_pMasterState, LUA_STRLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(pState, luaopen_math);
+	lua_pushliteral(pState, LUA_MATHLIBNAME);
+	lua_call(pState, 1, 0);
 
-	lua_pushcfunction(m_pMasterState, luaopen_math);
-	lua_pushliteral(m_pMasterState, LUA_MATHLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	// Have the math library's random functions use the calling thread's stream instead of the CRT rand()
+	lua_getglobal(pState, LUA_MATHLIBNAME);
+	lua_pushcfunction(pState, LuaMathRandom);
+	lua_setfield(pState, -2, "random");
+	lua_pushcfunction(pState, LuaMathRandomSeed);
+	lua_setfield(pState, -2, "randomseed");
+	lua_pop(pState, 1);
 
-	lua_pushcfunction(m_pMasterState, luaopen_debug);
-	lua_pushliteral(m_pMasterState, LUA_DBLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(pState, luaopen_debug);
+	lua_pushliteral(pState, LUA_DBLIBNAME);
+	lua_call(pState, 1, 0);
 
-	lua_pushcfunction(m_pMasterState, luaopen_package);
-	lua_pushliteral(m_pMasterState, LUA_LOADLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(pState, luaopen_package);
+	lua_pushliteral(pState, LUA_LOADLIBNAME);
+	lua_call(pState, 1, 0);
 
 
     // From LuaBind documentation:
@@ -462,8 +740,8 @@ int LuaMan::Create()
     // It is possible to set the error handler function that Luabind will use globally:
     //set_pcall_callback(&AddFileAndLineToError);
 
-    // Declare all useful classes in the master state
-    module(m_pMasterState)
+    // Declare all useful classes in the state
+    module(pState)
     [
         class_<Vector>("Vector")
             .def(luabind::constructor<>())
@@ -554,16 +832,16 @@ int LuaMan::Create()
 
         class_<Entity/*, boost::shared_ptr<Entity> */>("Entity")
             .def("Clone", &CloneEntity)
-            .def("Reset", &Entity::Reset)
+            .def("Reset", LANEGUARD(&Entity::Reset))
             .def(tostring(const_self))
             .property("ClassName", &Entity::GetClassName)
-            .property("PresetName", &Entity::GetPresetName, &Entity::SetPresetName)
+            .property("PresetName", &Entity::GetPresetName, LANEGUARD(&Entity::SetPresetName))
             .def("GetModuleAndPresetName", &Entity::GetModuleAndPresetName)
             .property("IsOriginalPreset", &Entity::IsOriginalPreset)
             .property("ModuleID", &Entity::GetModuleID)
 			.property("RandomWeight", &Entity::GetRandomWeight)
-            .def("AddToGroup", &Entity::AddToGroup)
-            .def("IsInGroup", (bool (Entity::*)(const string &))&Entity::IsInGroup),
+            .def("AddToGroup", LANEGUARD(&Entity::AddToGroup))
+            .def("IsInGroup", &IsInGroup),
 
 		class_<Sound>("Sound")
 			.def(constructor<>())
@@ -573,14 +851,14 @@ int LuaMan::Create()
 			//.property("Loops", &Sound::GetLoopSetting, &Sound::SetLoopSetting),
 
         ABSTRACTLUABINDING(SceneObject, Entity)
-            .property("Pos", &SceneObject::GetPos, &SceneObject::SetPos)
-            .property("HFlipped", &SceneObject::IsHFlipped, &SceneObject::SetHFlipped)
-            .property("RotAngle", &SceneObject::GetRotAngle, &SceneObject::SetRotAngle)
-            .property("Team", &SceneObject::GetTeam, &SceneObject::SetTeam)
-            .property("PlacedByPlayer", &SceneObject::GetPlacedByPlayer, &SceneObject::SetPlacedByPlayer)
+            .property("Pos", &SceneObject::GetPos, LANEGUARD(&SceneObject::SetPos))
+            .property("HFlipped", &SceneObject::IsHFlipped, LANEGUARD(&SceneObject::SetHFlipped))
+            .property("RotAngle", &SceneObject::GetRotAngle, LANEGUARD(&SceneObject::SetRotAngle))
+            .property("Team", &SceneObject::GetTeam, LANEGUARD(&SceneObject::SetTeam))
+            .property("PlacedByPlayer", &SceneObject::GetPlacedByPlayer, LANEGUARD(&SceneObject::SetPlacedByPlayer))
             .def("GetGoldValue", &SceneObject::GetGoldValueOld)
             .def("GetGoldValue", &SceneObject::GetGoldValue)
-			.def("SetGoldValue", &SceneObject::SetGoldValue)
+			.def("SetGoldValue", LANEGUARD(&SceneObject::SetGoldValue))
 			.def("GetGoldValueString", &SceneObject::GetGoldValueString)
             .def("GetTotalValue", &SceneObject::GetTotalValueOld)
             .def("GetTotalValue", &SceneObject::GetTotalValue)
@@ -589,39 +867,39 @@ int LuaMan::Create()
 
         ABSTRACTLUABINDING(MovableObject, SceneObject)
 			.property("Material", &MovableObject::GetMaterial)
-			.def("ReloadScripts", &MovableObject::ReloadScripts)
-            .property("Mass", &MovableObject::GetMass, &MovableObject::SetMass)
-            .property("Pos", &MovableObject::GetPos, &MovableObject::SetPos)
-            .property("Vel", &MovableObject::GetVel, &MovableObject::SetVel)
-            .property("AngularVel", &MovableObject::GetAngularVel, &MovableObject::SetAngularVel)
+			.def("ReloadScripts", SHAREDGUARD(&MovableObject::ReloadScripts))
+            .property("Mass", &MovableObject::GetMass, LANEGUARD(&MovableObject::SetMass))
+            .property("Pos", &MovableObject::GetPos, LANEGUARD(&MovableObject::SetPos))
+            .property("Vel", &MovableObject::GetVel, LANEGUARD(&MovableObject::SetVel))
+            .property("AngularVel", &MovableObject::GetAngularVel, LANEGUARD(&MovableObject::SetAngularVel))
             .property("Radius", &MovableObject::GetRadius)
             .property("Diameter", &MovableObject::GetDiameter)
-            .property("Scale", &MovableObject::GetScale, &MovableObject::SetScale)
-            .property("EffectRotAngle", &MovableObject::GetEffectRotAngle, &MovableObject::SetEffectRotAngle)
-            .property("GlobalAccScalar", &MovableObject::GetGlobalAccScalar, &MovableObject::SetGlobalAccScalar)
-            .property("AirResistance", &MovableObject::GetAirResistance, &MovableObject::SetAirResistance)
-            .property("AirThreshold", &MovableObject::GetAirThreshold, &MovableObject::SetAirThreshold)
-            .property("Age", &MovableObject::GetAge, &MovableObject::SetAge)
-            .property("Lifetime", &MovableObject::GetLifetime, &MovableObject::SetLifetime)
+            .property("Scale", &MovableObject::GetScale, LANEGUARD(&MovableObject::SetScale))
+            .property("EffectRotAngle", &MovableObject::GetEffectRotAngle, LANEGUARD(&MovableObject::SetEffectRotAngle))
+            .property("GlobalAccScalar", &MovableObject::GetGlobalAccScalar, LANEGUARD(&MovableObject::SetGlobalAccScalar))
+            .property("AirResistance", &MovableObject::GetAirResistance, LANEGUARD(&MovableObject::SetAirResistance))
+            .property("AirThreshold", &MovableObject::GetAirThreshold, LANEGUARD(&MovableObject::SetAirThreshold))
+            .property("Age", &MovableObject::GetAge, LANEGUARD(&MovableObject::SetAge))
+            .property("Lifetime", &MovableObject::GetLifetime, LANEGUARD(&MovableObject::SetLifetime))
             .property("ID", &MovableObject::GetID)
             .property("UniqueID", &MovableObject::GetUniqueID)
             .property("RootID", &MovableObject::GetRootID)
             .property("MOIDFootprint", &MovableObject::GetMOIDFootprint)
-            .property("Sharpness", &MovableObject::GetSharpness, &MovableObject::SetSharpness)
+            .property("Sharpness", &MovableObject::GetSharpness, LANEGUARD(&MovableObject::SetSharpness))
             .def("GetAltitude", &MovableObject::GetAltitude)
             .property("AboveHUDPos", &MovableObject::GetAboveHUDPos)
-            .property("HitsMOs", &MovableObject::HitsMOs, &MovableObject::SetToHitMOs)
-            .property("GetsHitByMOs", &MovableObject::GetsHitByMOs, &MovableObject::SetToGetHitByMOs)
-            .property("IgnoresTeamHits", &MovableObject::IgnoresTeamHits, &MovableObject::SetIgnoresTeamHits)
+            .property("HitsMOs", &MovableObject::HitsMOs, LANEGUARD(&MovableObject::SetToHitMOs))
+            .property("GetsHitByMOs", &MovableObject::GetsHitByMOs, LANEGUARD(&MovableObject::SetToGetHitByMOs))
+            .property("IgnoresTeamHits", &MovableObject::IgnoresTeamHits, LANEGUARD(&MovableObject::SetIgnoresTeamHits))
             .property("IgnoresWhichTeam", &MovableObject::IgnoresWhichTeam)
-			.property("IgnoreTerrain", &MovableObject::IgnoreTerrain, &MovableObject::SetIgnoreTerrain)
-			.def("SetWhichMOToNotHit", &MovableObject::SetWhichMOToNotHit)
-            .property("ToSettle", &MovableObject::ToSettle, &MovableObject::SetToSettle)
-            .property("ToDelete", &MovableObject::ToDelete, &MovableObject::SetToDelete)
+			.property("IgnoreTerrain", &MovableObject::IgnoreTerrain, LANEGUARD(&MovableObject::SetIgnoreTerrain))
+			.def("SetWhichMOToNotHit", LANEGUARD(&MovableObject::SetWhichMOToNotHit))
+            .property("ToSettle", &MovableObject::ToSettle, LANEGUARD(&MovableObject::SetToSettle))
+            .property("ToDelete", &MovableObject::ToDelete, &SetToDelete)
             .def("IsSetToDelete", &MovableObject::IsSetToDelete)
-			.property("MissionCritical", &MovableObject::IsMissionCritical, &MovableObject::SetMissionCritical)
+			.property("MissionCritical", &MovableObject::IsMissionCritical, LANEGUARD(&MovableObject::SetMissionCritical))
 			.def("IsMissionCritical", &MovableObject::IsMissionCritical)
-			.property("HUDVisible", &MovableObject::GetHUDVisible, &MovableObject::SetHUDVisible)
+			.property("HUDVisible", &MovableObject::GetHUDVisible, LANEGUARD(&MovableObject::SetHUDVisible))
             .def("IsGeneric", &MovableObject::IsGeneric)
             .def("IsActor", &MovableObject::IsActor)
             .def("IsDevice", &MovableObject::IsDevice)
@@ -631,35 +909,37 @@ int LuaMan::Create()
             .def("IsThrownDevice", &MovableObject::IsThrownDevice)
             .def("HasObject", &MovableObject::HasObject)
             .def("HasObjectInGroup", &MovableObject::HasObjectInGroup)
-            .def("AddForce", &MovableObject::AddForce)
-            .def("AddAbsForce", &MovableObject::AddAbsForce)
-            .def("AddImpulseForce", &MovableObject::AddImpulseForce)
-            .def("AddAbsImpulseForce", &MovableObject::AddAbsImpulseForce)
-            .def("ClearForces", &MovableObject::ClearForces)
-            .def("ClearImpulseForces", &MovableObject::ClearImpulseForces)
+            .def("AddForce", &AddForce)
+            .def("AddAbsForce", &AddAbsForce)
+            .def("AddImpulseForce", &AddImpulseForce)
+            .def("AddAbsImpulseForce", &AddAbsImpulseForce)
+            .def("ClearForces", LANEGUARD(&MovableObject::ClearForces))
+            .def("ClearImpulseForces", LANEGUARD(&MovableObject::ClearImpulseForces))
 			.def("GetForcesCount", &MovableObject::GetForcesCount)
 			.def("GetForceVector", &MovableObject::GetForceVector)
 			.def("GetForceOffset", &MovableObject::GetForceOffset)
-			.def("SetForceVector", &MovableObject::SetForceVector)
-			.def("SetForceOffset", &MovableObject::SetForceOffset)
+			.def("SetForceVector", LANEGUARD(&MovableObject::SetForceVector))
+			.def("SetForceOffset", LANEGUARD(&MovableObject::SetForceOffset))
 			.def("GetImpulsesCount", &MovableObject::GetImpulsesCount)
 			.def("GetImpulseVector", &MovableObject::GetImpulseVector)
 			.def("GetImpulseOffset", &MovableObject::GetImpulseOffset)
-			.def("SetImpulseVector", &MovableObject::SetImpulseVector)
-			.def("SetImpulseOffset", &MovableObject::SetImpulseOffset)
-            .property("PinStrength", &MovableObject::GetPinStrength, &MovableObject::SetPinStrength)
-            .def("RestDetection", &MovableObject::RestDetection)
-            .def("NotResting", &MovableObject::NotResting)
+			.def("SetImpulseVector", LANEGUARD(&MovableObject::SetImpulseVector))
+			.def("SetImpulseOffset", LANEGUARD(&MovableObject::SetImpulseOffset))
+            .property("PinStrength", &MovableObject::GetPinStrength, LANEGUARD(&MovableObject::SetPinStrength))
+            .def("RestDetection", LANEGUARD(&MovableObject::RestDetection))
+            .def("NotResting", LANEGUARD(&MovableObject::NotResting))
             .def("IsAtRest", &MovableObject::IsAtRest)
-            .def("MoveOutOfTerrain", &MovableObject::MoveOutOfTerrain)
+            .def("IsAsleep", &MovableObject::IsAsleep)
+            .def("WakeUp", LANEGUARD(&MovableObject::WakeUp))
+            .def("MoveOutOfTerrain", LANEGUARD(&MovableObject::MoveOutOfTerrain))
             .def("RotateOffset", &MovableObject::RotateOffset)
-			.property("DamageOnCollision", &MovableObject::DamageOnCollision, &MovableObject::SetDamageOnCollision)
-			.property("DamageOnPenetration", &MovableObject::DamageOnPenetration, &MovableObject::SetDamageOnPenetration)
-			.property("WoundDamageMultiplier", &MovableObject::WoundDamageMultiplier, &MovableObject::SetWoundDamageMultiplier)
+			.property("DamageOnCollision", &MovableObject::DamageOnCollision, LANEGUARD(&MovableObject::SetDamageOnCollision))
+			.property("DamageOnPenetration", &MovableObject::DamageOnPenetration, LANEGUARD(&MovableObject::SetDamageOnPenetration))
+			.property("WoundDamageMultiplier", &MovableObject::WoundDamageMultiplier, LANEGUARD(&MovableObject::SetWoundDamageMultiplier))
 			.property("HitWhatMOID", &MovableObject::HitWhatMOID)
 			.property("HitWhatTerrMaterial", &MovableObject::HitWhatTerrMaterial)
-			.property("ProvidesPieMenuContext", &MovableObject::ProvidesPieMenuContext, &MovableObject::SetProvidesPieMenuContext)
-			.def_readwrite("PieMenuActor", &MovableObject::m_pPieMenuActor)
+			.property("ProvidesPieMenuContext", &MovableObject::ProvidesPieMenuContext, LANEGUARD(&MovableObject::SetProvidesPieMenuContext))
+			.property("PieMenuActor", &MovableObject::GetPieMenuActor, LANEGUARD(&MovableObject::SetPieMenuActor))
 			.property("HitWhatParticleUniqueID", &MovableObject::HitWhatParticleUniqueID),
 
 		class_<Material, Entity>("Material")
@@ -703,28 +983,28 @@ int LuaMan::Create()
             .property("Diameter", &MOSprite::GetDiameter)
             .property("BoundingBox", &MOSprite::GetBoundingBox)
             .property("FrameCount", &MOSprite::GetFrameCount)
-            .property("SpriteOffset", &MOSprite::GetSpriteOffset, &MOSprite::SetSpriteOffset)
-            .property("HFlipped", &MOSprite::IsHFlipped, &MOSprite::SetHFlipped)
-            .property("RotAngle", &MOSprite::GetRotAngle, &MOSprite::SetRotAngle)
-            .property("AngularVel", &MOSprite::GetAngularVel, &MOSprite::SetAngularVel)
-            .property("Frame", &MOSprite::GetFrame, &MOSprite::SetFrame)
-            .property("SpriteAnimMode", &MOSprite::GetSpriteAnimMode, &MOSprite::SetSpriteAnimMode)
-            .property("SpriteAnimDuration", &MOSprite::GetSpriteAnimDuration, &MOSprite::SetSpriteAnimDuration)
-            .def("SetNextFrame", &MOSprite::SetNextFrame)
+            .property("SpriteOffset", &MOSprite::GetSpriteOffset, LANEGUARD(&MOSprite::SetSpriteOffset))
+            .property("HFlipped", &MOSprite::IsHFlipped, LANEGUARD(&MOSprite::SetHFlipped))
+            .property("RotAngle", &MOSprite::GetRotAngle, LANEGUARD(&MOSprite::SetRotAngle))
+            .property("AngularVel", &MOSprite::GetAngularVel, LANEGUARD(&MOSprite::SetAngularVel))
+            .property("Frame", &MOSprite::GetFrame, LANEGUARD(&MOSprite::SetFrame))
+            .property("SpriteAnimMode", &MOSprite::GetSpriteAnimMode, LANEGUARD(&MOSprite::SetSpriteAnimMode))
+            .property("SpriteAnimDuration", &MOSprite::GetSpriteAnimDuration, LANEGUARD(&MOSprite::SetSpriteAnimDuration))
+            .def("SetNextFrame", LANEGUARD(&MOSprite::SetNextFrame))
             .def("IsTooFast", &MOSprite::IsTooFast)
             .def("IsOnScenePoint", &MOSprite::IsOnScenePoint)
             .def("RotateOffset", &MOSprite::RotateOffset)
             .def("UnRotateOffset", &MOSprite::UnRotateOffset)
             .def("GetSpriteWidth", &MOSprite::GetSpriteWidth)
             .def("GetSpriteHeight", &MOSprite::GetSpriteHeight)
-			.def("SetEntryWound", &MOSprite::SetEntryWound)
-			.def("SetExitWound", &MOSprite::SetExitWound)
+			.def("SetEntryWound", LANEGUARD(&MOSprite::SetEntryWound))
+			.def("SetExitWound", LANEGUARD(&MOSprite::SetExitWound))
 			.def("GetEntryWoundPresetName", &MOSprite::GetEntryWoundPresetName)
 			.def("GetExitWoundPresetName", &MOSprite::GetExitWoundPresetName),
 
         CONCRETELUABINDING(MOSParticle, MOSprite)
             /*.property("Material", &MOSParticle::GetMaterial)*/
-            .property("Framerate", &MOSParticle::GetFramerate, &MOSParticle::SetFramerate)
+            .property("Framerate", &MOSParticle::GetFramerate, LANEGUARD(&MOSParticle::SetFramerate))
 //            .property("Atom", &MOSParticle::GetAtom, &MOSParticle:SetAtom)
             .property("IsGold", &MOSParticle::IsGold),
 
@@ -733,36 +1013,36 @@ int LuaMan::Create()
             .property("RecoilForce", &MOSRotating::GetRecoilForce)
             .property("RecoilOffset", &MOSRotating::GetRecoilOffset)
             .property("IsGold", &MOSRotating::IsGold)
-			.property("TravelImpulse", &MOSRotating::GetTravelImpulse, &MOSRotating::SetTravelImpulse)
-			.property("GibWoundLimit", &MOSRotating::GetGibWoundLimit, &MOSRotating::SetGibWoundLimit)
-			.property("GibImpulseLimit", &MOSRotating::GetGibImpulseLimit, &MOSRotating::SetGibImpulseLimit)
-			.property("DamageMultiplier", &MOSRotating::GetDamageMultiplier, &MOSRotating::SetDamageMultiplier)
+			.property("TravelImpulse", &MOSRotating::GetTravelImpulse, LANEGUARD(&MOSRotating::SetTravelImpulse))
+			.property("GibWoundLimit", &MOSRotating::GetGibWoundLimit, LANEGUARD(&MOSRotating::SetGibWoundLimit))
+			.property("GibImpulseLimit", &MOSRotating::GetGibImpulseLimit, LANEGUARD(&MOSRotating::SetGibImpulseLimit))
+			.property("DamageMultiplier", &MOSRotating::GetDamageMultiplier, LANEGUARD(&MOSRotating::SetDamageMultiplier))
 			.property("WoundCount", &MOSRotating::GetWoundCount)
             .def_readwrite("Wounds", &MOSRotating::m_Emitters, return_stl_iterator)
-            .def("AddRecoil", &MOSRotating::AddRecoil)
-            .def("SetRecoil", &MOSRotating::SetRecoil)
+            .def("AddRecoil", LANEGUARD(&MOSRotating::AddRecoil))
+            .def("SetRecoil", LANEGUARD(&MOSRotating::SetRecoil))
             .def("IsRecoiled", &MOSRotating::IsRecoiled)
-            .def("EnableDeepCheck", &MOSRotating::EnableDeepCheck)
-            .def("ForceDeepCheck", &MOSRotating::ForceDeepCheck)
-            .def("GibThis", &MOSRotating::GibThis)
+            .def("EnableDeepCheck", LANEGUARD(&MOSRotating::EnableDeepCheck))
+            .def("ForceDeepCheck", LANEGUARD(&MOSRotating::ForceDeepCheck))
+            .def("GibThis", (void (*)(MOSRotating *, Vector, float, MovableObject *))&GibThis)
             // Free function bound as member function to emulate default variables
-            .def("GibThis", &GibThis)
-            .def("MoveOutOfTerrain", &MOSRotating::MoveOutOfTerrain)
-            .def("ApplyForces", &MOSRotating::ApplyForces)
-            .def("ApplyImpulses", &MOSRotating::ApplyImpulses)
-            .def("AttachEmitter", &MOSRotating::AttachEmitter, adopt(_2))
-			.def("RemoveWounds", &MOSRotating::RemoveWounds)
+            .def("GibThis", (void (*)(MOSRotating *))&GibThis)
+            .def("MoveOutOfTerrain", LANEGUARD(&MOSRotating::MoveOutOfTerrain))
+            .def("ApplyForces", LANEGUARD(&MOSRotating::ApplyForces))
+            .def("ApplyImpulses", LANEGUARD(&MOSRotating::ApplyImpulses))
+            .def("AttachEmitter", LANEGUARD(&MOSRotating::AttachEmitter), adopt(_2))
+			.def("RemoveWounds", LANEGUARD(&MOSRotating::RemoveWounds))
             .def("IsOnScenePoint", &MOSRotating::IsOnScenePoint)
-            .def("EraseFromTerrain", &MOSRotating::EraseFromTerrain)
+            .def("EraseFromTerrain", SHAREDGUARD(&MOSRotating::EraseFromTerrain))
             .def("GetStringValue", &MOSRotating::GetStringValue)
             .def("GetNumberValue", &MOSRotating::GetNumberValue)
             .def("GetObjectValue", &MOSRotating::GetObjectValue)
-            .def("SetStringValue", &MOSRotating::SetStringValue)
-            .def("SetNumberValue", &MOSRotating::SetNumberValue)
-            .def("SetObjectValue", &MOSRotating::SetObjectValue)
-            .def("RemoveStringValue", &MOSRotating::RemoveStringValue)
-            .def("RemoveNumberValue", &MOSRotating::RemoveNumberValue)
-            .def("RemoveObjectValue", &MOSRotating::RemoveObjectValue)
+            .def("SetStringValue", LANEGUARD(&MOSRotating::SetStringValue))
+            .def("SetNumberValue", LANEGUARD(&MOSRotating::SetNumberValue))
+            .def("SetObjectValue", LANEGUARD(&MOSRotating::SetObjectValue))
+            .def("RemoveStringValue", LANEGUARD(&MOSRotating::RemoveStringValue))
+            .def("RemoveNumberValue", LANEGUARD(&MOSRotating::RemoveNumberValue))
+            .def("RemoveObjectValue", LANEGUARD(&MOSRotating::RemoveObjectValue))
             .def("StringValueExists", &MOSRotating::StringValueExists)
             .def("NumberValueExists", &MOSRotating::NumberValueExists)
             .def("ObjectValueExists", &MOSRotating::ObjectValueExists)
@@ -774,23 +1054,23 @@ int LuaMan::Create()
             .def("GetRootParent", (const MovableObject * (Attachable::*)() const)&Attachable::GetRootParent)
 			.def("GetParent", (MovableObject * (Attachable::*)())&Attachable::GetParent)
 			.def("GetParent", (const MovableObject * (Attachable::*)() const)&Attachable::GetParent)
-			.property("ParentOffset", &Attachable::GetParentOffset, &Attachable::SetParentOffset)
-            .property("JointOffset", &Attachable::GetJointOffset, &Attachable::SetJointOffset)
-            .property("JointStiffness", &Attachable::GetJointStiffness, &Attachable::SetJointStiffness)
-            .property("JointStrength", &Attachable::GetJointStrength, &Attachable::SetJointStrength)
-            .property("RotTarget", &Attachable::GetRotTarget, &Attachable::SetRotTarget)
-            .property("AtomSubgroupID", &Attachable::GetAtomSubgroupID, &Attachable::SetAtomSubgroupID)
-            .property("OnlyLinearForces", &Attachable::GetOnlyLinearForces, &Attachable::SetOnlyLinearForces)
+			.property("ParentOffset", &Attachable::GetParentOffset, LANEGUARD(&Attachable::SetParentOffset))
+            .property("JointOffset", &Attachable::GetJointOffset, LANEGUARD(&Attachable::SetJointOffset))
+            .property("JointStiffness", &Attachable::GetJointStiffness, LANEGUARD(&Attachable::SetJointStiffness))
+            .property("JointStrength", &Attachable::GetJointStrength, LANEGUARD(&Attachable::SetJointStrength))
+            .property("RotTarget", &Attachable::GetRotTarget, LANEGUARD(&Attachable::SetRotTarget))
+            .property("AtomSubgroupID", &Attachable::GetAtomSubgroupID, LANEGUARD(&Attachable::SetAtomSubgroupID))
+            .property("OnlyLinearForces", &Attachable::GetOnlyLinearForces, LANEGUARD(&Attachable::SetOnlyLinearForces))
             .def("IsAttached", &Attachable::IsAttached)
             .def("IsAttachedTo", &Attachable::IsAttachedTo)
             .def("IsDrawnAfterParent", &Attachable::IsDrawnAfterParent)
-            .def("Attach", (void (Attachable::*)(MOSRotating *))&Attachable::Attach)
-            .def("Attach", (void (Attachable::*)(MOSRotating *, const Vector &))&Attachable::Attach)
-            .def("Detach", &Attachable::Detach)
-            .def("TransferJointForces", &Attachable::TransferJointForces)
-            .def("TransferJointImpulses", &Attachable::TransferJointImpulses)
-            .def("CollectDamage", &Attachable::CollectDamage)
-			.property("InheritsRotAngle", &Attachable::InheritsRotAngle, &Attachable::SetInheritsRotAngle),
+            .def("Attach", &LaneGuard<void (Attachable::*)(MOSRotating *), &Attachable::Attach, false>::Call)
+            .def("Attach", &LaneGuard<void (Attachable::*)(MOSRotating *, const Vector &), &Attachable::Attach, false>::Call)
+            .def("Detach", LANEGUARD(&Attachable::Detach))
+            .def("TransferJointForces", LANEGUARD(&Attachable::TransferJointForces))
+            .def("TransferJointImpulses", LANEGUARD(&Attachable::TransferJointImpulses))
+            .def("CollectDamage", LANEGUARD(&Attachable::CollectDamage))
+			.property("InheritsRotAngle", &Attachable::InheritsRotAngle, LANEGUARD(&Attachable::SetInheritsRotAngle)),
 
 		ABSTRACTLUABINDING(Emission, Entity)
 			.property("ParticlesPerMinute", &Emission::GetRate, &Emission::SetRate)
@@ -805,21 +1085,21 @@ int LuaMan::Create()
 
         CONCRETELUABINDING(AEmitter, Attachable)
             .def("IsEmitting", &AEmitter::IsEmitting)
-            .def("EnableEmission", &AEmitter::EnableEmission)
-            .property("BurstScale", &AEmitter::GetBurstScale, &AEmitter::SetBurstScale)
-            .property("EmitAngle", &AEmitter::GetEmitAngle, &AEmitter::SetEmitAngle)
-            .property("GetThrottle", &AEmitter::GetThrottle, &AEmitter::SetThrottle)
-            .property("Throttle", &AEmitter::GetThrottle, &AEmitter::SetThrottle)
-            .property("BurstSpacing", &AEmitter::GetBurstSpacing, &AEmitter::SetBurstSpacing)
-			.property("BurstDamage", &AEmitter::GetBurstDamage, &AEmitter::SetBurstDamage)
-			.property("EmitterDamageMultiplier", &AEmitter::GetEmitterDamageMultiplier, &AEmitter::SetEmitterDamageMultiplier)
-			.property("EmitCountLimit", &AEmitter::GetEmitCountLimit, &AEmitter::SetEmitCountLimit)
-			.property("EmitDamage", &AEmitter::GetEmitDamage, &AEmitter::SetEmitDamage)
-			.property("FlashScale", &AEmitter::GetFlashScale, &AEmitter::SetFlashScale)
+            .def("EnableEmission", LANEGUARD(&AEmitter::EnableEmission))
+            .property("BurstScale", &AEmitter::GetBurstScale, LANEGUARD(&AEmitter::SetBurstScale))
+            .property("EmitAngle", &AEmitter::GetEmitAngle, LANEGUARD(&AEmitter::SetEmitAngle))
+            .property("GetThrottle", &AEmitter::GetThrottle, LANEGUARD(&AEmitter::SetThrottle))
+            .property("Throttle", &AEmitter::GetThrottle, LANEGUARD(&AEmitter::SetThrottle))
+            .property("BurstSpacing", &AEmitter::GetBurstSpacing, LANEGUARD(&AEmitter::SetBurstSpacing))
+			.property("BurstDamage", &AEmitter::GetBurstDamage, LANEGUARD(&AEmitter::SetBurstDamage))
+			.property("EmitterDamageMultiplier", &AEmitter::GetEmitterDamageMultiplier, LANEGUARD(&AEmitter::SetEmitterDamageMultiplier))
+			.property("EmitCountLimit", &AEmitter::GetEmitCountLimit, LANEGUARD(&AEmitter::SetEmitCountLimit))
+			.property("EmitDamage", &AEmitter::GetEmitDamage, LANEGUARD(&AEmitter::SetEmitDamage))
+			.property("FlashScale", &AEmitter::GetFlashScale, LANEGUARD(&AEmitter::SetFlashScale))
 			.def("GetEmitVector", &AEmitter::GetEmitVector)
             .def("GetRecoilVector", &AEmitter::GetRecoilVector)
             .def("EstimateImpulse", &AEmitter::EstimateImpulse)
-            .def("TriggerBurst", &AEmitter::TriggerBurst)
+            .def("TriggerBurst", LANEGUARD(&AEmitter::TriggerBurst))
             .def("IsSetToBurst", &AEmitter::IsSetToBurst)
             .def("CanTriggerBurst", &AEmitter::CanTriggerBurst)
 			.def_readwrite("Emissions", &AEmitter::m_EmissionList, return_stl_iterator),
@@ -889,64 +1169,65 @@ int LuaMan::Create()
             .def("GetController", &Actor::GetController)
             .def("IsPlayerControlled", &Actor::IsPlayerControlled)
             .def("IsControllable", &Actor::IsControllable)
-            .def("SetControllerMode", &Actor::SetControllerMode)
-            .def("SwapControllerModes", &Actor::SwapControllerModes)
-			.property("ImpulseDamageThreshold", &Actor::GetTravelImpulseDamage, &Actor::SetTravelImpulseDamage)
-            .property("Status", &Actor::GetStatus, &Actor::SetStatus)
-            .property("Health", &Actor::GetHealth, &Actor::SetHealth)
-            .property("MaxHealth", &Actor::GetMaxHealth, &Actor::SetMaxHealth)
-            .property("GoldCarried", &Actor::GetGoldCarried, &Actor::SetGoldCarried)
-            .property("AimRange", &Actor::GetAimRange, &Actor::SetAimRange)
+            .def("SetControllerMode", LANEGUARD(&Actor::SetControllerMode))
+            .def("SwapControllerModes", LANEGUARD(&Actor::SwapControllerModes))
+			.property("ImpulseDamageThreshold", &Actor::GetTravelImpulseDamage, LANEGUARD(&Actor::SetTravelImpulseDamage))
+            .property("Status", &Actor::GetStatus, LANEGUARD(&Actor::SetStatus))
+            .property("Health", &Actor::GetHealth, &SetHealth)
+            .property("MaxHealth", &Actor::GetMaxHealth, LANEGUARD(&Actor::SetMaxHealth))
+            .property("GoldCarried", &Actor::GetGoldCarried, LANEGUARD(&Actor::SetGoldCarried))
+            .property("AimRange", &Actor::GetAimRange, LANEGUARD(&Actor::SetAimRange))
             .def("GetAimAngle", &Actor::GetAimAngle)
-            .def("SetAimAngle", &Actor::SetAimAngle)
+            .def("SetAimAngle", LANEGUARD(&Actor::SetAimAngle))
             .def("HasObject", &Actor::HasObject)
             .def("HasObjectInGroup", &Actor::HasObjectInGroup)
             .property("CPUPos", &Actor::GetCPUPos)
             .property("EyePos", &Actor::GetEyePos)
-            .property("ViewPoint", &Actor::GetViewPoint, &Actor::SetViewPoint)
+            .property("ViewPoint", &Actor::GetViewPoint, LANEGUARD(&Actor::SetViewPoint))
             .property("Height", &Actor::GetHeight)
             .def("IsWithinRange", &Actor::IsWithinRange)
-            .def("AddHealth", &Actor::AddHealth)
+            .def("AddHealth", LANEGUARD(&Actor::AddHealth))
             .def("IsStatus", &Actor::IsStatus)
             .def("IsDead", &Actor::IsDead)
             .def("FacingAngle", &Actor::FacingAngle)
-            .property("AIMode", &Actor::GetAIMode, &Actor::SetAIMode)
+            .property("AIMode", &Actor::GetAIMode, LANEGUARD(&Actor::SetAIMode))
 			.property("DeploymentID", &Actor::GetDeploymentID)
-			.def("AddAISceneWaypoint", &Actor::AddAISceneWaypoint)
-            .def("AddAIMOWaypoint", &Actor::AddAIMOWaypoint)
-            .def("ClearAIWaypoints", &Actor::ClearAIWaypoints)
+			.def("AddAISceneWaypoint", LANEGUARD(&Actor::AddAISceneWaypoint))
+            .def("AddAIMOWaypoint", LANEGUARD(&Actor::AddAIMOWaypoint))
+            .def("ClearAIWaypoints", LANEGUARD(&Actor::ClearAIWaypoints))
             .def("GetLastAIWaypoint", &Actor::GetLastAIWaypoint)
             .def("GetAIMOWaypointID", &Actor::GetAIMOWaypointID)
             .def("GetWaypointListSize", &Actor::GetWaypointsSize)
-            .def("ClearMovePath", &Actor::ClearMovePath)
-            .def("AddToMovePathBeginning", &Actor::AddToMovePathBeginning)
-            .def("AddToMovePathEnd", &Actor::AddToMovePathEnd)
-            .def("RemoveMovePathBeginning", &Actor::RemoveMovePathBeginning)
-            .def("RemoveMovePathEnd", &Actor::RemoveMovePathEnd)
-            .property("Perceptiveness", &Actor::GetPerceptiveness, &Actor::SetPerceptiveness)
-            .def("AddInventoryItem", &Actor::AddInventoryItem, adopt(_2))
-            .def("RemoveInventoryItem", &Actor::RemoveInventoryItem)
-            .def("SwapNextInventory", &Actor::SwapNextInventory)
-            .def("SwapPrevInventory", &Actor::SwapPrevInventory)
-            .def("DropAllInventory", &Actor::DropAllInventory)
+            .def("ClearMovePath", LANEGUARD(&Actor::ClearMovePath))
+            .def("AddToMovePathBeginning", LANEGUARD(&Actor::AddToMovePathBeginning))
+            .def("AddToMovePathEnd", LANEGUARD(&Actor::AddToMovePathEnd))
+            .def("RemoveMovePathBeginning", LANEGUARD(&Actor::RemoveMovePathBeginning))
+            .def("RemoveMovePathEnd", LANEGUARD(&Actor::RemoveMovePathEnd))
+            .property("Perceptiveness", &Actor::GetPerceptiveness, LANEGUARD(&Actor::SetPerceptiveness))
+            .property("AIUpdateTime", &Actor::GetAIUpdateTime)
+            .def("AddInventoryItem", LANEGUARD(&Actor::AddInventoryItem), adopt(_2))
+            .def("RemoveInventoryItem", LANEGUARD(&Actor::RemoveInventoryItem))
+            .def("SwapNextInventory", LANEGUARD(&Actor::SwapNextInventory))
+            .def("SwapPrevInventory", LANEGUARD(&Actor::SwapPrevInventory))
+            .def("DropAllInventory", LANEGUARD(&Actor::DropAllInventory))
             .property("InventorySize", &Actor::GetInventorySize)
             .def("IsInventoryEmpty", &Actor::IsInventoryEmpty)
             .property("MaxMass", &Actor::GetMaxMass)
-            .def("FlashWhite", &Actor::FlashWhite)
-            .def("DrawWaypoints", &Actor::DrawWaypoints)
-            .def("SetMovePathToUpdate", &Actor::SetMovePathToUpdate)
-            .def("UpdateMovePath", &Actor::UpdateMovePath)
+            .def("FlashWhite", LANEGUARD(&Actor::FlashWhite))
+            .def("DrawWaypoints", LANEGUARD(&Actor::DrawWaypoints))
+            .def("SetMovePathToUpdate", LANEGUARD(&Actor::SetMovePathToUpdate))
+            .def("UpdateMovePath", SHAREDGUARD(&Actor::UpdateMovePath))
             .property("MovePathSize", &Actor::GetMovePathSize)
-            .def_readwrite("MOMoveTarget", &Actor::m_pMOMoveTarget)
+            .property("MOMoveTarget", &Actor::GetMOMoveTarget, LANEGUARD(&Actor::SetMOMoveTarget))
             .def_readwrite("MovePath", &Actor::m_MovePath, return_stl_iterator)
             .def_readwrite("Inventory", &Actor::m_Inventory, return_stl_iterator)
-            .def("SetAlarmPoint", &Actor::AlarmPoint)
+            .def("SetAlarmPoint", LANEGUARD(&Actor::AlarmPoint))
             .def("GetAlarmPoint", &Actor::GetAlarmPoint)
-            .property("AimDistance", &Actor::GetAimDistance, &Actor::SetAimDistance)
-			.property("SightDistance", &Actor::GetSightDistance, &Actor::SetSightDistance)
+            .property("AimDistance", &Actor::GetAimDistance, LANEGUARD(&Actor::SetAimDistance))
+			.property("SightDistance", &Actor::GetSightDistance, LANEGUARD(&Actor::SetSightDistance))
 			.property("TotalWoundCount", &Actor::GetTotalWoundCount)
 			.property("TotalWoundLimit", &Actor::GetTotalWoundLimit)
-            .def("RemoveAnyRandomWounds", &Actor::RemoveAnyRandomWounds),
+            .def("RemoveAnyRandomWounds", LANEGUARD(&Actor::RemoveAnyRandomWounds)),
 
         CONCRETELUABINDING(ADoor, Actor)
 			.enum_("DooorState")
@@ -958,13 +1239,13 @@ int LuaMan::Create()
 			]
             .property("Door", &ADoor::GetDoor)
 			.def("GetDoorState", &ADoor::GetDoorState)
-			.def("OpenDoor", &ADoor::OpenDoor)
-			.def("CloseDoor", &ADoor::CloseDoor)
-			.def("SetClosedByDefault", &ADoor::SetClosedByDefault),
+			.def("OpenDoor", LANEGUARD(&ADoor::OpenDoor))
+			.def("CloseDoor", LANEGUARD(&ADoor::CloseDoor))
+			.def("SetClosedByDefault", LANEGUARD(&ADoor::SetClosedByDefault)),
 
 		ABSTRACTLUABINDING(Arm, Attachable)
-			.property("IdleOffset", &Arm::GetIdleOffset, &Arm::SetIdleOffset)
-			.property("HandPos", &Arm::GetHandPos, &Arm::SetHandPos),
+			.property("IdleOffset", &Arm::GetIdleOffset, LANEGUARD(&Arm::SetIdleOffset))
+			.property("HandPos", &Arm::GetHandPos, LANEGUARD(&Arm::SetHandPos)),
 
         CONCRETELUABINDING(AHuman, Actor)
             .enum_("UpperBodyState")
@@ -1046,17 +1327,17 @@ int LuaMan::Create()
             .property("FGLeg", &AHuman::GetFGLeg)
             .property("BGLeg", &AHuman::GetBGLeg)
             .property("Jetpack", &AHuman::GetJetpack)
-            .property("JetTimeTotal", &AHuman::GetJetTimeTotal, &AHuman::SetJetTimeTotal)
-            .property("JetTimeLeft", &AHuman::GetJetTimeLeft, &AHuman::SetJetTimeLeft)
-            .def("EquipFirearm", &AHuman::EquipFirearm)
-            .def("EquipThrowable", &AHuman::EquipThrowable)
-            .def("EquipDiggingTool", &AHuman::EquipDiggingTool)
-            .def("EquipShield", &AHuman::EquipShield)
-            .def("EquipShieldInBGArm", &AHuman::EquipShieldInBGArm)
-            .def("EquipDeviceInGroup", &AHuman::EquipDeviceInGroup)
-            .def("EquipNamedDevice", &AHuman::EquipNamedDevice)
-            .def("EquipLoadedFirearmInGroup", &AHuman::EquipLoadedFirearmInGroup)
-            .def("UnequipBGArm", &AHuman::UnequipBGArm)
+            .property("JetTimeTotal", &AHuman::GetJetTimeTotal, LANEGUARD(&AHuman::SetJetTimeTotal))
+            .property("JetTimeLeft", &AHuman::GetJetTimeLeft, LANEGUARD(&AHuman::SetJetTimeLeft))
+            .def("EquipFirearm", LANEGUARD(&AHuman::EquipFirearm))
+            .def("EquipThrowable", LANEGUARD(&AHuman::EquipThrowable))
+            .def("EquipDiggingTool", LANEGUARD(&AHuman::EquipDiggingTool))
+            .def("EquipShield", LANEGUARD(&AHuman::EquipShield))
+            .def("EquipShieldInBGArm", LANEGUARD(&AHuman::EquipShieldInBGArm))
+            .def("EquipDeviceInGroup", LANEGUARD(&AHuman::EquipDeviceInGroup))
+            .def("EquipNamedDevice", LANEGUARD(&AHuman::EquipNamedDevice))
+            .def("EquipLoadedFirearmInGroup", LANEGUARD(&AHuman::EquipLoadedFirearmInGroup))
+            .def("UnequipBGArm", LANEGUARD(&AHuman::UnequipBGArm))
             .property("EquippedItem", &AHuman::GetEquippedItem)
             .property("EquippedBGItem", &AHuman::GetEquippedBGItem)
             .property("FirearmIsReady", &AHuman::FirearmIsReady)
@@ -1065,15 +1346,15 @@ int LuaMan::Create()
             .property("FirearmNeedsReload", &AHuman::FirearmNeedsReload)
             .property("FirearmIsSemiAuto", &AHuman::FirearmIsSemiAuto)
             .property("FirearmActivationDelay", &AHuman::FirearmActivationDelay)
-            .def("ReloadFirearm", &AHuman::ReloadFirearm)
+            .def("ReloadFirearm", LANEGUARD(&AHuman::ReloadFirearm))
             .def("IsWithinRange", &AHuman::IsWithinRange)
-            .def("Look", &AHuman::Look)
+            .def("Look", SHAREDGUARD(&AHuman::Look))
             .def("LookForGold", &AHuman::LookForGold)
             .def("LookForMOs", &AHuman::LookForMOs)
             .def("IsOnScenePoint", &AHuman::IsOnScenePoint)
-			.property("LimbPathPushForce", &AHuman::GetLimbPathPushForce, &AHuman::SetLimbPathPushForce)
+			.property("LimbPathPushForce", &AHuman::GetLimbPathPushForce, LANEGUARD(&AHuman::SetLimbPathPushForce))
 			.def("GetLimbPathSpeed", &AHuman::GetLimbPathSpeed)
-			.def("SetLimbPathSpeed", &AHuman::SetLimbPathSpeed),
+			.def("SetLimbPathSpeed", LANEGUARD(&AHuman::SetLimbPathSpeed)),
         
 		CONCRETELUABINDING(ACrab, Actor)
             .enum_("MovementState")
@@ -1138,7 +1419,7 @@ int LuaMan::Create()
             .property("RFGLeg", &ACrab::GetRFGLeg)
             .property("RBGLeg", &ACrab::GetRBGLeg)
             .property("Jetpack", &ACrab::GetJetpack)
-            .property("JetTimeTotal", &ACrab::GetJetTimeTotal, &ACrab::SetJetTimeTotal)
+            .property("JetTimeTotal", &ACrab::GetJetTimeTotal, LANEGUARD(&ACrab::SetJetTimeTotal))
             .property("JetTimeLeft", &ACrab::GetJetTimeLeft)
             .property("EquippedItem", &ACrab::GetEquippedItem)
             .property("FirearmIsReady", &ACrab::FirearmIsReady)
@@ -1146,14 +1427,14 @@ int LuaMan::Create()
             .property("FirearmNeedsReload", &ACrab::FirearmNeedsReload)
             .property("FirearmIsSemiAuto", &ACrab::FirearmIsSemiAuto)
             .property("FirearmActivationDelay", &ACrab::FirearmActivationDelay)
-            .def("ReloadFirearm", &ACrab::ReloadFirearm)
+            .def("ReloadFirearm", LANEGUARD(&ACrab::ReloadFirearm))
             .def("IsWithinRange", &ACrab::IsWithinRange)
-            .def("Look", &ACrab::Look)
+            .def("Look", SHAREDGUARD(&ACrab::Look))
             .def("LookForMOs", &ACrab::LookForMOs)
             .def("IsOnScenePoint", &ACrab::IsOnScenePoint)
-			.property("LimbPathPushForce", &ACrab::GetLimbPathPushForce, &ACrab::SetLimbPathPushForce)
+			.property("LimbPathPushForce", &ACrab::GetLimbPathPushForce, LANEGUARD(&ACrab::SetLimbPathPushForce))
 			.def("GetLimbPathSpeed", &ACrab::GetLimbPathSpeed)
-			.def("SetLimbPathSpeed", &ACrab::SetLimbPathSpeed),
+			.def("SetLimbPathSpeed", LANEGUARD(&ACrab::SetLimbPathSpeed)),
 
         ABSTRACTLUABINDING(ACraft, Actor)
             .enum_("HatchState")
@@ -1184,8 +1465,8 @@ int LuaMan::Create()
                 value("DESCEND", 1),
                 value("ASCEND", 2)
             ]
-            .def("OpenHatch", &ACraft::OpenHatch)
-            .def("CloseHatch", &ACraft::CloseHatch)
+            .def("OpenHatch", LANEGUARD(&ACraft::OpenHatch))
+            .def("CloseHatch", LANEGUARD(&ACraft::CloseHatch))
             .property("HatchState", &ACraft::GetHatchState)
             .property("MaxPassengers", &ACraft::GetMaxPassengers)
             .property("DeliveryDelayMultiplier", &ACraft::GetDeliveryDelayMultiplier),
@@ -1197,8 +1478,8 @@ int LuaMan::Create()
             .property("LeftThruster", &ACDropShip::GetULThruster)
 			.property("LeftHatch", &ACDropShip::GetLHatch)
 			.property("RightHatch", &ACDropShip::GetRHatch)
-			.property("MaxEngineAngle", &ACDropShip::GetMaxEngineAngle, &ACDropShip::SetMaxEngineAngle)
-			.property("LateralControlSpeed", &ACDropShip::GetLateralControlSpeed, &ACDropShip::SetLateralControlSpeed)
+			.property("MaxEngineAngle", &ACDropShip::GetMaxEngineAngle, LANEGUARD(&ACDropShip::SetMaxEngineAngle))
+			.property("LateralControlSpeed", &ACDropShip::GetLateralControlSpeed, LANEGUARD(&ACDropShip::SetLateralControlSpeed))
 			.property("LateralControl", &ACDropShip::GetLateralControl)
 			.def("DetectObstacle", &ACDropShip::DetectObstacle)
             .def("GetAltitude", &ACDropShip::GetAltitude),
@@ -1223,32 +1504,32 @@ int LuaMan::Create()
             .property("SupportPos", &HeldDevice::GetSupportPos)
             .property("MagazinePos", &HeldDevice::GetMagazinePos)
             .property("MuzzlePos", &HeldDevice::GetMuzzlePos)
-            .property("MuzzleOffset", &HeldDevice::GetMuzzleOffset, &HeldDevice::SetMuzzleOffset)
-            .property("StanceOffset", &HeldDevice::GetStanceOffset, &HeldDevice::SetStanceOffset)
-            .property("SharpStanceOffset", &HeldDevice::GetSharpStanceOffset, &HeldDevice::SetSharpStanceOffset)
-            .property("SharpLength", &HeldDevice::GetSharpLength, &HeldDevice::SetSharpLength)
+            .property("MuzzleOffset", &HeldDevice::GetMuzzleOffset, LANEGUARD(&HeldDevice::SetMuzzleOffset))
+            .property("StanceOffset", &HeldDevice::GetStanceOffset, LANEGUARD(&HeldDevice::SetStanceOffset))
+            .property("SharpStanceOffset", &HeldDevice::GetSharpStanceOffset, LANEGUARD(&HeldDevice::SetSharpStanceOffset))
+            .property("SharpLength", &HeldDevice::GetSharpLength, LANEGUARD(&HeldDevice::SetSharpLength))
             .def("IsWeapon", &HeldDevice::IsWeapon)
             .def("IsTool", &HeldDevice::IsTool)
             .def("IsShield", &HeldDevice::IsShield)
             .def("IsDualWieldable", &HeldDevice::IsDualWieldable)
-            .def("SetDualWieldable", &HeldDevice::SetDualWieldable)
+            .def("SetDualWieldable", LANEGUARD(&HeldDevice::SetDualWieldable))
             .def("IsOneHanded", &HeldDevice::IsOneHanded)
-            .def("SetOneHanded", &HeldDevice::SetOneHanded)
-            .def("Activate", &HeldDevice::Activate)
-            .def("Deactivate", &HeldDevice::Deactivate)
-            .def("Reload", &HeldDevice::Reload)
+            .def("SetOneHanded", LANEGUARD(&HeldDevice::SetOneHanded))
+            .def("Activate", LANEGUARD(&HeldDevice::Activate))
+            .def("Deactivate", LANEGUARD(&HeldDevice::Deactivate))
+            .def("Reload", LANEGUARD(&HeldDevice::Reload))
             .def("IsActivated", &HeldDevice::IsActivated)
             .def("IsReloading", &HeldDevice::IsReloading)
             .def("DoneReloading", &HeldDevice::DoneReloading)
             .def("NeedsReloading", &HeldDevice::NeedsReloading)
             .def("IsFull", &HeldDevice::IsFull)
-			.property("SharpLength", &HeldDevice::GetSharpLength, &HeldDevice::SetSharpLength)
-			.property("SupportOffset", &HeldDevice::GetSupportOffset, &HeldDevice::SetSupportOffset)
-			.def("SetSupported", &HeldDevice::SetSupported),
+			.property("SharpLength", &HeldDevice::GetSharpLength, LANEGUARD(&HeldDevice::SetSharpLength))
+			.property("SupportOffset", &HeldDevice::GetSupportOffset, LANEGUARD(&HeldDevice::SetSupportOffset))
+			.def("SetSupported", LANEGUARD(&HeldDevice::SetSupported)),
 
         CONCRETELUABINDING(Magazine, Attachable)
             .property("NextRound", &Magazine::GetNextRound)
-            .property("RoundCount", &Magazine::GetRoundCount, &Magazine::SetRoundCount)
+            .property("RoundCount", &Magazine::GetRoundCount, LANEGUARD(&Magazine::SetRoundCount))
             .property("IsEmpty", &Magazine::IsEmpty)
             .property("IsFull", &Magazine::IsFull)
             .property("IsOverHalfFull", &Magazine::IsOverHalfFull)
@@ -1267,17 +1548,17 @@ int LuaMan::Create()
             .property("IsEmpty", &Round::IsEmpty),
 
         CONCRETELUABINDING(HDFirearm, HeldDevice)
-            .property("RateOfFire", &HDFirearm::GetRateOfFire, &HDFirearm::SetRateOfFire)
-			.property("FullAuto", &HDFirearm::IsFullAuto, &HDFirearm::SetFullAuto)
+            .property("RateOfFire", &HDFirearm::GetRateOfFire, LANEGUARD(&HDFirearm::SetRateOfFire))
+			.property("FullAuto", &HDFirearm::IsFullAuto, LANEGUARD(&HDFirearm::SetFullAuto))
             .property("RoundInMagCount", &HDFirearm::GetRoundInMagCount)
             .property("Magazine", &HDFirearm::GetMagazine)
-            .property("ActivationDelay", &HDFirearm::GetActivationDelay, &HDFirearm::SetActivationDelay)
-            .property("DeactivationDelay", &HDFirearm::GetDeactivationDelay, &HDFirearm::SetDeactivationDelay)
-            .property("ReloadTime", &HDFirearm::GetReloadTime, &HDFirearm::SetReloadTime)
-            .property("ShakeRange", &HDFirearm::GetShakeRange, &HDFirearm::SetShakeRange)
-            .property("SharpShakeRange", &HDFirearm::GetSharpShakeRange, &HDFirearm::SetSharpShakeRange)
-            .property("NoSupportFactor", &HDFirearm::GetNoSupportFactor, &HDFirearm::SetNoSupportFactor)
-            .property("ParticleSpreadRange", &HDFirearm::GetParticleSpreadRange, &HDFirearm::SetParticleSpreadRange)
+            .property("ActivationDelay", &HDFirearm::GetActivationDelay, LANEGUARD(&HDFirearm::SetActivationDelay))
+            .property("DeactivationDelay", &HDFirearm::GetDeactivationDelay, LANEGUARD(&HDFirearm::SetDeactivationDelay))
+            .property("ReloadTime", &HDFirearm::GetReloadTime, LANEGUARD(&HDFirearm::SetReloadTime))
+            .property("ShakeRange", &HDFirearm::GetShakeRange, LANEGUARD(&HDFirearm::SetShakeRange))
+            .property("SharpShakeRange", &HDFirearm::GetSharpShakeRange, LANEGUARD(&HDFirearm::SetSharpShakeRange))
+            .property("NoSupportFactor", &HDFirearm::GetNoSupportFactor, LANEGUARD(&HDFirearm::SetNoSupportFactor))
+            .property("ParticleSpreadRange", &HDFirearm::GetParticleSpreadRange, LANEGUARD(&HDFirearm::SetParticleSpreadRange))
 			.property("FiredOnce", &HDFirearm::FiredOnce)
 			.property("FiredFrame", &HDFirearm::FiredFrame)
 			.property("RoundsFired", &HDFirearm::RoundsFired)
@@ -1287,13 +1568,13 @@ int LuaMan::Create()
             .def("GetAIBlastRadius", &HDFirearm::GetAIBlastRadius)
             .def("GetAIPenetration", &HDFirearm::GetAIPenetration)
             .def("CompareTrajectories", &HDFirearm::CompareTrajectories)
-            .def("SetNextMagazineName", &HDFirearm::SetNextMagazineName)
-			.property("IsAnimatedManually", &HDFirearm::IsAnimatedManually, &HDFirearm::SetAnimatedManually)
-			.property("RecoilTransmission", &HDFirearm::GetRecoilTransmission, &HDFirearm::SetRecoilTransmission),
+            .def("SetNextMagazineName", LANEGUARD(&HDFirearm::SetNextMagazineName))
+			.property("IsAnimatedManually", &HDFirearm::IsAnimatedManually, LANEGUARD(&HDFirearm::SetAnimatedManually))
+			.property("RecoilTransmission", &HDFirearm::GetRecoilTransmission, LANEGUARD(&HDFirearm::SetRecoilTransmission)),
 
         CONCRETELUABINDING(ThrownDevice, HeldDevice)
-            .property("MinThrowVel", &ThrownDevice::GetMinThrowVel, &ThrownDevice::SetMinThrowVel)
-            .property("MaxThrowVel", &ThrownDevice::GetMaxThrowVel, &ThrownDevice::SetMaxThrowVel),
+            .property("MinThrowVel", &ThrownDevice::GetMinThrowVel, LANEGUARD(&ThrownDevice::SetMinThrowVel))
+            .property("MaxThrowVel", &ThrownDevice::GetMaxThrowVel, LANEGUARD(&ThrownDevice::SetMaxThrowVel)),
 
         CONCRETELUABINDING(TDExplosive, ThrownDevice),
 
@@ -1353,19 +1634,19 @@ int LuaMan::Create()
                 value("CIM_INPUTMODECOUNT", 4)
             ]
             .def(luabind::constructor<>())
-            .property("InputMode", &Controller::GetInputMode, &Controller::SetInputMode)
+            .property("InputMode", &Controller::GetInputMode, LANEGUARD(&Controller::SetInputMode))
             .def("IsPlayerControlled", &Controller::IsPlayerControlled)
-            .property("ControlledActor", &Controller::GetControlledActor, &Controller::SetControlledActor)
-            .property("Team", &Controller::GetTeam, &Controller::SetTeam)
-            .property("AnalogMove", &Controller::GetAnalogMove, &Controller::SetAnalogMove)
-            .property("AnalogAim", &Controller::GetAnalogAim, &Controller::SetAnalogAim)
+            .property("ControlledActor", &Controller::GetControlledActor, LANEGUARD(&Controller::SetControlledActor))
+            .property("Team", &Controller::GetTeam, LANEGUARD(&Controller::SetTeam))
+            .property("AnalogMove", &Controller::GetAnalogMove, LANEGUARD(&Controller::SetAnalogMove))
+            .property("AnalogAim", &Controller::GetAnalogAim, LANEGUARD(&Controller::SetAnalogAim))
             .property("AnalogCursor", &Controller::GetAnalogCursor)
             .def("RelativeCursorMovement", &Controller::RelativeCursorMovement)
-            .property("Player", &Controller::GetPlayer, &Controller::SetPlayer)
+            .property("Player", &Controller::GetPlayer, LANEGUARD(&Controller::SetPlayer))
             .def("IsMouseControlled", &Controller::IsMouseControlled)
             .property("MouseMovement", &Controller::GetMouseMovement)
-            .property("Disabled", &Controller::IsDisabled, &Controller::SetDisabled)
-            .def("SetState", &Controller::SetState)
+            .property("Disabled", &Controller::IsDisabled, LANEGUARD(&Controller::SetDisabled))
+            .def("SetState", LANEGUARD(&Controller::SetState))
             .def("IsState", &Controller::IsState),
 
         class_<Timer>("Timer")
@@ -1407,6 +1688,14 @@ int LuaMan::Create()
             .def("TimeForSimUpdate", &TimerMan::TimeForSimUpdate)
             .def("DrawnSimUpdate", &TimerMan::DrawnSimUpdate),
 
+        class_<PerformanceMan>("PerformanceManager")
+            .def("RegisterCounter", &PerformanceMan::RegisterCounter)
+            .def("GetCounterID", &PerformanceMan::GetCounterID)
+            .def("StartPerformanceMeasurement", &PerformanceMan::StartPerformanceMeasurement)
+            .def("StopPerformanceMeasurement", &PerformanceMan::StopPerformanceMeasurement)
+            .def("ResetStatistics", &PerformanceMan::ResetStatistics)
+            .def("DumpCounters", &PerformanceMan::DumpCounters),
+
         class_<FrameMan>("FrameManager")
             .def("ResetSplitScreens", &FrameMan::ResetSplitScreens)
             .property("PPM", &FrameMan::GetPPM, &FrameMan::SetPPM)
@@ -1478,24 +1767,25 @@ int LuaMan::Create()
             .def("ReloadAllScripts", &PresetMan::ReloadAllScripts),
 
         class_<AudioMan>("AudioManager")
-            .property("SoundsVolume", &AudioMan::GetSoundsVolume, &AudioMan::SetSoundsVolume)
-            .property("MusicVolume", &AudioMan::GetMusicVolume, &AudioMan::SetMusicVolume)
+            // The sound library isn't safe to call from several threads, so none of this can be used by thread-safe scripts
+            .property("SoundsVolume", &AudioMan::GetSoundsVolume, SHAREDGUARD(&AudioMan::SetSoundsVolume))
+            .property("MusicVolume", &AudioMan::GetMusicVolume, SHAREDGUARD(&AudioMan::SetMusicVolume))
 //            .def("PlayModule", &AudioMan::PlayModule)
-            .def("PlayMusic", &AudioMan::PlayMusic)
-            .def("QueueMusicStream", &AudioMan::QueueMusicStream)
-            .def("QueueSilence", &AudioMan::QueueSilence)
-            .def("ClearMusicQueue", &AudioMan::ClearMusicQueue)
-            .def("PlaySound", (Sound * (AudioMan::*)(const char *, float, bool, bool, int))&AudioMan::PlaySound)
-            .def("PlaySound", (void (AudioMan::*)(const char *))&AudioMan::PlaySound)
-            .def("SetSoundAttenuation", &AudioMan::SetSoundAttenuation)
-            .def("IsPlaying", &AudioMan::IsPlaying)
-            .def("IsMusicPlaying", &AudioMan::IsMusicPlaying)
+            .def("PlayMusic", SHAREDGUARD(&AudioMan::PlayMusic))
+            .def("QueueMusicStream", SHAREDGUARD(&AudioMan::QueueMusicStream))
+            .def("QueueSilence", SHAREDGUARD(&AudioMan::QueueSilence))
+            .def("ClearMusicQueue", SHAREDGUARD(&AudioMan::ClearMusicQueue))
+            .def("PlaySound", &LaneGuard<Sound * (AudioMan::*)(const char *, float, bool, bool, int), &AudioMan::PlaySound, true>::Call)
+            .def("PlaySound", &LaneGuard<void (AudioMan::*)(const char *), &AudioMan::PlaySound, true>::Call)
+            .def("SetSoundAttenuation", SHAREDGUARD(&AudioMan::SetSoundAttenuation))
+            .def("IsPlaying", SHAREDGUARD(&AudioMan::IsPlaying))
+            .def("IsMusicPlaying", SHAREDGUARD(&AudioMan::IsMusicPlaying))
             //.def("StopSound", &AudioMan::StopSound)
             //.def("FadeOutSound", &AudioMan::FadeOutSound)
-            .def("StopMusic", &AudioMan::StopMusic)
-            .def("SetMusicPosition", &AudioMan::SetMusicPosition)
-			.def("GetMusicPosition", &AudioMan::GetMusicPosition)
-			.def("StopAll", &AudioMan::StopMusic),
+            .def("StopMusic", SHAREDGUARD(&AudioMan::StopMusic))
+            .def("SetMusicPosition", SHAREDGUARD(&AudioMan::SetMusicPosition))
+			.def("GetMusicPosition", SHAREDGUARD(&AudioMan::GetMusicPosition))
+			.def("StopAll", SHAREDGUARD(&AudioMan::StopMusic)),
 
         class_<UInputMan>("UInputManager")
             .enum_("Players")
@@ -1632,35 +1922,35 @@ int LuaMan::Create()
                 value("AIPLAN", 2),
                 value("PLACEDSETSCOUNT", 3)
             ]
-            .property("Location", &Scene::GetLocation, &Scene::SetLocation)
+            .property("Location", &Scene::GetLocation, LANEGUARD(&Scene::SetLocation))
 //            .property("Terrain", &Scene::GetTerrain)
             .property("Dimensions", &Scene::GetDimensions)
             .property("Width", &Scene::GetWidth)
             .property("Height", &Scene::GetHeight)
             .property("WrapsX", &Scene::WrapsX)
             .property("WrapsY", &Scene::WrapsY)
-            .property("TeamOwnership", &Scene::GetTeamOwnership, &Scene::SetTeamOwnership)
+            .property("TeamOwnership", &Scene::GetTeamOwnership, LANEGUARD(&Scene::SetTeamOwnership))
             .def("GetBuildBudget", &Scene::GetBuildBudget)
-            .def("SetBuildBudget", &Scene::SetBuildBudget)
+            .def("SetBuildBudget", LANEGUARD(&Scene::SetBuildBudget))
             .def("IsScanScheduled", &Scene::IsScanScheduled)
-            .def("SetScheduledScan", &Scene::SetScheduledScan)
-            .def("ClearPlacedObjectSet", &Scene::ClearPlacedObjectSet)
-            .def("PlaceResidentBrain", &Scene::PlaceResidentBrain)
-            .def("PlaceResidentBrains", &Scene::PlaceResidentBrains)
-            .def("RetrieveResidentBrains", &Scene::RetrieveResidentBrains)
+            .def("SetScheduledScan", LANEGUARD(&Scene::SetScheduledScan))
+            .def("ClearPlacedObjectSet", LANEGUARD(&Scene::ClearPlacedObjectSet))
+            .def("PlaceResidentBrain", LANEGUARD(&Scene::PlaceResidentBrain))
+            .def("PlaceResidentBrains", LANEGUARD(&Scene::PlaceResidentBrains))
+            .def("RetrieveResidentBrains", LANEGUARD(&Scene::RetrieveResidentBrains))
             .def("GetResidentBrain", &Scene::GetResidentBrain)
-            .def("SetResidentBrain", &Scene::SetResidentBrain)
-            .def("SetArea", &Scene::SetArea)
+            .def("SetResidentBrain", LANEGUARD(&Scene::SetResidentBrain))
+            .def("SetArea", LANEGUARD(&Scene::SetArea))
             .def("HasArea", &Scene::HasArea)
             .def("GetArea", &Scene::GetArea)
 			.def("GetOptionalArea", &Scene::GetOptionalArea)
 			.def("WithinArea", &Scene::WithinArea)
-            .property("GlobalAcc", &Scene::GetGlobalAcc, &Scene::SetGlobalAcc)
-			.property("GlocalAcc", &Scene::GetGlobalAcc, &Scene::SetGlobalAcc)
-			.def("ResetPathFinding", &Scene::ResetPathFinding)
-            .def("UpdatePathFinding", &Scene::UpdatePathFinding)
+            .property("GlobalAcc", &Scene::GetGlobalAcc, LANEGUARD(&Scene::SetGlobalAcc))
+			.property("GlocalAcc", &Scene::GetGlobalAcc, LANEGUARD(&Scene::SetGlobalAcc))
+			.def("ResetPathFinding", LANEGUARD(&Scene::ResetPathFinding))
+            .def("UpdatePathFinding", LANEGUARD(&Scene::UpdatePathFinding))
             .def("PathFindingUpdated", &Scene::PathFindingUpdated)
-            .def("CalculatePath", &Scene::CalculateScenePath)
+            .def("CalculatePath", LANEGUARD(&Scene::CalculateScenePath))
             .def_readwrite("ScenePath", &Scene::m_ScenePath, return_stl_iterator)
 			.def_readwrite("Deployments", &Scene::m_Deployments, return_stl_iterator)
 			.property("ScenePathSize", &Scene::GetScenePathSize),
@@ -1675,49 +1965,49 @@ int LuaMan::Create()
 
         class_<SceneMan>("SceneManager")
             .property("Scene", &SceneMan::GetScene)
-            .def("LoadScene", (int (SceneMan::*)(string, bool, bool))&SceneMan::LoadScene)
-            .def("LoadScene", (int (SceneMan::*)(string, bool))&SceneMan::LoadScene)
+            .def("LoadScene", &LaneGuard<int (SceneMan::*)(string, bool, bool), &SceneMan::LoadScene, false>::Call)
+            .def("LoadScene", &LaneGuard<int (SceneMan::*)(string, bool), &SceneMan::LoadScene, false>::Call)
             .property("SceneDim", &SceneMan::GetSceneDim)
             .property("SceneWidth", &SceneMan::GetSceneWidth)
             .property("SceneHeight", &SceneMan::GetSceneHeight)
             .property("SceneWrapsX", &SceneMan::SceneWrapsX)
             .property("SceneWrapsY", &SceneMan::SceneWrapsY)
             .def("GetOffset", &SceneMan::GetOffset)
-            .def("SetOffset", (void (SceneMan::*)(const Vector &, int))&SceneMan::SetOffset)
-            .def("SetOffsetX", &SceneMan::SetOffsetX)
-            .def("SetOffsetY", &SceneMan::SetOffsetY)
+            .def("SetOffset", &LaneGuard<void (SceneMan::*)(const Vector &, int), &SceneMan::SetOffset, false>::Call)
+            .def("SetOffsetX", LANEGUARD(&SceneMan::SetOffsetX))
+            .def("SetOffsetY", LANEGUARD(&SceneMan::SetOffsetY))
             .def("GetScreenOcclusion", &SceneMan::GetScreenOcclusion)
-            .def("SetScreenOcclusion", &SceneMan::SetScreenOcclusion)
+            .def("SetScreenOcclusion", LANEGUARD(&SceneMan::SetScreenOcclusion))
             .def("GetTerrain", &SceneMan::GetTerrain)
             .def("GetMaterial", &SceneMan::GetMaterial)
             .def("GetMaterialFromID", &SceneMan::GetMaterialFromID)
 //            .property("MOColorBitmap", &SceneMan::GetMOColorBitmap)
 //            .property("DebugBitmap", &SceneMan::GetDebugBitmap)
 //            .property("MOIDBitmap", &SceneMan::GetMOIDBitmap)
-            .property("LayerDrawMode", &SceneMan::GetLayerDrawMode, &SceneMan::SetLayerDrawMode)
+            .property("LayerDrawMode", &SceneMan::GetLayerDrawMode, LANEGUARD(&SceneMan::SetLayerDrawMode))
             .def("GetTerrMatter", &SceneMan::GetTerrMatter)
             .def("GetMOIDPixel", &SceneMan::GetMOIDPixel)
             .property("GlobalAcc", &SceneMan::GetGlobalAcc)
             .property("OzPerKg", &SceneMan::GetOzPerKg)
             .property("KgPerOz", &SceneMan::GetKgPerOz)
-            .def("SetLayerDrawMode", &SceneMan::SetLayerDrawMode)
-            .def("SetScroll", &SceneMan::SetScroll)
-            .def("SetScrollTarget", &SceneMan::SetScrollTarget)
+            .def("SetLayerDrawMode", LANEGUARD(&SceneMan::SetLayerDrawMode))
+            .def("SetScroll", LANEGUARD(&SceneMan::SetScroll))
+            .def("SetScrollTarget", LANEGUARD(&SceneMan::SetScrollTarget))
             .def("GetScrollTarget", &SceneMan::GetScrollTarget)
             .def("TargetDistanceScalar", &SceneMan::TargetDistanceScalar)
             .def("CheckOffset", &SceneMan::CheckOffset)
-            .def("LoadUnseenLayer", &SceneMan::LoadUnseenLayer)
-            .def("MakeAllUnseen", &SceneMan::MakeAllUnseen)
+            .def("LoadUnseenLayer", LANEGUARD(&SceneMan::LoadUnseenLayer))
+            .def("MakeAllUnseen", LANEGUARD(&SceneMan::MakeAllUnseen))
             .def("AnythingUnseen", &SceneMan::AnythingUnseen)
             .def("GetUnseenResolution", &SceneMan::GetUnseenResolution)
             .def("IsUnseen", &SceneMan::IsUnseen)
-            .def("RevealUnseen", &SceneMan::RevealUnseen)
-            .def("RevealUnseenBox", &SceneMan::RevealUnseenBox)
-            .def("RestoreUnseen", &SceneMan::RestoreUnseen)
-            .def("RestoreUnseenBox", &SceneMan::RestoreUnseenBox)
-			.def("CastSeeRay", &SceneMan::CastSeeRay)
-			.def("CastUnseeRay", &SceneMan::CastUnseeRay)
-			.def("CastUnseenRay", &SceneMan::CastUnseenRay)
+            .def("RevealUnseen", LANEGUARD(&SceneMan::RevealUnseen))
+            .def("RevealUnseenBox", LANEGUARD(&SceneMan::RevealUnseenBox))
+            .def("RestoreUnseen", LANEGUARD(&SceneMan::RestoreUnseen))
+            .def("RestoreUnseenBox", LANEGUARD(&SceneMan::RestoreUnseenBox))
+			.def("CastSeeRay", SHAREDGUARD(&SceneMan::CastSeeRay))
+			.def("CastUnseeRay", SHAREDGUARD(&SceneMan::CastUnseeRay))
+			.def("CastUnseenRay", SHAREDGUARD(&SceneMan::CastUnseenRay))
 			.def("CastMaterialRay", (bool (SceneMan::*)(const Vector &, const Vector &, unsigned char, Vector &, int, bool))&SceneMan::CastMaterialRay)
             .def("CastMaterialRay", (float (SceneMan::*)(const Vector &, const Vector &, unsigned char, int))&SceneMan::CastMaterialRay)
             .def("CastNotMaterialRay", (bool (SceneMan::*)(const Vector &, const Vector &, unsigned char, Vector &, int, bool))&SceneMan::CastNotMaterialRay)
@@ -1741,11 +2031,11 @@ int LuaMan::Create()
             .def("ShortestDistance", &SceneMan::ShortestDistance)
             .def("ObscuredPoint", (bool (SceneMan::*)(Vector &, int))&SceneMan::ObscuredPoint)//, out_value(_2))
             .def("ObscuredPoint", (bool (SceneMan::*)(int, int, int))&SceneMan::ObscuredPoint)
-            .def("RegisterPostEffect", &SceneMan::RegisterPostEffect)
-            .def("AddSceneObject", &SceneMan::AddSceneObject)
-            .def("AddTerrainObject", &SceneMan::AddTerrainObject)
-			.def("CheckAndRemoveOrphans", (int (SceneMan::*)(int, int, int, int, bool))&SceneMan::RemoveOrphans)
-            .def("ClearPostEffects", &SceneMan::ClearPostEffects),
+            .def("RegisterPostEffect", LANEGUARD(&SceneMan::RegisterPostEffect))
+            .def("AddSceneObject", &AddSceneObject)
+            .def("AddTerrainObject", &AddTerrainObject)
+			.def("CheckAndRemoveOrphans", &LaneGuard<int (SceneMan::*)(int, int, int, int, bool), &SceneMan::RemoveOrphans, false>::Call)
+            .def("ClearPostEffects", LANEGUARD(&SceneMan::ClearPostEffects)),
 
 		class_<DataModule>("DataModule")
 			.def_readwrite("Presets", &DataModule::m_EntityList, return_stl_iterator)
@@ -1867,26 +2157,26 @@ int LuaMan::Create()
             .def(constructor<>())
             .property("ClassName", &Activity::GetClassName)
             .property("Description", &Activity::GetDescription)
-            .property("InCampaignStage", &Activity::GetInCampaignStage, &Activity::SetInCampaignStage)
-            .property("ActivityState", &Activity::GetActivityState, &Activity::SetActivityState)
-            .property("SceneName", &Activity::GetSceneName, &Activity::SetSceneName)
-            .property("PlayerCount", &Activity::GetPlayerCount, &Activity::SetPlayerCount)
-            .def("DeactivatePlayer", &Activity::DeactivatePlayer)
+            .property("InCampaignStage", &Activity::GetInCampaignStage, LANEGUARD(&Activity::SetInCampaignStage))
+            .property("ActivityState", &Activity::GetActivityState, LANEGUARD(&Activity::SetActivityState))
+            .property("SceneName", &Activity::GetSceneName, LANEGUARD(&Activity::SetSceneName))
+            .property("PlayerCount", &Activity::GetPlayerCount, LANEGUARD(&Activity::SetPlayerCount))
+            .def("DeactivatePlayer", LANEGUARD(&Activity::DeactivatePlayer))
             .def("PlayerActive", &Activity::PlayerActive)
             .def("PlayerHuman", &Activity::PlayerHuman)
             .property("HumanCount", &Activity::GetHumanCount)
-            .property("TeamCount", &Activity::GetTeamCount, &Activity::SetTeamCount)
+            .property("TeamCount", &Activity::GetTeamCount, LANEGUARD(&Activity::SetTeamCount))
             .def("TeamActive", &Activity::TeamActive)
             .def("GetTeamOfPlayer", &Activity::GetTeamOfPlayer)
-            .def("SetTeamOfPlayer", &Activity::SetTeamOfPlayer)
+            .def("SetTeamOfPlayer", LANEGUARD(&Activity::SetTeamOfPlayer))
             .def("PlayersInTeamCount", &Activity::PlayersInTeamCount)
             .def("ScreenOfPlayer", &Activity::ScreenOfPlayer)
             .def("GetViewState", &Activity::GetViewState)
-            .def("SetViewState", &Activity::SetViewState)
+            .def("SetViewState", LANEGUARD(&Activity::SetViewState))
             .def("GetPlayerBrain", &Activity::GetPlayerBrain)
-            .def("SetPlayerBrain", &Activity::SetPlayerBrain)
+            .def("SetPlayerBrain", LANEGUARD(&Activity::SetPlayerBrain))
             .def("PlayerHadBrain", &Activity::PlayerHadBrain)
-            .def("SetBrainEvacuated", &Activity::SetBrainEvacuated)
+            .def("SetBrainEvacuated", LANEGUARD(&Activity::SetBrainEvacuated))
             .def("BrainWasEvacuated", &Activity::BrainWasEvacuated)
             .def("IsAssignedBrain", &Activity::IsAssignedBrain)
             .def("IsBrainOfWhichPlayer", &Activity::IsBrainOfWhichPlayer)
@@ -1894,24 +2184,24 @@ int LuaMan::Create()
             .def("HumanBrainCount", &Activity::HumanBrainCount)
             .def("AIBrainCount", &Activity::AIBrainCount)
             .def("GetControlledActor", &Activity::GetControlledActor)
-            .def("SetTeamFunds", &Activity::SetTeamFunds)
+            .def("SetTeamFunds", LANEGUARD(&Activity::SetTeamFunds))
             .def("GetTeamFunds", &Activity::GetTeamFunds)
-            .def("SetTeamAISkill", &Activity::SetTeamAISkill)
+            .def("SetTeamAISkill", LANEGUARD(&Activity::SetTeamAISkill))
             .def("GetTeamAISkill", &Activity::GetTeamAISkill)
-            .def("ChangeTeamFunds", &Activity::ChangeTeamFunds)
-            .def("TeamFundsChanged", &Activity::TeamFundsChanged)
-            .def("ReportDeath", &Activity::ReportDeath)
+            .def("ChangeTeamFunds", LANEGUARD(&Activity::ChangeTeamFunds))
+            .def("TeamFundsChanged", LANEGUARD(&Activity::TeamFundsChanged))
+            .def("ReportDeath", LANEGUARD(&Activity::ReportDeath))
             .def("GetTeamDeathCount", &Activity::GetTeamDeathCount)
             .def("Running", &Activity::Running)
             .def("Paused", &Activity::Paused)
             .def("ActivityOver", &Activity::ActivityOver)
-            .def("EnteredOrbit", &Activity::EnteredOrbit)
-            .def("SwitchToActor", &Activity::SwitchToActor)
-            .def("SwitchToNextActor", &Activity::SwitchToNextActor)
-            .def("SwitchToPrevActor", &Activity::SwitchToPrevActor)
-            .property("Difficulty", &Activity::GetDifficulty, &Activity::SetDifficulty)
+            .def("EnteredOrbit", LANEGUARD(&Activity::EnteredOrbit))
+            .def("SwitchToActor", LANEGUARD(&Activity::SwitchToActor))
+            .def("SwitchToNextActor", LANEGUARD(&Activity::SwitchToNextActor))
+            .def("SwitchToPrevActor", LANEGUARD(&Activity::SwitchToPrevActor))
+            .property("Difficulty", &Activity::GetDifficulty, LANEGUARD(&Activity::SetDifficulty))
             .def("IsPlayerTeam", &Activity::IsPlayerTeam)
-            .def("ResetMessageTimer", &Activity::ResetMessageTimer)
+            .def("ResetMessageTimer", LANEGUARD(&Activity::ResetMessageTimer))
 // These are defined later in GAScripted
 /*            .def("Start", &Activity::Start)
             .def("Pause", &Activity::Pause)
@@ -1958,15 +2248,15 @@ int LuaMan::Create()
                 value("ARROWUP", 3)
             ]
             .def(constructor<>())
-            .def("SetObservationTarget", &GameActivity::SetObservationTarget)
-            .def("SetDeathViewTarget", &GameActivity::SetDeathViewTarget)
-            .def("SetLandingZone", &GameActivity::SetLandingZone)
+            .def("SetObservationTarget", LANEGUARD(&GameActivity::SetObservationTarget))
+            .def("SetDeathViewTarget", LANEGUARD(&GameActivity::SetDeathViewTarget))
+            .def("SetLandingZone", LANEGUARD(&GameActivity::SetLandingZone))
             .def("GetLandingZone", &GameActivity::GetLandingZone)
-            .def("SetActorSelectCursor", &GameActivity::SetActorSelectCursor)
+            .def("SetActorSelectCursor", LANEGUARD(&GameActivity::SetActorSelectCursor))
             .def("GetBuyGUI", &GameActivity::GetBuyGUI)
             .def("GetEditorGUI", &GameActivity::GetEditorGUI)
-            .property("WinnerTeam", &GameActivity::GetWinnerTeam, &GameActivity::SetWinnerTeam)
-            .property("CPUTeam", &GameActivity::GetCPUTeam, &GameActivity::SetCPUTeam)
+            .property("WinnerTeam", &GameActivity::GetWinnerTeam, LANEGUARD(&GameActivity::SetWinnerTeam))
+            .property("CPUTeam", &GameActivity::GetCPUTeam, LANEGUARD(&GameActivity::SetCPUTeam))
 //            .def_readwrite("ActorCursor", &GameActivity::m_ActorCursor)
             .def_readwrite("CursorTimer", &GameActivity::m_CursorTimer)
             .def_readwrite("GameTimer", &GameActivity::m_GameTimer)
@@ -1981,39 +2271,39 @@ int LuaMan::Create()
             // Backwards compat
             .def("OnlyOneTeamLeft", &GameActivity::OneOrNoneTeamsLeft)
             .def("GetBanner", &GameActivity::GetBanner)
-            .def("SetLZArea", &GameActivity::SetLZArea)
+            .def("SetLZArea", LANEGUARD(&GameActivity::SetLZArea))
             .def("GetLZArea", &GameActivity::GetLZArea)
-            .def("SetBrainLZWidth", &GameActivity::SetBrainLZWidth)
+            .def("SetBrainLZWidth", LANEGUARD(&GameActivity::SetBrainLZWidth))
             .def("GetBrainLZWidth", &GameActivity::GetBrainLZWidth)
 			.def("GetActiveCPUTeamCount", &GameActivity::GetActiveCPUTeamCount)
 			.def("GetActiveHumanTeamCount", &GameActivity::GetActiveHumanTeamCount)
-			.def("AddObjectivePoint", &GameActivity::AddObjectivePoint)
-            .def("YSortObjectivePoints", &GameActivity::YSortObjectivePoints)
-            .def("ClearObjectivePoints", &GameActivity::ClearObjectivePoints)
-            .def("AddOverridePurchase", &GameActivity::AddOverridePurchase)
-            .def("SetOverridePurchaseList", (int (GameActivity::*)(const Loadout *, int))&GameActivity::SetOverridePurchaseList)
-            .def("SetOverridePurchaseList", (int (GameActivity::*)(string, int))&GameActivity::SetOverridePurchaseList)
-            .def("ClearOverridePurchase", &GameActivity::ClearOverridePurchase)
-            .def("CreateDelivery", (bool (GameActivity::*)(int))&GameActivity::CreateDelivery)
-            .def("CreateDelivery", (bool (GameActivity::*)(int, int))&GameActivity::CreateDelivery)
-            .def("CreateDelivery", (bool (GameActivity::*)(int, int, Vector&))&GameActivity::CreateDelivery)
-            .def("CreateDelivery", (bool (GameActivity::*)(int, int, Actor*))&GameActivity::CreateDelivery)
+			.def("AddObjectivePoint", LANEGUARD(&GameActivity::AddObjectivePoint))
+            .def("YSortObjectivePoints", LANEGUARD(&GameActivity::YSortObjectivePoints))
+            .def("ClearObjectivePoints", LANEGUARD(&GameActivity::ClearObjectivePoints))
+            .def("AddOverridePurchase", LANEGUARD(&GameActivity::AddOverridePurchase))
+            .def("SetOverridePurchaseList", &LaneGuard<int (GameActivity::*)(const Loadout *, int), &GameActivity::SetOverridePurchaseList, false>::Call)
+            .def("SetOverridePurchaseList", &LaneGuard<int (GameActivity::*)(string, int), &GameActivity::SetOverridePurchaseList, false>::Call)
+            .def("ClearOverridePurchase", LANEGUARD(&GameActivity::ClearOverridePurchase))
+            .def("CreateDelivery", &LaneGuard<bool (GameActivity::*)(int), &GameActivity::CreateDelivery, false>::Call)
+            .def("CreateDelivery", &LaneGuard<bool (GameActivity::*)(int, int), &GameActivity::CreateDelivery, false>::Call)
+            .def("CreateDelivery", &LaneGuard<bool (GameActivity::*)(int, int, Vector&), &GameActivity::CreateDelivery, false>::Call)
+            .def("CreateDelivery", &LaneGuard<bool (GameActivity::*)(int, int, Actor*), &GameActivity::CreateDelivery, false>::Call)
             .def("GetDeliveryCount", &GameActivity::GetDeliveryCount)
-            .property("DeliveryDelay", &GameActivity::GetDeliveryDelay, &GameActivity::SetDeliveryDelay)
+            .property("DeliveryDelay", &GameActivity::GetDeliveryDelay, LANEGUARD(&GameActivity::SetDeliveryDelay))
 			.def("GetTeamTech", &GameActivity::GetTeamTech)
-			.def("SetTeamTech", &GameActivity::SetTeamTech)
+			.def("SetTeamTech", LANEGUARD(&GameActivity::SetTeamTech))
 			.def("GetCrabToHumanSpawnRatio", &GameActivity::GetCrabToHumanSpawnRatio)
-			.property("BuyMenuEnabled", &GameActivity::GetBuyMenuEnabled, &GameActivity::SetBuyMenuEnabled)
-			.property("CraftsOrbitAtTheEdge", &GameActivity::GetCraftsOrbitAtTheEdge, &GameActivity::SetCraftsOrbitAtTheEdge)
+			.property("BuyMenuEnabled", &GameActivity::GetBuyMenuEnabled, LANEGUARD(&GameActivity::SetBuyMenuEnabled))
+			.property("CraftsOrbitAtTheEdge", &GameActivity::GetCraftsOrbitAtTheEdge, LANEGUARD(&GameActivity::SetCraftsOrbitAtTheEdge))
             .def("TeamIsCPU", &GameActivity::TeamIsCPU)
             .def("GetStartingGold", &GameActivity::GetStartingGold)
             .def("GetFogOfWarEnabled", &GameActivity::GetFogOfWarEnabled)
-            .def("UpdateEditing", &GameActivity::UpdateEditing)
-            .def("DisableAIs", &GameActivity::DisableAIs)
-            .def("InitAIs", &GameActivity::InitAIs)
-            .def("AddPieMenuSlice", &GameActivity::AddPieMenuSlice)
-            .def("AlterPieMenuSlice", &GameActivity::AlterPieMenuSlice)
-            .def("RemovePieMenuSlice", &GameActivity::RemovePieMenuSlice)
+            .def("UpdateEditing", LANEGUARD(&GameActivity::UpdateEditing))
+            .def("DisableAIs", LANEGUARD(&GameActivity::DisableAIs))
+            .def("InitAIs", LANEGUARD(&GameActivity::InitAIs))
+            .def("AddPieMenuSlice", LANEGUARD(&GameActivity::AddPieMenuSlice))
+            .def("AlterPieMenuSlice", LANEGUARD(&GameActivity::AlterPieMenuSlice))
+            .def("RemovePieMenuSlice", LANEGUARD(&GameActivity::RemovePieMenuSlice))
 			.def_readwrite("PieMenuSlices", &GameActivity::m_CurrentPieMenuSlices, return_stl_iterator),
 		
 		class_<PieMenuGUI::Slice>("Slice")
@@ -2079,18 +2369,20 @@ int LuaMan::Create()
 			.def("Deactivate", &GlobalScript::Deactivate),
 
         class_<ActivityMan>("ActivityManager")
-            .property("DefaultActivityType", &ActivityMan::GetDefaultActivityType, &ActivityMan::SetDefaultActivityType)
-            .property("DefaultActivityName", &ActivityMan::GetDefaultActivityName, &ActivityMan::SetDefaultActivityName)
+            .property("DefaultActivityType", &ActivityMan::GetDefaultActivityType, LANEGUARD(&ActivityMan::SetDefaultActivityType))
+            .property("DefaultActivityName", &ActivityMan::GetDefaultActivityName, LANEGUARD(&ActivityMan::SetDefaultActivityName))
+            .property("ActivitySeed", &ActivityMan::GetActivitySeed, LANEGUARD(&ActivityMan::SetActivitySeed))
+            .def("ClearActivitySeed", LANEGUARD(&ActivityMan::ClearActivitySeed))
             // Transfers ownership of the Activity to start into the ActivityMan, adopts ownership (_1 is the this ptr)
-            .def("SetStartActivity", &ActivityMan::SetStartActivity, adopt(_2))
+            .def("SetStartActivity", LANEGUARD(&ActivityMan::SetStartActivity), adopt(_2))
             .def("GetStartActivity", &ActivityMan::GetStartActivity)
             .def("GetActivity", &ActivityMan::GetActivity)
             // Transfers ownership of the Activity to start into the ActivityMan, adopts ownership (_1 is the this ptr)
-            .def("StartActivity", (int (ActivityMan::*)(Activity *))&ActivityMan::StartActivity, adopt(_2))
-            .def("StartActivity", (int (ActivityMan::*)(string, string))&ActivityMan::StartActivity)
-            .def("RestartActivity", &ActivityMan::RestartActivity)
-            .def("PauseActivity", &ActivityMan::PauseActivity)
-            .def("EndActivity", &ActivityMan::EndActivity)
+            .def("StartActivity", &LaneGuard<int (ActivityMan::*)(Activity *), &ActivityMan::StartActivity, false>::Call, adopt(_2))
+            .def("StartActivity", &LaneGuard<int (ActivityMan::*)(string, string), &ActivityMan::StartActivity, false>::Call)
+            .def("RestartActivity", LANEGUARD(&ActivityMan::RestartActivity))
+            .def("PauseActivity", LANEGUARD(&ActivityMan::PauseActivity))
+            .def("EndActivity", LANEGUARD(&ActivityMan::EndActivity))
             .def("ActivityRunning", &ActivityMan::ActivityRunning)
             .def("ActivityPaused", &ActivityMan::ActivityPaused),
 
@@ -2125,7 +2417,7 @@ int LuaMan::Create()
 			.def("FindObjectByUniqueID", &MovableMan::FindObjectByUniqueID)
 			.def("GetMOIDCount", &MovableMan::GetMOIDCount)
 			.def("GetTeamMOIDCount", &MovableMan::GetTeamMOIDCount)
-            .def("PurgeAllMOs", &MovableMan::PurgeAllMOs)
+            .def("PurgeAllMOs", LANEGUARD(&MovableMan::PurgeAllMOs))
             .def("GetNextActorInGroup", &MovableMan::GetNextActorInGroup)
             .def("GetPrevActorInGroup", &MovableMan::GetPrevActorInGroup)
             .def("GetNextTeamActor", &MovableMan::GetNextTeamActor)
@@ -2140,30 +2432,34 @@ int LuaMan::Create()
             .def("GetFirstOtherBrainActor", &MovableMan::GetFirstOtherBrainActor)
             .def("GetUnassignedBrain", &MovableMan::GetUnassignedBrain)
             .def("GetParticleCount", &MovableMan::GetParticleCount)
+            .def("GetSleepingCount", &MovableMan::GetSleepingCount)
+            .property("ItemSleepDelay", &MovableMan::GetSleepDelay, LANEGUARD(&MovableMan::SetSleepDelay))
             .def("GetAGResolution", &MovableMan::GetAGResolution)
             .def("GetSplashRatio", &MovableMan::GetSplashRatio)
-            .property("MaxDroppedItems", &MovableMan::GetMaxDroppedItems, &MovableMan::SetMaxDroppedItems)
-            .property("ScriptedEntity", &MovableMan::GetScriptedEntity, &MovableMan::SetScriptedEntity)
-            .def("SortTeamRoster", &MovableMan::SortTeamRoster)
-			.def("ChangeActorTeam", &MovableMan::ChangeActorTeam)
+            .property("MaxDroppedItems", &MovableMan::GetMaxDroppedItems, LANEGUARD(&MovableMan::SetMaxDroppedItems))
+            .property("AISensingInterval", &MovableMan::GetAISensingInterval, LANEGUARD(&MovableMan::SetAISensingInterval))
+            .property("AISensingBudget", &MovableMan::GetAISensingBudget, LANEGUARD(&MovableMan::SetAISensingBudget))
+            .property("ScriptedEntity", &MovableMan::GetScriptedEntity, LANEGUARD(&MovableMan::SetScriptedEntity))
+            .def("SortTeamRoster", LANEGUARD(&MovableMan::SortTeamRoster))
+			.def("ChangeActorTeam", LANEGUARD(&MovableMan::ChangeActorTeam))
 			.def("AddMO", &AddMO, adopt(_2))
             .def("AddActor", &AddActor, adopt(_2))
             .def("AddItem", &AddItem, adopt(_2))
             .def("AddParticle", &AddParticle, adopt(_2))
-            .def("RemoveActor", &MovableMan::RemoveActor)
-            .def("RemoveItem", &MovableMan::RemoveItem)
-            .def("RemoveParticle", &MovableMan::RemoveParticle)
+            .def("RemoveActor", LANEGUARD(&MovableMan::RemoveActor))
+            .def("RemoveItem", LANEGUARD(&MovableMan::RemoveItem))
+            .def("RemoveParticle", LANEGUARD(&MovableMan::RemoveParticle))
             .def("ValidMO", &MovableMan::ValidMO)
             .def("IsActor", &MovableMan::IsActor)
             .def("IsDevice", &MovableMan::IsDevice)
             .def("IsParticle", &MovableMan::IsParticle)
             .def("IsOfActor", &MovableMan::IsOfActor)
             .def("GetRootMOID", &MovableMan::GetRootMOID)
-            .def("RemoveMO", &MovableMan::RemoveMO)
-            .def("KillAllActors", &MovableMan::KillAllActors)
-            .def("OpenAllDoors", &MovableMan::OpenAllDoors)
+            .def("RemoveMO", LANEGUARD(&MovableMan::RemoveMO))
+            .def("KillAllActors", LANEGUARD(&MovableMan::KillAllActors))
+            .def("OpenAllDoors", LANEGUARD(&MovableMan::OpenAllDoors))
             .def("IsParticleSettlingEnabled", &MovableMan::IsParticleSettlingEnabled)
-            .def("EnableParticleSettling", &MovableMan::EnableParticleSettling)
+            .def("EnableParticleSettling", LANEGUARD(&MovableMan::EnableParticleSettling))
             .def("IsMOSubtractionEnabled", &MovableMan::IsMOSubtractionEnabled)
             .def_readwrite("Actors", &MovableMan::m_Actors, return_stl_iterator)
             .def_readwrite("Items", &MovableMan::m_Items, return_stl_iterator)
@@ -2175,7 +2471,7 @@ int LuaMan::Create()
             .def_readwrite("AddedAlarmEvents", &MovableMan::m_AddedAlarmEvents, return_stl_iterator),
 
         class_<ConsoleMan>("ConsoleManager")
-            .def("PrintString", &ConsoleMan::PrintString)
+            .def("PrintString", &PrintString)
             .def("SaveInputLog", &ConsoleMan::SaveInputLog)
             .def("SaveAllText", &ConsoleMan::SaveAllText)
             .def("Clear", &ConsoleMan::ClearLog)
@@ -2184,11 +2480,12 @@ int LuaMan::Create()
 
         class_<LuaMan>("LuaManager")
             .property("TempEntity", &LuaMan::GetTempEntity, &LuaMan::SetTempEntity)
-            .def("FileOpen", &LuaMan::FileOpen)
-            .def("FileClose", &LuaMan::FileClose)
-            .def("FileReadLine", &LuaMan::FileReadLine)
-            .def("FileWriteLine", &LuaMan::FileWriteLine)
-            .def("FileEOF", &LuaMan::FileEOF),
+            // The open files are shared by all states
+            .def("FileOpen", SHAREDGUARD(&LuaMan::FileOpen))
+            .def("FileClose", SHAREDGUARD(&LuaMan::FileClose))
+            .def("FileReadLine", SHAREDGUARD(&LuaMan::FileReadLine))
+            .def("FileWriteLine", SHAREDGUARD(&LuaMan::FileWriteLine))
+            .def("FileEOF", SHAREDGUARD(&LuaMan::FileEOF)),
 
         class_<SettingsMan>("SettingsdManager")
             .property("PrintDebugInfo", &SettingsMan::PrintDebugInfo, &SettingsMan::SetPrintDebugInfo)
@@ -2207,21 +2504,22 @@ int LuaMan::Create()
         def("Clamp", &Limit)
     ];
 
-    // Assign the manager instances to globals in the lua master state
-    globals(m_pMasterState)["TimerMan"] = &g_TimerMan;
-    globals(m_pMasterState)["FrameMan"] = &g_FrameMan;
-    globals(m_pMasterState)["PresetMan"] = &g_PresetMan;
-    globals(m_pMasterState)["AudioMan"] = &g_AudioMan;
-    globals(m_pMasterState)["UInputMan"] = &g_UInputMan;
-    globals(m_pMasterState)["SceneMan"] = &g_SceneMan;
-    globals(m_pMasterState)["ActivityMan"] = &g_ActivityMan;
-    globals(m_pMasterState)["MetaMan"] = &g_MetaMan;
-    globals(m_pMasterState)["MovableMan"] = &g_MovableMan;
-    globals(m_pMasterState)["ConsoleMan"] = &g_ConsoleMan;
-    globals(m_pMasterState)["LuaMan"] = &g_LuaMan;
-    globals(m_pMasterState)["SettingsMan"] = &g_SettingsMan;
-
-    luaL_dostring(m_pMasterState,
+    // Assign the manager instances to globals in the lua state
+    globals(pState)["TimerMan"] = &g_TimerMan;
+    globals(pState)["FrameMan"] = &g_FrameMan;
+    globals(pState)["PerformanceMan"] = &g_PerformanceMan;
+    globals(pState)["PresetMan"] = &g_PresetMan;
+    globals(pState)["AudioMan"] = &g_AudioMan;
+    globals(pState)["UInputMan"] = &g_UInputMan;
+    globals(pState)["SceneMan"] = &g_SceneMan;
+    globals(pState)["ActivityMan"] = &g_ActivityMan;
+    globals(pState)["MetaMan"] = &g_MetaMan;
+    globals(pState)["MovableMan"] = &g_MovableMan;
+    globals(pState)["ConsoleMan"] = &g_ConsoleMan;
+    globals(pState)["LuaMan"] = &g_LuaMan;
+    globals(pState)["SettingsMan"] = &g_SettingsMan;
+
+    luaL_dostring(pState,
         // Override print() in the lua state to output to the console
         "print = function(toPrint) ConsoleMan:PrintString(\"PRINT: \" .. tostring(toPrint)); end;\n"
         // Add cls() as a shorcut to ConsoleMan:Clear()
@@ -2229,8 +2527,6 @@ int LuaMan::Create()
         // Add package path to the defaults
         "package.path = package.path .. \";Base.rte/?.lua\";\n"
     );
-
-    return 0;
 }
 
 void LuaMan::ClearUserModuleCache()
@@ -2281,6 +2577,7 @@ int LuaMan::Save(Writer &writer) const
 
 void LuaMan::Destroy()
 {
+    StopScriptLanes();
     lua_close(m_pMasterState);
 
 	//Close all opened files
@@ -2568,6 +2865,548 @@ string LuaMan::GetNewObjectID()
 void LuaMan::Update()
 {
 	lua_gc(m_pMasterState, LUA_GCSTEP, 1);
+    // The lanes are idle between batches, so their states can be collected from here too
+    for (vector<ScriptLane *>::iterator lItr = m_ScriptLanes.begin(); lItr != m_ScriptLanes.end(); ++lItr)
+        lua_gc((*lItr)->m_pState, LUA_GCSTEP, 1);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StartScriptLanes
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Creates the script lanes and starts the threads that help run them.
+
+void LuaMan::StartScriptLanes()
+{
+    for (int i = 0; i < SCRIPTLANES; ++i)
+    {
+        ScriptLane *pLane = new ScriptLane;
+        pLane->m_Index = i;
+        // Set up the state here, LuaBind registration isn't safe to do from several threads at once
+        pLane->m_pState = lua_open();
+        InitializeState(pLane->m_pState);
+        m_ScriptLanes.push_back(pLane);
+    }
+
+    // The main thread runs lanes too, so there's no point in more helpers than lanes left for them
+    int helperCount = m_ParallelScriptThreads;
+    if (helperCount < 0)
+        helperCount = (int)thread::hardware_concurrency() - 1;
+    helperCount = max(0, min(helperCount, (int)SCRIPTLANES - 1));
+
+    m_StopScriptHelpers = false;
+    for (int i = 0; i < helperCount; ++i)
+        s_ScriptHelpers.push_back(thread(&LuaMan::RunScriptHelper, this));
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StopScriptLanes
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Stops the helper threads and closes the states of the script lanes.
+
+void LuaMan::StopScriptLanes()
+{
+    {
+        lock_guard<mutex> laneLock(ScriptLaneMutex);
+        m_StopScriptHelpers = true;
+    }
+    ScriptLaneStartCondition.notify_all();
+
+    for (vector<thread>::iterator hItr = s_ScriptHelpers.begin(); hItr != s_ScriptHelpers.end(); ++hItr)
+    {
+        if (hItr->joinable())
+            hItr->join();
+    }
+    s_ScriptHelpers.clear();
+
+    for (vector<ScriptLane *>::iterator lItr = m_ScriptLanes.begin(); lItr != m_ScriptLanes.end(); ++lItr)
+    {
+        lua_close((*lItr)->m_pState);
+        delete *lItr;
+    }
+    m_ScriptLanes.clear();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RunScriptHelper
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Body of a helper thread. Runs lanes of each batch as it comes in.
+
+void LuaMan::RunScriptHelper()
+{
+    unsigned int lastBatch = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> laneLock(ScriptLaneMutex);
+            while (!m_StopScriptHelpers && m_ParallelBatchNumber == lastBatch)
+                ScriptLaneStartCondition.wait(laneLock);
+            if (m_StopScriptHelpers)
+                return;
+            lastBatch = m_ParallelBatchNumber;
+        }
+
+        RunScriptLanes();
+
+        {
+            lock_guard<mutex> laneLock(ScriptLaneMutex);
+            if (--m_BusyScriptHelpers == 0)
+                ScriptLaneDoneCondition.notify_one();
+        }
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RunScriptLanes
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Claims and runs lanes of the current batch until there are none left.
+
+void LuaMan::RunScriptLanes()
+{
+    int lane;
+    while ((lane = s_NextScriptLane++) < (int)m_ScriptLanes.size())
+        RunScriptLane(*m_ScriptLanes[lane]);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RunScriptLane
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the script Update of a lane's share of the current batch, in
+//                  batch order.
+
+void LuaMan::RunScriptLane(ScriptLane &lane)
+{
+    if (lane.m_Share.empty())
+        return;
+
+    s_pThreadScriptLane = &lane;
+    const vector<MovableObject *> &batch = *m_pParallelBatch;
+    for (vector<int>::iterator sItr = lane.m_Share.begin(); sItr != lane.m_Share.end(); ++sItr)
+    {
+        lane.m_pObject = batch[*sItr];
+        lane.m_Order = *sItr;
+        // Whatever the script draws comes from the object's own stream, so it doesn't matter which thread runs it
+        SetThreadRandom(&lane.m_pObject->GetScriptRandom());
+        UpdateLaneObject(lane, lane.m_pObject);
+    }
+    SetThreadRandom(0);
+    lane.m_pObject = 0;
+    s_pThreadScriptLane = 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RunLaneScript
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs a script snippet or file on a lane's state, keeping any error to
+//                  be printed once the batch is done.
+
+int LuaMan::RunLaneScript(ScriptLane &lane, const string &script, bool isFile)
+{
+    try
+    {
+        const char *path = script.c_str();
+#ifndef WIN32
+        extern char *fcase( const char *path );
+        char *fixed = isFile ? fcase( script.c_str() ) : 0;
+        if ( fixed )
+            path = fixed;
+#endif
+        if (isFile ? luaL_dofile(lane.m_pState, path) : luaL_dostring(lane.m_pState, script.c_str()))
+        {
+            // Retrieve and pop the error message off the stack
+            lane.m_Errors.push_back(lua_tostring(lane.m_pState, -1));
+            lua_pop(lane.m_pState, 1);
+            return -1;
+        }
+    }
+    catch(const std::exception &e)
+    {
+        lane.m_Errors.push_back(e.what());
+        return -1;
+    }
+
+    return 0;
+}
+
+
+// The name of an object's Lua representation in a lane's state. It is named after its unique ID, since the master state's object IDs aren't safe to hand out from a lane
+static string LaneObjectName(const MovableObject *pObject)
+{
+    char objectID[64];
+    sprintf(objectID, ".Par%lu", pObject->GetUniqueID());
+    return pObject->GetClassName() + "s" + objectID;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateLaneObject
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the script Update of an object on a lane's state, first defining
+//                  its preset's functions and creating its Lua representation there if
+//                  that hasn't been done yet.
+
+int LuaMan::UpdateLaneObject(ScriptLane &lane, MovableObject *pObject)
+{
+    const string &presetName = pObject->GetScriptPresetName();
+    string classTable = pObject->GetClassName() + "s";
+
+    // Define the preset's functions in this state the same way MovableObject::LoadScripts does in the master
+    if (lane.m_LoadedPresets.find(presetName) == lane.m_LoadedPresets.end())
+    {
+        // Only try once, so a broken script doesn't get read in again every frame
+        lane.m_LoadedPresets.insert(presetName);
+        if (RunLaneScript(lane, "Create = nil; Destroy = nil; Update = nil;", false) < 0 ||
+            RunLaneScript(lane, pObject->GetScriptPath(), true) < 0 ||
+            RunLaneScript(lane, "if not " + classTable + " then " + classTable + " = {}; end; " + presetName + " = {}; " +
+                                "if Create then " + presetName + ".Create = Create; end; " +
+                                "if Destroy then " + presetName + ".Destroy = Destroy; end; " +
+                                "if Update then " + presetName + ".Update = Update; end;", false) < 0)
+            return -1;
+    }
+
+    string objectName = LaneObjectName(pObject);
+
+    if (pObject->GetScriptLane() != lane.m_Index)
+    {
+        pObject->SetScriptLane(lane.m_Index);
+        globals(lane.m_pState)["ScriptedEntity"] = static_cast<Entity *>(pObject);
+        if (RunLaneScript(lane, objectName + " = To" + pObject->GetClassName() + "(ScriptedEntity); ScriptedEntity = nil;", false) < 0)
+            return -1;
+        if (RunLaneScript(lane, "if " + presetName + ".Create and " + objectName + " then " + presetName + ".Create(" + objectName + "); end", false) < 0)
+            return -1;
+    }
+
+    return RunLaneScript(lane, "if " + presetName + ".Update and " + objectName + " then " + presetName + ".Update(" + objectName + "); end", false);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateParallelScripts
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the script Update of a batch of ScriptThreadSafe objects on the
+//                  script lanes, and waits for them.
+
+void LuaMan::UpdateParallelScripts(const vector<MovableObject *> &batch)
+{
+    if (batch.empty())
+        return;
+
+    if (m_ScriptLanes.empty())
+        StartScriptLanes();
+
+    g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_SCRIPTS);
+
+    // Each object always goes on the lane picked by its unique ID, and draws from a stream of its own,
+    // so nothing about the outcome depends on how many threads there are or which of them runs what
+    for (vector<ScriptLane *>::iterator lItr = m_ScriptLanes.begin(); lItr != m_ScriptLanes.end(); ++lItr)
+    {
+        (*lItr)->m_Share.clear();
+        (*lItr)->m_Created.clear();
+    }
+    for (int i = 0; i < (int)batch.size(); ++i)
+    {
+        MovableObject *pObject = batch[i];
+        if (pObject->GetScriptLane() < 0)
+            pObject->GetScriptRandom().Seed(GetRandSeed(), 0x80000000 | pObject->GetUniqueID());
+        m_ScriptLanes[pObject->GetUniqueID() % SCRIPTLANES]->m_Share.push_back(i);
+    }
+
+    for (vector<ScriptLane *>::iterator lItr = m_ScriptLanes.begin(); lItr != m_ScriptLanes.end(); ++lItr)
+    {
+        (*lItr)->m_NextUniqueID = SCRIPTLANEFIRSTSTANDINID + (*lItr)->m_Index * SCRIPTLANEUNIQUEIDS;
+        (*lItr)->m_UniqueIDsLeft = SCRIPTLANEUNIQUEIDS;
+    }
+
+    {
+        lock_guard<mutex> laneLock(ScriptLaneMutex);
+        m_pParallelBatch = &batch;
+        s_NextScriptLane = 0;
+        m_BusyScriptHelpers = s_ScriptHelpers.size();
+        m_ParallelBatchNumber++;
+    }
+    ScriptLaneStartCondition.notify_all();
+
+    // Pitch in with the helpers, and then wait for the lanes they're still running
+    RunScriptLanes();
+    {
+        unique_lock<mutex> laneLock(ScriptLaneMutex);
+        while (m_BusyScriptHelpers > 0)
+            ScriptLaneDoneCondition.wait(laneLock);
+        m_pParallelBatch = 0;
+    }
+
+    // Swap the stand-in ids of what the lanes made for real ones, in lane order and then in the order they were made.
+    // What's been deleted again since doesn't need one
+    for (vector<ScriptLane *>::iterator lItr = m_ScriptLanes.begin(); lItr != m_ScriptLanes.end(); ++lItr)
+    {
+        for (unsigned long int standInID = SCRIPTLANEFIRSTSTANDINID + (*lItr)->m_Index * SCRIPTLANEUNIQUEIDS; standInID < (*lItr)->m_NextUniqueID; ++standInID)
+        {
+            MovableObject *pMO = g_MovableMan.FindObjectByUniqueID(standInID);
+            if (pMO)
+            {
+                g_MovableMan.UnregisterObject(pMO);
+                pMO->m_UniqueID = MovableObject::GetNextUniqueID();
+                g_MovableMan.RegisterObject(pMO);
+            }
+        }
+    }
+
+    ApplyScriptCommands();
+
+    g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_SCRIPTS);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DestroyParallelScriptObject
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the scripted Destroy of an object on the script lane that holds
+//                  its Lua representation, and then removes that representation.
+
+void LuaMan::DestroyParallelScriptObject(MovableObject *pObject)
+{
+    int lane = pObject->GetScriptLane();
+    pObject->SetScriptLane(-1);
+    if (lane < 0 || lane >= (int)m_ScriptLanes.size())
+        return;
+
+    string objectName = LaneObjectName(pObject);
+    ScriptLane &scriptLane = *m_ScriptLanes[lane];
+
+    // Another lane's state can't be used from here, so have it removed after the batch. The object is gone by then, so its Destroy can't run anymore
+    if (s_pThreadScriptLane && s_pThreadScriptLane != &scriptLane)
+    {
+        DeferScriptObjectRemoval(objectName, lane);
+        return;
+    }
+
+    // The state is free to use, either between batches or because this is the lane running it
+    const string &presetName = pObject->GetScriptPresetName();
+    RunLaneScript(scriptLane, "if " + presetName + " and " + presetName + ".Destroy and " + objectName + " then " + presetName + ".Destroy(" + objectName + "); end", false);
+    RunLaneScript(scriptLane, "if " + objectName + " then " + objectName + " = nil; end", false);
+    // Errors hit on the lane itself get printed with the rest of the batch's
+    if (!s_pThreadScriptLane)
+    {
+        for (vector<string>::iterator eItr = scriptLane.m_Errors.begin(); eItr != scriptLane.m_Errors.end(); ++eItr)
+            g_ConsoleMan.PrintString("ERROR: " + *eItr);
+        scriptLane.m_Errors.clear();
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          InScriptLane
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether the calling thread is running a script lane.
+
+bool LuaMan::InScriptLane() const
+{
+    return s_pThreadScriptLane != 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetParallelScriptObject
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the object whose script the calling thread is running on a
+//                  script lane.
+
+MovableObject * LuaMan::GetParallelScriptObject() const
+{
+    return s_pThreadScriptLane ? static_cast<ScriptLane *>(s_pThreadScriptLane)->m_pObject : 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          NoteScriptCreation
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Lets the script lane the calling thread is running know that its
+//                  script made a new entity.
+
+void LuaMan::NoteScriptCreation(const Entity *pEntity)
+{
+    if (s_pThreadScriptLane && pEntity)
+        static_cast<ScriptLane *>(s_pThreadScriptLane)->m_Created.insert(pEntity);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsScriptCreation
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether an entity was made by the scripts of the script lane the
+//                  calling thread is running, during this batch.
+
+bool LuaMan::IsScriptCreation(const Entity *pEntity) const
+{
+    if (!s_pThreadScriptLane || !pEntity)
+        return false;
+    const set<const Entity *> &created = static_cast<ScriptLane *>(s_pThreadScriptLane)->m_Created;
+    return created.find(pEntity) != created.end();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DefersChangesTo
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether a change a script wants to make to an object has to be
+//                  held back with DeferScriptCommand, or refused.
+
+bool LuaMan::DefersChangesTo(const MovableObject *pTarget) const
+{
+    MovableObject *pRunning = GetParallelScriptObject();
+    if (!pRunning)
+        return false;
+    if (!pTarget)
+        return true;
+    // Attachables belong to whatever they're attached to
+    const MovableObject *pRoot = pTarget->GetRootParent();
+    return pRoot != pRunning->GetRootParent() && !IsScriptCreation(pRoot) && !IsScriptCreation(pTarget);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DeferScriptCommand
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Holds back a change a script running on a script lane wants to make,
+//                  until the end of the batch.
+
+bool LuaMan::DeferScriptCommand(const ScriptCommand &command)
+{
+    if (!s_pThreadScriptLane)
+        return false;
+
+    ScriptLane *pLane = static_cast<ScriptLane *>(s_pThreadScriptLane);
+    pLane->m_Commands.push_back(command);
+    pLane->m_Commands.back().m_Order = pLane->m_Order;
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          TakeScriptUniqueID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Takes the next unique id for a MovableObject made on the script lane
+//                  the calling thread is running.
+
+unsigned long int LuaMan::TakeScriptUniqueID()
+{
+    ScriptLane *pLane = static_cast<ScriptLane *>(s_pThreadScriptLane);
+    if (!pLane || pLane->m_UniqueIDsLeft == 0)
+        return 0;
+    pLane->m_UniqueIDsLeft--;
+    return pLane->m_NextUniqueID++;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DeferScriptObjectRemoval
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Has the Lua representation of an object that was deleted on a script
+//                  lane removed from the state holding it after the batch.
+
+void LuaMan::DeferScriptObjectRemoval(const string &objectName, int lane)
+{
+    ScriptCommand command;
+    command.m_Type = ScriptCommand::REMOVESCRIPTOBJECT;
+    command.m_Text = objectName;
+    command.m_Value = lane;
+    DeferScriptCommand(command);
+}
+
+
+// Orders the held back commands by where in the batch they came from
+static bool ScriptCommandOrder(const LuaMan::ScriptCommand &lhs, const LuaMan::ScriptCommand &rhs) { return lhs.m_Order < rhs.m_Order; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ApplyScriptCommands
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes all the changes held back by the lanes during the last batch,
+//                  in the order of the batch, and prints their errors.
+
+void LuaMan::ApplyScriptCommands()
+{
+    vector<ScriptCommand> commands;
+    for (vector<ScriptLane *>::iterator lItr = m_ScriptLanes.begin(); lItr != m_ScriptLanes.end(); ++lItr)
+    {
+        commands.insert(commands.end(), (*lItr)->m_Commands.begin(), (*lItr)->m_Commands.end());
+        (*lItr)->m_Commands.clear();
+        for (vector<string>::iterator eItr = (*lItr)->m_Errors.begin(); eItr != (*lItr)->m_Errors.end(); ++eItr)
+            g_ConsoleMan.PrintString("ERROR: " + *eItr);
+        (*lItr)->m_Errors.clear();
+    }
+    // Each lane's commands are already in batch order, keep it that way within each object too
+    stable_sort(commands.begin(), commands.end(), ScriptCommandOrder);
+
+    for (vector<ScriptCommand>::iterator cItr = commands.begin(); cItr != commands.end(); ++cItr)
+    {
+        MovableObject *pTarget = cItr->m_pTarget;
+        switch (cItr->m_Type)
+        {
+            case ScriptCommand::ADDMO:
+                g_MovableMan.AddMO(dynamic_cast<MovableObject *>(cItr->m_pEntity));
+                break;
+            case ScriptCommand::ADDACTOR:
+                g_MovableMan.AddActor(dynamic_cast<Actor *>(cItr->m_pEntity));
+                break;
+            case ScriptCommand::ADDITEM:
+                g_MovableMan.AddItem(dynamic_cast<MovableObject *>(cItr->m_pEntity));
+                break;
+            case ScriptCommand::ADDPARTICLE:
+                g_MovableMan.AddParticle(dynamic_cast<MovableObject *>(cItr->m_pEntity));
+                break;
+            case ScriptCommand::ADDFORCE:
+                pTarget->AddForce(cItr->m_Vector, cItr->m_Offset);
+                break;
+            case ScriptCommand::ADDABSFORCE:
+                pTarget->AddAbsForce(cItr->m_Vector, cItr->m_Offset);
+                break;
+            case ScriptCommand::ADDIMPULSEFORCE:
+                pTarget->AddImpulseForce(cItr->m_Vector, cItr->m_Offset);
+                break;
+            case ScriptCommand::ADDABSIMPULSEFORCE:
+                pTarget->AddAbsImpulseForce(cItr->m_Vector, cItr->m_Offset);
+                break;
+            case ScriptCommand::SETHEALTH:
+                if (Actor *pActor = dynamic_cast<Actor *>(pTarget))
+                    pActor->SetHealth((int)cItr->m_Value);
+                break;
+            case ScriptCommand::SETTODELETE:
+                pTarget->SetToDelete(cItr->m_Value != 0);
+                break;
+            case ScriptCommand::GIBTHIS:
+                if (MOSRotating *pMOSR = dynamic_cast<MOSRotating *>(pTarget))
+                    pMOSR->GibThis(cItr->m_Vector, cItr->m_Value, dynamic_cast<MovableObject *>(cItr->m_pEntity));
+                break;
+            case ScriptCommand::ADDTERRAINOBJECT:
+                g_SceneMan.AddTerrainObject(dynamic_cast<TerrainObject *>(cItr->m_pEntity));
+                delete cItr->m_pEntity;
+                break;
+            case ScriptCommand::ADDSCENEOBJECT:
+                g_SceneMan.AddSceneObject(dynamic_cast<SceneObject *>(cItr->m_pEntity));
+                break;
+            case ScriptCommand::DELETEENTITY:
+                delete cItr->m_pEntity;
+                break;
+            case ScriptCommand::REMOVESCRIPTOBJECT:
+            {
+                int lane = (int)cItr->m_Value;
+                lua_State *pState = lane < 0 ? m_pMasterState : (lane < (int)m_ScriptLanes.size() ? m_ScriptLanes[lane]->m_pState : 0);
+                if (pState)
+                    luaL_dostring(pState, ("if " + cItr->m_Text + " then " + cItr->m_Text + " = nil; end").c_str());
+                g_ConsoleMan.PrintString("ERROR: " + cItr->m_Text + " was deleted by a thread-safe script, so its Destroy script could not be run!");
+                break;
+            }
+            case ScriptCommand::PRINT:
+                g_ConsoleMan.PrintString(cItr->m_Text);
+                break;
+        }
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -27,12 +27,15 @@ struct lua_State;
 namespace RTE
 {
 
+class MovableObject;
+
 #define MAX_OPEN_FILES 10
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Class:           LuaMan
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     The singleton manager of the master lua script state.
+// Description:     The singleton manager of the master lua script state, and of the
+//                  script lanes that the scripts of thread-safe presets run on.
 // Parent(s):       Singleton, Serializable?
 // Class history:   3/13/2008 LuaMan created.
 
@@ -47,6 +50,57 @@ class LuaMan:
 
 public:
 
+    enum
+    {
+        // How many script lanes there are. Fixed, so that which lane and Lua state an object's
+        // script runs on never depends on how many threads the machine has
+        SCRIPTLANES = 8,
+        // Objects made on a lane get stand-in unique ids out of a range of the lane's own, way
+        // above what the counter reaches, and are given their real ids after the batch
+        SCRIPTLANEFIRSTSTANDINID = 0x40000000,
+        // How many stand-in ids each lane's range holds
+        SCRIPTLANEUNIQUEIDS = 0x00100000
+    };
+
+    // A change to the engine that a script running on a script lane asked for. It is held
+    // back and made on the main thread once all the lanes are done with their batch.
+    struct ScriptCommand
+    {
+        enum CommandType
+        {
+            ADDMO = 0,
+            ADDACTOR,
+            ADDITEM,
+            ADDPARTICLE,
+            ADDFORCE,
+            ADDABSFORCE,
+            ADDIMPULSEFORCE,
+            ADDABSIMPULSEFORCE,
+            SETHEALTH,
+            SETTODELETE,
+            GIBTHIS,
+            ADDTERRAINOBJECT,
+            ADDSCENEOBJECT,
+            DELETEENTITY,
+            REMOVESCRIPTOBJECT,
+            PRINT
+        };
+
+        ScriptCommand() { m_Type = PRINT; m_pTarget = 0; m_pEntity = 0; m_Value = 0; m_Order = 0; }
+
+        int m_Type;
+        // The object that is changed, or ignored by its gibs
+        MovableObject *m_pTarget;
+        // The entity that gets added or deleted. Owned by the command until it is made
+        Entity *m_pEntity;
+        Vector m_Vector;
+        Vector m_Offset;
+        float m_Value;
+        std::string m_Text;
+        // Where in the batch the object whose script asked for this is, so commands are made in that order
+        int m_Order;
+    };
+
 /*
 enum ServerResult
 {
@@ -379,11 +433,261 @@ enum ServerResult
 	void ClearUserModuleCache();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetParallelScriptThreads
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets how many extra threads help the main thread work through the
+//                  script lanes, which run the Update of objects whose presets are marked
+//                  ScriptThreadSafe. Only changes how fast that goes, the results come
+//                  out the same for any count. Should be set before any such object is
+//                  updated.
+// Arguments:       The number of extra threads. 0 has the main thread run all the lanes
+//                  itself, -1 uses one less than the number of hardware threads.
+// Return value:    None.
+
+    void SetParallelScriptThreads(int threadCount) { m_ParallelScriptThreads = threadCount; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetParallelScriptThreads
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many extra threads help work through the script lanes.
+// Arguments:       None.
+// Return value:    The number of threads, as set.
+
+    int GetParallelScriptThreads() const { return m_ParallelScriptThreads; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateParallelScripts
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the script Update of a batch of ScriptThreadSafe objects on the
+//                  script lanes, and waits for them. Each object always runs on the same
+//                  lane, which holds its Lua representation, and draws from its own
+//                  random stream. The changes the scripts asked for that had to be held
+//                  back are then made, in the order of the batch.
+// Arguments:       The objects to update. Ownership is NOT transferred!
+// Return value:    None.
+
+    void UpdateParallelScripts(const std::vector<MovableObject *> &batch);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DestroyParallelScriptObject
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the scripted Destroy of an object on the script lane that holds
+//                  its Lua representation, and then removes that representation.
+// Arguments:       The object being destroyed. Ownership is NOT transferred!
+// Return value:    None.
+
+    void DestroyParallelScriptObject(MovableObject *pObject);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          InScriptLane
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether the calling thread is running a script lane.
+// Arguments:       None.
+// Return value:    Whether it is.
+
+    bool InScriptLane() const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetParallelScriptObject
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the object whose script the calling thread is running on a
+//                  script lane.
+// Arguments:       None.
+// Return value:    The object, or 0 if the calling thread isn't running a lane.
+
+    MovableObject * GetParallelScriptObject() const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          NoteScriptCreation
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Lets the script lane the calling thread is running know that its
+//                  script made a new entity, which it is then free to change until the
+//                  end of the batch.
+// Arguments:       The new entity. Ownership is NOT transferred!
+// Return value:    None.
+
+    void NoteScriptCreation(const Entity *pEntity);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsScriptCreation
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether an entity was made by the scripts of the script lane the
+//                  calling thread is running, during this batch.
+// Arguments:       The entity. Ownership is NOT transferred!
+// Return value:    Whether it was. Always false if not called from a lane.
+
+    bool IsScriptCreation(const Entity *pEntity) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DefersChangesTo
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether a change a script wants to make to an object has to be
+//                  held back with DeferScriptCommand, or refused. That is the case on
+//                  script lanes, unless the object is part of the one whose script is
+//                  running, or was made by that script during this batch.
+// Arguments:       The object to change, or 0 for a change to the engine itself.
+// Return value:    Whether the change can't be made right away.
+
+    bool DefersChangesTo(const MovableObject *pTarget) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DeferScriptCommand
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Holds back a change a script running on a script lane wants to make,
+//                  until the end of the batch.
+// Arguments:       The change. Ownership of its entity is transferred!
+// Return value:    Whether the change was held back. False if the calling thread isn't
+//                  running a script lane, in which case the change should just be made.
+
+    bool DeferScriptCommand(const ScriptCommand &command);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          TakeScriptUniqueID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Takes the next stand-in unique id for a MovableObject made on the
+//                  script lane the calling thread is running. The stand-ins are swapped
+//                  for real ids after the batch, lane by lane, so the ids come out the
+//                  same no matter how the lanes were spread over the threads.
+// Arguments:       None.
+// Return value:    The id, or 0 if the calling thread isn't running a lane or the lane's
+//                  range ran out, in which case the id should come from the counter.
+
+    unsigned long int TakeScriptUniqueID();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DeferScriptObjectRemoval
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Has the Lua representation of an object that was deleted on a script
+//                  lane removed from the state holding it after the batch, since that
+//                  state can't be used from here. The scripted Destroy can't be run then
+//                  anymore, which gets reported.
+// Arguments:       The name of the representation.
+//                  The lane whose state holds it, or -1 for the master state.
+// Return value:    None.
+
+    void DeferScriptObjectRemoval(const std::string &objectName, int lane);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Protected member variable and method declarations
 
 protected:
 
+    // A script lane with its own Lua state, defined in LuaMan.cpp
+    struct ScriptLane;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          InitializeState
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Opens the libraries and registers all the bindings and manager
+//                  globals in a newly created Lua state.
+// Arguments:       The state to set up.
+// Return value:    None.
+
+    void InitializeState(lua_State *pState);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StartScriptLanes
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Creates the script lanes and starts the threads that help run them.
+// Arguments:       None.
+// Return value:    None.
+
+    void StartScriptLanes();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StopScriptLanes
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Stops the helper threads and closes the states of the script lanes.
+// Arguments:       None.
+// Return value:    None.
+
+    void StopScriptLanes();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RunScriptHelper
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Body of a helper thread. Runs lanes of each batch as it comes in.
+// Arguments:       None.
+// Return value:    None.
+
+    void RunScriptHelper();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RunScriptLanes
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Claims and runs lanes of the current batch until there are none left.
+// Arguments:       None.
+// Return value:    None.
+
+    void RunScriptLanes();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RunScriptLane
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the script Update of a lane's share of the current batch, in
+//                  batch order.
+// Arguments:       The lane to run.
+// Return value:    None.
+
+    void RunScriptLane(ScriptLane &lane);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateLaneObject
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the script Update of an object on a lane's state, first defining
+//                  its preset's functions and creating its Lua representation there if
+//                  that hasn't been done yet.
+// Arguments:       The lane to run on.
+//                  The object to update.
+// Return value:    Returns less than zero if any errors encountered.
+
+    int UpdateLaneObject(ScriptLane &lane, MovableObject *pObject);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RunLaneScript
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs a script snippet or file on a lane's state, keeping any error to
+//                  be printed once the batch is done.
+// Arguments:       The lane to run on.
+//                  The script snippet, or the path to the file.
+//                  Whether a file should be run.
+// Return value:    Returns less than zero if any errors encountered.
+
+    int RunLaneScript(ScriptLane &lane, const std::string &script, bool isFile);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ApplyScriptCommands
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes all the changes held back by the lanes during the last batch,
+//                  in the order of the batch, and prints their errors.
+// Arguments:       None.
+// Return value:    None.
+
+    void ApplyScriptCommands();
+
+
     // Member variables
     static const std::string m_ClassName;
 
@@ -399,6 +703,18 @@ protected:
     long m_NextObjectID;
     // Temporary holder for an Entity object that we want to pass into the Lua state without fuss
     Entity *m_pTempEntity;
+    // How many extra threads help run the script lanes, see SetParallelScriptThreads
+    int m_ParallelScriptThreads;
+    // The script lanes and their states, created on the first batch
+    std::vector<ScriptLane *> m_ScriptLanes;
+    // The batch being worked on. Guarded by the lane mutex in LuaMan.cpp
+    const std::vector<MovableObject *> *m_pParallelBatch;
+    // Bumped for each batch so the helper threads can tell a new one from the last
+    unsigned int m_ParallelBatchNumber;
+    // How many helper threads haven't finished the current batch yet
+    int m_BusyScriptHelpers;
+    // Tells the helper threads to exit
+    bool m_StopScriptHelpers;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
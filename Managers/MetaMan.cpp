@@ -419,7 +419,8 @@ int MetaMan::Save(Writer &writer) const
 // Method:          SaveSceneData
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Saves the bitmap data of all Scenes of this Metagame that are currently
-//                  loaded.
+//                  loaded, as LZ4 compressed layer files. The files of Scenes that aren't
+//                  loaded are unchanged, so they're only copied if the path base changed.
 
 int MetaMan::SaveSceneData(string pathBase)
 {
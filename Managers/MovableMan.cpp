@@ -12,9 +12,11 @@
 // Inclusions of header files
 
 #include <functional>
+#include <mutex>
 
 #include "MovableMan.h"
 #include "PresetMan.h"
+#include "PerformanceMan.h"
 #include "AHuman.h"
 #include "MOPixel.h"
 #include "Attachable.h"
@@ -31,6 +33,24 @@ namespace RTE
 {
 
 const string MovableMan::m_ClassName = "MovableMan";
+const float MovableMan::SUPPORTMOVINGSPEED = 0.5F;
+
+// Objects are registered and unregistered from the script lanes too, whenever their scripts make or delete them
+static mutex s_KnownObjectsMutex;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Holds back adding an object that a script on one of LuaMan's lanes made, directly or
+// through gibbing, reloading, dropping and such, since the lists can't be touched from
+// there. It gets added once the batch is done. Returns false when not on a lane.
+
+static bool DeferScriptAdd(int type, MovableObject *pMOToAdd)
+{
+    LuaMan::ScriptCommand command;
+    command.m_Type = type;
+    command.m_pEntity = pMOToAdd;
+    return g_LuaMan.DeferScriptCommand(command);
+}
 
 
 // Comparison functor for sorting movable objects by their X position using STL's sort
@@ -67,14 +87,25 @@ void MovableMan::Clear()
     m_AddedAlarmEvents.clear();
     m_AlarmEvents.clear();
     m_MOIDIndex.clear();
+    m_MOIDInfo.clear();
     m_AGResolution = 1;
     m_SplashRatio = 0.75;
     m_MaxDroppedItems = 25;
+    m_AISensingInterval = 3;
+    m_AISensingBudget = 0;
+    m_AISensingThisFrame = 0;
+    m_AICounters.clear();
     m_SloMoTimer.Reset();
     m_SloMoThreshold = 100;
     m_SloMoDuration = 1000;
     m_SettlingEnabled = true;
     m_MOSubtractionEnabled = true;
+    m_SleepDelay = 3000;
+    m_SleepingCount = 0;
+    m_TerrainChangeFrames.clear();
+    m_TerrainCellColumns = 0;
+    m_TerrainCellRows = 0;
+    m_LastTerrainChangeFrame = 0;
     m_pObjectToScriptUpdate = 0;
 }
 
@@ -121,6 +152,16 @@ int MovableMan::ReadProperty(std::string propName, Reader &reader)
         reader >> m_SplashRatio;
     else if (propName == "MaxUnheldItems")
         reader >> m_MaxDroppedItems;
+    else if (propName == "AISensingInterval")
+    {
+        reader >> m_AISensingInterval;
+        SetAISensingInterval(m_AISensingInterval);
+    }
+    else if (propName == "AISensingBudget")
+    {
+        reader >> m_AISensingBudget;
+        SetAISensingBudget(m_AISensingBudget);
+    }
     else if (propName == "SloMoThreshold")
         reader >> m_SloMoThreshold;
     else if (propName == "SloMoDurationMS")
@@ -129,6 +170,8 @@ int MovableMan::ReadProperty(std::string propName, Reader &reader)
         reader >> m_SettlingEnabled;
     else if (propName == "EnableMOSubtraction")
         reader >> m_MOSubtractionEnabled;
+    else if (propName == "ItemSleepDelayMS")
+        reader >> m_SleepDelay;
     else
         // See if the base class(es) can find a match instead
         return Serializable::ReadProperty(propName, reader);
@@ -214,7 +257,12 @@ MovableObject * MovableMan::GetMOFromID(MOID whichID)
 void MovableMan::RegisterObject(MovableObject * mo) 
 { 
 	if (mo) 
+	{
+		lock_guard<mutex> knownLock(s_KnownObjectsMutex);
 		m_KnownObjects[mo->GetUniqueID()] = mo; 
+		// Whatever a script on a lane makes, it may go on to change during its batch
+		g_LuaMan.NoteScriptCreation(mo);
+	}
 }
 
 
@@ -229,11 +277,26 @@ void MovableMan::UnregisterObject(MovableObject * mo)
 { 
 	if (mo)
 	{
+		lock_guard<mutex> knownLock(s_KnownObjectsMutex);
 		m_KnownObjects.erase(mo->GetUniqueID());
 		//g_ConsoleMan.PrintString(std::to_string(mo->GetUniqueID()));
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          FindObjectByUniqueId
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Uses a global lookup map to find an object by it's unique id.
+// Arguments:       Unique Id to look for.
+// Return value:    Object found or 0 if not found any.
+
+MovableObject * MovableMan::FindObjectByUniqueID(long int id)
+{
+	lock_guard<mutex> knownLock(s_KnownObjectsMutex);
+	map<long int, MovableObject *>::iterator kItr = m_KnownObjects.find(id);
+	return kItr != m_KnownObjects.end() ? kItr->second : 0;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          PurgeAllMOs
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -267,11 +330,13 @@ void MovableMan::PurgeAllMOs()
     m_AddedAlarmEvents.clear();
     m_AlarmEvents.clear();
     m_MOIDIndex.clear();
+    m_MOIDInfo.clear();
 
     // Set the time limit to 0 so it will report as being past it from the start of simulation
     m_SloMoTimer.SetRealTimeLimitMS(0);
     m_SloMoTimer.SetSimTimeLimitMS(0);
 
+	lock_guard<mutex> knownLock(s_KnownObjectsMutex);
 	m_KnownObjects.clear();
 }
 
@@ -848,7 +913,7 @@ bool MovableMan::AddMO(MovableObject *pMOToAdd)
 
 void MovableMan::AddActor(Actor *pActorToAdd)
 {
-    if (pActorToAdd)
+    if (pActorToAdd && !DeferScriptAdd(LuaMan::ScriptCommand::ADDACTOR, pActorToAdd))
     {
 //        pActorToAdd->SetPrevPos(pActorToAdd->GetPos());
 //        pActorToAdd->Update();
@@ -884,7 +949,7 @@ void MovableMan::AddActor(Actor *pActorToAdd)
 
 void MovableMan::AddItem(MovableObject *pItemToAdd)
 {
-    if (pItemToAdd)
+    if (pItemToAdd && !DeferScriptAdd(LuaMan::ScriptCommand::ADDITEM, pItemToAdd))
     {
 //        pItemToAdd->SetPrevPos(pItemToAdd->GetPos());
 //        pItemToAdd->Update();
@@ -920,7 +985,7 @@ void MovableMan::AddItem(MovableObject *pItemToAdd)
 
 void MovableMan::AddParticle(MovableObject *pMOToAdd)
 {
-    if (pMOToAdd)
+    if (pMOToAdd && !DeferScriptAdd(LuaMan::ScriptCommand::ADDPARTICLE, pMOToAdd))
     {
 //        pMOToAdd->SetPrevPos(pMOToAdd->GetPos());
 //        pMOToAdd->Update();
@@ -1346,21 +1411,6 @@ bool MovableMan::IsOfActor(MOID checkMOID)
 }
 
 
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          GetRootMOID
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Produces the root MOID of the MOID of a potential child MO to another MO.
-
-MOID MovableMan::GetRootMOID(MOID checkMOID)
-{
-    MovableObject *pMO = GetMOFromID(checkMOID);
-    if (pMO)
-        return pMO->GetRootID();
-
-    return g_NoMOID;
-}
-
-
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RemoveMO
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1642,6 +1692,53 @@ void MovableMan::OnPieMenu(Actor * pActor)
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ScheduleAISensing
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Decides whether an actor's AI should do its expensive looking around
+//                  this frame.
+
+bool MovableMan::ScheduleAISensing(Actor *pActor, bool urgent)
+{
+    unsigned int sinceLast = m_SimUpdateFrameNumber - pActor->GetLastAISenseFrame();
+    bool sense = urgent || m_AISensingInterval <= 1;
+
+    if (!sense)
+    {
+        // Overdue actors go even if the budget is spent, so none can starve
+        if (sinceLast >= (unsigned int)m_AISensingInterval * 2)
+            sense = true;
+        else if ((m_SimUpdateFrameNumber + pActor->GetUniqueID()) % m_AISensingInterval == 0)
+            sense = m_AISensingBudget <= 0 || m_AISensingThisFrame < m_AISensingBudget;
+
+        if (sense)
+            m_AISensingThisFrame++;
+    }
+
+    if (sense)
+        pActor->SetLastAISenseFrame(m_SimUpdateFrameNumber);
+    return sense;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AddAIUpdateTime
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Reports how long an actor's AI update took, to the actor itself and to
+//                  the AI performance counter of its class.
+
+void MovableMan::AddAIUpdateTime(Actor *pActor, int64_t time)
+{
+    pActor->AddAIUpdateTime(time);
+    g_PerformanceMan.AddPerformanceSample(PerformanceMan::PERF_ACTORS_AI, time);
+
+    map<string, int>::iterator cItr = m_AICounters.find(pActor->GetClassName());
+    if (cItr == m_AICounters.end())
+        cItr = m_AICounters.insert(pair<string, int>(pActor->GetClassName(), g_PerformanceMan.RegisterCounter("AI " + pActor->GetClassName(), PerformanceMan::PERF_ACTORS_AI))).first;
+    if (cItr->second >= 0)
+        g_PerformanceMan.AddPerformanceSample(cItr->second, time);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          Update
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1656,6 +1753,7 @@ void MovableMan::Update()
         return;
 
 	m_SimUpdateFrameNumber++;
+	m_AISensingThisFrame = 0;
 
     // Clear the MO color layer only if this is a drawn update
     if (g_TimerMan.DrawnSimUpdate())
@@ -1700,7 +1798,7 @@ void MovableMan::Update()
         SLICK_PROFILENAME("First Pass", 0xFF354556);
 
         // Travel Actor:s
-		g_FrameMan.StartPerformanceMeasurement(FrameMan::PERF_ACTORS_PASS1);
+		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTORS_PASS1);
         {
             SLICK_PROFILENAME("Travel Actors", 0xFF648434);
 
@@ -1722,29 +1820,43 @@ void MovableMan::Update()
                     (*aIt)->PostTravel();
                 }
                 (*aIt)->NewFrame();
+
+                // Items lying on actors, crafts included, have to fall off when they move
+                if ((*aIt)->GetVel().GetLargest() > SUPPORTMOVINGSPEED)
+                    RegisterSupportChange(*aIt);
             }
         }
-		g_FrameMan.StopPerformanceMeasurement(FrameMan::PERF_ACTORS_PASS1);
+		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ACTORS_PASS1);
 
         // Travel items
         {
             SLICK_PROFILENAME("Travel Items", 0xFF224535);
 
+            // Only bother looking for terrain changes around sleepers if there were any lately
+            bool checkTerrain = m_LastTerrainChangeFrame + 1 >= m_SimUpdateFrameNumber;
+
             for (iIt = m_Items.begin(); iIt != m_Items.end(); ++iIt)
             {
-                if (!((*iIt)->IsUpdated()))
+                if ((*iIt)->IsAsleep() && SleeperDisturbed(*iIt, checkTerrain))
+                    (*iIt)->WakeUp();
+
+                if (!((*iIt)->IsUpdated()) && !((*iIt)->IsAsleep()))
                 {
                     (*iIt)->ApplyForces();
                     (*iIt)->PreTravel();
                     (*iIt)->Travel();
                     (*iIt)->PostTravel();
+
+                    // Same goes for items piled on other items, those get woken up next update
+                    if ((*iIt)->GetVel().GetLargest() > SUPPORTMOVINGSPEED)
+                        RegisterSupportChange(*iIt);
                 }
                 (*iIt)->NewFrame();
             }
         }
 
         // Travel particles
-		g_FrameMan.StartPerformanceMeasurement(FrameMan::PERF_PARTICLES_PASS1);
+		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_PARTICLES_PASS1);
         {
             SLICK_PROFILENAME("Travel Particles", 0xFF778962);
 
@@ -1760,7 +1872,7 @@ void MovableMan::Update()
                 (*parIt)->NewFrame();
             }
         }
-		g_FrameMan.StopPerformanceMeasurement(FrameMan::PERF_PARTICLES_PASS1);
+		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_PARTICLES_PASS1);
 
         g_SceneMan.UnlockScene();
     }
@@ -1774,21 +1886,31 @@ void MovableMan::Update()
         g_SceneMan.LockScene();
 
         // Actor:s
-		g_FrameMan.StartPerformanceMeasurement(FrameMan::PERF_ACTORS_PASS2);
+		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTORS_PASS2);
         {
             SLICK_PROFILENAME("Second Pass -  Actors", 0xFF558673);
+            m_ParallelScriptBatch.clear();
             for (aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
             {
-				//g_FrameMan.StartPerformanceMeasurement(FrameMan::PERF_ACTORS_PASS2);
+				//g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTORS_PASS2);
 				(*aIt)->Update();
-				//g_FrameMan.StopPerformanceMeasurement(FrameMan::PERF_ACTORS_PASS2);
-				//g_FrameMan.StartPerformanceMeasurement(FrameMan::PERF_ACTORS_AI);
+				//g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ACTORS_PASS2);
+                // Thread safe scripts get run together on the workers after the loop
+                if ((*aIt)->IsScriptThreadSafe())
+                {
+                    m_ParallelScriptBatch.push_back(*aIt);
+                    continue;
+                }
+				//g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTORS_AI);
                 (*aIt)->UpdateScript();
-				//g_FrameMan.StopPerformanceMeasurement(FrameMan::PERF_ACTORS_AI);
+				//g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ACTORS_AI);
                 (*aIt)->ApplyImpulses();
             }
+            g_LuaMan.UpdateParallelScripts(m_ParallelScriptBatch);
+            for (vector<MovableObject *>::iterator bItr = m_ParallelScriptBatch.begin(); bItr != m_ParallelScriptBatch.end(); ++bItr)
+                (*bItr)->ApplyImpulses();
         }
-		g_FrameMan.StopPerformanceMeasurement(FrameMan::PERF_ACTORS_PASS2);
+		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ACTORS_PASS2);
 
     // TOD0: TEMP REMOVE!
 #ifdef _DEBUG
@@ -1800,25 +1922,55 @@ void MovableMan::Update()
             SLICK_PROFILENAME("Second Pass - Items", 0xFF556876);
             int count = 0;
             int itemLimit = m_Items.size() - m_MaxDroppedItems;
+            int sleepingCount = 0;
+            m_ParallelScriptBatch.clear();
             for (iIt = m_Items.begin(); iIt != m_Items.end(); ++iIt, ++count)
             {
-                (*iIt)->Update();
-                (*iIt)->UpdateScript();
-                (*iIt)->ApplyImpulses();
+                // Something may have bumped into a sleeper during travel
+                if ((*iIt)->IsAsleep() && SleeperDisturbed(*iIt, false))
+                    (*iIt)->WakeUp();
+
+                if ((*iIt)->IsAsleep())
+                    ++sleepingCount;
+                else if ((*iIt)->IsScriptThreadSafe())
+                {
+                    (*iIt)->Update();
+                    m_ParallelScriptBatch.push_back(*iIt);
+                }
+                else
+                {
+                    (*iIt)->Update();
+                    (*iIt)->UpdateScript();
+                    (*iIt)->ApplyImpulses();
+                    (*iIt)->SleepDetection(m_SleepDelay);
+                }
                 if (count <= itemLimit)
                 {
                     (*iIt)->SetToSettle(true);
                 }
             }
+            m_SleepingCount = sleepingCount;
+            g_LuaMan.UpdateParallelScripts(m_ParallelScriptBatch);
+            for (vector<MovableObject *>::iterator bItr = m_ParallelScriptBatch.begin(); bItr != m_ParallelScriptBatch.end(); ++bItr)
+            {
+                (*bItr)->ApplyImpulses();
+                (*bItr)->SleepDetection(m_SleepDelay);
+            }
         }
 
         // Particles
-		g_FrameMan.StartPerformanceMeasurement(FrameMan::PERF_PARTICLES_PASS2);
+		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_PARTICLES_PASS2);
         {
             SLICK_PROFILENAME("Second Pass - Particles", 0xFF557766);
+            m_ParallelScriptBatch.clear();
             for (parIt = m_Particles.begin(); parIt != m_Particles.end(); ++parIt)
             {
                 (*parIt)->Update();
+                if ((*parIt)->IsScriptThreadSafe())
+                {
+                    m_ParallelScriptBatch.push_back(*parIt);
+                    continue;
+                }
                 (*parIt)->UpdateScript();
                 (*parIt)->ApplyImpulses();
                 (*parIt)->RestDetection();
@@ -1829,8 +1981,16 @@ void MovableMan::Update()
                     (*parIt)->SetToSettle(true);
                 }
             }
+            g_LuaMan.UpdateParallelScripts(m_ParallelScriptBatch);
+            for (vector<MovableObject *>::iterator bItr = m_ParallelScriptBatch.begin(); bItr != m_ParallelScriptBatch.end(); ++bItr)
+            {
+                (*bItr)->ApplyImpulses();
+                (*bItr)->RestDetection();
+                if ((*bItr)->IsAtRest())
+                    (*bItr)->SetToSettle(true);
+            }
         }
-		g_FrameMan.StopPerformanceMeasurement(FrameMan::PERF_PARTICLES_PASS2);
+		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_PARTICLES_PASS2);
     }
 
     ///////////////////////////////////////////////////
@@ -1917,6 +2077,8 @@ void MovableMan::Update()
             {
                 // Report the death of the actor to the game
                 g_ActivityMan.GetActivity()->ReportDeath((*aIt)->GetTeam());
+                // Whatever was lying on it can't count on it staying put anymore
+                RegisterSupportChange(*aIt);
 
                 // Add to the particles list
                 m_Particles.push_back(*aIt);
@@ -1943,6 +2105,7 @@ void MovableMan::Update()
             while (iIt != m_Items.end())
             {
                 (*iIt)->SetToSettle(false);
+                RegisterSupportChange(*iIt);
 				// Disable TDExplosive's immunity to settling
 				if ((*iIt)->GetRestThreshold()< 0)
 					(*iIt)->SetRestThreshold(500);
@@ -1974,7 +2137,8 @@ void MovableMan::Update()
                 //m_ActorRoster[(*aIt)->GetTeam()].remove(*aIt);
 				RemoveActorFromTeamRoster(*aIt);
 
-            // Delete
+            // Delete, waking up whatever was lying on it
+            RegisterSupportChange(*aIt);
             delete *aIt;
             aIt++;
         }
@@ -1987,7 +2151,10 @@ void MovableMan::Update()
         imidIt = iIt;
 
         while (iIt != m_Items.end())
+        {
+            RegisterSupportChange(*iIt);
             delete *(iIt++);
+        }
         m_Items.erase(imidIt, m_Items.end());
 
         // Particles
@@ -2001,6 +2168,7 @@ void MovableMan::Update()
 
     // SETTLE PARTICLES //////////////////////////////////////////////////
     // Only settle after all updates and deletions are done
+	g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_SETTLE);
     if (m_SettlingEnabled)
     {
         SLICK_PROFILENAME("Settle particles", 0xFF879646);
@@ -2038,13 +2206,16 @@ void MovableMan::Update()
     }
 
     release_bitmap(g_SceneMan.GetTerrain()->GetMaterialBitmap());
+	g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_SETTLE);
 
     ////////////////////////////////////////////////////////////////////////
     // Draw the MO matter and IDs to their layers for next frame
 
 // Not anymore, we're using ClearAllMOIDDrawings instead.. much more efficient
 //    g_SceneMan.ClearMOIDLayer();
+	g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_MOIDS);
     UpdateDrawMOIDs(g_SceneMan.GetMOIDBitmap());
+	g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_MOIDS);
 
 	// COUNT MOID USAGE PER TEAM  //////////////////////////////////////////////////
 	{
@@ -2103,6 +2274,44 @@ void MovableMan::DrawMatter(BITMAP *pTargetBitmap, Vector &targetPos)
         (*parIt)->Draw(pTargetBitmap, targetPos, g_DrawMaterial);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetSimStateHash
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Calculates a hash of the current state of all held MOs.
+
+// FNV-1a over the raw bits of an MO's state, so that even the tiniest divergence shows up
+static void HashMOState(unsigned int &hash, const MovableObject *pMO)
+{
+    float state[5];
+    state[0] = pMO->GetPos().m_X;
+    state[1] = pMO->GetPos().m_Y;
+    state[2] = pMO->GetVel().m_X;
+    state[3] = pMO->GetVel().m_Y;
+    state[4] = pMO->GetRotMatrix().GetRadAngle();
+
+    const unsigned char *pBytes = reinterpret_cast<const unsigned char *>(state);
+    for (int b = 0; b < sizeof(state); ++b)
+    {
+        hash ^= pBytes[b];
+        hash *= 16777619U;
+    }
+}
+
+unsigned long MovableMan::GetSimStateHash() const
+{
+    unsigned int hash = 2166136261U;
+
+    for (deque<Actor *>::const_iterator aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
+        HashMOState(hash, *aIt);
+    for (deque<MovableObject *>::const_iterator iIt = m_Items.begin(); iIt != m_Items.end(); ++iIt)
+        HashMOState(hash, *iIt);
+    for (deque<MovableObject *>::const_iterator parIt = m_Particles.begin(); parIt != m_Particles.end(); ++parIt)
+        HashMOState(hash, *parIt);
+
+    return hash;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          VerifyMOIDIndex
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2138,6 +2347,104 @@ void MovableMan::VerifyMOIDIndex()
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MarkTerrainCells
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Either marks the terrain cells an area covers as changed this update,
+//                  or checks whether any of them changed this update or the last one.
+
+bool MovableMan::MarkTerrainCells(const Box &area, bool mark)
+{
+    int sceneWidth = g_SceneMan.GetSceneWidth();
+    int sceneHeight = g_SceneMan.GetSceneHeight();
+    if (sceneWidth <= 0 || sceneHeight <= 0)
+        return false;
+
+    // Size the grid to the current scene
+    int columns = (sceneWidth + TERRAINCELLSIZE - 1) / TERRAINCELLSIZE;
+    int rows = (sceneHeight + TERRAINCELLSIZE - 1) / TERRAINCELLSIZE;
+    if (columns != m_TerrainCellColumns || rows != m_TerrainCellRows)
+    {
+        if (!mark)
+            return false;
+        m_TerrainCellColumns = columns;
+        m_TerrainCellRows = rows;
+        m_TerrainChangeFrames.assign(columns * rows, 0);
+    }
+
+    Box box = area;
+    box.Unflip();
+    int left = (int)floor(box.GetCorner().m_X / TERRAINCELLSIZE);
+    int right = (int)floor((box.GetCorner().m_X + box.GetWidth()) / TERRAINCELLSIZE);
+    int top = max((int)floor(box.GetCorner().m_Y / TERRAINCELLSIZE), 0);
+    int bottom = min((int)floor((box.GetCorner().m_Y + box.GetHeight()) / TERRAINCELLSIZE), rows - 1);
+    // No point going around more than once
+    right = min(right, left + columns - 1);
+    bool wrapsX = g_SceneMan.SceneWrapsX();
+
+    for (int cellY = top; cellY <= bottom; ++cellY)
+    {
+        for (int cellX = left; cellX <= right; ++cellX)
+        {
+            int wrappedX = cellX;
+            if (wrappedX < 0 || wrappedX >= columns)
+            {
+                if (!wrapsX)
+                    continue;
+                wrappedX = ((wrappedX % columns) + columns) % columns;
+            }
+
+            unsigned int &cellFrame = m_TerrainChangeFrames[cellY * columns + wrappedX];
+            if (mark)
+                cellFrame = m_SimUpdateFrameNumber;
+            else if (cellFrame != 0 && cellFrame + 1 >= m_SimUpdateFrameNumber)
+                return true;
+        }
+    }
+
+    if (mark)
+        m_LastTerrainChangeFrame = m_SimUpdateFrameNumber;
+
+    return false;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RegisterSupportChange
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Marks the area around an MO that moved or is going away as changed, so
+//                  any sleeping items that may have been lying on it get woken up.
+
+void MovableMan::RegisterSupportChange(const MovableObject *pMO)
+{
+    // The same margin as sleepers are checked with, so anything touching it is caught
+    float radius = pMO->GetRadius() + 2;
+    MarkTerrainCells(Box(pMO->GetPos() - Vector(radius, radius), radius * 2, radius * 2), true);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SleeperDisturbed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether a sleeping MO needs to be woken up, either because
+//                  something happened to it or the terrain around it changed.
+
+bool MovableMan::SleeperDisturbed(const MovableObject *pMO, bool checkTerrain)
+{
+    if (pMO->SleepDisturbed())
+        return true;
+
+    if (checkTerrain)
+    {
+        // Include a little margin for what it's lying on
+        float radius = pMO->GetRadius() + 2;
+        return MarkTerrainCells(Box(pMO->GetPos() - Vector(radius, radius), radius * 2, radius * 2), false);
+    }
+
+    return false;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          UpdateDrawMOIDs
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2155,6 +2462,7 @@ void MovableMan::UpdateDrawMOIDs(BITMAP *pTargetBitmap)
     // Clear the index each frame and do it over because MO's get added and
     // deleted between each frame.
     m_MOIDIndex.clear();
+    m_MOIDInfo.clear();
     // Add a null and start counter at 1 because MOID == 0 means no MO.
     // - Update: This isnt' true anymore, but still keep 0 free just to be safe
     m_MOIDIndex.push_back(0);
@@ -2195,6 +2503,26 @@ void MovableMan::UpdateDrawMOIDs(BITMAP *pTargetBitmap)
         else
             m_Particles[i]->SetID(g_NoMOID);
     }
+
+    // Pack what the hit code needs to know about each MOID's root alongside the index
+    m_MOIDInfo.resize(m_MOIDIndex.size());
+    for (int id = 0; id < m_MOIDIndex.size(); ++id)
+    {
+        MOIDInfo &info = m_MOIDInfo[id];
+        const MovableObject *pRoot = m_MOIDIndex[id] ? m_MOIDIndex[m_MOIDIndex[id]->GetRootID()] : 0;
+        if (pRoot)
+        {
+            info.m_RootMOID = pRoot->GetID();
+            info.m_Team = pRoot->GetTeam();
+            info.m_IgnoresTeamHits = pRoot->IgnoresTeamHits();
+        }
+        else
+        {
+            info.m_RootMOID = g_NoMOID;
+            info.m_Team = Activity::NOTEAM;
+            info.m_IgnoresTeamHits = false;
+        }
+    }
 }
 
 
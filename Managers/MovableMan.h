@@ -447,6 +447,26 @@ public:
     long GetParticleCount() const { return m_Particles.size(); }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetActorCount
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the number of Actor:s currently held.
+// Arguments:       None.
+// Return value:    The number of actors.
+
+    long GetActorCount() const { return m_Actors.size(); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetItemCount
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the number of items currently held.
+// Arguments:       None.
+// Return value:    The number of items.
+
+    long GetItemCount() const { return m_Items.size(); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetAGResolution
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -490,6 +510,77 @@ public:
     int GetMaxDroppedItems() const { return m_MaxDroppedItems; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetAISensingInterval
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets how many frames apart the AI of actors that aren't engaged or
+//                  alarmed looks around for enemies and gold.
+// Arguments:       The number of frames. 1 makes all AI look around every frame.
+// Return value:    None.
+
+    void SetAISensingInterval(int newInterval) { m_AISensingInterval = newInterval > 1 ? newInterval : 1; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetAISensingInterval
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many frames apart the AI of actors that aren't engaged or
+//                  alarmed looks around for enemies and gold.
+// Arguments:       None.
+// Return value:    The number of frames.
+
+    int GetAISensingInterval() const { return m_AISensingInterval; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetAISensingBudget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the most actors that aren't engaged or alarmed that get to run
+//                  their AI sensing in any one frame. The rest wait for a later frame.
+// Arguments:       The number of actors. 0 means no limit.
+// Return value:    None.
+
+    void SetAISensingBudget(int newBudget) { m_AISensingBudget = newBudget > 0 ? newBudget : 0; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetAISensingBudget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the most actors that aren't engaged or alarmed that get to run
+//                  their AI sensing in any one frame.
+// Arguments:       None.
+// Return value:    The number of actors. 0 means no limit.
+
+    int GetAISensingBudget() const { return m_AISensingBudget; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ScheduleAISensing
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Decides whether an actor's AI should do its expensive looking around
+//                  this frame. Urgent actors always do. The others are staggered over the
+//                  sensing interval by their unique ID, and held to the per frame budget,
+//                  but never go longer than two intervals without sensing. Only frame
+//                  counts go into the decision, so it plays out the same way every run.
+// Arguments:       The actor whose AI is being updated.
+//                  Whether the actor is engaged, alarmed or hurt and needs to sense now.
+// Return value:    Whether the actor should sense this frame.
+
+    bool ScheduleAISensing(Actor *pActor, bool urgent);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AddAIUpdateTime
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Reports how long an actor's AI update took, to the actor itself and to
+//                  the AI performance counter of its class.
+// Arguments:       The actor whose AI was updated.
+//                  The time the update took, in microseconds.
+// Return value:    None.
+
+    void AddAIUpdateTime(Actor *pActor, int64_t time);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          SetScriptedEntity
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -720,7 +811,33 @@ public:
 //                  will be the same as the MOID passed in if the MO is a root itself. It will
 //                  be equal to g_NoMOID if the MOID isn't allocated to an MO.
 
-    MOID GetRootMOID(MOID checkMOID);
+    MOID GetRootMOID(MOID checkMOID) const { return checkMOID > 0 && checkMOID < m_MOIDInfo.size() ? m_MOIDInfo[checkMOID].m_RootMOID : g_NoMOID; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetMOIDTeam
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the team of the root MO of the MOID of a potential child MO,
+//                  without having to look up and walk up the MO hierarchy.
+// Arguments:       An MOID to get the root team of.
+// Return value:    The team of the root MO of the MO the passed-in MOID represents, as it
+//                  was when the MOIDs were assigned this frame. Activity::NOTEAM if the
+//                  MOID isn't allocated to an MO.
+
+    int GetMOIDTeam(MOID checkMOID) const { return checkMOID > 0 && checkMOID < m_MOIDInfo.size() ? m_MOIDInfo[checkMOID].m_Team : Activity::NOTEAM; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MOIDIgnoresTeamHits
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether the root MO of the MOID of a potential child MO ignores
+//                  hits with other MOs of its own team, without having to look up and
+//                  walk up the MO hierarchy.
+// Arguments:       An MOID to check the root of.
+// Return value:    Whether the root MO ignores team hits, as it was when the MOIDs were
+//                  assigned this frame. False if the MOID isn't allocated to an MO.
+
+    bool MOIDIgnoresTeamHits(MOID checkMOID) const { return checkMOID > 0 && checkMOID < m_MOIDInfo.size() ? m_MOIDInfo[checkMOID].m_IgnoresTeamHits : false; }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -861,6 +978,60 @@ public:
     void EnableParticleSettling(bool enable = true) { m_SettlingEnabled = enable; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetSleepDelay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how long an item has to lie still before it is put to sleep and
+//                  skipped by the travel and update passes until something disturbs it.
+// Arguments:       None.
+// Return value:    The delay in ms sim time. 0 means items never sleep.
+
+    int GetSleepDelay() const { return m_SleepDelay; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetSleepDelay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets how long an item has to lie still before it is put to sleep.
+// Arguments:       The delay in ms sim time. 0 means items never sleep.
+// Return value:    None.
+
+    void SetSleepDelay(int newDelay) { m_SleepDelay = newDelay; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetSleepingCount
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many items were asleep at the end of the last update.
+// Arguments:       None.
+// Return value:    The number of sleeping items.
+
+    int GetSleepingCount() const { return m_SleepingCount; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RegisterTerrainChange
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Marks an area of the terrain as changed, so that any sleeping items
+//                  lying there get woken up at the start of the next update.
+// Arguments:       The area of the scene that changed. Can cross the wrapping seam.
+// Return value:    None.
+
+    void RegisterTerrainChange(const Box &area) { MarkTerrainCells(area, true); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RegisterSupportChange
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Marks the area around an MO that moved or is going away as changed, the
+//                  same way as changed terrain, so any sleeping items that may have been
+//                  lying on it get woken up.
+// Arguments:       The MO that moved or is going away. Ownership is NOT transferred.
+// Return value:    None.
+
+    void RegisterSupportChange(const MovableObject *pMO);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          IsMOSubtractionEnabled
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -992,7 +1163,7 @@ public:
 // Arguments:       Unique Id to look for.
 // Return value:    Object found or 0 if not found any.
 
-	MovableObject * FindObjectByUniqueID(long int id) { if (m_KnownObjects.count(id) > 0) return m_KnownObjects[id]; else return 0; }
+	MovableObject * FindObjectByUniqueID(long int id);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1014,6 +1185,18 @@ public:
 
 	unsigned int GetSimUpdateFrameNumber() const { return m_SimUpdateFrameNumber; }
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetSimStateHash
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Calculates a hash of the current state of all held MOs, their
+//                  positions, velocities and rotations. Two runs of the same simulation
+//                  with the same seed should produce the same hash.
+// Arguments:       None.
+// Return value:    The hash of the current MO state.
+
+	unsigned long GetSimStateHash() const;
+
 	void OnPieMenu(Actor *pActor);
 
 
@@ -1022,6 +1205,36 @@ public:
 
 protected:
 
+    // The size of the cells the terrain is divided into for keeping track of where it changed,
+    // and how fast an MO has to be going for anything lying on it to be woken up
+    enum { TERRAINCELLSIZE = 64 };
+    static const float SUPPORTMOVINGSPEED;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MarkTerrainCells
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Either marks the terrain cells an area covers as changed this update,
+//                  or checks whether any of them changed this update or the last one.
+// Arguments:       The area of the scene. Can cross the wrapping seam.
+//                  Whether to mark the cells rather than check them.
+// Return value:    Whether any of the covered cells were changed recently, when checking.
+
+    bool MarkTerrainCells(const Box &area, bool mark);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SleeperDisturbed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether a sleeping MO needs to be woken up, either because
+//                  something happened to it or the terrain around it changed.
+// Arguments:       The sleeping MO. Ownership is NOT transferred.
+//                  Whether to also check for terrain changes around it.
+// Return value:    Whether the MO should be woken up.
+
+    bool SleeperDisturbed(const MovableObject *pMO, bool checkTerrain);
+
+
     // Member variables
     static const std::string m_ClassName;
 
@@ -1056,8 +1269,22 @@ protected:
     // This is the current frame's events, will be filled up during MovableMan Updates, should be transferred to Last Frame at end of update.
     std::list<AlarmEvent> m_AddedAlarmEvents;
 
+    // What the hit code needs to know about each MOID's root, packed so it can be looked up
+    // without chasing pointers through the MO hierarchy
+    struct MOIDInfo
+    {
+        // The MOID of the root MO, g_NoMOID if the index entry is unused
+        MOID m_RootMOID;
+        // The team of the root MO
+        char m_Team;
+        // Whether the root MO ignores hits with its own team
+        bool m_IgnoresTeamHits;
+    };
+
     // The list created each frame to register all the current MO's
     std::vector<MovableObject *> m_MOIDIndex;
+    // Parallel to m_MOIDIndex, rebuilt along with it each frame
+    std::vector<MOIDInfo> m_MOIDInfo;
     // Global AtomGroup resolution setting.
     int m_AGResolution;
     // The ration of terrain pixels to be converted into MOPixel:s upon
@@ -1065,6 +1292,14 @@ protected:
     float m_SplashRatio;
     // The maximum number of loose items allowed.
     int m_MaxDroppedItems;
+    // How many frames apart actors that aren't engaged or alarmed run their AI sensing
+    int m_AISensingInterval;
+    // The most non-urgent AI sensing runs per frame, 0 for no limit
+    int m_AISensingBudget;
+    // How many non-urgent AI sensing runs have been done this frame
+    int m_AISensingThisFrame;
+    // The AI performance counter of each actor class, by class name
+    std::map<std::string, int> m_AICounters;
 
     // Timer for measuring periods of slo-mo effects
     Timer m_SloMoTimer;
@@ -1078,11 +1313,25 @@ protected:
     // Whtehr MO's vcanng et subtracted form the terrain at all
     bool m_MOSubtractionEnabled;
 
+    // How long, in ms sim time, an item has to lie still before being put to sleep. 0 disables sleeping
+    int m_SleepDelay;
+    // How many items were asleep at the end of the last update
+    int m_SleepingCount;
+    // The sim update frame number each terrain cell was last changed in, row by row
+    std::vector<unsigned int> m_TerrainChangeFrames;
+    // The dimensions of the terrain cell grid, in cells
+    int m_TerrainCellColumns;
+    int m_TerrainCellRows;
+    // The last sim update frame number any terrain cell was changed in
+    unsigned int m_LastTerrainChangeFrame;
+
 	unsigned int m_SimUpdateFrameNumber;
 
     // Temporary hold for scripted entites that are about to have their preset scripts run.
     // This is a way to export an entity pointer properly to the Lua/Luabind environment.
     Entity *m_pObjectToScriptUpdate;
+    // The ScriptThreadSafe objects of the current second pass loop, to have their scripts run by LuaMan's workers all at once
+    std::vector<MovableObject *> m_ParallelScriptBatch;
 
 	// Global map which stores all objects so they could be foud by their unique ID
 	std::map<long int, MovableObject *> m_KnownObjects;
@@ -19,6 +19,7 @@
 #include "FrameMan.h"
 #include "Audioman.h"
 #include "SettingsMan.h"
+#include "System.h"
 
 #include "NetworkClient.h"
 
@@ -59,6 +60,8 @@ namespace RTE
 		//m_LastLineReceived = 0;
 		m_pSceneBackgroundBitmap = 0;
 		m_pSceneForegroundBitmap = 0;
+		m_SceneCache.clear();
+		m_SceneKey = 0;
 		for (int f = 0; f < FRAMES_TO_REMEMBER; f++)
 			m_TargetPos[f].Reset();
 		m_CurrentSceneLayerReceived = -1;
@@ -435,9 +438,124 @@ namespace RTE
 				else
 					LZ4_decompress_safe((char *)(p->data + sizeof(MsgSceneLine)), (char *)(bmp->line[liney] + linex), frameData->DataSize, width);
 			}
+
+			// Keep the line as it was sent so it can be cached
+			int strips = (m_SceneWidth + SCENE_LINE_WIDTH - 1) / SCENE_LINE_WIDTH;
+			unsigned int index = (frameData->Layer * strips + linex / SCENE_LINE_WIDTH) * m_SceneHeight + liney;
+			if (index < m_SceneCache.size())
+			{
+				SceneCacheLine &line = m_SceneCache[index];
+				line.Hash = frameData->Hash;
+				line.UncompressedSize = frameData->UncompressedSize;
+				line.Data.assign((char *)(p->data + sizeof(MsgSceneLine)), (char *)(p->data + sizeof(MsgSceneLine)) + frameData->DataSize);
+			}
 		}
 	}
 
+	std::string NetworkClient::GetSceneCachePath(unsigned int sceneKey) const
+	{
+		char fileName[64];
+		sprintf(fileName, "SceneCache/%08x.dat", sceneKey);
+		return fileName;
+	}
+
+	bool NetworkClient::LoadSceneCache()
+	{
+		PACKFILE *pFile = pack_fopen(GetSceneCachePath(m_SceneKey).c_str(), F_READ);
+		if (!pFile)
+			return false;
+
+		bool valid = pack_mgetl(pFile) == SCENECACHEMAGIC && pack_mgetl(pFile) == SCENECACHEVERSION;
+		valid = valid && (unsigned int)pack_mgetl(pFile) == m_SceneKey && pack_mgetl(pFile) == m_SceneWidth && pack_mgetl(pFile) == m_SceneHeight;
+		valid = valid && pack_mgetl(pFile) == m_SceneCache.size();
+
+		// Read it all in before touching the scene, so a truncated file leaves it as it was
+		std::vector<SceneCacheLine> lines(m_SceneCache.size());
+		for (std::vector<SceneCacheLine>::iterator lItr = lines.begin(); valid && lItr != lines.end(); ++lItr)
+		{
+			lItr->Hash = pack_mgetl(pFile);
+			lItr->UncompressedSize = pack_mgetw(pFile);
+			int dataSize = pack_mgetw(pFile);
+			valid = !pack_feof(pFile) && lItr->UncompressedSize <= SCENE_LINE_WIDTH && dataSize <= MAX_PIXEL_LINE_BUFFER_SIZE;
+			if (valid && dataSize > 0)
+			{
+				lItr->Data.resize(dataSize);
+				valid = pack_fread(&lItr->Data[0], dataSize, pFile) == dataSize;
+			}
+		}
+		pack_fclose(pFile);
+
+		if (!valid)
+			return false;
+
+		m_SceneCache.swap(lines);
+
+		// Draw what was cached, the server will send whatever has changed since
+		int strips = (m_SceneWidth + SCENE_LINE_WIDTH - 1) / SCENE_LINE_WIDTH;
+		int index = 0;
+		for (int layer = 0; layer < 2; layer++)
+		{
+			BITMAP * bmp = layer == 0 ? m_pSceneBackgroundBitmap : m_pSceneForegroundBitmap;
+			for (int strip = 0; strip < strips; strip++)
+			{
+				int linex = strip * SCENE_LINE_WIDTH;
+				int width = MIN(SCENE_LINE_WIDTH, m_SceneWidth - linex);
+				for (int liney = 0; liney < m_SceneHeight; liney++, index++)
+				{
+					SceneCacheLine &line = m_SceneCache[index];
+					if (line.Hash == 0 || line.UncompressedSize != width)
+					{
+						line.Hash = 0;
+						continue;
+					}
+
+					if (line.Data.empty())
+						memset(bmp->line[liney] + linex, g_KeyColor, width);
+					else if (line.Data.size() == line.UncompressedSize)
+						memcpy(bmp->line[liney] + linex, &line.Data[0], width);
+					else if (LZ4_decompress_safe(&line.Data[0], (char *)(bmp->line[liney] + linex), line.Data.size(), width) != width)
+						line.Hash = 0;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool NetworkClient::SaveSceneCache() const
+	{
+		if (m_SceneCache.empty())
+			return false;
+
+		g_System.MakeDirectory("SceneCache");
+		PACKFILE *pFile = pack_fopen(GetSceneCachePath(m_SceneKey).c_str(), F_WRITE);
+		if (!pFile)
+			return false;
+
+		pack_mputl(SCENECACHEMAGIC, pFile);
+		pack_mputl(SCENECACHEVERSION, pFile);
+		pack_mputl(m_SceneKey, pFile);
+		pack_mputl(m_SceneWidth, pFile);
+		pack_mputl(m_SceneHeight, pFile);
+		pack_mputl(m_SceneCache.size(), pFile);
+
+		bool written = true;
+		for (std::vector<SceneCacheLine>::const_iterator lItr = m_SceneCache.begin(); written && lItr != m_SceneCache.end(); ++lItr)
+		{
+			pack_mputl(lItr->Hash, pFile);
+			pack_mputw(lItr->UncompressedSize, pFile);
+			pack_mputw(lItr->Data.size(), pFile);
+			if (!lItr->Data.empty())
+				written = pack_fwrite(&lItr->Data[0], lItr->Data.size(), pFile) == lItr->Data.size();
+		}
+		pack_fclose(pFile);
+
+		// Don't let the caches of scenes long gone pile up
+		g_System.TrimDirectory("SceneCache", "*.dat", SCENECACHEMAXSIZE);
+
+		return written;
+	}
+
 	void NetworkClient::DrawBackgrounds(BITMAP * pTargetBitmap)
 	{
 		for (int i = m_ActiveBackgroundLayers - 1; i >= 0; i--)
@@ -1014,6 +1132,7 @@ namespace RTE
 	void NetworkClient::ReceiveSceneEndMsg()
 	{
 		g_ConsoleMan.PrintString("Client: Scene received.");
+		SaveSceneCache();
 		SendSceneAcceptedMsg();
 	}
 
@@ -1061,6 +1180,18 @@ namespace RTE
 		m_SceneWidth = frameData->Width;
 		m_SceneHeight = frameData->Height;
 
+		// Start from whatever was cached from this map before, so the server only has to send what's missing or changed
+		m_SceneKey = frameData->SceneKey;
+		m_SceneCache.clear();
+		m_SceneCache.resize(2 * ((m_SceneWidth + SCENE_LINE_WIDTH - 1) / SCENE_LINE_WIDTH) * m_SceneHeight);
+		for (std::vector<SceneCacheLine>::iterator lItr = m_SceneCache.begin(); lItr != m_SceneCache.end(); ++lItr)
+		{
+			lItr->Hash = 0;
+			lItr->UncompressedSize = 0;
+		}
+		if (LoadSceneCache())
+			g_ConsoleMan.PrintString("Client: Scene cache loaded");
+
 		m_ActiveBackgroundLayers = frameData->BackgroundLayerCount;
 
 		for (int i = 0; i < m_ActiveBackgroundLayers; i++)
@@ -1110,10 +1241,18 @@ namespace RTE
 
 	void NetworkClient::SendSceneSetupAcceptedMsg()
 	{
-		MsgRegister msg;
-		msg.Id = ID_CLT_SCENE_SETUP_ACCEPTED;
-
-		m_Client->Send((const char *)&msg, sizeof(msg), HIGH_PRIORITY, RELIABLE_ORDERED, 0, m_ServerID, false);
+		// Tell the server which scene lines we already have, so it can skip them
+		std::vector<unsigned char> buffer(sizeof(MsgSceneSetupAccepted) + m_SceneCache.size() * sizeof(unsigned int));
+		MsgSceneSetupAccepted * msg = (MsgSceneSetupAccepted *)&buffer[0];
+		msg->Id = ID_CLT_SCENE_SETUP_ACCEPTED;
+		msg->SceneId = m_SceneId;
+		msg->LineHashCount = m_SceneCache.size();
+
+		unsigned int * pHashes = (unsigned int *)(&buffer[0] + sizeof(MsgSceneSetupAccepted));
+		for (int i = 0; i < m_SceneCache.size(); i++)
+			pHashes[i] = m_SceneCache[i].Hash;
+
+		m_Client->Send((const char *)&buffer[0], buffer.size(), HIGH_PRIORITY, RELIABLE_ORDERED, 0, m_ServerID, false);
 
 		g_ConsoleMan.PrintString("Client: Scene setup ACK Sent");
 	}
@@ -18,6 +18,7 @@
 #include "Sound.h"
 
 #include <map>
+#include <vector>
 
 #include "Network.h"
 #include "NatPunchthroughClient.h"
@@ -206,6 +207,36 @@ namespace RTE
 
 		void ReceiveSceneEndMsg();
 
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Method:          GetSceneCachePath
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Description:     Gets the path of the scene cache file for a specific map.
+		// Arguments:       The scene key the server identified the map with.
+		// Return value:    The path of the cache file.
+
+		std::string GetSceneCachePath(unsigned int sceneKey) const;
+
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Method:          LoadSceneCache
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Description:     Loads the scene lines cached from the current map the last time it
+		//                  was received, if there are any, and draws them into the scene bitmaps
+		//                  so the server can skip sending the ones that haven't changed.
+		// Arguments:       None.
+		// Return value:    Whether a cache matching the current scene was loaded.
+
+		bool LoadSceneCache();
+
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Method:          SaveSceneCache
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Description:     Saves the scene lines as received from the server to the cache file
+		//                  of the current map.
+		// Arguments:       None.
+		// Return value:    Whether the cache file was written.
+
+		bool SaveSceneCache() const;
+
 		void DrawBackgrounds(BITMAP * pTargetBitmap);
 
 		void DrawFrame();
@@ -247,6 +278,25 @@ namespace RTE
 
 		unsigned char m_SceneId;
 
+		// One line of the scene terrain as received from the server, kept so it can be cached on disk
+		struct SceneCacheLine
+		{
+			// Hash of the uncompressed pixels as given by the server, 0 if the line isn't held
+			unsigned int Hash;
+			unsigned short int UncompressedSize;
+			// The pixels as sent, LZ4 compressed unless as long as UncompressedSize. Empty means all key color
+			std::vector<char> Data;
+		};
+
+		// Magic number and version of the scene cache files
+		// The oldest cache files get deleted once they add up to more than SCENECACHEMAXSIZE bytes
+		enum { SCENECACHEMAGIC = 0x53434331, SCENECACHEVERSION = 1, SCENECACHEMAXSIZE = 64 * 1024 * 1024 };
+
+		// The lines of the current scene, ordered by layer, strip and line like the server sends them
+		std::vector<SceneCacheLine> m_SceneCache;
+		// Which map the current scene is, as identified by the server
+		unsigned int m_SceneKey;
+
 		int m_CurrentFrame;
 
 		Vector m_TargetPos[FRAMES_TO_REMEMBER];
@@ -6,9 +6,16 @@ namespace RTE
 #define MAX_PIXEL_LINE_BUFFER_SIZE 8192
 #define MAX_BACKGROUND_LAYERS_TRANSMITTED 10
 #define FRAMES_TO_REMEMBER 3
+// The width of the strips the scene terrain is cut into when sent, in pixels
+#define SCENE_LINE_WIDTH 1280
 
 #define MAX_CLIENTS 4
 
+// How often game servers refresh their registration with the NAT service, and how long the
+// NAT service keeps a registration around without a refresh
+#define NAT_SERVER_HEARTBEAT_MS 30000
+#define NAT_SERVER_REGISTRATION_TTL_MS 90000
+
 
 	enum CustomMessageIDTypes
 	{
@@ -161,6 +168,8 @@ namespace RTE
 		short int Width;
 		short int Height;
 		bool SceneWrapsX;
+		// Identifies the map, so clients can find the scene lines they cached from it before
+		unsigned int SceneKey;
 
 		short int BackgroundLayerCount;
 		LightweightSceneLayer BackgroundLayers[MAX_BACKGROUND_LAYERS_TRANSMITTED];
@@ -176,6 +185,17 @@ namespace RTE
 		unsigned char Layer;
 		unsigned short int DataSize;
 		unsigned short int UncompressedSize;
+		// Hash of the uncompressed pixels, for the client's scene cache
+		unsigned int Hash;
+	};
+
+	// Followed by LineHashCount hashes of the scene lines the client already has, 0 for the ones it doesn't,
+	// ordered by layer, strip and line
+	struct MsgSceneSetupAccepted
+	{
+		unsigned char Id;
+		unsigned char SceneId;
+		unsigned int LineHashCount;
 	};
 
 	struct MsgSceneEnd
@@ -31,6 +31,7 @@
 #include "Scene.h"
 #include "SLTerrain.h"
 #include "TimerMan.h"
+#include "PerformanceMan.h"
 #include "AudioMan.h"
 #include "GameActivity.h"
 
@@ -47,6 +48,10 @@ namespace RTE
 
 	void BackgroundSendThreadFunction(NetworkServer * ns, int player)
 	{
+		// Measured on each player's send thread and summed up by the PerformanceMan
+		int sceneCounter = g_PerformanceMan.RegisterCounter("Net Send Scene");
+		int frameCounter = g_PerformanceMan.RegisterCounter("Net Send Frame");
+
 		while (ns->IsServerModeEnabled() && ns->IsPlayerConnected(player))
 		{
 			if (ns->NeedToSendSceneSetupData(player) && ns->IsSceneAvailable(player))
@@ -56,11 +61,15 @@ namespace RTE
 			if (ns->NeedToSendSceneData(player) && ns->IsSceneAvailable(player))
 			{
 				ns->ClearTerrainChangeQueue(player);
+				g_PerformanceMan.StartPerformanceMeasurement(sceneCounter);
 				ns->SendSceneData(player);
+				g_PerformanceMan.StopPerformanceMeasurement(sceneCounter);
 			}
 			if (ns->SendFrameData(player))
 			{
+				g_PerformanceMan.StartPerformanceMeasurement(frameCounter);
 				int ret = ns->SendFrame(player);
+				g_PerformanceMan.StopPerformanceMeasurement(frameCounter);
 				ns->SetMSecsToSleep(player, ret / 1000);
 				if (ret > 0)
 					std::this_thread::sleep_for(std::chrono::microseconds(ret));
@@ -185,6 +194,13 @@ namespace RTE
 		m_BoxHeight = 44;
 		m_NatServerConnected = false;
 		m_LastPackedReceived.Reset();
+
+		m_SceneSnapshot.clear();
+		m_SceneSnapshotId = -1;
+		m_SceneSnapshotStrips = 0;
+		m_SceneSnapshotHeight = 0;
+		m_SceneSnapshotHash = 0;
+		m_SceneSnapshotStale.clear();
 	}
 
 	//////////////////////////////////////////////////////////////////////////////////////////
@@ -266,6 +282,11 @@ namespace RTE
 		m_IsInServerMode = false;
 		// Wait for thread to shut down
 		Sleep(250);
+		while (!m_HeldPackets.empty())
+		{
+			m_Server->DeallocatePacket(m_HeldPackets.front());
+			m_HeldPackets.pop();
+		}
 		m_Server->Shutdown(300);
 		// We're done with the network
 		RakNet::RakPeerInterface::DestroyInstance(m_Server);
@@ -296,9 +317,10 @@ namespace RTE
 		RakNet::RakNetGUID guid = GetServerGuid();
 		strncpy(msg.ServerGuid, guid.ToString(), 62);
 		
-		int payloadSize = sizeof(RTE::MsgSceneSetup);
+		int payloadSize = sizeof(RTE::MsgRegisterServer);
 
 		m_Server->Send((const char *)&msg, payloadSize, IMMEDIATE_PRIORITY, RELIABLE, 0, addr, false);
+		m_NatRegistrationTimer.Reset();
 	}
 
 	void NetworkServer::Start()
@@ -357,121 +379,156 @@ namespace RTE
 		m_Server->SetUnreliableTimeout(50);
 	}
 
-	void NetworkServer::Update(bool processInput)
-	{
-		RakNet::Packet *p;
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Method:          KeepAlive
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Description:     Takes in whatever the clients sent without acting on it yet, and keeps
+	//                  the NAT service registration fresh.
 
-		for (p = m_Server->Receive(); p; m_Server->DeallocatePacket(p), p = m_Server->Receive())
+	void NetworkServer::KeepAlive()
+	{
+		for (RakNet::Packet *p = m_Server->Receive(); p; p = m_Server->Receive())
 		{
 			m_LastPackedReceived.Reset();
+			m_HeldPackets.push(p);
+		}
 
-			// We got a packet, get the identifier with our handy function
-			unsigned char packetIdentifier = GetPacketIdentifier(p);
-			std::string msg;
-			RakNet::SystemAddress clientID;
-
-			// Check if this is a network message packet
-			switch (packetIdentifier)
-			{
-			case ID_DISCONNECTION_NOTIFICATION:
-				// Connection lost normally
-				msg = "ID_DISCONNECTION_NOTIFICATION from ";
-				msg += p->systemAddress.ToString(true);
-				g_ConsoleMan.PrintString(msg);
-				ReceiveDisconnection(p);
-				break;
-
-
-			case ID_NEW_INCOMING_CONNECTION:
-				ReceiveNewIncomingConnection(p);
-				break;
-
-			case ID_INCOMPATIBLE_PROTOCOL_VERSION:
-				g_ConsoleMan.PrintString("ID_INCOMPATIBLE_PROTOCOL_VERSION\n");
-				break;
-
-			case ID_CONNECTED_PING:
-			case ID_UNCONNECTED_PING:
-				g_ConsoleMan.PrintString(p->systemAddress.ToString(true));
-				break;
-
-			// Couldn't deliver a reliable packet - i.e. the other system was abnormally terminated
-			case ID_CONNECTION_LOST:
-			// Manual disconnection
-			case ID_CLT_DISCONNECT:
-				ReceiveDisconnection(p);
-				break;
-
-			case ID_CLT_SCENE_SETUP_ACCEPTED:
-				ReceiveSceneSetupDataAccepted(p);
-				break;
-
-			case ID_CLT_REGISTER:
-				ReceiveRegisterMsg(p);
-				break;
-
-			case ID_CLT_INPUT:
-				ReceiveInputMsg(p);
-				break;
-
-			case ID_CLT_SCENE_ACCEPTED:
-				ReceiveSceneAcceptedMsg(p);
-				break;
-
-			case ID_CONNECTION_REQUEST_ACCEPTED:
-				break;
-
-			case ID_NAT_SERVER_REGISTER_ACCEPTED:
-				m_NatServerConnected = true;
-				break;
-
-			case ID_NAT_TARGET_NOT_CONNECTED:
-				g_ConsoleMan.PrintString("Failed: ID_NAT_TARGET_NOT_CONNECTED");
-				break;
+		if (m_NatServerConnected && m_NatRegistrationTimer.IsPastRealMS(NAT_SERVER_HEARTBEAT_MS))
+			SendNATServerRegistrationMsg(m_NATServiceServerID);
+	}
 
-			case ID_NAT_TARGET_UNRESPONSIVE:
-				g_ConsoleMan.PrintString("Failed: ID_NAT_TARGET_UNRESPONSIVE");
-				break;
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Method:          HandlePacket
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Description:     Acts on a packet received from a client or the NAT service.
 
-			case ID_NAT_CONNECTION_TO_TARGET_LOST:
-				g_ConsoleMan.PrintString("Failed: ID_NAT_CONNECTION_TO_TARGET_LOST");
-				break;
+	void NetworkServer::HandlePacket(RakNet::Packet *p)
+	{
+		// We got a packet, get the identifier with our handy function
+		unsigned char packetIdentifier = GetPacketIdentifier(p);
+		std::string msg;
+		RakNet::SystemAddress clientID;
 
-			case ID_NAT_PUNCHTHROUGH_FAILED:
-				g_ConsoleMan.PrintString("Failed: ID_NAT_PUNCHTHROUGH_FAILED");
-				break;
+		// Check if this is a network message packet
+		switch (packetIdentifier)
+		{
+		case ID_DISCONNECTION_NOTIFICATION:
+			// Connection lost normally
+			msg = "ID_DISCONNECTION_NOTIFICATION from ";
+			msg += p->systemAddress.ToString(true);
+			g_ConsoleMan.PrintString(msg);
+			ReceiveDisconnection(p);
+			break;
+
+
+		case ID_NEW_INCOMING_CONNECTION:
+			ReceiveNewIncomingConnection(p);
+			break;
+
+		case ID_INCOMPATIBLE_PROTOCOL_VERSION:
+			g_ConsoleMan.PrintString("ID_INCOMPATIBLE_PROTOCOL_VERSION\n");
+			break;
+
+		case ID_CONNECTED_PING:
+		case ID_UNCONNECTED_PING:
+			g_ConsoleMan.PrintString(p->systemAddress.ToString(true));
+			break;
+
+		// Couldn't deliver a reliable packet - i.e. the other system was abnormally terminated
+		case ID_CONNECTION_LOST:
+		// Manual disconnection
+		case ID_CLT_DISCONNECT:
+			ReceiveDisconnection(p);
+			break;
+
+		case ID_CLT_SCENE_SETUP_ACCEPTED:
+			ReceiveSceneSetupDataAccepted(p);
+			break;
+
+		case ID_CLT_REGISTER:
+			ReceiveRegisterMsg(p);
+			break;
+
+		case ID_CLT_INPUT:
+			ReceiveInputMsg(p);
+			break;
+
+		case ID_CLT_SCENE_ACCEPTED:
+			ReceiveSceneAcceptedMsg(p);
+			break;
+
+		case ID_CONNECTION_REQUEST_ACCEPTED:
+			break;
+
+		case ID_NAT_SERVER_REGISTER_ACCEPTED:
+			m_NatServerConnected = true;
+			break;
+
+		case ID_NAT_TARGET_NOT_CONNECTED:
+			g_ConsoleMan.PrintString("Failed: ID_NAT_TARGET_NOT_CONNECTED");
+			break;
+
+		case ID_NAT_TARGET_UNRESPONSIVE:
+			g_ConsoleMan.PrintString("Failed: ID_NAT_TARGET_UNRESPONSIVE");
+			break;
+
+		case ID_NAT_CONNECTION_TO_TARGET_LOST:
+			g_ConsoleMan.PrintString("Failed: ID_NAT_CONNECTION_TO_TARGET_LOST");
+			break;
+
+		case ID_NAT_PUNCHTHROUGH_FAILED:
+			g_ConsoleMan.PrintString("Failed: ID_NAT_PUNCHTHROUGH_FAILED");
+			break;
+
+		case ID_NAT_PUNCHTHROUGH_SUCCEEDED:
+			g_ConsoleMan.PrintString("Server: ID_NAT_PUNCHTHROUGH_SUCCEEDED");
+			break;
+
+		/*case ID_UNCONNECTED_PONG:
+		case ID_CONNECTED_PONG:
+		{
+			g_ConsoleMan.PrintString("PONG");
+			int player = -1;
 
-			case ID_NAT_PUNCHTHROUGH_SUCCEEDED:
-				g_ConsoleMan.PrintString("Server: ID_NAT_PUNCHTHROUGH_SUCCEEDED");
-				break;
+			for (int index = 0; index < MAX_CLIENTS; index++)
+				if (m_ClientConnections[index].ClientId == p->systemAddress)
+					player = index;
 
-			/*case ID_UNCONNECTED_PONG:
-			case ID_CONNECTED_PONG:
+			if (player > -1 && player < MAX_CLIENTS)
 			{
-				g_ConsoleMan.PrintString("PONG");
-				int player = -1;
+				unsigned int dataLength;
+				RakNet::TimeMS time;
+				RakNet::BitStream bsIn(p->data, p->length, false);
+				bsIn.IgnoreBytes(1);
+				bsIn.Read(time);
+				dataLength = p->length - sizeof(unsigned char) - sizeof(RakNet::TimeMS);
+				m_Ping[player] = (unsigned int)(RakNet::GetTimeMS() - time);
+			}
+			break;
+		}*/
 
-				for (int index = 0; index < MAX_CLIENTS; index++)
-					if (m_ClientConnections[index].ClientId == p->systemAddress)
-						player = index;
 
-				if (player > -1 && player < MAX_CLIENTS)
-				{
-					unsigned int dataLength;
-					RakNet::TimeMS time;
-					RakNet::BitStream bsIn(p->data, p->length, false);
-					bsIn.IgnoreBytes(1);
-					bsIn.Read(time);
-					dataLength = p->length - sizeof(unsigned char) - sizeof(RakNet::TimeMS);
-					m_Ping[player] = (unsigned int)(RakNet::GetTimeMS() - time);
-				}
-				break;
-			}*/
+		default:
+			break;
+		}
+	}
 
+	void NetworkServer::Update(bool processInput)
+	{
+		RakNet::Packet *p;
 
-			default:
-				break;
-			}
+		// What came in while KeepAlive was standing in goes first
+		while (!m_HeldPackets.empty())
+		{
+			HandlePacket(m_HeldPackets.front());
+			m_Server->DeallocatePacket(m_HeldPackets.front());
+			m_HeldPackets.pop();
+		}
+
+		for (p = m_Server->Receive(); p; m_Server->DeallocatePacket(p), p = m_Server->Receive())
+		{
+			m_LastPackedReceived.Reset();
+			HandlePacket(p);
 		}
 
 		if (processInput)
@@ -483,6 +540,7 @@ namespace RTE
 				{
 					NetworkClient::MsgInput msg = m_InputMessages[p].front();
 					m_InputMessages[p].pop();
+					g_UInputMan.GetInputRecorder().RecordEvent(InputRecorder::EVENT_NETWORKINPUT, p, &msg, sizeof(msg));
 					ProcessInputMessage(p, msg);
 				}
 			}
@@ -547,6 +605,10 @@ namespace RTE
 		}
 
 
+		// Keep the registration with the NAT service alive, it forgets servers that stop refreshing it
+		if (m_NatServerConnected && m_NatRegistrationTimer.IsPastRealMS(NAT_SERVER_HEARTBEAT_MS))
+			SendNATServerRegistrationMsg(m_NATServiceServerID);
+
 		if (g_SettingsMan.GetServerSleepWhenIdle() && m_LastPackedReceived.IsPastRealMS(10000))
 		{
 			int playersConnected = 0;
@@ -743,6 +805,14 @@ namespace RTE
 
 		Scene * pScene = g_SceneMan.GetScene();
 
+		// FNV-1a of the map's name and size, which is all the client needs to pick its cache for it
+		std::string sceneName = pScene->GetPresetName();
+		msgSceneSetup.SceneKey = 2166136261U;
+		for (int i = 0; i < sceneName.size(); i++)
+			msgSceneSetup.SceneKey = (msgSceneSetup.SceneKey ^ (unsigned char)sceneName[i]) * 16777619U;
+		msgSceneSetup.SceneKey = (msgSceneSetup.SceneKey ^ (unsigned int)msgSceneSetup.Width) * 16777619U;
+		msgSceneSetup.SceneKey = (msgSceneSetup.SceneKey ^ (unsigned int)msgSceneSetup.Height) * 16777619U;
+
 		std::list<SceneLayer *> layers = pScene->GetBackLayers();
 		int index = 0;
 
@@ -810,6 +880,21 @@ namespace RTE
 	void NetworkServer::ResetScene()
 	{
 		m_SceneId++;
+
+		// The old snapshot is of no use anymore, let the memory go
+		m_SceneSnapshotMutex.lock();
+		m_SceneSnapshot.clear();
+		m_SceneSnapshotId = -1;
+		m_SceneSnapshotHash = 0;
+		m_SceneSnapshotMutex.unlock();
+
+		for (int i = 0; i < MAX_CLIENTS; i++)
+		{
+			m_Mutex[i].lock();
+			m_ClientSceneHashes[i].clear();
+			m_Mutex[i].unlock();
+		}
+
 		for (int i = 0; i < MAX_CLIENTS; i++)
 		{
 			m_SendSceneSetupData[i] = true;
@@ -829,6 +914,23 @@ namespace RTE
 
 		if (player > -1)
 		{
+			// Keep the hashes of the scene lines the client has cached, if they are for this scene and all arrived
+			RTE::MsgSceneSetupAccepted * msg = (RTE::MsgSceneSetupAccepted *)p->data;
+			m_Mutex[player].lock();
+			m_ClientSceneHashes[player].clear();
+			if (p->length >= sizeof(RTE::MsgSceneSetupAccepted) && msg->SceneId == m_SceneId)
+			{
+				// Check the count against what actually arrived and what this scene can have before using it, so it can't overflow or run past the packet
+				unsigned int hashesReceived = (p->length - sizeof(RTE::MsgSceneSetupAccepted)) / sizeof(unsigned int);
+				unsigned int sceneLines = 2 * ((g_SceneMan.GetSceneWidth() + SCENE_LINE_WIDTH - 1) / SCENE_LINE_WIDTH) * g_SceneMan.GetSceneHeight();
+				if (msg->LineHashCount <= hashesReceived && msg->LineHashCount == sceneLines)
+				{
+					const unsigned int * pHashes = (const unsigned int *)(p->data + sizeof(RTE::MsgSceneSetupAccepted));
+					m_ClientSceneHashes[player].assign(pHashes, pHashes + msg->LineHashCount);
+				}
+			}
+			m_Mutex[player].unlock();
+
 			m_SendSceneSetupData[player] = false;
 			m_SendSceneData[player] = true;
 			m_SendFrameData[player] = false;
@@ -848,6 +950,23 @@ namespace RTE
 					m_Mutex[p].unlock();
 				}
 			}
+
+			// Mark the snapshot lines under the change so they get recompressed before being sent to anyone again
+			m_SceneSnapshotStaleMutex.lock();
+			if (!m_SceneSnapshotStale.empty())
+			{
+				int firstStrip = MAX(tc.x, 0) / SCENE_LINE_WIDTH;
+				int lastStrip = MIN((tc.x + MAX(tc.w, 1) - 1) / SCENE_LINE_WIDTH, m_SceneSnapshotStrips - 1);
+				int firstLine = MAX(tc.y, 0);
+				int lastLine = MIN(tc.y + MAX(tc.h, 1) - 1, m_SceneSnapshotHeight - 1);
+				int layer = tc.back ? 0 : 1;
+				for (int strip = firstStrip; strip <= lastStrip; ++strip)
+				{
+					for (int line = firstLine; line <= lastLine; ++line)
+						m_SceneSnapshotStale[(layer * m_SceneSnapshotStrips + strip) * m_SceneSnapshotHeight + line] = true;
+				}
+			}
+			m_SceneSnapshotStaleMutex.unlock();
 		}
 	}
 
@@ -1015,6 +1134,87 @@ namespace RTE
 	}
 
 
+	void NetworkServer::UpdateSceneSnapshot(SLTerrain * pTerrain, int player)
+	{
+		int sceneWidth = g_SceneMan.GetSceneWidth();
+		int sceneHeight = g_SceneMan.GetSceneHeight();
+		int strips = (sceneWidth + SCENE_LINE_WIDTH - 1) / SCENE_LINE_WIDTH;
+
+		// Start over if this is a different scene than the one in the snapshot
+		bool rebuild = m_SceneSnapshotId != m_SceneId || m_SceneSnapshotStrips != strips || m_SceneSnapshotHeight != sceneHeight;
+		if (rebuild)
+		{
+			m_SceneSnapshot.clear();
+			m_SceneSnapshot.resize(2 * strips * sceneHeight);
+			m_SceneSnapshotId = m_SceneId;
+
+			// The dimensions are used to mark stale lines as well
+			m_SceneSnapshotStaleMutex.lock();
+			m_SceneSnapshotStrips = strips;
+			m_SceneSnapshotHeight = sceneHeight;
+			m_SceneSnapshotStale.assign(m_SceneSnapshot.size(), false);
+			m_SceneSnapshotStaleMutex.unlock();
+		}
+
+		unsigned int snapshotHash = 2166136261U;
+		int index = 0;
+
+		for (int layer = 0; layer < 2; layer++)
+		{
+			BITMAP * bmp = layer == 0 ? pTerrain->GetBGColorBitmap() : pTerrain->GetFGColorBitmap();
+
+			lock_bitmap(bmp);
+
+			for (int strip = 0; strip < strips; strip++)
+			{
+				int linex = strip * SCENE_LINE_WIDTH;
+				int width = MIN((int)SCENE_LINE_WIDTH, sceneWidth - linex);
+
+				for (int liney = 0; liney < sceneHeight; liney++, index++)
+				{
+					SceneSnapshotLine &line = m_SceneSnapshot[index];
+
+					bool stale = rebuild;
+					if (!stale)
+					{
+						m_SceneSnapshotStaleMutex.lock();
+						stale = m_SceneSnapshotStale[index];
+						m_SceneSnapshotStale[index] = false;
+						m_SceneSnapshotStaleMutex.unlock();
+					}
+
+					if (stale)
+					{
+						const char * pPixels = (const char *)bmp->line[liney] + linex;
+
+						// FNV-1a of the raw pixels, so identical lines can be recognized without sending them
+						line.Hash = 2166136261U;
+						for (int x = 0; x < width; x++)
+							line.Hash = (line.Hash ^ (unsigned char)pPixels[x]) * 16777619U;
+						// 0 is reserved for lines the client doesn't have
+						if (line.Hash == 0)
+							line.Hash = 1;
+
+						int result = LZ4_compress_HC_extStateHC(m_pLZ4CompressionState[player], pPixels, (char *)(m_aPixelLineBuffer[player] + sizeof(RTE::MsgSceneLine)), width, width, LZ4HC_CLEVEL_MAX);
+
+						// Compression failed or ineffective, keep as is
+						if (result == 0 || result == width)
+							line.Data.assign(pPixels, pPixels + width);
+						else
+							line.Data.assign((char *)(m_aPixelLineBuffer[player] + sizeof(RTE::MsgSceneLine)), (char *)(m_aPixelLineBuffer[player] + sizeof(RTE::MsgSceneLine)) + result);
+						line.UncompressedSize = width;
+					}
+
+					snapshotHash = (snapshotHash ^ line.Hash) * 16777619U;
+				}
+			}
+
+			release_bitmap(bmp);
+		}
+
+		m_SceneSnapshotHash = snapshotHash;
+	}
+
 	void NetworkServer::SendSceneData(int player)
 	{
 		// Check for congestion
@@ -1025,10 +1225,6 @@ namespace RTE
 		// Save msg ID
 		sceneData->Id = ID_SRV_SCENE;
 
-		int linex = 0;
-		int liney = 0;
-		int lineWidth = 1280;
-
 		Scene * pScene = g_SceneMan.GetScene();
 		SLTerrain * pTerrain = 0;
 		if (pScene)
@@ -1040,46 +1236,52 @@ namespace RTE
 		else
 			return;
 
-		// Lock the scene until current bitmap is fully transfered
+		// Bring the shared snapshot up to date and take a copy of it to stream from, so neither the scene
+		// nor the other players' send threads have to wait for this player's transfer to finish
+		std::vector<SceneSnapshotLine> snapshot;
+		int strips = 0;
+		int sceneHeight = 0;
+		unsigned char sceneId = 0;
+
 		m_SceneLock[player].lock();
+		m_SceneSnapshotMutex.lock();
+		UpdateSceneSnapshot(pTerrain, player);
+		snapshot = m_SceneSnapshot;
+		strips = m_SceneSnapshotStrips;
+		sceneHeight = m_SceneSnapshotHeight;
+		sceneId = m_SceneSnapshotId;
+		m_SceneSnapshotMutex.unlock();
+		m_SceneLock[player].unlock();
 
-		for (int layer = 0; layer < 2; layer++)
-		{
-			BITMAP * bmp = 0;
-			if (layer == 0)
-				bmp = pTerrain->GetBGColorBitmap();
-			else if (layer == 1)
-				bmp = pTerrain->GetFGColorBitmap();
+		// Only the lines the client doesn't already have cached need to be sent
+		std::vector<unsigned int> clientHashes;
+		m_Mutex[player].lock();
+		if (m_ClientSceneHashes[player].size() == snapshot.size())
+			clientHashes.swap(m_ClientSceneHashes[player]);
+		m_Mutex[player].unlock();
 
-			lock_bitmap(bmp);
+		int index = 0;
 
-			for (int linex = 0; ; linex += lineWidth)
+		for (int layer = 0; layer < 2 && IsPlayerConnected(player); layer++)
+		{
+			for (int strip = 0; strip < strips && IsPlayerConnected(player); strip++)
 			{
-				int width = lineWidth;
-				if (linex + width >= g_SceneMan.GetSceneWidth())
-					width = g_SceneMan.GetSceneWidth() - linex;
-
-				for (liney = 0; liney < g_SceneMan.GetSceneHeight(); liney++)
+				for (int liney = 0; liney < sceneHeight; liney++, index++)
 				{
+					const SceneSnapshotLine &line = snapshot[index];
+					if (!clientHashes.empty() && clientHashes[index] == line.Hash)
+						continue;
+
 					// Save scene fragment data
-					sceneData->DataSize = width;
-					sceneData->UncompressedSize = width;
+					sceneData->DataSize = line.Data.size();
+					sceneData->UncompressedSize = line.UncompressedSize;
 					sceneData->Layer = layer;
-					sceneData->X = linex;
+					sceneData->X = strip * SCENE_LINE_WIDTH;
 					sceneData->Y = liney;
-					sceneData->SceneId = m_SceneId;
-
-					// Compression section
-					int result = 0;
-					bool lineIsEmpty = false;
-
-					result = LZ4_compress_HC_extStateHC(m_pLZ4CompressionState[player], (char *)bmp->line[liney] + linex, (char *)(m_aPixelLineBuffer[player] + sizeof(RTE::MsgSceneLine)), width, width, LZ4HC_CLEVEL_MAX);
+					sceneData->SceneId = sceneId;
+					sceneData->Hash = line.Hash;
 
-					// Compression failed or ineffective, send as is
-					if (result == 0 || result == width)
-						memcpy_s(m_aPixelLineBuffer[player] + sizeof(RTE::MsgSceneLine), MAX_PIXEL_LINE_BUFFER_SIZE, bmp->line[liney] + linex, width);
-					else
-						sceneData->DataSize = result;
+					memcpy_s(m_aPixelLineBuffer[player] + sizeof(RTE::MsgSceneLine), MAX_PIXEL_LINE_BUFFER_SIZE - sizeof(RTE::MsgSceneLine), &line.Data[0], line.Data.size());
 
 					int payloadSize = sceneData->DataSize + sizeof(RTE::MsgSceneLine);
 
@@ -1111,16 +1313,9 @@ namespace RTE
 							break;
 					}
 				} // next liney
-
-				if (linex + lineWidth >= g_SceneMan.GetSceneWidth())
-					break;
-			}// next linex
-
-			release_bitmap(bmp);
+			}// next strip
 		}// next layer
 
-		m_SceneLock[player].unlock();
-
 		m_SendSceneSetupData[player] = false;
 		m_SendSceneData[player] = false;
 		m_SendFrameData[player] = false;
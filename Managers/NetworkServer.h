@@ -22,6 +22,7 @@
 
 #include "boost\thread.hpp"
 #include <mutex>
+#include <vector>
 
 #include "TimerMan.h"
 
@@ -141,6 +142,19 @@ namespace RTE
 
 		void Update(bool processInput = false);
 
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Method:          KeepAlive
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Description:     Stands in for Update while the main thread is busy with something
+		//                  long, like loading a scene. Takes in the packets the clients sent so
+		//                  they don't pile up, but holds them for the next Update instead of
+		//                  acting on them, since that can register clients and set up their
+		//                  buffers and threads.
+		// Arguments:       None.
+		// Return value:    None.
+
+		void KeepAlive();
+
 		void EnableServerMode() { m_IsInServerMode = true; }
 
 		bool IsServerModeEnabled() { return m_IsInServerMode; }
@@ -231,6 +245,16 @@ namespace RTE
 
 		unsigned int GetPing(int player) const { return m_Ping[player]; }
 
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Method:          GetSceneSnapshotHash
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Description:     Gets the combined hash of all the lines of the shared scene snapshot,
+		//                  as of the last time it was brought up to date.
+		// Arguments:       None.
+		// Return value:    The snapshot hash. 0 if there's no snapshot yet.
+
+		unsigned int GetSceneSnapshotHash() { std::lock_guard<std::mutex> guard(m_SceneSnapshotMutex); return m_SceneSnapshotHash; }
+
 		//////////////////////////////////////////////////////////////////////////////////////////
 		// Protected member variable and method declarations
 
@@ -250,6 +274,30 @@ namespace RTE
 
 		ClientConnection m_ClientConnections[MAX_CLIENTS];
 
+		// One line of one strip of one terrain layer in the shared scene snapshot
+		struct SceneSnapshotLine
+		{
+			// The line's pixels, LZ4HC compressed unless that didn't help
+			std::vector<char> Data;
+			// How many pixels the line holds
+			unsigned short int UncompressedSize;
+			// Hash of the uncompressed pixels
+			unsigned int Hash;
+		};
+
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Method:          UpdateSceneSnapshot
+		//////////////////////////////////////////////////////////////////////////////////////////
+		// Description:     Brings the shared scene snapshot up to date with the terrain, only
+		//                  compressing the lines that changed since the last time. Has to be
+		//                  called with the snapshot mutex and the player's scene lock held.
+		// Arguments:       The terrain to take the snapshot of.
+		//                  The player whose send thread is doing it, whose compression state
+		//                  is used.
+		// Return value:    None.
+
+		void UpdateSceneSnapshot(SLTerrain *pTerrain, int player);
+
 		// Member variables
 		static const std::string m_ClassName;
 
@@ -370,11 +418,33 @@ namespace RTE
 		//std::mutex m_InputQueueMutex[MAX_CLIENTS];
 		std::queue<NetworkClient::MsgInput>m_InputMessages[MAX_CLIENTS];
 
+		// Packets taken in by KeepAlive, to be handled by the next Update
+		std::queue<RakNet::Packet *> m_HeldPackets;
+
 		float OffsetX[MAX_CLIENTS][MAX_BACKGROUND_LAYERS_TRANSMITTED];
 		float OffsetY[MAX_CLIENTS][MAX_BACKGROUND_LAYERS_TRANSMITTED];
 
 		unsigned char m_SceneId;
 
+		// The compressed terrain layers shared by all the players' send threads, so each line only
+		// gets compressed once per change no matter how many players join. Indexed by layer, strip, then line
+		std::vector<SceneSnapshotLine> m_SceneSnapshot;
+		// Which scene the snapshot was taken of, -1 if none
+		int m_SceneSnapshotId;
+		// The dimensions of the snapshot, in strips and lines
+		int m_SceneSnapshotStrips;
+		int m_SceneSnapshotHeight;
+		// Combined hash of all the snapshot lines
+		unsigned int m_SceneSnapshotHash;
+		// The hashes of the scene lines each player said it already has cached, ordered like the snapshot
+		std::vector<unsigned int> m_ClientSceneHashes[MAX_CLIENTS];
+		// Guards the snapshot lines while they are being updated or copied out
+		std::mutex m_SceneSnapshotMutex;
+		// Which snapshot lines had the terrain change under them since they were compressed, parallel to the lines
+		std::vector<bool> m_SceneSnapshotStale;
+		// Guards the stale flags, which get set from the simulation thread
+		std::mutex m_SceneSnapshotStaleMutex;
+
 		bool m_ResetActivityVotes[MAX_CLIENTS];
 
 		int m_FrameNumbers[MAX_CLIENTS];
@@ -392,6 +462,8 @@ namespace RTE
 		int m_BoxHeight;
 
 		bool m_NatServerConnected;
+		// When the registration with the NAT service was last refreshed
+		Timer m_NatRegistrationTimer;
 
 		RakNet::SystemAddress m_NATServiceServerID;
 
@@ -413,6 +485,8 @@ namespace RTE
 		NetworkServer & operator=(const NetworkServer &rhs);
 
 		unsigned char GetPacketIdentifier(RakNet::Packet *p);
+
+		void HandlePacket(RakNet::Packet *p);
 	};
 
 } // namespace RTE
@@ -0,0 +1,564 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// File:            PerformanceMan.cpp
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Source file for the PerformanceMan class.
+// Project:         Retro Terrain Engine
+// Author(s):
+//
+//
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Inclusions of header files
+
+#include "PerformanceMan.h"
+#include "TimerMan.h"
+#include "ConsoleMan.h"
+#include "System.h"
+
+#include <fstream>
+#include <cmath>
+#include <cstdio>
+
+using namespace std;
+
+namespace RTE
+{
+
+const string PerformanceMan::m_ClassName = "PerformanceMan";
+
+// The calling thread's measurements, owned by the PerformanceMan, and which set of them they were taken from.
+// Handed back to the PerformanceMan for reuse when the thread ends
+struct ThreadCountersSlot
+{
+    void *m_pCounters;
+    unsigned int m_Generation;
+    ~ThreadCountersSlot();
+};
+static thread_local ThreadCountersSlot s_ThreadCounters = { 0, 0 };
+// Bumped each time the PerformanceMan deletes all the measurements, so every thread knows to drop what it points to
+static atomic<unsigned int> s_ThreadCountersGeneration(0);
+
+// Only go through the PerformanceMan if it hasn't been destroyed since, it may well be gone by the time a thread ends
+ThreadCountersSlot::~ThreadCountersSlot()
+{
+    if (m_pCounters && m_Generation == s_ThreadCountersGeneration)
+        g_PerformanceMan.ReleaseThreadCounters();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Histogram helpers: values below 8 us get a bucket each, above that every doubling of
+// the value is split into 4 buckets
+
+static int HistogramBucket(int64_t value)
+{
+    if (value < 8)
+        return value < 0 ? 0 : (int)value;
+
+    int octave = 3;
+    while ((value >> (octave + 1)) > 0)
+        ++octave;
+
+    int bucket = 8 + (octave - 3) * 4 + (int)((value >> (octave - 2)) & 3);
+    return bucket < PerformanceMan::HISTOGRAMBUCKETS ? bucket : PerformanceMan::HISTOGRAMBUCKETS - 1;
+}
+
+static int64_t HistogramBucketValue(int bucket)
+{
+    if (bucket < 8)
+        return bucket;
+
+    int octave = 3 + (bucket - 8) / 4;
+    int64_t low = (int64_t)(4 + (bucket - 8) % 4) << (octave - 2);
+    int64_t width = (int64_t)1 << (octave - 2);
+    // Report the middle of the bucket
+    return low + width / 2;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Clear
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Clears all the member variables of this PerformanceMan, effectively
+//                  resetting the members of this abstraction level only.
+
+void PerformanceMan::Clear()
+{
+    m_CounterCount = 0;
+    m_Sample = 0;
+    m_StatSampleCount = 0;
+
+    for (int c = 0; c < MAXCOUNTERS; ++c)
+    {
+        m_Counters[c].m_Name.clear();
+        m_Counters[c].m_Parent = -1;
+        m_Counters[c].m_Depth = 0;
+        for (int i = 0; i < MAXSAMPLES; ++i)
+            m_Counters[c].m_Samples[i] = 0;
+    }
+    ResetStatistics();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Create
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes the PerformanceMan object ready for use.
+
+int PerformanceMan::Create()
+{
+    // Register the built-in counters in the order of the enum so that the IDs match
+    RegisterCounter("Total");
+    RegisterCounter("Act Travel", PERF_SIM_TOTAL);
+    RegisterCounter("Act Update", PERF_SIM_TOTAL);
+    RegisterCounter("Act AI", PERF_ACTORS_PASS2);
+    RegisterCounter("Prt Travel", PERF_SIM_TOTAL);
+    RegisterCounter("Prt Update", PERF_SIM_TOTAL);
+    RegisterCounter("Activity", PERF_SIM_TOTAL);
+    RegisterCounter("Scripts", PERF_SIM_TOTAL);
+    RegisterCounter("Settle", PERF_SIM_TOTAL);
+    RegisterCounter("MOID Draw", PERF_SIM_TOTAL);
+    RegisterCounter("AtomGroup Travel", PERF_SIM_TOTAL);
+    RegisterCounter("PathFinder Solve");
+    RegisterCounter("PathFinder Hierarchical");
+#if __USE_SOUND_GORILLA
+    RegisterCounter("Sound");
+#endif
+
+    return 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Destroy
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys and resets (through Clear()) the PerformanceMan object.
+
+void PerformanceMan::Destroy()
+{
+    {
+        lock_guard<mutex> guard(m_ThreadCountersMutex);
+        s_ThreadCountersGeneration++;
+        for (list<ThreadCounters *>::iterator itr = m_ThreadCounters.begin(); itr != m_ThreadCounters.end(); ++itr)
+            delete *itr;
+        m_ThreadCounters.clear();
+    }
+    s_ThreadCounters.m_pCounters = 0;
+
+    Clear();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ReleaseThreadCounters
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Hands the calling thread's measurements back for the next thread to
+//                  measure anything to reuse.
+
+void PerformanceMan::ReleaseThreadCounters()
+{
+    lock_guard<mutex> guard(m_ThreadCountersMutex);
+    // Measurements taken from a set that has been deleted since are gone already
+    if (s_ThreadCounters.m_pCounters && s_ThreadCounters.m_Generation == s_ThreadCountersGeneration)
+    {
+        // Whatever was accumulated stays, to be collected with the next sample
+        ThreadCounters *pCounters = static_cast<ThreadCounters *>(s_ThreadCounters.m_pCounters);
+        for (int c = 0; c < MAXCOUNTERS; ++c)
+            pCounters->m_Depth[c] = 0;
+        pCounters->m_InUse = false;
+    }
+    s_ThreadCounters.m_pCounters = 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RegisterCounter
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Registers a new performance counter.
+
+int PerformanceMan::RegisterCounter(string name, int parent)
+{
+    lock_guard<mutex> guard(m_RegistrationMutex);
+
+    for (int c = 0; c < m_CounterCount; ++c)
+    {
+        if (m_Counters[c].m_Name == name)
+            return c;
+    }
+
+    if (m_CounterCount >= MAXCOUNTERS)
+    {
+        g_ConsoleMan.PrintString("ERROR: Too many performance counters registered, can't add " + name + "!");
+        return -1;
+    }
+
+    int counter = m_CounterCount;
+    m_Counters[counter].m_Name = name;
+    m_Counters[counter].m_Parent = parent >= 0 && parent < counter ? parent : -1;
+    m_Counters[counter].m_Depth = m_Counters[counter].m_Parent >= 0 ? m_Counters[m_Counters[counter].m_Parent].m_Depth + 1 : 0;
+    // Only make it visible to the other threads once it's all set up
+    m_CounterCount = counter + 1;
+
+    return counter;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetCounterID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the ID of a registered counter by its name.
+
+int PerformanceMan::GetCounterID(string name) const
+{
+    lock_guard<mutex> guard(m_RegistrationMutex);
+
+    for (int c = 0; c < m_CounterCount; ++c)
+    {
+        if (m_Counters[c].m_Name == name)
+            return c;
+    }
+    return -1;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetThreadCounters
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the measurements of the calling thread.
+
+PerformanceMan::ThreadCounters * PerformanceMan::GetThreadCounters()
+{
+    if (!s_ThreadCounters.m_pCounters || s_ThreadCounters.m_Generation != s_ThreadCountersGeneration)
+    {
+        lock_guard<mutex> guard(m_ThreadCountersMutex);
+
+        // Reuse the measurements of a thread that has ended if there are any, so threads coming and going don't pile them up
+        ThreadCounters *pCounters = 0;
+        for (list<ThreadCounters *>::iterator itr = m_ThreadCounters.begin(); !pCounters && itr != m_ThreadCounters.end(); ++itr)
+        {
+            if (!(*itr)->m_InUse)
+                pCounters = *itr;
+        }
+        if (!pCounters)
+        {
+            pCounters = new ThreadCounters;
+            for (int c = 0; c < MAXCOUNTERS; ++c)
+            {
+                pCounters->m_Accumulated[c] = 0;
+                pCounters->m_MeasureStart[c] = 0;
+                pCounters->m_Depth[c] = 0;
+            }
+            m_ThreadCounters.push_back(pCounters);
+        }
+        pCounters->m_InUse = true;
+
+        s_ThreadCounters.m_pCounters = pCounters;
+        s_ThreadCounters.m_Generation = s_ThreadCountersGeneration;
+    }
+    return static_cast<ThreadCounters *>(s_ThreadCounters.m_pCounters);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StartPerformanceMeasurement
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Saves current absolute time in microseconds as a start of performance
+//                  measurement on the calling thread.
+
+void PerformanceMan::StartPerformanceMeasurement(int counter)
+{
+    if (counter < 0 || counter >= m_CounterCount)
+        return;
+
+    ThreadCounters *pThread = GetThreadCounters();
+    if (pThread->m_Depth[counter]++ == 0)
+        pThread->m_MeasureStart[counter] = g_TimerMan.GetAbsoulteTime();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StopPerformanceMeasurement
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Adds the time passed since the matching start to the calling thread's
+//                  accumulation for this counter.
+
+void PerformanceMan::StopPerformanceMeasurement(int counter)
+{
+    if (counter < 0 || counter >= m_CounterCount)
+        return;
+
+    ThreadCounters *pThread = GetThreadCounters();
+    if (pThread->m_Depth[counter] > 0 && --pThread->m_Depth[counter] == 0)
+        pThread->m_Accumulated[counter].fetch_add(g_TimerMan.GetAbsoulteTime() - pThread->m_MeasureStart[counter], memory_order_relaxed);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AddPerformanceSample
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Adds provided value to the calling thread's accumulation of a counter.
+
+void PerformanceMan::AddPerformanceSample(int counter, int64_t value)
+{
+    if (counter < 0 || counter >= m_CounterCount)
+        return;
+
+    GetThreadCounters()->m_Accumulated[counter].fetch_add(value, memory_order_relaxed);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          NewPerformanceSample
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Closes the current sample by gathering what all threads have measured
+//                  since the last call, and starts a new sample.
+
+void PerformanceMan::NewPerformanceSample()
+{
+    m_Sample++;
+    if (m_Sample >= MAXSAMPLES)
+        m_Sample = 0;
+
+    int counterCount = m_CounterCount;
+    for (int c = 0; c < counterCount; ++c)
+        m_Counters[c].m_Samples[m_Sample] = 0;
+
+    {
+        lock_guard<mutex> guard(m_ThreadCountersMutex);
+        for (list<ThreadCounters *>::iterator itr = m_ThreadCounters.begin(); itr != m_ThreadCounters.end(); ++itr)
+        {
+            for (int c = 0; c < counterCount; ++c)
+                m_Counters[c].m_Samples[m_Sample] += (*itr)->m_Accumulated[c].exchange(0, memory_order_relaxed);
+        }
+    }
+
+    for (int c = 0; c < counterCount; ++c)
+    {
+        Counter &counter = m_Counters[c];
+        int64_t value = counter.m_Samples[m_Sample];
+
+        counter.m_Total += value;
+        if (m_StatSampleCount == 0 || value < counter.m_Min)
+            counter.m_Min = value;
+        if (value > counter.m_Max)
+            counter.m_Max = value;
+        counter.m_Histogram[HistogramBucket(value)]++;
+    }
+    m_StatSampleCount++;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetCounterName
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the display name of a counter.
+
+const string & PerformanceMan::GetCounterName(int counter) const
+{
+    static const string noName;
+    if (counter < 0 || counter >= m_CounterCount)
+        return noName;
+
+    return m_Counters[counter].m_Name;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPerformanceSample
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a closed sample of a counter.
+
+int64_t PerformanceMan::GetPerformanceSample(int counter, int samplesBack) const
+{
+    if (counter < 0 || counter >= m_CounterCount || samplesBack < 0)
+        return 0;
+
+    int sample = m_Sample - (samplesBack % MAXSAMPLES);
+    if (sample < 0)
+        sample += MAXSAMPLES;
+
+    return m_Counters[counter].m_Samples[sample];
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPerformanceCounterAverage
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Returns an average value of AVERAGE last samples for specified counter.
+
+int64_t PerformanceMan::GetPerformanceCounterAverage(int counter) const
+{
+    int64_t accum = 0;
+    for (int i = 0; i < AVERAGE; ++i)
+        accum += GetPerformanceSample(counter, i);
+
+    return accum / AVERAGE;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPerformanceCounterPercentile
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Estimates a percentile of the samples of a counter.
+
+int64_t PerformanceMan::GetPerformanceCounterPercentile(int counter, float percentile) const
+{
+    if (m_StatSampleCount <= 0)
+        return 0;
+
+    // The rank of the sample we're looking for, 1-based
+    long rank = (long)ceil((double)percentile / 100.0 * (double)m_StatSampleCount);
+    if (rank < 1)
+        rank = 1;
+
+    long seen = 0;
+    for (int b = 0; b < HISTOGRAMBUCKETS; ++b)
+    {
+        seen += m_Counters[counter].m_Histogram[b];
+        if (seen >= rank)
+        {
+            // Never report anything outside of what was actually measured
+            int64_t value = HistogramBucketValue(b);
+            if (value > m_Counters[counter].m_Max)
+                value = m_Counters[counter].m_Max;
+            if (value < m_Counters[counter].m_Min)
+                value = m_Counters[counter].m_Min;
+            return value;
+        }
+    }
+    return m_Counters[counter].m_Max;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ResetStatistics
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Clears the totals, min/max and histograms of all counters.
+
+void PerformanceMan::ResetStatistics()
+{
+    for (int c = 0; c < MAXCOUNTERS; ++c)
+    {
+        m_Counters[c].m_Total = 0;
+        m_Counters[c].m_Min = 0;
+        m_Counters[c].m_Max = 0;
+        for (int b = 0; b < HISTOGRAMBUCKETS; ++b)
+            m_Counters[c].m_Histogram[b] = 0;
+    }
+    m_StatSampleCount = 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WriteCSV
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Writes the statistics of all counters to a stream as CSV.
+
+void PerformanceMan::WriteCSV(ostream &stream) const
+{
+    stream << "Counter,Parent,Samples,TotalMS,AverageMS,MinMS,MaxMS,P50MS,P99MS\n";
+
+    for (int c = 0; c < m_CounterCount; ++c)
+    {
+        const Counter &counter = m_Counters[c];
+        stream << "\"" << counter.m_Name << "\",\"" << (counter.m_Parent >= 0 ? m_Counters[counter.m_Parent].m_Name : "") << "\",";
+        stream << m_StatSampleCount << ",";
+        stream << (double)counter.m_Total / 1000.0 << ",";
+        stream << (m_StatSampleCount > 0 ? (double)counter.m_Total / 1000.0 / (double)m_StatSampleCount : 0.0) << ",";
+        stream << (double)GetPerformanceCounterMin(c) / 1000.0 << ",";
+        stream << (double)counter.m_Max / 1000.0 << ",";
+        stream << (double)GetPerformanceCounterPercentile(c, 50) / 1000.0 << ",";
+        stream << (double)GetPerformanceCounterPercentile(c, 99) / 1000.0 << "\n";
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Escapes a counter name so it can be written as a JSON string.
+
+static string EscapeJSON(const string &text)
+{
+    string escaped;
+    escaped.reserve(text.size());
+    for (string::const_iterator itr = text.begin(); itr != text.end(); ++itr)
+    {
+        unsigned char c = *itr;
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (c < 0x20)
+        {
+            char code[8];
+            sprintf(code, "\\u%04x", c);
+            escaped += code;
+        }
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WriteJSON
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Writes the statistics of all counters to a stream as a JSON array.
+
+void PerformanceMan::WriteJSON(ostream &stream) const
+{
+    stream << "[\n";
+
+    for (int c = 0; c < m_CounterCount; ++c)
+    {
+        const Counter &counter = m_Counters[c];
+        stream << "\t{ \"counter\": \"" << EscapeJSON(counter.m_Name) << "\", ";
+        stream << "\"parent\": " << (counter.m_Parent >= 0 ? "\"" + EscapeJSON(m_Counters[counter.m_Parent].m_Name) + "\"" : string("null")) << ", ";
+        stream << "\"samples\": " << m_StatSampleCount << ", ";
+        stream << "\"totalMS\": " << (double)counter.m_Total / 1000.0 << ", ";
+        stream << "\"averageMS\": " << (m_StatSampleCount > 0 ? (double)counter.m_Total / 1000.0 / (double)m_StatSampleCount : 0.0) << ", ";
+        stream << "\"minMS\": " << (double)GetPerformanceCounterMin(c) / 1000.0 << ", ";
+        stream << "\"maxMS\": " << (double)counter.m_Max / 1000.0 << ", ";
+        stream << "\"p50MS\": " << (double)GetPerformanceCounterPercentile(c, 50) / 1000.0 << ", ";
+        stream << "\"p99MS\": " << (double)GetPerformanceCounterPercentile(c, 99) / 1000.0 << " }";
+        stream << (c < m_CounterCount - 1 ? ",\n" : "\n");
+    }
+
+    stream << "]\n";
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DumpCounters
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Writes the statistics of all counters to a file.
+
+int PerformanceMan::DumpCounters(string filePath) const
+{
+    // Same rules as scripted file access: no back-traversing and only inside .rte folders
+    string fullPath = g_System.GetWorkingDirectory() + "/" + filePath;
+    if (fullPath.find("..") != string::npos || fullPath.find(".rte") == string::npos)
+    {
+        g_ConsoleMan.PrintString("ERROR: Performance counters can only be dumped to files inside an .rte folder!");
+        return -1;
+    }
+
+    ofstream stream(fullPath.c_str());
+    if (!stream.good())
+    {
+        g_ConsoleMan.PrintString("ERROR: Couldn't open " + filePath + " to dump performance counters to!");
+        return -1;
+    }
+
+    if (filePath.size() >= 5 && filePath.substr(filePath.size() - 5) == ".json")
+        WriteJSON(stream);
+    else
+        WriteCSV(stream);
+
+    g_ConsoleMan.PrintString("Performance counters dumped to " + filePath);
+    return 0;
+}
+
+} // namespace RTE
@@ -0,0 +1,459 @@
+#ifndef _RTEPERFORMANCEMAN_
+#define _RTEPERFORMANCEMAN_
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// File:            PerformanceMan.h
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Header file for the PerformanceMan class.
+// Project:         Retro Terrain Engine
+// Author(s):
+//
+//
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Inclusions of header files
+
+#include <string>
+#include <list>
+#include <ostream>
+#include <atomic>
+#include <mutex>
+
+#include "Singleton.h"
+#define g_PerformanceMan PerformanceMan::Instance()
+
+namespace RTE
+{
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Class:           PerformanceMan
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     The centralized singleton registry of all performance counters. Any
+//                  manager, entity or Lua script can register a counter here and time
+//                  itself with it, from any thread.
+// Parent(s):       Singleton
+// Class history:   10/19/2026  PerformanceMan created from FrameMan's performance counters.
+
+class PerformanceMan:
+    public Singleton<PerformanceMan>
+{
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Public member variable, method and friend function declarations
+
+public:
+
+	// The built-in counters, always registered in this order so their IDs match these values
+	enum PerformanceCounters
+	{
+		PERF_SIM_TOTAL = 0,
+		PERF_ACTORS_PASS1,
+		PERF_ACTORS_PASS2,
+		PERF_ACTORS_AI,
+		PERF_PARTICLES_PASS1,
+		PERF_PARTICLES_PASS2,
+		PERF_ACTIVITY,
+		PERF_SCRIPTS,
+		PERF_SETTLE,
+		PERF_MOIDS,
+		PERF_ATOMGROUP_TRAVEL,
+		PERF_PATHFINDER_SOLVE,
+		PERF_PATHFINDER_HIERARCHICAL,
+#if __USE_SOUND_GORILLA
+		PERF_SOUND,
+#endif
+		PERF_COUNT
+	};
+
+	// Maximum number of counters that can be registered
+	const static int MAXCOUNTERS = 128;
+	// How many performance samples to store, directly affects graph size
+	const static int MAXSAMPLES = 120;
+	// How many samples to use to calculate average value displayed on screen
+	const static int AVERAGE = 10;
+	// Number of buckets in each counter's histogram; 4 buckets per doubling of the measured time
+	const static int HISTOGRAMBUCKETS = 160;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Constructor:     PerformanceMan
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Constructor method used to instantiate a PerformanceMan object in system
+//                  memory. Create() should be called before using the object.
+// Arguments:       None.
+
+    PerformanceMan() { Clear(); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Destructor:      ~PerformanceMan
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destructor method used to clean up a PerformanceMan object before deletion
+//                  from system memory.
+// Arguments:       None.
+
+    virtual ~PerformanceMan() { Destroy(); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Create
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes the PerformanceMan object ready for use, registering all the
+//                  built-in counters.
+// Arguments:       None.
+// Return value:    An error return value signaling sucess or any particular failure.
+//                  Anything below 0 is an error signal.
+
+    virtual int Create();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Destroy
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys and resets (through Clear()) the PerformanceMan object.
+// Arguments:       None.
+// Return value:    None.
+
+    void Destroy();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ReleaseThreadCounters
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Hands the calling thread's measurements back, so the next thread to
+//                  measure anything reuses them instead of making new ones. Called by
+//                  itself when a thread that has measured anything ends.
+// Arguments:       None.
+// Return value:    None.
+
+    void ReleaseThreadCounters();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  GetClassName
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the class name of this Entity.
+// Arguments:       None.
+// Return value:    A string with the friendly-formatted type name of this object.
+
+    virtual const std::string & GetClassName() const { return m_ClassName; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RegisterCounter
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Registers a new performance counter. If one with the same name already
+//                  exists, that one is returned instead, so it's safe to call repeatedly.
+// Arguments:       The display name of the counter.
+//                  The ID of the counter this one is nested under, or -1 for a root one.
+// Return value:    The ID of the counter, or -1 if no more counters can be registered.
+
+    int RegisterCounter(std::string name, int parent = -1);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetCounterID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the ID of a registered counter by its name.
+// Arguments:       The name of the counter.
+// Return value:    The ID of the counter, or -1 if there's none with that name.
+
+    int GetCounterID(std::string name) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetCounterCount
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the number of registered counters.
+// Arguments:       None.
+// Return value:    The number of counters. Valid IDs are from 0 up to this.
+
+    int GetCounterCount() const { return m_CounterCount; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetCounterName
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the display name of a counter.
+// Arguments:       The ID of the counter.
+// Return value:    The name of the counter, or an empty string if the ID is invalid.
+
+    const std::string & GetCounterName(int counter) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetCounterParent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the ID of the counter a counter is nested under.
+// Arguments:       The ID of the counter.
+// Return value:    The ID of the parent counter, or -1 if this is a root counter.
+
+    int GetCounterParent(int counter) const { return m_Counters[counter].m_Parent; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetCounterDepth
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how deeply nested a counter is.
+// Arguments:       The ID of the counter.
+// Return value:    0 for root counters, 1 for their children, and so on.
+
+    int GetCounterDepth(int counter) const { return m_Counters[counter].m_Depth; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StartPerformanceMeasurement
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Saves current absolute time in microseconds as a start of performance
+//                  measurement on the calling thread. Recursive starts of the same counter
+//                  are only measured once, by the outermost start/stop pair.
+// Arguments:       Counter to start measurement for.
+// Return value:    None.
+
+    void StartPerformanceMeasurement(int counter);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StopPerformanceMeasurement
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Adds the time passed since the matching start to the calling thread's
+//                  accumulation for this counter.
+// Arguments:       Counter to stop and update measurement for.
+// Return value:    None.
+
+    void StopPerformanceMeasurement(int counter);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AddPerformanceSample
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Adds provided value to the calling thread's accumulation of a counter.
+// Arguments:       Counter to update, value in microseconds to add to this counter.
+// Return value:    None.
+
+    void AddPerformanceSample(int counter, int64_t value);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          NewPerformanceSample
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Closes the current sample by gathering what all threads have measured
+//                  since the last call, updates the statistics with it and starts a new
+//                  sample. Should be called once per sim update, on the main thread.
+// Arguments:       None.
+// Return value:    None.
+
+    void NewPerformanceSample();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPerformanceSample
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a closed sample of a counter.
+// Arguments:       Counter to get the sample of.
+//                  How many samples back to go, 0 being the last closed one.
+// Return value:    The time measured in that sample, in microseconds.
+
+    int64_t GetPerformanceSample(int counter, int samplesBack = 0) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPerformanceCounterAverage
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Returns an average value of AVERAGE last samples for specified counter.
+// Arguments:       Counter to get the average of.
+// Return value:    An average value for specified counter, in microseconds.
+
+    int64_t GetPerformanceCounterAverage(int counter) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPerformanceCounterTotal
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the total time measured by a counter since the statistics were
+//                  last reset.
+// Arguments:       Counter to get the total of.
+// Return value:    The total time in microseconds.
+
+    int64_t GetPerformanceCounterTotal(int counter) const { return m_Counters[counter].m_Total; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPerformanceCounterMin
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the lowest sample of a counter since the statistics were last reset.
+// Arguments:       Counter to get the minimum of.
+// Return value:    The lowest sample in microseconds.
+
+    int64_t GetPerformanceCounterMin(int counter) const { return m_StatSampleCount > 0 ? m_Counters[counter].m_Min : 0; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPerformanceCounterMax
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the highest sample of a counter since the statistics were last reset.
+// Arguments:       Counter to get the maximum of.
+// Return value:    The highest sample in microseconds.
+
+    int64_t GetPerformanceCounterMax(int counter) const { return m_Counters[counter].m_Max; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPerformanceCounterPercentile
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Estimates a percentile of the samples of a counter since the statistics
+//                  were last reset, from its histogram. Accurate to within about 20%.
+// Arguments:       Counter to get the percentile of.
+//                  The percentile to get, from 0 to 100.
+// Return value:    The estimated percentile in microseconds.
+
+    int64_t GetPerformanceCounterPercentile(int counter, float percentile) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetStatisticsSampleCount
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the number of samples closed since the statistics were last reset.
+// Arguments:       None.
+// Return value:    The number of samples.
+
+    long GetStatisticsSampleCount() const { return m_StatSampleCount; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ResetStatistics
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Clears the totals, min/max and histograms of all counters. The sample
+//                  history used by the on-screen graphs is left alone.
+// Arguments:       None.
+// Return value:    None.
+
+    void ResetStatistics();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WriteCSV
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Writes the statistics of all counters to a stream as CSV, one line
+//                  per counter. All times are in milliseconds.
+// Arguments:       The stream to write to.
+// Return value:    None.
+
+    void WriteCSV(std::ostream &stream) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WriteJSON
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Writes the statistics of all counters to a stream as a JSON array.
+//                  All times are in milliseconds.
+// Arguments:       The stream to write to.
+// Return value:    None.
+
+    void WriteJSON(std::ostream &stream) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DumpCounters
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Writes the statistics of all counters to a file, as JSON if the file
+//                  name ends with .json and as CSV otherwise. Meant to be called from the
+//                  console, ie. PerformanceMan:DumpCounters("Base.rte/Perf.csv")
+//                  Like other script file access, the path must lie inside an .rte folder.
+// Arguments:       The path of the file to write, relative to the working directory.
+// Return value:    An error return value signaling sucess or any particular failure.
+//                  Anything below 0 is an error signal.
+
+    int DumpCounters(std::string filePath) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Protected member variable and method declarations
+
+protected:
+
+    // The measurements of one thread, which only that thread ever writes to except for
+    // the accumulations being collected by NewPerformanceSample
+    struct ThreadCounters
+    {
+        // What has been measured since the last collection, in microseconds
+        std::atomic<int64_t> m_Accumulated[MAXCOUNTERS];
+        // When the current outermost measurement started, in microseconds
+        int64_t m_MeasureStart[MAXCOUNTERS];
+        // How many measurements of each counter are currently open on this thread
+        int m_Depth[MAXCOUNTERS];
+        // Whether a thread is using these, or they're free to be reused by the next new thread
+        bool m_InUse;
+    };
+
+    // All that is known about a single counter
+    struct Counter
+    {
+        std::string m_Name;
+        int m_Parent;
+        int m_Depth;
+        // Ring buffer of the last closed samples
+        int64_t m_Samples[MAXSAMPLES];
+        // Statistics since last reset
+        int64_t m_Total;
+        int64_t m_Min;
+        int64_t m_Max;
+        unsigned int m_Histogram[HISTOGRAMBUCKETS];
+    };
+
+    // Member variables
+    static const std::string m_ClassName;
+
+    // All the registered counters
+    Counter m_Counters[MAXCOUNTERS];
+    // How many counters are registered
+    std::atomic<int> m_CounterCount;
+    // Guards registration of counters
+    mutable std::mutex m_RegistrationMutex;
+    // The measurements of every thread that has measured anything, including those of ended threads up for reuse
+    std::list<ThreadCounters *> m_ThreadCounters;
+    // Guards the list of thread measurements
+    std::mutex m_ThreadCountersMutex;
+    // Index of the last closed sample in the ring buffers
+    int m_Sample;
+    // How many samples have been closed since statistics were reset
+    long m_StatSampleCount;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetThreadCounters
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the measurements of the calling thread, creating them if this
+//                  is the first time this thread measures anything.
+// Arguments:       None.
+// Return value:    The calling thread's measurements.
+
+    ThreadCounters * GetThreadCounters();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Private member variable and method declarations
+
+private:
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Clear
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Clears all the member variables of this PerformanceMan, effectively
+//                  resetting the members of this abstraction level only.
+// Arguments:       None.
+// Return value:    None.
+
+    void Clear();
+
+    // Disallow the use of some implicit methods.
+    PerformanceMan(const PerformanceMan &reference);
+    PerformanceMan & operator=(const PerformanceMan &rhs);
+
+};
+
+} // namespace RTE
+
+#endif // File
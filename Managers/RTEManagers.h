@@ -12,6 +12,7 @@
 
 #include "SettingsMan.h"
 #include "TimerMan.h"
+#include "PerformanceMan.h"
 #include "FrameMan.h"
 #include "PresetMan.h"
 #include "AudioMan.h"
@@ -116,6 +116,7 @@ void SceneMan::Clear()
     }
 
     m_pUnseenRevealSound = 0;
+    m_fpLoadProgressCallback = 0;
     m_LastUpdatedScreen = 0;
     m_SecondStructPass = false;
 //    m_CalcTimer.Reset();
@@ -200,7 +201,7 @@ int SceneMan::LoadScene(Scene *pNewScene, bool placeObjects, bool placeUnits)
 	g_NetworkServer.LockScene(true);
 
     m_pCurrentScene = pNewScene;
-    if (m_pCurrentScene->LoadData(placeObjects, true, placeUnits) < 0)
+    if (m_pCurrentScene->LoadData(placeObjects, true, placeUnits, m_fpLoadProgressCallback) < 0)
     {
         g_ConsoleMan.PrintString("ERROR: Loading scene \'" + m_pCurrentScene->GetPresetName() + "\' failed! Has it been properly defined?");
 		g_NetworkServer.LockScene(false);
@@ -1113,6 +1114,10 @@ int SceneMan::RemoveOrphans(int posX, int posY,
 
 void SceneMan::RegisterTerrainChange(int x, int y, int w, int h, unsigned char color, bool back) 
 {
+	// Anything that was lying asleep on the changed terrain needs to notice
+	if (!back)
+		g_MovableMan.RegisterTerrainChange(Box(Vector(x, y), w, h));
+
 	if (!g_NetworkServer.IsServerModeEnabled())
 		return;
 
@@ -1490,13 +1495,13 @@ bool SceneMan::IsUnseen(const int posX, const int posY, const int team)
 		return false;
 
     SceneLayer *pUnseenLayer = m_pCurrentScene->GetUnseenLayer(team);
-    if (pUnseenLayer)
+    if (pUnseenLayer && m_pCurrentScene->GetUnseenMask(team))
     {
         // Translate to the scaled unseen layer's coordinates
         Vector scale = pUnseenLayer->GetScaleInverse();
         int scaledX = posX * scale.m_X;
         int scaledY = posY * scale.m_Y;
-        return getpixel(pUnseenLayer->GetBitmap(), scaledX, scaledY) != g_KeyColor;
+        return m_pCurrentScene->IsUnseenPixel(team, scaledX, scaledY);
     }
 
     return false;
@@ -1522,14 +1527,11 @@ bool SceneMan::RevealUnseen(const int posX, const int posY, const int team)
         int scaledX = posX * scale.m_X;
         int scaledY = posY * scale.m_Y;
 
-        // Make sure we're actually revealing an unseen pixel that is ON the bitmap!
-        int pixel = getpixel(pUnseenLayer->GetBitmap(), scaledX, scaledY);
-        if (pixel != g_KeyColor && pixel != -1)
+        // Clear the pixel on the mask so it won't be detected as unseen again, if it actually is an unseen pixel ON the map
+        if (m_pCurrentScene->SetUnseenPixel(team, scaledX, scaledY, false))
         {
             // Add the pixel to the list of now seen pixels so it can be visually flashed
             m_pCurrentScene->GetSeenPixels(team).push_back(Vector(scaledX, scaledY));
-            // Clear to key color that pixel on the map so it won't be detected as unseen again
-            putpixel(pUnseenLayer->GetBitmap(), scaledX, scaledY, g_KeyColor);
             // Play the reveal sound, if there's not too many already revealed this frame
             if (g_SettingsMan.BlipOnRevealUnseen() && m_pUnseenRevealSound && m_pCurrentScene->GetSeenPixels(team).size() < 5)
                 m_pUnseenRevealSound->Play(g_SceneMan.TargetDistanceScalar(Vector(posX, posY)));
@@ -1561,14 +1563,10 @@ bool SceneMan::RestoreUnseen(const int posX, const int posY, const int team)
         int scaledX = posX * scale.m_X;
         int scaledY = posY * scale.m_Y;
 
-        // Make sure we're actually revealing an unseen pixel that is ON the bitmap!
-        int pixel = getpixel(pUnseenLayer->GetBitmap(), scaledX, scaledY);
-        if (pixel != g_BlackColor && pixel != -1)
+        // Set the pixel on the mask so it will be detected as unseen again, if it actually is a seen pixel ON the map.
+        // Not added to the seen pixels, since those get cleared to seen again after they've been flashed
+        if (m_pCurrentScene->SetUnseenPixel(team, scaledX, scaledY, true))
         {
-            // Add the pixel to the list of now seen pixels so it can be visually flashed
-            m_pCurrentScene->GetSeenPixels(team).push_back(Vector(scaledX, scaledY));
-            // Clear to key color that pixel on the map so it won't be detected as unseen again
-            putpixel(pUnseenLayer->GetBitmap(), scaledX, scaledY, g_BlackColor);
             // Play the reveal sound, if there's not too many already revealed this frame
             //if (g_SettingsMan.BlipOnRevealUnseen() && m_pUnseenRevealSound && m_pCurrentScene->GetSeenPixels(team).size() < 5)
             //    m_pUnseenRevealSound->Play(g_SceneMan.TargetDistanceScalar(Vector(posX, posY)));
@@ -1602,8 +1600,8 @@ void SceneMan::RevealUnseenBox(const int posX, const int posY, const int width,
         int scaledW = width * scale.m_X;
         int scaledH = height * scale.m_Y;
 
-        // Fill the box
-        rectfill(pUnseenLayer->GetBitmap(), scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, g_KeyColor);
+        // Clear the box on the mask
+        m_pCurrentScene->SetUnseenBox(team, scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, false);
     }
 }
 
@@ -1629,8 +1627,8 @@ void SceneMan::RestoreUnseenBox(const int posX, const int posY, const int width,
         int scaledW = width * scale.m_X;
         int scaledH = height * scale.m_Y;
 
-        // Fill the box
-        rectfill(pUnseenLayer->GetBitmap(), scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, g_BlackColor);
+        // Fill the box on the mask
+        m_pCurrentScene->SetUnseenBox(team, scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, true);
     }
 }
 
@@ -2156,7 +2154,6 @@ float SceneMan::CastMaxStrengthRay(const Vector &start, const Vector &end, int s
     int intPos[2], delta[2], delta2[2], increment[2];
     bool foundPixel = false;
     unsigned char materialID;
-    Material foundMaterial;
 
     intPos[X] = floorf(start.m_X);
     intPos[Y] = floorf(start.m_Y);
@@ -2568,10 +2565,8 @@ MOID SceneMan::CastMORay(const Vector &start, const Vector &ray, MOID ignoreMOID
                 // Check if we're supposed to ignore the team of what we hit
                 if (ignoreTeam != Activity::NOTEAM)
                 {
-                    const MovableObject *pHitMO = g_MovableMan.GetMOFromID(hitMOID);
-                    pHitMO = pHitMO ? pHitMO->GetRootParent() : 0;
                     // Yup, we are supposed to ignore this!
-                    if (pHitMO && pHitMO->IgnoresTeamHits() && pHitMO->GetTeam() == ignoreTeam)
+                    if (g_MovableMan.MOIDIgnoresTeamHits(hitMOID) && g_MovableMan.GetMOIDTeam(hitMOID) == ignoreTeam)
                     {
                         ;
                     }
@@ -2832,19 +2827,12 @@ float SceneMan::CastObstacleRay(const Vector &start, const Vector &ray, Vector &
             // Translate any found MOID into the root MOID of that hit MO
             if (checkMOID != g_NoMOID)
             {
-                MovableObject *pHitMO = g_MovableMan.GetMOFromID(checkMOID);
-                if (pHitMO)
-                {
-                    checkMOID = pHitMO->GetRootID();
-                    // Check if we're supposed to ignore the team of what we hit
-                    if (ignoreTeam != Activity::NOTEAM)
-                    {
-                        pHitMO = pHitMO->GetRootParent();
-                        // We are indeed supposed to ignore this object because of its ignoring of its specific team
-                        if (pHitMO && pHitMO->IgnoresTeamHits() && pHitMO->GetTeam() == ignoreTeam)
-                            checkMOID = g_NoMOID;
-                    }
-                }
+                // Check if we're supposed to ignore the team of what we hit
+                // We are indeed supposed to ignore this object because of its ignoring of its specific team
+                if (ignoreTeam != Activity::NOTEAM && g_MovableMan.MOIDIgnoresTeamHits(checkMOID) && g_MovableMan.GetMOIDTeam(checkMOID) == ignoreTeam)
+                    checkMOID = g_NoMOID;
+                else
+                    checkMOID = g_MovableMan.GetRootMOID(checkMOID);
             }
 
             // See if we found the looked-for pixel of the correct material,
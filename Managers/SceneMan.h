@@ -211,6 +211,21 @@ public:
     virtual int LoadScene(Scene *pNewScene, bool placeObjects = true, bool placeUnits = true);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetLoadProgressCallback
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets a function to report the progress of Scene loading to. It gets
+//                  called at each loading stage and repeatedly while stages that run in
+//                  the background are being waited on, so it can keep the UI and network
+//                  responsive. It must not touch the simulation.
+// Arguments:       A function pointer to a function that will be called and sent a string
+//                  with information about the loading progress, and whether it is a new
+//                  stage. 0 to not report anything.
+// Return value:    None.
+
+    void SetLoadProgressCallback(void (*fpProgressCallback)(std::string, bool)) { m_fpLoadProgressCallback = fpProgressCallback; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  SetSceneToLoad
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -236,6 +251,26 @@ public:
     virtual int SetSceneToLoad(std::string sceneName, bool placeObjects = true, bool placeUnits = true);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPlaceObjectsOnLoad
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Shows whether the Scene set to be loaded places its objects when loaded.
+// Arguments:       None.
+// Return value:    Whether objects are placed.
+
+    bool GetPlaceObjectsOnLoad() const { return m_PlaceObjects; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPlaceUnitsOnLoad
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Shows whether the Scene set to be loaded deploys its units when loaded.
+// Arguments:       None.
+// Return value:    Whether units are deployed.
+
+    bool GetPlaceUnitsOnLoad() const { return m_PlaceUnits; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  GetSceneToLoad
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1924,6 +1959,9 @@ protected:
     // Sound of an unseen pixel on an unseen layer being revealed.
     Sound *m_pUnseenRevealSound;
 
+    // Where to report Scene loading progress to, if anywhere
+    void (*m_fpLoadProgressCallback)(std::string, bool);
+
     // The last screen everything has been updated to
     int m_LastUpdatedScreen;
     // Whether we're in second pass of the structural computations.
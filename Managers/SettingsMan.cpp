@@ -65,6 +65,9 @@ void SettingsMan::Clear()
 
 	m_ServerSleepWhenIdle = false;
 	m_ServerSimSleepWhenIdle = false;
+	m_RotatedSpriteCacheMegabytes = 16;
+	m_StreamBackgroundLayers = true;
+	m_ParallelScriptThreads = -1;
 
 	m_ServerUseHighCompression = true;
 	m_ServerUseFastCompression = false;
@@ -277,6 +280,12 @@ int SettingsMan::ReadProperty(std::string propName, Reader &reader)
 		reader >> m_ServerSleepWhenIdle;
 	else if (propName == "ServerSimSleepWhenIdle")
 		reader >> m_ServerSimSleepWhenIdle;
+	else if (propName == "RotatedSpriteCacheMegabytes")
+		reader >> m_RotatedSpriteCacheMegabytes;
+	else if (propName == "StreamBackgroundLayers")
+		reader >> m_StreamBackgroundLayers;
+	else if (propName == "ParallelScriptThreads")
+		reader >> m_ParallelScriptThreads;
 	else if (propName == "AudioChannels")
 		reader >> m_AudioChannels;
 	else if (propName == "DisableLoadingScreen")
@@ -476,6 +485,12 @@ int SettingsMan::Save(Writer &writer) const
 	writer << m_ServerSleepWhenIdle;
 	writer.NewProperty("ServerSimSleepWhenIdle");
 	writer << m_ServerSimSleepWhenIdle;
+	writer.NewProperty("RotatedSpriteCacheMegabytes");
+	writer << m_RotatedSpriteCacheMegabytes;
+	writer.NewProperty("StreamBackgroundLayers");
+	writer << m_StreamBackgroundLayers;
+	writer.NewProperty("ParallelScriptThreads");
+	writer << m_ParallelScriptThreads;
 	
 	writer.NewProperty("DisableLoadingScreen");
 	writer << m_DisableLoadingScreen;
@@ -610,6 +610,12 @@ public:
 	bool GetServerSleepWhenIdle() { return m_ServerSleepWhenIdle; }
 
 	bool GetServerSimSleepWhenIdle() { return m_ServerSimSleepWhenIdle; }
+
+	int GetRotatedSpriteCacheMegabytes() { return m_RotatedSpriteCacheMegabytes; }
+
+	bool StreamBackgroundLayers() { return m_StreamBackgroundLayers; }
+
+	int GetParallelScriptThreads() { return m_ParallelScriptThreads; }
 	
 	int GetAudioChannels() { return m_AudioChannels; }
 
@@ -698,6 +704,15 @@ protected:
 
 	bool m_ServerSimSleepWhenIdle;
 
+	// How many megabytes the pre-rotated sprite frames used by MOSRotating::Draw may take up, 0 disables that cache
+	int m_RotatedSpriteCacheMegabytes;
+
+	// Whether large Scene background layers are kept as compressed tiles that get decoded as they're drawn
+	bool m_StreamBackgroundLayers;
+
+	// How many worker threads run the Update of ScriptThreadSafe presets, 0 runs them serially, -1 picks from the core count
+	int m_ParallelScriptThreads;
+
 	int m_AudioChannels;
 
 	bool m_DisableLoadingScreen;
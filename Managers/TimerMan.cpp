@@ -204,7 +204,11 @@ int64_t TimerMan::GetAbsoulteTime()
 	ticks = tickReading.QuadPart;
 #elif defined(__APPLE__)
 	ticks = mach_absolute_time();
-#endif // defined(__APPLE__)
+#elif defined(__unix__)
+	timespec my_TimeSpec;
+	clock_gettime(CLOCK_MONOTONIC, &my_TimeSpec);
+	ticks = (int64_t)((my_TimeSpec.tv_sec * 1000000) + (my_TimeSpec.tv_nsec / 1000));
+#endif // defined(__unix__)
 	
 	ticks *= 1000000;
 	ticks /= m_TicksPerSecond;
@@ -343,4 +347,21 @@ void TimerMan::UpdateSim()
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateSimFixed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Advances the simulation time by exactly one DeltaTime, regardless of
+//                  how much real time has passed.
+
+void TimerMan::UpdateSimFixed()
+{
+    m_SimAccumulator = 0;
+    m_SimTimeTicks += m_DeltaTime;
+    ++m_SimUpdateCount;
+    // Nothing gets drawn in this mode, so every update counts as a pure sim update
+    m_SimUpdatesSinceDrawn = 0;
+    m_DrawnSimUpdate = false;
+}
+
+
 } // namespace RTE
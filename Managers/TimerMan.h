@@ -416,6 +416,18 @@ public:
     void UpdateSim();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateSimFixed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Advances the simulation time by exactly one DeltaTime, regardless of
+//                  how much real time has passed. Used by the benchmark mode so that
+//                  runs are repeatable and not tied to the speed of the machine.
+// Arguments:       None.
+// Return value:    None.
+
+    void UpdateSimFixed();
+
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetAbsoulteTime
@@ -911,6 +911,7 @@ int UInputMan::Save(Writer &writer) const
 
 void UInputMan::Destroy()
 {
+    m_InputRecorder.Stop();
     Clear();
 }
 	
@@ -2441,13 +2442,18 @@ int UInputMan::Update()
 
     poll_joystick();
 
+    int mickeyX, mickeyY;
+    get_mouse_mickeys(&mickeyX, &mickeyY);
+
+    // Log the device state of this sim update, or replace it with the logged one, before anything looks at it
+    if (g_InActivity)
+        m_InputRecorder.UpdateDevices(mickeyX, mickeyY);
+
     // Detect and store key changes since last Update()
     for (int i = 0; i < KEY_MAX; ++i)
         s_aChangedKeys[i] = key[i] != s_aLastKeys[i];
 
     // Store mouse movement
-    int mickeyX, mickeyY;
-    get_mouse_mickeys(&mickeyX, &mickeyY);
     m_RawMouseMovement.SetXY(mickeyX, mickeyY);
 /* Figured out that it was a acceleration setting in AllegroConfig.txt that caused this problem
     // Adjust for the wackiness that happens to the mickeys when 2x fullscreen screened
@@ -19,6 +19,7 @@
 #define g_UInputMan UInputMan::Instance()
 #include "Serializable.h"
 #include "Timer.h"
+#include "InputRecorder.h"
 
 #include "FrameMan.h"
 //#include "SceneMan.h"
@@ -1584,6 +1585,17 @@ public:
 	bool AccumulatedElementReleased(int element);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetInputRecorder
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the recorder that logs or replays the device input of each sim
+//                  update of an activity.
+// Arguments:       None.
+// Return value:    The input recorder.
+
+	InputRecorder & GetInputRecorder() { return m_InputRecorder; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          FlagAltState
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1701,6 +1713,8 @@ private:
 	bool m_OverrideInput;
 	// If true then this instance operates in multiplayer mode
 	bool m_IsInMultiplayerMode;
+	// Logs the device input of each sim update, or feeds it back from a log
+	InputRecorder m_InputRecorder;
 
 	Vector m_NetworkAccumulatedRawMouseMovement[MAX_PLAYERS];
 
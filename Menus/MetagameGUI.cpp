@@ -1324,17 +1324,14 @@ bool MetagameGUI::LoadGame()
 // Description:     Attempts to save a Metagame to disk using the settings set in the
 //                  Save Game dialog box.
 
-bool MetagameGUI::SaveGame(string saveName, string savePath, bool resaveSceneData)
+bool MetagameGUI::SaveGame(string saveName, string savePath)
 {
-    // If specified, first load all bitmap data of all Scenes in the current Metagame that have once saved em, so we can re-save them to the new files
-    if (resaveSceneData)
-        g_MetaMan.LoadSceneData();
-
     // Set the GameName of the MetaGame to be the save name
     g_MetaMan.m_GameName = saveName;
 
     // Save any loaded scene data FIRST, so that all the paths of ContentFiles get updated to the actual save location first,
-    // which may have been changed due to the saveName being different than before.   
+    // which may have been changed due to the saveName being different than before.
+    // Scenes that aren't loaded haven't changed since they were last saved, so their files just get copied over if the name changed.
     g_MetaMan.SaveSceneData(METASAVEPATH + saveName);
 
     // Whichever new or existing, create a writer with the path
@@ -1343,10 +1340,6 @@ bool MetagameGUI::SaveGame(string saveName, string savePath, bool resaveSceneDat
     if (g_MetaMan.Save(metaWriter) < 0)
         return false;
 
-    // Clear out the scene data again so we're not keeping it in memory unnecessarily
-    if (resaveSceneData)
-        g_MetaMan.ClearSceneData();
-
     // After successful save, update the corresponding preset to reflect the newly saved game
     // Create a new MetaSave preset that will hold the runtime info of this new save (so it shows up as something we can overwrite later this same runtime)
     MetaSave newSave;
@@ -1416,8 +1409,7 @@ bool MetagameGUI::SaveGameFromDialog()
         return false;
     }
 
-    // First load all bitmap data of all Scenes in the current Metagame that have once saved em, so we can re-save them to the new files
-    return SaveGame(saveName, savePath, true);
+    return SaveGame(saveName, savePath);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -3078,7 +3070,7 @@ void MetagameGUI::CompletedActivity()
             m_pPlayingScene = 0;
             // Auto save the entire MetaMan state too
 // Do this later in FinalizeOffensive, since the funds change until then
-//            SaveGame(AUTOSAVENAME, METASAVEPATH + string(AUTOSAVENAME) + ".ini", false);
+//            SaveGame(AUTOSAVENAME, METASAVEPATH + string(AUTOSAVENAME) + ".ini");
 
             // Update the Scene info box since the scene might have changed
             UpdateScenesBox(true);
@@ -5230,7 +5222,7 @@ bool MetagameGUI::FinalizeOffensive()
     g_MetaMan.m_CurrentOffensive++;
 
     // AUTO-SAVE THE GAME AFTER EACH PLAYED BATTLE
-    SaveGame(AUTOSAVENAME, METASAVEPATH + string(AUTOSAVENAME) + ".ini", false);
+    SaveGame(AUTOSAVENAME, METASAVEPATH + string(AUTOSAVENAME) + ".ini");
 
     // If we're out of offensives, then move onto the next phase
     if (g_MetaMan.m_CurrentOffensive >= g_MetaMan.m_RoundOffensives.size())
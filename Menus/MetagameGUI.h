@@ -430,11 +430,9 @@ public:
 //                  location.
 // Arguments:       The name of the save game to create or overwrite here.
 //                  The full path of the ini that we want to save the Metagame state to.
-//                  Whether to load all the scene data that is on disk first so it will
-//                  be re-saved to the new location here.
 // Return value:    Whether the game was able to be saved there.
 
-    bool SaveGame(std::string saveName, std::string savePath, bool resaveSceneData = false);
+    bool SaveGame(std::string saveName, std::string savePath);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -31,6 +31,13 @@
 #include "RelayPlugin.h"
 
 #include <map>
+#include <set>
+#include <queue>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "GetTime.h"
 
 // This one comes from RTEA source base
 #include "..\..\Managers\NetworkMessages.h"
@@ -59,6 +66,27 @@ enum FeatureList
 
 static int DEFAULT_RAKPEER_PORT=61111;
 
+// Skip the per-request printouts, which would otherwise be most of the work under load
+static bool g_Quiet=false;
+
+// Set by RakNet's update thread every time it has run a cycle, which it does right away when
+// datagrams come in, so the main loop can wait on this instead of sleeping a fixed time
+static std::mutex g_UpdateMutex;
+static std::condition_variable g_UpdateCondition;
+static bool g_UpdateCycled=false;
+
+static void OnRakPeerUpdateCycle(RakNet::RakPeerInterface *rakPeer, void *data)
+{
+	{
+		std::lock_guard<std::mutex> lock(g_UpdateMutex);
+		g_UpdateCycled=true;
+	}
+	g_UpdateCondition.notify_one();
+}
+
+// How often to check the keyboard when nothing else wakes up the main loop
+static const unsigned int KEYBOARD_POLL_MS=100;
+
 #define NatTypeDetectionServerFramework_Supported QUERY
 #define NatPunchthroughServerFramework_Supported QUERY
 #define RelayPlugin_Supported QUERY
@@ -89,6 +117,10 @@ struct SampleFramework
 	virtual void Init(RakNet::RakPeerInterface *rakPeer)=0;
 	virtual void ProcessPacket(RakNet::RakPeerInterface *rakPeer, Packet *packet)=0;
 	virtual void Shutdown(RakNet::RakPeerInterface *rakPeer)=0;
+	// Housekeeping that isn't driven by packets, and how long it can wait until it needs to run again
+	virtual void Update(RakNet::RakPeerInterface *rakPeer) {}
+	virtual unsigned int TimeToNextUpdate(unsigned int maxMS) {return maxMS;}
+	virtual void PrintStatistics(void) {}
 
 	FeatureSupport isSupported;
 };
@@ -134,16 +166,124 @@ struct SampleFramework
 	NatTypeDetectionServer *ntds;
 };*/
 
+// Registered game servers, looked up by name and password. Entries expire unless the game
+// server refreshes its registration in time, and all of a system's entries go when it disconnects.
+struct ServerRegistry
+{
+	struct Entry
+	{
+		RakNet::RakNetGUID Guid;
+		RakNet::SystemAddress Owner;
+		RakNet::TimeUS Expires;
+	};
+
+	typedef std::pair<RakNet::TimeUS, std::string> Expiry;
+
+	std::unordered_map<std::string, Entry> Servers;
+	// Which names each connected system has registered
+	std::map<RakNet::SystemAddress, std::set<std::string> > ByOwner;
+	// Expiry times, earliest on top. A refresh pushes a new one, the outdated one is skipped when it comes up
+	std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry> > ExpiryQueue;
+
+	// Returns true if the name wasn't registered yet
+	bool Register(const std::string &key, RakNet::RakNetGUID guid, RakNet::SystemAddress owner, RakNet::TimeUS now)
+	{
+		std::unordered_map<std::string, Entry>::iterator itr = Servers.find(key);
+		bool isNew = itr == Servers.end();
+		if (isNew)
+			itr = Servers.insert(std::make_pair(key, Entry())).first;
+		else if (itr->second.Owner != owner)
+			RemoveFromOwner(itr->second.Owner, key);
+
+		itr->second.Guid = guid;
+		itr->second.Owner = owner;
+		itr->second.Expires = now + (RakNet::TimeUS)NAT_SERVER_REGISTRATION_TTL_MS * 1000;
+		ByOwner[owner].insert(key);
+		ExpiryQueue.push(Expiry(itr->second.Expires, key));
+		return isNew;
+	}
+
+	bool Find(const std::string &key, RakNet::RakNetGUID &guid) const
+	{
+		std::unordered_map<std::string, Entry>::const_iterator itr = Servers.find(key);
+		if (itr == Servers.end())
+			return false;
+		guid = itr->second.Guid;
+		return true;
+	}
+
+	// Returns how many entries were dropped
+	int RemoveOwner(RakNet::SystemAddress owner)
+	{
+		std::map<RakNet::SystemAddress, std::set<std::string> >::iterator itr = ByOwner.find(owner);
+		if (itr == ByOwner.end())
+			return 0;
+		int count = (int)itr->second.size();
+		for (std::set<std::string>::iterator kItr = itr->second.begin(); kItr != itr->second.end(); ++kItr)
+			Servers.erase(*kItr);
+		ByOwner.erase(itr);
+		return count;
+	}
+
+	// Drops everything that wasn't refreshed in time, returns how many entries were dropped
+	int Expire(RakNet::TimeUS now)
+	{
+		int count = 0;
+		while (!ExpiryQueue.empty() && ExpiryQueue.top().first <= now)
+		{
+			std::unordered_map<std::string, Entry>::iterator itr = Servers.find(ExpiryQueue.top().second);
+			if (itr != Servers.end() && itr->second.Expires <= now)
+			{
+				RemoveFromOwner(itr->second.Owner, itr->first);
+				Servers.erase(itr);
+				count++;
+			}
+			ExpiryQueue.pop();
+		}
+		return count;
+	}
+
+	// How long until the next entry could expire, in ms, capped at the given maximum
+	unsigned int TimeToNextExpiry(RakNet::TimeUS now, unsigned int maxMS) const
+	{
+		if (ExpiryQueue.empty())
+			return maxMS;
+		if (ExpiryQueue.top().first <= now)
+			return 0;
+		RakNet::TimeUS waitMS = (ExpiryQueue.top().first - now + 999) / 1000;
+		return waitMS < maxMS ? (unsigned int)waitMS : maxMS;
+	}
+
+	void RemoveFromOwner(RakNet::SystemAddress owner, const std::string &key)
+	{
+		std::map<RakNet::SystemAddress, std::set<std::string> >::iterator itr = ByOwner.find(owner);
+		if (itr != ByOwner.end())
+		{
+			itr->second.erase(key);
+			if (itr->second.empty())
+				ByOwner.erase(itr);
+		}
+	}
+};
+
 struct NatPunchthroughServerFramework : public SampleFramework, public NatPunchthroughServerDebugInterface_Printf
 {
-	NatPunchthroughServerFramework() {isSupported=NatPunchthroughServerFramework_Supported; nps=0;}
+	NatPunchthroughServerFramework() {isSupported=NatPunchthroughServerFramework_Supported; nps=0; Registrations=0; Refreshes=0; QueryHits=0; QueryMisses=0; Expired=0; Dropped=0;}
 	virtual const char * QueryName(void) {return "NatPunchthroughServerFramework";}
 	virtual const char * QueryRequirements(void) {return "None";}
 	virtual const char * QueryFunction(void) {return "Coordinates NATPunchthroughClient.";}
 
-	std::map<std::string, RakNet::RakNetGUID> KnownServers;
+	ServerRegistry KnownServers;
 	RakNet::RakPeerInterface * Peer;
 
+	// Counters for the statistics printout
+	unsigned int Registrations;
+	unsigned int Refreshes;
+	unsigned int QueryHits;
+	unsigned int QueryMisses;
+	unsigned int Expired;
+	unsigned int Dropped;
+
 	virtual void Init(RakNet::RakPeerInterface *rakPeer)
 	{
 		if (isSupported==SUPPORTED)
@@ -151,6 +291,7 @@ struct NatPunchthroughServerFramework : public SampleFramework, public NatPuncht
 			nps = new NatPunchthroughServer;
 			rakPeer->AttachPlugin(nps);
 			#ifdef VERBOSE_LOGGING
+			if (!g_Quiet)
 				nps->SetDebugInterface(this);
 			#endif
 				Peer = rakPeer;
@@ -164,6 +305,8 @@ struct NatPunchthroughServerFramework : public SampleFramework, public NatPuncht
 		{
 			case RTE::ID_NAT_SERVER_REGISTER_SERVER:
 				{
+					if (packet->length < sizeof(RTE::MsgRegisterServer))
+						break;
 					RTE::MsgRegisterServer * msg = (RTE::MsgRegisterServer *)packet->data;
 
 					std::string server(msg->ServerName, 62);
@@ -174,36 +317,63 @@ struct NatPunchthroughServerFramework : public SampleFramework, public NatPuncht
 					RakNet::RakNetGUID serverGuid;
 					serverGuid.FromString(guid.c_str());
 
-					KnownServers[merged] = serverGuid;
-
-					printf("New server registration: %s :: %s - %s\n", server.c_str(), password.c_str(), guid.c_str());
+					// Game servers send the same registration again as a heartbeat
+					if (KnownServers.Register(merged, serverGuid, packet->systemAddress, RakNet::GetTimeUS()))
+					{
+						Registrations++;
+						if (!g_Quiet)
+							printf("New server registration: %s :: %s - %s\n", server.c_str(), password.c_str(), guid.c_str());
+					}
+					else
+						Refreshes++;
 					SendServerRegistrationAccepted(packet->systemAddress);
 				}
 				break;
 			case RTE::ID_NAT_SERVER_GET_SERVER_GUID:
 				{
+					if (packet->length < sizeof(RTE::MsgGetServerRequest))
+						break;
 					RTE::MsgGetServerRequest * msg = (RTE::MsgGetServerRequest *)packet->data;
 
 					std::string server(msg->ServerName, 62);
 					std::string password(msg->ServerPassword, 62);
 					std::string merged = server + "::" + password;
 
-
-					if (KnownServers.count(merged) > 0)
+					RakNet::RakNetGUID guid;
+					if (KnownServers.Find(merged, guid))
 					{
-						RakNet::RakNetGUID guid = KnownServers[merged];
-						printf("Who is: %s :: %s -> %s\n", server.c_str(), password.c_str(), guid.ToString());
+						QueryHits++;
+						if (!g_Quiet)
+							printf("Who is: %s :: %s -> %s\n", server.c_str(), password.c_str(), guid.ToString());
 						SendServerGuid(packet->systemAddress, guid);
 					}
 					else
 					{
-						printf("Who is: %s :: %s -> ???\n", server.c_str(), password.c_str());
+						QueryMisses++;
+						if (!g_Quiet)
+							printf("Who is: %s :: %s -> ???\n", server.c_str(), password.c_str());
 						SendServerNoGuid(packet->systemAddress);
 					}
 				}
 				break;
+			case ID_CONNECTION_LOST:
+			case ID_DISCONNECTION_NOTIFICATION:
+				Dropped += KnownServers.RemoveOwner(packet->systemAddress);
+				break;
 		}
 	}
+	virtual void Update(RakNet::RakPeerInterface *rakPeer)
+	{
+		Expired += KnownServers.Expire(RakNet::GetTimeUS());
+	}
+	virtual unsigned int TimeToNextUpdate(unsigned int maxMS)
+	{
+		return KnownServers.TimeToNextExpiry(RakNet::GetTimeUS(), maxMS);
+	}
+	virtual void PrintStatistics(void)
+	{
+		printf("Registry: %u servers, %u registrations, %u refreshes, %u hits, %u misses, %u expired, %u dropped\n", (unsigned int)KnownServers.Servers.size(), Registrations, Refreshes, QueryHits, QueryMisses, Expired, Dropped);
+	}
 	void SendServerGuid(RakNet::AddressOrGUID addr, RakNet::RakNetGUID guid)
 	{
 		RTE::MsgGetServerAnswer msg;
@@ -562,9 +732,12 @@ int main(int argc, char **argv)
 	// If RakPeer is started on 2 IP addresses, NATPunchthroughServer supports port stride detection, improving success rate
 	int sdLen=1;
 	RakNet::SocketDescriptor sd[2];
-	if (argc>1)
+	for (int arg=1; arg < argc; arg++)
 	{
-		DEFAULT_RAKPEER_PORT = atoi(argv[1]);
+		if (strcmp(argv[arg], "-quiet")==0)
+			g_Quiet=true;
+		else
+			DEFAULT_RAKPEER_PORT = atoi(argv[arg]);
 	}
 	
 	sd[0].port=DEFAULT_RAKPEER_PORT;
@@ -682,7 +855,9 @@ int main(int argc, char **argv)
 		}
 	}
 	
-	printf("\nEntering update loop. Press 'q' to quit.\n");
+	printf("\nEntering update loop. Press 'q' to quit, space for statistics.\n");
+
+	rakPeer->SetUserUpdateThread(OnRakPeerUpdateCycle, 0);
 
 	RakNet::Packet *packet;
 	bool quit=false;
@@ -696,6 +871,16 @@ int main(int argc, char **argv)
 			}
 		}
 
+		unsigned int waitMS=KEYBOARD_POLL_MS;
+		for (i=0; i < FEATURE_LIST_COUNT; i++)
+		{
+			if (samples[i]->isSupported==SUPPORTED)
+			{
+				samples[i]->Update(rakPeer);
+				waitMS=samples[i]->TimeToNextUpdate(waitMS);
+			}
+		}
+
 		if (kbhit())
 		{
 			char ch = getch();
@@ -727,11 +912,23 @@ int main(int argc, char **argv)
 				DataStructures::List<RakNetGUID> guids;
 				rakPeer->GetSystemList(addresses, guids);
 				printf("%i systems connected\n", addresses.Size());
+
+				for (i=0; i < FEATURE_LIST_COUNT; i++)
+				{
+					if (samples[i]->isSupported==SUPPORTED)
+						samples[i]->PrintStatistics();
+				}
 			}
 		}
-		RakSleep(30);
+
+		// Sleep until RakNet has had a chance to hand us more packets, or there's housekeeping due
+		std::unique_lock<std::mutex> lock(g_UpdateMutex);
+		g_UpdateCondition.wait_for(lock, std::chrono::milliseconds(waitMS), []{return g_UpdateCycled;});
+		g_UpdateCycled=false;
 	}
 
+	rakPeer->SetUserUpdateThread(0, 0);
+
 	printf("Quitting.\n");
 	for (i=0; i < FEATURE_LIST_COUNT; i++)
 	{
@@ -0,0 +1,260 @@
+// Load generator for the NAT service registry in NATCompleteServer.
+//
+// Simulates a large number of game servers registering and keeping their registrations alive
+// with heartbeats, and clients looking them up, over a handful of connections to the NAT
+// service. Prints the throughput and reply latencies every second and a summary at the end.
+
+#include "RakPeerInterface.h"
+#include "RakSleep.h"
+#include "MessageIdentifiers.h"
+#include "GetTime.h"
+#include "Kbhit.h"
+#include "Getche.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+
+// This one comes from RTEA source base
+#include "..\..\Managers\NetworkMessages.h"
+
+using namespace RakNet;
+
+// Reply latencies of one kind of request, in microseconds
+struct LatencySamples
+{
+	LatencySamples() {Interval=0;}
+
+	void Add(RakNet::TimeUS latency) {Samples.push_back((unsigned int)latency); Interval++;}
+
+	unsigned int Percentile(std::vector<unsigned int> &sorted, int percent) const
+	{
+		if (sorted.empty())
+			return 0;
+		return sorted[(sorted.size()-1)*percent/100];
+	}
+
+	void Print(const char *name)
+	{
+		std::vector<unsigned int> sorted(Samples);
+		std::sort(sorted.begin(), sorted.end());
+		double total=0;
+		for (size_t i=0; i < sorted.size(); i++)
+			total+=sorted[i];
+		printf("%-13s replies %8u  avg %8.2fms  p50 %8.2fms  p99 %8.2fms  max %8.2fms\n", name, (unsigned int)sorted.size(),
+			sorted.empty() ? 0.0 : total/sorted.size()/1000.0, Percentile(sorted, 50)/1000.0, Percentile(sorted, 99)/1000.0, sorted.empty() ? 0.0 : sorted.back()/1000.0);
+	}
+
+	std::vector<unsigned int> Samples;
+	// Replies since the last per-second printout
+	unsigned int Interval;
+};
+
+// One connection to the NAT service, which a share of the simulated servers and clients send through
+struct LoadPeer
+{
+	RakNet::RakPeerInterface *Peer;
+	RakNet::SystemAddress Service;
+	bool Connected;
+	// When each request still waiting for a reply was sent, oldest first
+	std::deque<RakNet::TimeUS> PendingRegistrations;
+	std::deque<RakNet::TimeUS> PendingQueries;
+};
+
+static void ServerName(int server, char *name)
+{
+	// Same layout as the game fills in, the registry only ever compares the first 62 characters
+	memset(name, 0, 64);
+	sprintf(name, "LoadTest%06d", server);
+}
+
+static void SendRegistration(LoadPeer &peer, int server)
+{
+	RTE::MsgRegisterServer msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.Id = RTE::ID_NAT_SERVER_REGISTER_SERVER;
+	ServerName(server, msg.ServerName);
+	strncpy(msg.ServerGuid, peer.Peer->GetMyGUID().ToString(), 62);
+	peer.PendingRegistrations.push_back(RakNet::GetTimeUS());
+	peer.Peer->Send((const char *)&msg, sizeof(msg), IMMEDIATE_PRIORITY, RELIABLE, 0, peer.Service, false);
+}
+
+static void SendQuery(LoadPeer &peer, int server)
+{
+	RTE::MsgGetServerRequest msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.Id = RTE::ID_NAT_SERVER_GET_SERVER_GUID;
+	ServerName(server, msg.ServerName);
+	peer.PendingQueries.push_back(RakNet::GetTimeUS());
+	peer.Peer->Send((const char *)&msg, sizeof(msg), IMMEDIATE_PRIORITY, RELIABLE, 0, peer.Service, false);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1 && (strcmp(argv[1], "-h")==0 || strcmp(argv[1], "/?")==0))
+	{
+		printf("Usage: NATLoadGenerator [address] [port] [servers] [queries per second] [seconds] [connections] [heartbeat ms]\n");
+		return 0;
+	}
+
+	const char *address = argc > 1 ? argv[1] : "127.0.0.1";
+	int port = argc > 2 ? atoi(argv[2]) : 61111;
+	int servers = argc > 3 ? atoi(argv[3]) : 2000;
+	int queriesPerSecond = argc > 4 ? atoi(argv[4]) : 2000;
+	int seconds = argc > 5 ? atoi(argv[5]) : 30;
+	int connections = argc > 6 ? atoi(argv[6]) : 16;
+	int heartbeatMS = argc > 7 ? atoi(argv[7]) : NAT_SERVER_HEARTBEAT_MS;
+	if (servers < 1 || connections < 1 || heartbeatMS < 1 || seconds < 1)
+	{
+		printf("Servers, connections, heartbeat and seconds all need to be at least 1.\n");
+		return 1;
+	}
+
+	printf("Simulating %i servers and %i queries per second over %i connections to %s:%i for %i seconds, heartbeat every %ims.\n",
+		servers, queriesPerSecond, connections, address, port, seconds, heartbeatMS);
+
+	std::vector<LoadPeer> peers(connections);
+	for (int i=0; i < connections; i++)
+	{
+		peers[i].Peer = RakNet::RakPeerInterface::GetInstance();
+		peers[i].Connected = false;
+		RakNet::SocketDescriptor sd;
+		if (peers[i].Peer->Startup(1, &sd, 1)!=RakNet::RAKNET_STARTED || peers[i].Peer->Connect(address, port, 0, 0)!=RakNet::CONNECTION_ATTEMPT_STARTED)
+		{
+			printf("Failed to start connection %i! Quitting\n", i);
+			return 1;
+		}
+	}
+
+	// Wait for all the connections to go through
+	int connected = 0;
+	RakNet::TimeMS connectDeadline = RakNet::GetTimeMS() + 10000;
+	while (connected < connections && RakNet::GetTimeMS() < connectDeadline)
+	{
+		for (int i=0; i < connections; i++)
+		{
+			for (RakNet::Packet *packet=peers[i].Peer->Receive(); packet; peers[i].Peer->DeallocatePacket(packet), packet=peers[i].Peer->Receive())
+			{
+				if (packet->data[0]==ID_CONNECTION_REQUEST_ACCEPTED)
+				{
+					peers[i].Service = packet->systemAddress;
+					peers[i].Connected = true;
+					connected++;
+				}
+				else if (packet->data[0]==ID_CONNECTION_ATTEMPT_FAILED || packet->data[0]==ID_NO_FREE_INCOMING_CONNECTIONS)
+				{
+					printf("Connection %i was refused! Quitting\n", i);
+					return 1;
+				}
+			}
+		}
+		RakSleep(1);
+	}
+	if (connected < connections)
+	{
+		printf("Only %i of %i connections went through! Quitting\n", connected, connections);
+		return 1;
+	}
+
+	LatencySamples registrations;
+	LatencySamples hits;
+	LatencySamples misses;
+
+	RakNet::TimeUS startTime = RakNet::GetTimeUS();
+	RakNet::TimeUS endTime = startTime + (RakNet::TimeUS)seconds * 1000000;
+	RakNet::TimeUS heartbeatUS = (RakNet::TimeUS)heartbeatMS * 1000;
+	RakNet::TimeUS nextPrint = startTime + 1000000;
+	// Every server registers once right away, then refreshes are spread evenly over each heartbeat interval
+	long long registrationsSent = 0;
+	long long queriesSent = 0;
+	bool quit = false;
+
+	while (!quit)
+	{
+		RakNet::TimeUS now = RakNet::GetTimeUS();
+		if (now >= endTime)
+			break;
+
+		// Registrations and heartbeats that are due
+		while (true)
+		{
+			RakNet::TimeUS due = registrationsSent < servers ? startTime : startTime + heartbeatUS + (RakNet::TimeUS)(registrationsSent - servers) * heartbeatUS / servers;
+			if (due > now)
+				break;
+			int server = (int)(registrationsSent % servers);
+			SendRegistration(peers[server % connections], server);
+			registrationsSent++;
+		}
+
+		// Queries that are due, about one in ten for a server that doesn't exist
+		while (queriesPerSecond > 0 && startTime + (RakNet::TimeUS)queriesSent * 1000000 / queriesPerSecond <= now)
+		{
+			int server = rand() % (servers + servers / 10 + 1);
+			SendQuery(peers[queriesSent % connections], server);
+			queriesSent++;
+		}
+
+		for (int i=0; i < connections; i++)
+		{
+			LoadPeer &peer = peers[i];
+			for (RakNet::Packet *packet=peer.Peer->Receive(); packet; peer.Peer->DeallocatePacket(packet), packet=peer.Peer->Receive())
+			{
+				RakNet::TimeUS received = RakNet::GetTimeUS();
+				switch (packet->data[0])
+				{
+				case RTE::ID_NAT_SERVER_REGISTER_ACCEPTED:
+					if (!peer.PendingRegistrations.empty())
+					{
+						registrations.Add(received - peer.PendingRegistrations.front());
+						peer.PendingRegistrations.pop_front();
+					}
+					break;
+				case RTE::ID_NAT_SERVER_GUID:
+				case RTE::ID_NAT_SERVER_NO_GUID:
+					if (!peer.PendingQueries.empty())
+					{
+						(packet->data[0]==RTE::ID_NAT_SERVER_GUID ? hits : misses).Add(received - peer.PendingQueries.front());
+						peer.PendingQueries.pop_front();
+					}
+					break;
+				case ID_CONNECTION_LOST:
+				case ID_DISCONNECTION_NOTIFICATION:
+					printf("Connection %i was lost! Quitting\n", i);
+					quit = true;
+					break;
+				}
+			}
+		}
+
+		if (now >= nextPrint)
+		{
+			size_t pending = 0;
+			for (int i=0; i < connections; i++)
+				pending += peers[i].PendingRegistrations.size() + peers[i].PendingQueries.size();
+			printf("%3is: %6u registrations/s  %6u hits/s  %6u misses/s  %6u waiting\n", (int)((now - startTime) / 1000000),
+				registrations.Interval, hits.Interval, misses.Interval, (unsigned int)pending);
+			registrations.Interval = hits.Interval = misses.Interval = 0;
+			nextPrint += 1000000;
+		}
+
+		if (kbhit() && getch()=='q')
+			quit = true;
+
+		RakSleep(1);
+	}
+
+	printf("\nResults over %.1f seconds, %lld registrations and %lld queries sent:\n", (RakNet::GetTimeUS() - startTime) / 1000000.0, registrationsSent, queriesSent);
+	registrations.Print("Registrations");
+	hits.Print("Query hits");
+	misses.Print("Query misses");
+
+	for (int i=0; i < connections; i++)
+	{
+		peers[i].Peer->Shutdown(100);
+		RakNet::RakPeerInterface::DestroyInstance(peers[i].Peer);
+	}
+	return 0;
+}
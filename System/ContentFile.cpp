@@ -25,6 +25,11 @@
 #include "PresetMan.h"
 
 #include "allegro.h"
+#include "lz4.h"
+
+// Identifies the LZ4 compressed layer files written by SaveCompressedBitmap, and the version of their layout
+#define COMPRESSEDBITMAPMAGIC 0x4C34454CL
+#define COMPRESSEDBITMAPVERSION 1
 
 using namespace std;
 
@@ -855,8 +860,13 @@ BITMAP * ContentFile::LoadAndReleaseBitmap(int conversionMode)
     // Find where the '#' denoting the divider between the datafile and the datafile object's name is
     int separatorPos = m_DataPath.rfind('#');
 
+    // Compressed scene layer files saved by the metagame
+    if (separatorPos == -1 && IsCompressedBitmapPath(m_DataPath))
+    {
+        pReturnBitmap = LoadCompressedBitmap(m_DataPath);
+    }
     // If there is none, that means we're told to load an exposed file outside of a .dat datafile.
-    if (separatorPos == -1)
+    else if (separatorPos == -1)
     {
         PACKFILE *pFile = pack_fopen(m_DataPath.c_str(), F_READ);
         // Make sure we opened properly, or try to add 000 before the extension if it's part of an animation naming
@@ -936,6 +946,111 @@ BITMAP * ContentFile::LoadAndReleaseBitmap(int conversionMode)
     return pReturnBitmap;
 }
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static method:   SaveCompressedBitmap
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Saves a memory BITMAP to disk as an LZ4 compressed layer file.
+
+bool ContentFile::SaveCompressedBitmap(const std::string &filePath, BITMAP *pBitmap)
+{
+    if (filePath.empty() || !pBitmap)
+        return false;
+
+    // Gather all the rows into one block so they compress as a whole
+    int rowSize = pBitmap->w * ((bitmap_color_depth(pBitmap) + 7) / 8);
+    int rawSize = rowSize * pBitmap->h;
+    char *pRaw = new char[rawSize];
+    for (int y = 0; y < pBitmap->h; ++y)
+        memcpy(pRaw + y * rowSize, pBitmap->line[y], rowSize);
+
+    int compressBound = LZ4_compressBound(rawSize);
+    char *pCompressed = new char[compressBound];
+    int compressedSize = LZ4_compress_default(pRaw, pCompressed, rawSize, compressBound);
+
+    bool success = false;
+    PACKFILE *pFile = compressedSize > 0 ? pack_fopen(filePath.c_str(), F_WRITE) : 0;
+    if (pFile)
+    {
+        pack_mputl(COMPRESSEDBITMAPMAGIC, pFile);
+        pack_mputl(COMPRESSEDBITMAPVERSION, pFile);
+        pack_mputl(bitmap_color_depth(pBitmap), pFile);
+        pack_mputl(pBitmap->w, pFile);
+        pack_mputl(pBitmap->h, pFile);
+        pack_mputl(compressedSize, pFile);
+        success = pack_fwrite(pCompressed, compressedSize, pFile) == compressedSize;
+        pack_fclose(pFile);
+    }
+
+    delete[] pCompressed;
+    delete[] pRaw;
+
+    return success;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static method:   LoadCompressedBitmap
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Loads an LZ4 compressed layer file written by SaveCompressedBitmap.
+
+BITMAP * ContentFile::LoadCompressedBitmap(const std::string &filePath)
+{
+    PACKFILE *pFile = pack_fopen(filePath.c_str(), F_READ);
+    if (!pFile)
+        return 0;
+
+    if (pack_mgetl(pFile) != COMPRESSEDBITMAPMAGIC || pack_mgetl(pFile) != COMPRESSEDBITMAPVERSION)
+    {
+        pack_fclose(pFile);
+        return 0;
+    }
+
+    int depth = pack_mgetl(pFile);
+    int width = pack_mgetl(pFile);
+    int height = pack_mgetl(pFile);
+    int compressedSize = pack_mgetl(pFile);
+    if (width <= 0 || height <= 0 || compressedSize <= 0 || (depth != 8 && depth != 15 && depth != 16 && depth != 24 && depth != 32))
+    {
+        pack_fclose(pFile);
+        return 0;
+    }
+
+    char *pCompressed = new char[compressedSize];
+    bool readOK = pack_fread(pCompressed, compressedSize, pFile) == compressedSize;
+    pack_fclose(pFile);
+
+    BITMAP *pBitmap = 0;
+    if (readOK)
+    {
+        int rowSize = width * ((depth + 7) / 8);
+        int rawSize = rowSize * height;
+        char *pRaw = new char[rawSize];
+        if (LZ4_decompress_safe(pCompressed, pRaw, compressedSize, rawSize) == rawSize)
+        {
+            pBitmap = create_bitmap_ex(depth, width, height);
+            for (int y = 0; pBitmap && y < height; ++y)
+                memcpy(pBitmap->line[y], pRaw + y * rowSize, rowSize);
+        }
+        delete[] pRaw;
+    }
+    delete[] pCompressed;
+
+    return pBitmap;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static method:   IsCompressedBitmapPath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether a path refers to an LZ4 compressed layer file.
+
+bool ContentFile::IsCompressedBitmapPath(const std::string &filePath)
+{
+    return filePath.length() > 4 && ustricmp(filePath.c_str() + filePath.length() - 4, ".lz4") == 0;
+}
+
+
 std::string ContentFile::GetPathFromHash(size_t hash)
 {
 	std::string result;
@@ -444,6 +444,40 @@ public:
 
     virtual BITMAP ** LoadAndReleaseAnimation(int frameCount = 1, int conversionMode = 0);
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static method:   SaveCompressedBitmap
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Saves a memory BITMAP to disk as an LZ4 compressed layer file, which
+//                  is much smaller and faster to write than a .bmp. Such files are loaded
+//                  back by LoadAndReleaseBitmap when the data path ends with .lz4.
+// Arguments:       The path of the file to write.
+//                  The BITMAP to save. Ownership is NOT transferred!
+// Return value:    Whether the file was written successfully.
+
+    static bool SaveCompressedBitmap(const std::string &filePath, BITMAP *pBitmap);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static method:   LoadCompressedBitmap
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Loads an LZ4 compressed layer file written by SaveCompressedBitmap.
+// Arguments:       The path of the file to read.
+// Return value:    The pointer to the BITMAP loaded from disk. Ownership IS transferred!
+//                  If 0, the file could not be found or was not a valid layer file.
+
+    static BITMAP * LoadCompressedBitmap(const std::string &filePath);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static method:   IsCompressedBitmapPath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether a path refers to an LZ4 compressed layer file.
+// Arguments:       The path to check.
+// Return value:    Whether the path ends with the .lz4 extension.
+
+    static bool IsCompressedBitmapPath(const std::string &filePath);
+
 /* This is foolish
 //////////////////////////////////////////////////////////////////////////////////////////
 // Static method:   ClearAllLoadedData
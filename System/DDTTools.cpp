@@ -14,7 +14,9 @@
 #include "DDTTools.h"
 
 #include <math.h>
+#include <stdlib.h>
 #include <fstream>
+#include <atomic>
 #include "FrameMan.h"
 #include "SceneMan.h"
 #include "Vector.h"
@@ -25,22 +27,127 @@ namespace RTE
 #define X 0
 #define Y 1 
 
+// The seed all the per-thread streams are derived from, and how many times it's been set,
+// so that threads can tell that they need to restart on the new one
+static std::atomic<unsigned int> s_RandSeed(0);
+static std::atomic<unsigned int> s_RandSeedGeneration(0);
+// The next stream handed out to a thread when it first draws a number; 0 belongs to whoever seeds
+static std::atomic<unsigned int> s_NextRandStream(1);
+
+// The stream each thread's global rand functions draw from
+struct ThreadRandom
+{
+    ThreadRandom() { m_Stream = s_NextRandStream++; m_Generation = ~0U; m_pOverride = 0; }
+
+    RandomStream m_Random;
+    unsigned int m_Stream;
+    unsigned int m_Generation;
+    // Drawn from instead while set, see SetThreadRandom
+    RandomStream *m_pOverride;
+};
+static thread_local ThreadRandom s_ThreadRandom;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RandomStream::Seed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Restarts this at the beginning of one of the streams of a seed.
+
+void RandomStream::Seed(unsigned int seed, unsigned int stream)
+{
+    // Spread the seed and stream out over the state with splitmix64, as recommended for xoshiro
+    unsigned long long mix = ((unsigned long long)seed << 32) | stream;
+    for (int i = 0; i < 4; i += 2)
+    {
+        mix += 0x9E3779B97F4A7C15ULL;
+        unsigned long long z = mix;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        m_State[i] = (unsigned int)z;
+        m_State[i + 1] = (unsigned int)(z >> 32);
+    }
+    if (!(m_State[0] | m_State[1] | m_State[2] | m_State[3]))
+        m_State[0] = 1;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Global function: SeedRand
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Seeds the rand with the current runtime time.
 
-void SeedRand() { srand(time(0)); }
+void SeedRand() { SeedRand((unsigned int)time(0)); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Global function: SeedRand
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Seeds the rand with a specific value.
+
+void SeedRand(unsigned int seed)
+{
+    s_RandSeed = seed;
+    s_RandSeedGeneration++;
+    // The calling thread restarts on stream 0 right away
+    s_ThreadRandom.m_Stream = 0;
+    s_ThreadRandom.m_Generation = s_RandSeedGeneration;
+    s_ThreadRandom.m_Random.Seed(seed, 0);
+    // Libraries that still use the CRT rand() get the same seed
+    srand(seed);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Global function: GetRandSeed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the seed that the rand was last seeded with.
+
+unsigned int GetRandSeed() { return s_RandSeed; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Global function: SetThreadRandom
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes the global rand functions of the calling thread draw from a
+//                  stream owned by the caller, until cleared again.
+
+void SetThreadRandom(RandomStream *pRandom)
+{
+    s_ThreadRandom.m_pOverride = pRandom;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Global function: GetThreadRandom
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the stream that the global rand functions of the calling thread
+//                  draw from.
+
+RandomStream & GetThreadRandom()
+{
+    ThreadRandom &threadRandom = s_ThreadRandom;
+    if (threadRandom.m_pOverride)
+        return *threadRandom.m_pOverride;
+    // Restart on our stream of the new seed if it's been reseeded since we last drew
+    if (threadRandom.m_Generation != s_RandSeedGeneration.load(std::memory_order_relaxed))
+    {
+        threadRandom.m_Generation = s_RandSeedGeneration;
+        threadRandom.m_Random.Seed(s_RandSeed, threadRandom.m_Stream);
+    }
+    return threadRandom.m_Random;
+}
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Global function: PosRand
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     A good rand function that return a float between 0.0 and 0.999
+// Description:     A good rand function that return a float between 0.0 inclusive and
+//                  1.0 exclusive.
 
 double PosRand()
 {
-    return (rand() / (RAND_MAX / 1000 + 1)) / 1000.0;
+    return GetThreadRandom().PosRand();
 }
 
 
@@ -52,7 +159,7 @@ double PosRand()
 
 double NormalRand()
 {
-    return (static_cast<double>(rand()) / (RAND_MAX / 2)) - 1.0;
+    return GetThreadRandom().NormalRand();
 }
 
 
@@ -64,7 +171,7 @@ double NormalRand()
 
 double RangeRand(float min, float max)
 {
-    return min + ((max - min) * PosRand());
+    return GetThreadRandom().RangeRand(min, max);
 }
 
 
@@ -75,7 +182,7 @@ double RangeRand(float min, float max)
 
 int SelectRand(int min, int max)
 {
-    return min + (int)((max - min) * PosRand() + 0.5);
+    return GetThreadRandom().SelectRand(min, max);
 }
 
 
@@ -35,6 +35,117 @@ const double SixteenthPI = 0.1963495408;
 class Vector;
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Class:           RandomStream
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     A small and fast xoshiro128** random number generator. Each stream
+//                  is derived from a seed and a stream index, so that many independent
+//                  sequences can be drawn from the same seed without stepping on each
+//                  other. The global rand functions below each draw from one of these
+//                  per thread, and objects that want a sequence of their own that isn't
+//                  affected by the order things update in can hold one too.
+// Parent(s):       None.
+// Class history:   10/19/2026 RandomStream created.
+
+class RandomStream
+{
+
+public:
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Constructor:     RandomStream
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Constructor method used to instantiate a RandomStream object in system
+//                  memory.
+// Arguments:       The seed to start from.
+//                  Which of the streams of that seed to draw from.
+
+    RandomStream(unsigned int seed = 0, unsigned int stream = 0) { Seed(seed, stream); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Seed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Restarts this at the beginning of one of the streams of a seed.
+// Arguments:       The seed to start from.
+//                  Which of the streams of that seed to draw from.
+// Return value:    None.
+
+    void Seed(unsigned int seed, unsigned int stream);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Next
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Advances the stream and gets the next raw value from it.
+// Arguments:       None.
+// Return value:    A value evenly distributed over the whole unsigned 32 bit range.
+
+    unsigned int Next()
+    {
+        unsigned int result = RotateLeft(m_State[1] * 5, 7) * 9;
+        unsigned int t = m_State[1] << 9;
+        m_State[2] ^= m_State[0];
+        m_State[3] ^= m_State[1];
+        m_State[1] ^= m_State[2];
+        m_State[0] ^= m_State[3];
+        m_State[2] ^= t;
+        m_State[3] = RotateLeft(m_State[3], 11);
+        return result;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          PosRand
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a floating point value between 0.0 inclusive and 1.0 exclusive.
+// Arguments:       None.
+// Return value:    The random value.
+
+    double PosRand() { return (Next() >> 8) * (1.0 / 16777216.0); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          NormalRand
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a floating point value between -1.0 and 1.0, both inclusive.
+// Arguments:       None.
+// Return value:    The random value.
+
+    double NormalRand() { return (Next() >> 8) * (2.0 / 16777215.0) - 1.0; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RangeRand
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a floating point value between two given thresholds, the min
+//                  being inclusive, but the max not.
+// Arguments:       The thresholds.
+// Return value:    The random value.
+
+    double RangeRand(float min, float max) { return min + ((max - min) * PosRand()); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SelectRand
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets an int between min and max, both inclusive.
+// Arguments:       The thresholds.
+// Return value:    The random value.
+
+    int SelectRand(int min, int max) { return min + (int)((max - min) * PosRand() + 0.5); }
+
+
+protected:
+
+    static unsigned int RotateLeft(unsigned int value, int bits) { return (value << bits) | (value >> (32 - bits)); }
+
+    // The generator state, never all zero
+    unsigned int m_State[4];
+
+};
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Global function: SeedRand
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -43,10 +154,52 @@ class Vector;
 void SeedRand();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Global function: SeedRand
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Seeds the rand with a specific value, so that a sequence of random
+//                  numbers can be reproduced exactly. The calling thread restarts on
+//                  stream 0 of the seed right away, and every other thread restarts on
+//                  its own stream of it the next time it draws a number.
+
+void SeedRand(unsigned int seed);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Global function: GetRandSeed
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the seed that the rand was last seeded with.
+
+unsigned int GetRandSeed();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Global function: SetThreadRandom
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes the global rand functions of the calling thread draw from a
+//                  stream owned by the caller instead of the thread's own, so that what
+//                  some piece of work draws doesn't depend on which thread it ran on.
+// Arguments:       The stream to draw from, or 0 to go back to the thread's own one.
+//                  Ownership is NOT transferred!
+// Return value:    None.
+
+void SetThreadRandom(RandomStream *pRandom);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Global function: GetThreadRandom
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the stream that the global rand functions of the calling thread
+//                  draw from.
+
+RandomStream & GetThreadRandom();
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Global function: PosRand
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     A good rand function that return a float between 0.0 and 0.999
+// Description:     A good rand function that return a float between 0.0 inclusive and
+//                  1.0 exclusive.
 
 double PosRand();
 
@@ -57,7 +210,7 @@ double PosRand();
 // Description:     A good rand function that returns a floating point value between -1.0
 //                  and 1.0, both inclusive.
 
-double NormalRand()/* { return (static_cast<double>(rand()) / (RAND_MAX / 2)) - 1.0; }*/;
+double NormalRand();
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -66,7 +219,7 @@ double NormalRand()/* { return (static_cast<double>(rand()) / (RAND_MAX / 2)) -
 // Description:     A good rand function that returns a floating point value between two
 //                  given thresholds, the min being inclusive, but the max not.
 
-double RangeRand(float min, float max)/* { return min + ((max - min) * PosRand()); }*/;
+double RangeRand(float min, float max);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -15,6 +15,7 @@
 #include "RTEManagers.h"
 #include "Entity.h"
 #include <map>
+#include <mutex>
 
 #include "allegro.h"
 
@@ -25,6 +26,8 @@ namespace RTE
 {
 
 const string DataModule::m_ClassName = "DataModule";
+// Guards the group search caches, since scripts running on worker threads look up groups too
+static mutex s_GroupSearchCacheMutex;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -46,6 +49,8 @@ void DataModule::Clear()
     m_PresetList.clear();
 	m_EntityList.clear();
     m_TypeMap.clear();
+    m_GroupSearchCache.clear();
+    m_GroupSearchCacheChanges = 0;
     for (int i = 0; i < NUM_PALETTE_ENTRIES; ++i)
         m_MaterialMappings[i] = 0;
 	m_ScanFolderContents = false;
@@ -409,6 +414,8 @@ bool DataModule::AddEntityPreset(Entity *pEntToAdd, bool overwriteSame, string r
             pEntToAdd->Clone(pExistingEntity);
             // Make sure the existing one is still marked as the Original Preset
             pExistingEntity->m_IsOriginalPreset = true;
+            // The new definition may be in different groups
+            m_GroupSearchCache.clear();
             // Alter the instance entry to reflect the data file location of the new definition
             if (readFromFile != "Same")
             {
@@ -583,48 +590,40 @@ bool DataModule::GetAllOfGroup(list<Entity *> &entityList, string group, string
     if (group.empty())
         return false;
 
-    bool foundAny = false;
+    if (type.empty())
+        type = "All";
 
-    // Look in all classes, so only look in the Entity level, which includes all!
-    if (type.empty() || type == "All")
-    {
-        map<string, list<pair<string, Entity *> > >::iterator clsItr = m_TypeMap.find("Entity");
-        if (clsItr == m_TypeMap.end())
-            return false;
+    lock_guard<mutex> cacheLock(s_GroupSearchCacheMutex);
 
-        // Go through only the Entity typelist since it should contain all entitys in this DataModule
-        for (list<pair<string, Entity *> >::iterator instItr = clsItr->second.begin(); instItr != clsItr->second.end(); ++instItr)
-        {
-            // Get the grouped entitys, without transferring ownership
-            if (instItr->second->IsInGroup(group))
-            {
-                entityList.push_back(instItr->second);
-                foundAny = true;
-            }
-        }
-    }
-    // Look only in one specific class (which will get all derived classes' entitys too!)
-    else
+    // Start over if any preset has been put in a new group since the searches were cached
+    if (m_GroupSearchCacheChanges != Entity::GetPresetGroupChanges())
     {
-        // Look for the class entry
-        map<string, list<pair<string, Entity *> > >::iterator clsItr = m_TypeMap.find(type);
-        if (clsItr == m_TypeMap.end())
-            return 0;
+        m_GroupSearchCache.clear();
+        m_GroupSearchCacheChanges = Entity::GetPresetGroupChanges();
+    }
 
-        AAssert(!clsItr->second.empty(), "DataModule has class entry without instances in its map!?");
+    map<pair<string, string>, list<Entity *> >::iterator cacheItr = m_GroupSearchCache.find(pair<string, string>(group, type));
+    if (cacheItr == m_GroupSearchCache.end())
+    {
+        cacheItr = m_GroupSearchCache.insert(pair<pair<string, string>, list<Entity *> >(pair<string, string>(group, type), list<Entity *>())).first;
 
-        for (list<pair<string, Entity *> >::iterator instItr = clsItr->second.begin(); instItr != clsItr->second.end(); ++instItr)
+        // Look in all classes, so only look in the Entity level, which includes all!
+        // Otherwise look only in one specific class (which will get all derived classes' entitys too!)
+        map<string, list<pair<string, Entity *> > >::iterator clsItr = m_TypeMap.find(type == "All" ? "Entity" : type);
+        if (clsItr != m_TypeMap.end())
         {
-            // Get the grouped entitys, without transferring ownership
-            if (instItr->second->IsInGroup(group))
+            for (list<pair<string, Entity *> >::iterator instItr = clsItr->second.begin(); instItr != clsItr->second.end(); ++instItr)
             {
-                entityList.push_back(instItr->second);
-                foundAny = true;
+                // Get the grouped entitys, without transferring ownership
+                if (instItr->second->IsInGroup(group))
+                    cacheItr->second.push_back(instItr->second);
             }
         }
     }
 
-    return foundAny;
+    entityList.insert(entityList.end(), cacheItr->second.begin(), cacheItr->second.end());
+
+    return !cacheItr->second.empty();
 }
 
 
@@ -741,6 +740,9 @@ bool DataModule::AddToTypeMap(Entity *pEntToAdd)
     if (!pEntToAdd || pEntToAdd->GetPresetName() == "None" || pEntToAdd->GetPresetName().empty())
         return false;
 
+    // Any cached group searches could be missing the new entity
+    m_GroupSearchCache.clear();
+
     // Walk up the class hierarchy till we reach the top, adding an entry of the passed in entity into each typelist as we go along
     for (const Entity::ClassInfo *pClass = &(pEntToAdd->GetClass()); pClass != 0; pClass = pClass->GetParent())
     {
@@ -520,6 +520,11 @@ protected:
     // There can be multiple entries of the same instance name in any of the type submaps, but only ONE whose exact class is that of the typelist!
     // The Entity instaces are NOT owned by this map.
     std::map<std::string, std::list<std::pair<std::string, Entity *> > > m_TypeMap;
+    // Results of GetAllOfGroup by group and type, so opening the same menu category again doesn't have to search every preset.
+    // Cleared whenever presets are added to this or any original preset is added to a group
+    std::map<std::pair<std::string, std::string>, std::list<Entity *> > m_GroupSearchCache;
+    // The Entity::GetPresetGroupChanges count the group search cache is up to date with
+    long m_GroupSearchCacheChanges;
 
     // List of all Entity groups ever registered in this, all uniques
     std::list<std::string> m_GroupRegister;
@@ -0,0 +1,339 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// File:            InputRecorder.cpp
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Source file for the InputRecorder class.
+// Project:         Retro Terrain Engine
+// Author(s):
+//
+//
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Inclusions of header files
+
+#include "InputRecorder.h"
+#include "DDTError.h"
+#include "allegro.h"
+#include <cstring>
+
+using namespace std;
+
+namespace RTE
+{
+
+// The size of the device state that TransferDevices walks over
+static const int s_StateSize = KEY_MAX + 2 + 11 + 1 + MAX_JOYSTICKS * (4 + MAX_JOYSTICK_BUTTONS + MAX_JOYSTICK_STICKS * (3 + MAX_JOYSTICK_AXIS * 4));
+
+// The run count that marks the end of the log
+static const int s_EndOfLog = 0xFFFF;
+
+
+static void WriteString(PACKFILE *pFile, const string &text)
+{
+    pack_mputl((long)text.size(), pFile);
+    pack_fwrite(text.c_str(), (long)text.size(), pFile);
+}
+
+static string ReadString(PACKFILE *pFile)
+{
+    long length = pack_mgetl(pFile);
+    if (length <= 0)
+        return "";
+    vector<char> text(length);
+    if (pack_fread(&text[0], length, pFile) != length)
+        return "";
+    return string(text.begin(), text.end());
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StartRecording
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Starts a new recording in the record path, ending any previous one.
+
+bool InputRecorder::StartRecording(const SessionInfo &session)
+{
+    Stop();
+
+    if (m_RecordPath.empty() || !(m_pFile = pack_fopen(m_RecordPath.c_str(), F_WRITE_PACKED)))
+        return false;
+
+    m_Session = session;
+    pack_mputl(RECORDMAGIC, m_pFile);
+    pack_mputl(RECORDVERSION, m_pFile);
+    pack_mputl(s_StateSize, m_pFile);
+    pack_mputl(m_Session.m_Seed, m_pFile);
+    long deltaTimeBits;
+    memcpy(&deltaTimeBits, &m_Session.m_DeltaTimeSecs, sizeof(float));
+    pack_mputl(deltaTimeBits, m_pFile);
+    WriteString(m_pFile, m_Session.m_SceneName);
+    pack_putc(m_Session.m_PlaceObjects ? 1 : 0, m_pFile);
+    pack_putc(m_Session.m_PlaceUnits ? 1 : 0, m_pFile);
+    WriteString(m_pFile, m_Session.m_ActivityClass);
+    WriteString(m_pFile, m_Session.m_ActivityName);
+    WriteString(m_pFile, m_Session.m_ActivityModule);
+    WriteString(m_pFile, m_Session.m_ActivityData);
+
+    m_State.assign(s_StateSize, 0);
+    m_LastState.assign(s_StateSize, 0);
+    m_Events.clear();
+    m_FrameOpen = false;
+    m_FrameCount = 0;
+    m_Recording = true;
+
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StartReplay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Opens a log file and reads its session info, ending any recording or
+//                  replay in progress.
+
+bool InputRecorder::StartReplay(const string &replayPath)
+{
+    Stop();
+
+    if (!(m_pFile = pack_fopen(replayPath.c_str(), F_READ_PACKED)))
+        return false;
+
+    bool valid = pack_mgetl(m_pFile) == RECORDMAGIC && pack_mgetl(m_pFile) == RECORDVERSION && pack_mgetl(m_pFile) == s_StateSize;
+    if (valid)
+    {
+        m_Session.m_Seed = pack_mgetl(m_pFile);
+        long deltaTimeBits = pack_mgetl(m_pFile);
+        memcpy(&m_Session.m_DeltaTimeSecs, &deltaTimeBits, sizeof(float));
+        m_Session.m_SceneName = ReadString(m_pFile);
+        m_Session.m_PlaceObjects = pack_getc(m_pFile) == 1;
+        m_Session.m_PlaceUnits = pack_getc(m_pFile) == 1;
+        m_Session.m_ActivityClass = ReadString(m_pFile);
+        m_Session.m_ActivityName = ReadString(m_pFile);
+        m_Session.m_ActivityModule = ReadString(m_pFile);
+        m_Session.m_ActivityData = ReadString(m_pFile);
+        valid = !pack_feof(m_pFile);
+    }
+
+    if (!valid)
+    {
+        pack_fclose(m_pFile);
+        m_pFile = 0;
+        return false;
+    }
+
+    m_State.assign(s_StateSize, 0);
+    m_LastState.assign(s_StateSize, 0);
+    m_Events.clear();
+    m_FrameCount = 0;
+    m_Replaying = true;
+
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Stop
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Finishes and closes the log file of any recording or replay.
+
+void InputRecorder::Stop()
+{
+    if (m_Recording)
+    {
+        if (m_FrameOpen)
+            WriteFrame();
+        pack_mputw(s_EndOfLog, m_pFile);
+    }
+    if (m_pFile)
+        pack_fclose(m_pFile);
+
+    m_pFile = 0;
+    m_Recording = false;
+    m_Replaying = false;
+    m_FrameOpen = false;
+    m_Events.clear();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateDevices
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Starts the next sim update, logging or overwriting the state of the
+//                  Allegro keyboard, mouse and joystick globals.
+
+void InputRecorder::UpdateDevices(int &mickeyX, int &mickeyY)
+{
+    if (m_Recording)
+    {
+        // The last update is done now, events and all
+        if (m_FrameOpen)
+            WriteFrame();
+        TransferDevices(mickeyX, mickeyY);
+        m_FrameOpen = true;
+        m_FrameCount++;
+    }
+    else if (m_Replaying)
+    {
+        if (!ReadFrame())
+        {
+            Stop();
+            return;
+        }
+        TransferDevices(mickeyX, mickeyY);
+        m_FrameCount++;
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RecordEvent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Logs an input event as having happened during the current sim update.
+
+void InputRecorder::RecordEvent(int type, int player, const void *pData, int size)
+{
+    if (!m_Recording || !m_FrameOpen)
+        return;
+
+    InputEvent event;
+    event.m_Type = type;
+    event.m_Player = player;
+    event.m_Data.assign((const unsigned char *)pData, (const unsigned char *)pData + size);
+    m_Events.push_back(event);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          TransferDevices
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Walks over all the logged device state, copying it in the direction
+//                  of the current mode.
+
+void InputRecorder::TransferDevices(int &mickeyX, int &mickeyY)
+{
+    m_Cursor = 0;
+
+    for (int i = 0; i < KEY_MAX; ++i)
+        Transfer(key[i], 1);
+    Transfer(key_shifts, 2);
+
+    Transfer(mouse_b, 1);
+    Transfer(mouse_x, 2);
+    Transfer(mouse_y, 2);
+    Transfer(mouse_z, 2);
+    Transfer(mickeyX, 2);
+    Transfer(mickeyY, 2);
+
+    // Log all the slots whether there's a joystick in them or not, so the layout never changes
+    Transfer(num_joysticks, 1);
+    for (int joystick = 0; joystick < MAX_JOYSTICKS; ++joystick)
+    {
+        JOYSTICK_INFO &info = joy[joystick];
+        Transfer(info.flags, 2);
+        Transfer(info.num_sticks, 1);
+        Transfer(info.num_buttons, 1);
+        for (int button = 0; button < MAX_JOYSTICK_BUTTONS; ++button)
+            Transfer(info.button[button].b, 1);
+        for (int stick = 0; stick < MAX_JOYSTICK_STICKS; ++stick)
+        {
+            Transfer(info.stick[stick].flags, 2);
+            Transfer(info.stick[stick].num_axis, 1);
+            for (int axis = 0; axis < MAX_JOYSTICK_AXIS; ++axis)
+            {
+                Transfer(info.stick[stick].axis[axis].pos, 2);
+                Transfer(info.stick[stick].axis[axis].d1, 1);
+                Transfer(info.stick[stick].axis[axis].d2, 1);
+            }
+        }
+    }
+
+    DAssert(m_Cursor == s_StateSize, "InputRecorder device state layout doesn't match its size!");
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WriteFrame
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Logs the bytes of m_State that changed since the last update,
+//                  followed by the events of the update.
+
+void InputRecorder::WriteFrame()
+{
+    // Find the runs of changed bytes, bridging short unchanged gaps since each run costs 3 bytes
+    vector<pair<int, int> > runs;
+    for (int i = 0; i < s_StateSize; ++i)
+    {
+        if (m_State[i] == m_LastState[i])
+            continue;
+        if (!runs.empty() && i - (runs.back().first + runs.back().second) <= 3 && i - runs.back().first < 255)
+            runs.back().second = i - runs.back().first + 1;
+        else
+            runs.push_back(pair<int, int>(i, 1));
+    }
+
+    pack_mputw((int)runs.size(), m_pFile);
+    for (vector<pair<int, int> >::iterator rItr = runs.begin(); rItr != runs.end(); ++rItr)
+    {
+        pack_mputw(rItr->first, m_pFile);
+        pack_putc(rItr->second, m_pFile);
+        pack_fwrite(&m_State[rItr->first], rItr->second, m_pFile);
+    }
+
+    pack_mputw((int)m_Events.size(), m_pFile);
+    for (vector<InputEvent>::iterator eItr = m_Events.begin(); eItr != m_Events.end(); ++eItr)
+    {
+        pack_putc(eItr->m_Type, m_pFile);
+        pack_putc(eItr->m_Player, m_pFile);
+        pack_mputw((int)eItr->m_Data.size(), m_pFile);
+        if (!eItr->m_Data.empty())
+            pack_fwrite(&eItr->m_Data[0], (long)eItr->m_Data.size(), m_pFile);
+    }
+
+    m_LastState = m_State;
+    m_Events.clear();
+    m_FrameOpen = false;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ReadFrame
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Reads the changed bytes of the next update into m_State, and its
+//                  events into m_Events.
+
+bool InputRecorder::ReadFrame()
+{
+    m_Events.clear();
+
+    int runCount = pack_mgetw(m_pFile);
+    if (runCount == EOF || runCount == s_EndOfLog)
+        return false;
+
+    for (int run = 0; run < runCount; ++run)
+    {
+        int offset = pack_mgetw(m_pFile);
+        int length = pack_getc(m_pFile);
+        if (offset < 0 || length <= 0 || offset + length > s_StateSize || pack_fread(&m_State[offset], length, m_pFile) != length)
+            return false;
+    }
+
+    int eventCount = pack_mgetw(m_pFile);
+    if (eventCount == EOF)
+        return false;
+    m_Events.resize(eventCount);
+    for (vector<InputEvent>::iterator eItr = m_Events.begin(); eItr != m_Events.end(); ++eItr)
+    {
+        eItr->m_Type = pack_getc(m_pFile);
+        eItr->m_Player = pack_getc(m_pFile);
+        int size = pack_mgetw(m_pFile);
+        if (size < 0)
+            return false;
+        eItr->m_Data.resize(size);
+        if (size > 0 && pack_fread(&eItr->m_Data[0], size, m_pFile) != size)
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace RTE
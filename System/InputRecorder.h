@@ -0,0 +1,347 @@
+#ifndef _RTEINPUTRECORDER_
+#define _RTEINPUTRECORDER_
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// File:            InputRecorder.h
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Header file for the InputRecorder class.
+// Project:         Retro Terrain Engine
+// Author(s):
+//
+//
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Inclusions of header files
+
+#include <string>
+#include <vector>
+
+struct PACKFILE;
+
+namespace RTE
+{
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Class:           InputRecorder
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Records the raw keyboard, mouse and joystick state of every sim update
+//                  of an activity, along with any input events that came in from
+//                  elsewhere (like network clients), and the seed and setup the activity
+//                  was started with, into a compact packed log file. The log can then be
+//                  fed back in place of the real devices to play the exact same session
+//                  out again, as fast as the sim can go.
+// Parent(s):       None.
+// Class history:   10/19/2026 InputRecorder created.
+
+class InputRecorder
+{
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Public member variable, method and friend function declarations
+
+public:
+
+    enum EventType
+    {
+        // A NetworkClient::MsgInput received by the server from a client
+        EVENT_NETWORKINPUT = 0
+    };
+
+    enum
+    {
+        RECORDMAGIC = 0x52544952,
+        RECORDVERSION = 2
+    };
+
+    // Everything needed to start the recorded activity again the same way
+    struct SessionInfo
+    {
+        unsigned int m_Seed;
+        float m_DeltaTimeSecs;
+        std::string m_SceneName;
+        bool m_PlaceObjects;
+        bool m_PlaceUnits;
+        std::string m_ActivityClass;
+        std::string m_ActivityName;
+        // The module the start activity was defined in, and the whole start activity as
+        // written out by a Writer, with everything the setup screens changed on it
+        std::string m_ActivityModule;
+        std::string m_ActivityData;
+    };
+
+    // An input event that happened during a sim update
+    struct InputEvent
+    {
+        unsigned char m_Type;
+        unsigned char m_Player;
+        std::vector<unsigned char> m_Data;
+    };
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Constructor:     InputRecorder
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Constructor method used to instantiate a InputRecorder object in
+//                  system memory.
+// Arguments:       None.
+
+    InputRecorder() { m_pFile = 0; m_Recording = false; m_Replaying = false; m_FrameOpen = false; m_FrameCount = 0; m_Cursor = 0; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Destructor:      ~InputRecorder
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destructor method used to clean up a InputRecorder object before
+//                  deletion from system memory.
+// Arguments:       None.
+
+    ~InputRecorder() { Stop(); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetRecordPath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the file that each started activity gets recorded to. Each new
+//                  activity overwrites the recording of the last one.
+// Arguments:       The path of the log file. Empty disables recording.
+// Return value:    None.
+
+    void SetRecordPath(const std::string &recordPath) { m_RecordPath = recordPath; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetRecordPath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the file that each started activity gets recorded to.
+// Arguments:       None.
+// Return value:    The path of the log file. Empty if recording is disabled.
+
+    const std::string & GetRecordPath() const { return m_RecordPath; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StartRecording
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Starts a new recording in the record path, ending any previous one.
+// Arguments:       How the activity that is being recorded was started.
+// Return value:    Whether the log file could be opened.
+
+    bool StartRecording(const SessionInfo &session);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StartReplay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Opens a log file and reads its session info, ending any recording or
+//                  replay in progress. The session should then be started as described,
+//                  after which each sim update reads its input from the log.
+// Arguments:       The path of the log file.
+// Return value:    Whether the log file could be opened and is of a known version.
+
+    bool StartReplay(const std::string &replayPath);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Stop
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Finishes and closes the log file of any recording or replay.
+// Arguments:       None.
+// Return value:    None.
+
+    void Stop();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsRecording
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether sim updates are being recorded.
+// Arguments:       None.
+// Return value:    Whether a recording is in progress.
+
+    bool IsRecording() const { return m_Recording; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsReplaying
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether sim updates are being read from a log. This turns false
+//                  once the end of the log has been reached.
+// Arguments:       None.
+// Return value:    Whether a replay is in progress.
+
+    bool IsReplaying() const { return m_Replaying; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetSession
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how the activity being recorded or replayed was started.
+// Arguments:       None.
+// Return value:    The session info.
+
+    const SessionInfo & GetSession() const { return m_Session; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static method:   GetActivityFilePath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the file the start activity of a session is written to and read
+//                  back from on its way into and out of the log, since Writers and
+//                  Readers only work on files. It's inside the activity's own module, so
+//                  the presets it refers to resolve the same way they did originally.
+// Arguments:       The session.
+// Return value:    The file path.
+
+    static std::string GetActivityFilePath(const SessionInfo &session) { return session.m_ActivityModule + "/InputLogActivity.ini"; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetFrameCount
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many sim updates have been recorded or replayed so far.
+// Arguments:       None.
+// Return value:    The number of sim updates.
+
+    long GetFrameCount() const { return m_FrameCount; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateDevices
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Starts the next sim update. When recording, the polled state of the
+//                  Allegro keyboard, mouse and joystick globals is logged. When
+//                  replaying, those globals are instead overwritten with the logged
+//                  state, and the events of the update are read in.
+// Arguments:       The mouse mickeys of this update. Overwritten when replaying.
+// Return value:    None.
+
+    void UpdateDevices(int &mickeyX, int &mickeyY);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RecordEvent
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Logs an input event as having happened during the current sim update.
+// Arguments:       The EventType of the event.
+//                  Which player the event belongs to.
+//                  The event's data, and its size in bytes.
+// Return value:    None.
+
+    void RecordEvent(int type, int player, const void *pData, int size);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetReplayEvents
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the logged events of the current sim update when replaying.
+// Arguments:       None.
+// Return value:    The events, in the order they happened.
+
+    const std::vector<InputEvent> & GetReplayEvents() const { return m_Events; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Protected member variable and method declarations
+
+protected:
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          TransferDevices
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Walks over all the logged device state, copying it from the Allegro
+//                  globals into m_State when recording, or the other way around when
+//                  replaying. Keeping both directions in one place keeps the layout of
+//                  the state in sync.
+// Arguments:       The mouse mickeys of this update.
+// Return value:    None.
+
+    void TransferDevices(int &mickeyX, int &mickeyY);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Transfer
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Copies one value between m_State and where it lives, in the direction
+//                  of the current mode, and advances the cursor past it.
+// Arguments:       The value.
+//                  How many bytes of it to keep, 1 or 2.
+// Return value:    None.
+
+    template <typename Type> void Transfer(Type &target, int bytes)
+    {
+        if (m_Replaying)
+        {
+            int value = bytes == 1 ? (signed char)m_State[m_Cursor] : (short)(m_State[m_Cursor] | (m_State[m_Cursor + 1] << 8));
+            target = (Type)value;
+        }
+        else
+        {
+            int value = (int)target;
+            m_State[m_Cursor] = value & 0xFF;
+            if (bytes == 2)
+                m_State[m_Cursor + 1] = (value >> 8) & 0xFF;
+        }
+        m_Cursor += bytes;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WriteFrame
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Logs the bytes of m_State that changed since the last update,
+//                  followed by the events of the update.
+// Arguments:       None.
+// Return value:    None.
+
+    void WriteFrame();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ReadFrame
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Reads the changed bytes of the next update into m_State, and its
+//                  events into m_Events.
+// Arguments:       None.
+// Return value:    Whether there was another update in the log.
+
+    bool ReadFrame();
+
+
+    // The file new recordings go to
+    std::string m_RecordPath;
+    // The log being written or read, 0 if none
+    PACKFILE *m_pFile;
+    bool m_Recording;
+    bool m_Replaying;
+    // Whether the current update's device state has been logged but its events not yet
+    bool m_FrameOpen;
+    // How many sim updates have been logged or read
+    long m_FrameCount;
+    SessionInfo m_Session;
+    // The device state of the current and last update
+    std::vector<unsigned char> m_State;
+    std::vector<unsigned char> m_LastState;
+    // Where TransferDevices is in m_State
+    int m_Cursor;
+    // The events of the current update
+    std::vector<InputEvent> m_Events;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Private member variable and method declarations
+
+private:
+
+    // Disallow the use of some implicit methods.
+    InputRecorder(const InputRecorder &reference);
+    InputRecorder & operator=(const InputRecorder &rhs);
+
+};
+
+} // namespace RTE
+
+#endif // File
@@ -15,6 +15,13 @@
 #include "DDTTools.h"
 #include "SceneMan.h"
 #include "Scene.h"
+#include "SLTerrain.h"
+#include "PerformanceMan.h"
+#include "System.h"
+#include "allegro.h"
+#include <queue>
+#include <functional>
+#include <thread>
 
 using namespace std;
 
@@ -34,6 +41,14 @@ void PathFinder::Clear()
     m_NodeDimension = 20;
     m_DigStrenght = 1;
     m_pPather = 0;
+    m_Clusters.clear();
+    m_ClusterXCount = 0;
+    m_ClusterYCount = 0;
+    m_Portals.clear();
+    m_DigClasses.clear();
+    m_WrapsX = false;
+    m_WrapsY = false;
+    m_CostCacheKey = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -41,7 +56,7 @@ void PathFinder::Clear()
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Makes the PathFinder object ready for use.
 
-int PathFinder::Create(Scene *pScene, int nodeDimension, unsigned int allocate)
+int PathFinder::Create(Scene *pScene, int nodeDimension, unsigned int allocate, bool setUpCosts)
 {
     DAssert(pScene, "Scene doesn't exist or isn't loaded when creating PathFinder!");
 
@@ -72,6 +87,8 @@ int PathFinder::Create(Scene *pScene, int nodeDimension, unsigned int allocate)
                 nodePos.m_Y = sceneHeight - 1;
             // Create the new node with its in-scene position in the center of it
             pNode = new PathNode(nodePos);
+            pNode->m_GridX = x;
+            pNode->m_GridY = y;
             // Move current position down for the next node in the column
             nodePos.m_Y += nodeDimension;
             // Add the newly created node to the column, transferring ownership to it
@@ -130,6 +147,9 @@ int PathFinder::Create(Scene *pScene, int nodeDimension, unsigned int allocate)
     // Create and allocate the pather class which will do the work
     m_pPather = new MicroPather(this, allocate);
 
+    // Lay out the clusters and portals for the hierarchical search over long distances
+    CreateClusters(pScene->WrapsX(), pScene->WrapsY());
+
     // If the scene wraps we must find the cost over the seam before doing RecalculateAllCosts() the first time
     // since the cost is equal to max(pNode->m_LeftCost, pNode->m_pLeft->m_RightCost)
     if (pScene->WrapsX())
@@ -142,8 +162,12 @@ int PathFinder::Create(Scene *pScene, int nodeDimension, unsigned int allocate)
         }
     }
 
-    // Set up all the costs between all nodes
-    RecalculateAllCosts();
+    // Set up all the costs between all nodes, straight from the cache if the terrain is the same as last time they were calculated
+    if (setUpCosts && !LoadCachedCosts())
+    {
+        RecalculateAllCosts();
+        SaveCachedCosts();
+    }
 
     return 0;
 }
@@ -182,24 +206,285 @@ void PathFinder::RecalculateAllCosts()
 {
     DAssert(g_SceneMan.GetScene(), "Scene doesn't exist or isn't loaded when recalculating PathFinder!");
 
+    int nodeXCount = m_NodeGrid.size();
+    if (nodeXCount == 0)
+        return;
+    int nodeYCount = m_NodeGrid[0].size();
+
+    // The line casts of the four directions whose cost depends on the adjacent node's opposite one are kept here until all are done
+    vector<float> castCosts(nodeXCount * nodeYCount * 4, 0);
+
+    // Split the grid into bands of columns and cast them all in parallel, the last band on this thread
+    int threadCount = max(1, min((int)thread::hardware_concurrency(), nodeXCount));
+    int bandWidth = (nodeXCount + threadCount - 1) / threadCount;
+    vector<thread> workers;
+    for (int firstX = 0; firstX < nodeXCount; firstX += bandWidth)
+    {
+        if (firstX + bandWidth >= nodeXCount)
+            CastNodeCostsInBand(firstX, nodeXCount, &castCosts);
+        else
+            workers.push_back(thread(&PathFinder::CastNodeCostsInBand, this, firstX, firstX + bandWidth, &castCosts));
+    }
+    for (vector<thread>::iterator tItr = workers.begin(); tItr != workers.end(); ++tItr)
+        (*tItr).join();
+
+    // Now that every node's own costs are in, take the max of each pair of opposite directions like UpdateNodeCosts does
     PathNode *pNode = 0;
-    for (int x = 0; x < m_NodeGrid.size(); ++x)
+    float *pCast = 0;
+    for (int x = 0; x < nodeXCount; ++x)
     {
-        // Update all the costs going out from each node
-        for (int y = 0; y < m_NodeGrid[x].size(); ++y)
+        for (int y = 0; y < nodeYCount; ++y)
         {
             pNode = m_NodeGrid[x][y];
-            UpdateNodeCosts(pNode);
+            pCast = &castCosts[(x * nodeYCount + y) * 4];
+            if (pNode->m_pUp)
+                pNode->m_UpCost = max(pNode->m_pUp->m_DownCost, pCast[0]);
+            if (pNode->m_pLeft)
+                pNode->m_LeftCost = max(pNode->m_pLeft->m_RightCost, pCast[1]);
+            if (pNode->m_pUpRight)
+                pNode->m_UpRightCost = max(pNode->m_pUpRight->m_DownLeftCost, pCast[2]);
+            if (pNode->m_pLeftUp)
+                pNode->m_LeftUpCost = max(pNode->m_pLeftUp->m_RightDownCost, pCast[3]);
             // Should reset the changed flag since we're about to reset the pather
             pNode->m_IsChanged = false;
         }
     }
 
+    // All cached portal costs are stale
+    for (vector<PathCluster>::iterator cItr = m_Clusters.begin(); cItr != m_Clusters.end(); ++cItr)
+        (*cItr).m_Version++;
+
     // Reset the pather when costs change, as per the docs
     m_pPather->Reset();
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastNodeCostsInBand
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts the cost lines going out from every node in a band of columns.
+//                  Only reads the terrain and writes to the nodes of the band, so several
+//                  bands can be done at once.
+
+void PathFinder::CastNodeCostsInBand(int firstX, int endX, vector<float> *pCastCosts)
+{
+    int nodeYCount = m_NodeGrid[0].size();
+    PathNode *pNode = 0;
+    float *pCast = 0;
+    for (int x = firstX; x < endX; ++x)
+    {
+        for (int y = 0; y < nodeYCount; ++y)
+        {
+            pNode = m_NodeGrid[x][y];
+            pCast = &(*pCastCosts)[(x * nodeYCount + y) * 4];
+
+            // Same offset lines as UpdateNodeCosts
+            if (pNode->m_pUp)
+                pCast[0] = CostAlongLine(pNode->m_Pos+Vector(3,0), pNode->m_pUp->m_Pos+Vector(3,0));
+            if (pNode->m_pRight)
+                pNode->m_RightCost = CostAlongLine(pNode->m_Pos+Vector(0,3), pNode->m_pRight->m_Pos+Vector(0,3));
+            if (pNode->m_pDown)
+                pNode->m_DownCost = CostAlongLine(pNode->m_Pos+Vector(-3,0), pNode->m_pDown->m_Pos+Vector(-3,0));
+            if (pNode->m_pLeft)
+                pCast[1] = CostAlongLine(pNode->m_Pos+Vector(0,-3), pNode->m_pLeft->m_Pos+Vector(0,-3));
+
+            if (pNode->m_pUpRight)
+                pCast[2] = CostAlongLine(pNode->m_Pos+Vector(2,2), pNode->m_pUpRight->m_Pos+Vector(2,2));
+            if (pNode->m_pRightDown)
+                pNode->m_RightDownCost = CostAlongLine(pNode->m_Pos+Vector(2,-2), pNode->m_pRightDown->m_Pos+Vector(2,-2));
+            if (pNode->m_pDownLeft)
+                pNode->m_DownLeftCost = CostAlongLine(pNode->m_Pos+Vector(-2,-2), pNode->m_pDownLeft->m_Pos+Vector(-2,-2));
+            if (pNode->m_pLeftUp)
+                pCast[3] = CostAlongLine(pNode->m_Pos+Vector(-2,2), pNode->m_pLeftUp->m_Pos+Vector(-2,2));
+        }
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CalculateCostCacheKey
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Hashes everything the node costs depend on: the terrain material
+//                  bitmap, the material strengths and the layout of the node grid.
+
+unsigned long long PathFinder::CalculateCostCacheKey() const
+{
+    // FNV-1a, 64 bit
+    unsigned long long hash = 14695981039346656037ULL;
+    const unsigned long long prime = 1099511628211ULL;
+
+    int layout[5] = { m_NodeDimension, (int)m_NodeGrid.size(), m_NodeGrid.empty() ? 0 : (int)m_NodeGrid[0].size(), m_WrapsX, m_WrapsY };
+    const unsigned char *pBytes = (const unsigned char *)layout;
+    for (int i = 0; i < (int)sizeof(layout); ++i)
+        hash = (hash ^ pBytes[i]) * prime;
+
+    for (int id = 0; id < 256; ++id)
+    {
+        float strength = g_SceneMan.GetMaterialFromID(id)->strength;
+        pBytes = (const unsigned char *)&strength;
+        for (int i = 0; i < (int)sizeof(strength); ++i)
+            hash = (hash ^ pBytes[i]) * prime;
+    }
+
+    BITMAP *pMaterials = g_SceneMan.GetScene()->GetTerrain()->GetMaterialBitmap();
+    for (int y = 0; y < pMaterials->h; ++y)
+    {
+        pBytes = pMaterials->line[y];
+        for (int x = 0; x < pMaterials->w; ++x)
+            hash = (hash ^ pBytes[x]) * prime;
+    }
+
+    return hash;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          LoadCachedCosts
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Loads all the node costs from the cache file for the current terrain,
+//                  if there is a valid one.
+
+bool PathFinder::LoadCachedCosts()
+{
+    m_CostCacheKey = CalculateCostCacheKey();
+    return LoadCostCache(m_CostCacheKey);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SaveCachedCosts
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Saves all the node costs to the cache file for the terrain they were
+//                  set up for.
+
+bool PathFinder::SaveCachedCosts() const
+{
+    return SaveCostCache(m_CostCacheKey);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetCostCachePath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the path of the cost cache file for a specific cache key.
+
+string PathFinder::GetCostCachePath(unsigned long long cacheKey) const
+{
+    char fileName[64];
+    sprintf(fileName, "PathCache/%016llx.dat", cacheKey);
+    return fileName;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          LoadCostCache
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Loads all the node costs from the cache file of a specific key, if
+//                  there is one. Also resets the pather itself.
+
+bool PathFinder::LoadCostCache(unsigned long long cacheKey)
+{
+    if (m_NodeGrid.empty())
+        return false;
+
+    PACKFILE *pFile = pack_fopen(GetCostCachePath(cacheKey).c_str(), F_READ);
+    if (!pFile)
+        return false;
+
+    int nodeXCount = m_NodeGrid.size();
+    int nodeYCount = m_NodeGrid[0].size();
+    bool valid = pack_mgetl(pFile) == COSTCACHEMAGIC && pack_mgetl(pFile) == COSTCACHEVERSION;
+    valid = valid && (unsigned long)pack_mgetl(pFile) == (unsigned long)(cacheKey >> 32) && (unsigned long)pack_mgetl(pFile) == (unsigned long)(cacheKey & 0xFFFFFFFF);
+    valid = valid && pack_mgetl(pFile) == nodeXCount && pack_mgetl(pFile) == nodeYCount;
+
+    // Read it all in before touching any nodes, so a truncated file leaves them as they were
+    vector<float> costs(nodeXCount * nodeYCount * 8);
+    if (valid)
+        valid = (size_t)pack_fread(&costs[0], costs.size() * sizeof(float), pFile) == costs.size() * sizeof(float);
+    pack_fclose(pFile);
+
+    if (!valid)
+        return false;
+
+    PathNode *pNode = 0;
+    const float *pCosts = &costs[0];
+    for (int x = 0; x < nodeXCount; ++x)
+    {
+        for (int y = 0; y < nodeYCount; ++y, pCosts += 8)
+        {
+            pNode = m_NodeGrid[x][y];
+            pNode->m_UpCost = pCosts[0];
+            pNode->m_RightCost = pCosts[1];
+            pNode->m_DownCost = pCosts[2];
+            pNode->m_LeftCost = pCosts[3];
+            pNode->m_UpRightCost = pCosts[4];
+            pNode->m_RightDownCost = pCosts[5];
+            pNode->m_DownLeftCost = pCosts[6];
+            pNode->m_LeftUpCost = pCosts[7];
+            pNode->m_IsChanged = false;
+        }
+    }
+
+    for (vector<PathCluster>::iterator cItr = m_Clusters.begin(); cItr != m_Clusters.end(); ++cItr)
+        (*cItr).m_Version++;
+
+    m_pPather->Reset();
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SaveCostCache
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Saves all the node costs to the cache file of a specific key.
+
+bool PathFinder::SaveCostCache(unsigned long long cacheKey) const
+{
+    if (m_NodeGrid.empty())
+        return false;
+
+    g_System.MakeDirectory("PathCache");
+    PACKFILE *pFile = pack_fopen(GetCostCachePath(cacheKey).c_str(), F_WRITE);
+    if (!pFile)
+        return false;
+
+    int nodeXCount = m_NodeGrid.size();
+    int nodeYCount = m_NodeGrid[0].size();
+    vector<float> costs;
+    costs.reserve(nodeXCount * nodeYCount * 8);
+    PathNode *pNode = 0;
+    for (int x = 0; x < nodeXCount; ++x)
+    {
+        for (int y = 0; y < nodeYCount; ++y)
+        {
+            pNode = m_NodeGrid[x][y];
+            costs.push_back(pNode->m_UpCost);
+            costs.push_back(pNode->m_RightCost);
+            costs.push_back(pNode->m_DownCost);
+            costs.push_back(pNode->m_LeftCost);
+            costs.push_back(pNode->m_UpRightCost);
+            costs.push_back(pNode->m_RightDownCost);
+            costs.push_back(pNode->m_DownLeftCost);
+            costs.push_back(pNode->m_LeftUpCost);
+        }
+    }
+
+    pack_mputl(COSTCACHEMAGIC, pFile);
+    pack_mputl(COSTCACHEVERSION, pFile);
+    pack_mputl((long)(cacheKey >> 32), pFile);
+    pack_mputl((long)(cacheKey & 0xFFFFFFFF), pFile);
+    pack_mputl(nodeXCount, pFile);
+    pack_mputl(nodeYCount, pFile);
+    bool written = (size_t)pack_fwrite(&costs[0], costs.size() * sizeof(float), pFile) == costs.size() * sizeof(float);
+    pack_fclose(pFile);
+
+    // Don't let the caches of scenes long gone pile up
+    g_System.TrimDirectory("PathCache", "*.dat", COSTCACHEMAXSIZE);
+
+    return written;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RecalculateAreaCosts
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -287,12 +572,38 @@ int PathFinder::CalculatePath(Vector start, Vector end, list<Vector> &pathResult
     // Clear out the results if it happens to contain anything
     pathResult.clear();
 
-    // Actors capable of digging can use m_DigStrenght to modify the node adjacency cost
-    m_DigStrenght = digStrength;
-    
+    PathNode *pStartNode = m_NodeGrid[startNodeX][startNodeY];
+    PathNode *pEndNode = m_NodeGrid[endNodeX][endNodeY];
+
+    // See how many clusters apart the ends are, to decide whether to go hierarchical
+    int clusterDistX = abs(startNodeX / CLUSTERSIZE - endNodeX / CLUSTERSIZE);
+    if (m_WrapsX && m_ClusterXCount - clusterDistX < clusterDistX)
+        clusterDistX = m_ClusterXCount - clusterDistX;
+    int clusterDistY = abs(startNodeY / CLUSTERSIZE - endNodeY / CLUSTERSIZE);
+    if (m_WrapsY && m_ClusterYCount - clusterDistY < clusterDistY)
+        clusterDistY = m_ClusterYCount - clusterDistY;
+
     // Do the actual pathfinding, fetch out the list of states that comprise the best path
     vector<void *> statePath;
-    int result = m_pPather->Solve((void *)(m_NodeGrid[startNodeX][startNodeY]), (void *)(m_NodeGrid[endNodeX][endNodeY]), &statePath, &totalCostResult);
+    int result = MicroPather::NO_SOLUTION;
+    if (max(clusterDistX, clusterDistY) >= HIERARCHICALDISTANCE)
+    {
+        g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_PATHFINDER_HIERARCHICAL);
+        result = SolveHierarchical(pStartNode, pEndNode, digStrength, statePath, totalCostResult);
+        g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_PATHFINDER_HIERARCHICAL);
+    }
+    else
+    {
+        // MicroPather caches the paths it has solved, which are only valid for the dig strength they were solved with
+        if (digStrength != m_DigStrenght)
+            m_pPather->Reset();
+        // Actors capable of digging can use m_DigStrenght to modify the node adjacency cost
+        m_DigStrenght = digStrength;
+
+        g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_PATHFINDER_SOLVE);
+        result = m_pPather->Solve((void *)pStartNode, (void *)pEndNode, &statePath, &totalCostResult);
+        g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_PATHFINDER_SOLVE);
+    }
 
     // We got something back
     if (!statePath.empty())
@@ -346,69 +657,84 @@ float PathFinder::LeastCostEstimate(void *pStartState, void *pEndState)
 
 void PathFinder::AdjacentCost(void *pState, std::vector<micropather::StateCost> *pAdjacentList)
 {
-    PathNode *pNode = (PathNode *)pState;
+    PathNode *apAdjacent[8];
+    float aCosts[8];
+    int adjacentCount = GetAdjacentNodes((PathNode *)pState, m_DigStrenght, apAdjacent, aCosts);
+
     micropather::StateCost adjCost;
+    for (int i = 0; i < adjacentCount; ++i)
+    {
+        adjCost.cost = aCosts[i];
+        adjCost.state = (void *)apAdjacent[i];
+        pAdjacentList->push_back(adjCost);
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetAdjacentNodes
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets all the nodes adjacent to one and the cost of moving to each, as
+//                  seen by an actor of a specific dig strength.
+
+int PathFinder::GetAdjacentNodes(PathNode *pNode, float digStrength, PathNode **apAdjacent, float *aCosts) const
+{
+    int count = 0;
     float strength = 0;
-    
+
     // Add cost for digging upwards
     if (pNode->m_pUp)
     {
         strength = pNode->m_UpCost;
-        adjCost.cost = 1 + (strength > m_DigStrenght ? strength * 2000 : strength * 4); // Four times more expensive when digging
-        adjCost.state = (void *)pNode->m_pUp;
-        pAdjacentList->push_back(adjCost);
+        aCosts[count] = 1 + (strength > digStrength ? strength * 2000 : strength * 4); // Four times more expensive when digging
+        apAdjacent[count++] = pNode->m_pUp;
     }
     if (pNode->m_pRight)
     {
         strength = pNode->m_RightCost;
-        adjCost.cost = 1 + (strength > m_DigStrenght ? strength * 1000 : strength);
-        adjCost.state = (void *)pNode->m_pRight;
-        pAdjacentList->push_back(adjCost);
+        aCosts[count] = 1 + (strength > digStrength ? strength * 1000 : strength);
+        apAdjacent[count++] = pNode->m_pRight;
     }
     if (pNode->m_pDown)
     {
         strength = pNode->m_DownCost;
-        adjCost.cost = 1 + (strength > m_DigStrenght ? strength * 1000 : strength);
-        adjCost.state = (void *)pNode->m_pDown;
-        pAdjacentList->push_back(adjCost);
+        aCosts[count] = 1 + (strength > digStrength ? strength * 1000 : strength);
+        apAdjacent[count++] = pNode->m_pDown;
     }
     if (pNode->m_pLeft)
     {
         strength = pNode->m_LeftCost;
-        adjCost.cost = 1 + (strength > m_DigStrenght ? strength * 1000 : strength);
-        adjCost.state = (void *)pNode->m_pLeft;
-        pAdjacentList->push_back(adjCost);
+        aCosts[count] = 1 + (strength > digStrength ? strength * 1000 : strength);
+        apAdjacent[count++] = pNode->m_pLeft;
     }
-    
+
     // Add cost for digging at 45 degrees and for digging upwards
     if (pNode->m_pUpRight)
     {
         strength = pNode->m_UpRightCost;
-        adjCost.cost = 1.4 + (strength > m_DigStrenght ? strength * 2828 : strength * 4.2);  // Three times more expensive when digging
-        adjCost.state = (void *)pNode->m_pUpRight;
-        pAdjacentList->push_back(adjCost);
+        aCosts[count] = 1.4 + (strength > digStrength ? strength * 2828 : strength * 4.2);  // Three times more expensive when digging
+        apAdjacent[count++] = pNode->m_pUpRight;
     }
     if (pNode->m_pRightDown)
     {
         strength = pNode->m_RightDownCost;
-        adjCost.cost = 1.4 + (strength > m_DigStrenght ? strength * 1414 : strength * 1.4);
-        adjCost.state = (void *)pNode->m_pRightDown;
-        pAdjacentList->push_back(adjCost);
+        aCosts[count] = 1.4 + (strength > digStrength ? strength * 1414 : strength * 1.4);
+        apAdjacent[count++] = pNode->m_pRightDown;
     }
     if (pNode->m_pDownLeft)
     {
         strength = pNode->m_DownLeftCost;
-        adjCost.cost = 1.4 + (strength > m_DigStrenght ? strength * 1414 : strength * 1.4);
-        adjCost.state = (void *)pNode->m_pDownLeft;
-        pAdjacentList->push_back(adjCost);
+        aCosts[count] = 1.4 + (strength > digStrength ? strength * 1414 : strength * 1.4);
+        apAdjacent[count++] = pNode->m_pDownLeft;
     }
     if (pNode->m_pLeftUp)
     {
         strength = pNode->m_LeftUpCost;
-        adjCost.cost = 1.4 + (strength > m_DigStrenght ? strength * 2828 : strength * 4.2);  // Three times more expensive when digging
-        adjCost.state = (void *)pNode->m_pLeftUp;
-        pAdjacentList->push_back(adjCost);
+        aCosts[count] = 1.4 + (strength > digStrength ? strength * 2828 : strength * 4.2);  // Three times more expensive when digging
+        apAdjacent[count++] = pNode->m_pLeftUp;
     }
+
+    return count;
 }
 
 
@@ -459,6 +785,10 @@ void PathFinder::UpdateNodeCosts(PathNode *pNode)
     
     // Mark this as already changed so the above expensive calc isn't done redundantly
     pNode->m_IsChanged = true;
+
+    // Any cached portal costs through this node's cluster are stale now
+    if (!m_Clusters.empty())
+        m_Clusters[GetClusterOf(pNode)].m_Version++;
 }
 
 
@@ -504,4 +834,381 @@ void PathFinder::UpdateNodeCostsInBox(Box &box)
     }
 }
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CreateClusters
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Divides the node grid into clusters and places the portals on all the
+//                  borders between them, for the hierarchical search.
+
+void PathFinder::CreateClusters(bool wrapsX, bool wrapsY)
+{
+    m_WrapsX = wrapsX;
+    m_WrapsY = wrapsY;
+    m_Clusters.clear();
+    m_Portals.clear();
+    m_DigClasses.clear();
+
+    if (m_NodeGrid.empty())
+        return;
+
+    int nodeXCount = m_NodeGrid.size();
+    int nodeYCount = m_NodeGrid[0].size();
+    m_ClusterXCount = (nodeXCount + CLUSTERSIZE - 1) / CLUSTERSIZE;
+    m_ClusterYCount = (nodeYCount + CLUSTERSIZE - 1) / CLUSTERSIZE;
+
+    PathCluster cluster;
+    for (int cx = 0; cx < m_ClusterXCount; ++cx)
+    {
+        for (int cy = 0; cy < m_ClusterYCount; ++cy)
+        {
+            cluster.m_FirstX = cx * CLUSTERSIZE;
+            cluster.m_FirstY = cy * CLUSTERSIZE;
+            cluster.m_LastX = min(cluster.m_FirstX + CLUSTERSIZE, nodeXCount) - 1;
+            cluster.m_LastY = min(cluster.m_FirstY + CLUSTERSIZE, nodeYCount) - 1;
+            cluster.m_Version = 1;
+            m_Clusters.push_back(cluster);
+        }
+    }
+
+    // Connect each cluster to the one to its right and the one below it, across the seams too if wrapping
+    for (int cx = 0; cx < m_ClusterXCount; ++cx)
+    {
+        for (int cy = 0; cy < m_ClusterYCount; ++cy)
+        {
+            if (cx + 1 < m_ClusterXCount)
+                AddPortals(cx * m_ClusterYCount + cy, (cx + 1) * m_ClusterYCount + cy, true);
+            else if (m_WrapsX && m_ClusterXCount > 1)
+                AddPortals(cx * m_ClusterYCount + cy, cy, true);
+
+            if (cy + 1 < m_ClusterYCount)
+                AddPortals(cx * m_ClusterYCount + cy, cx * m_ClusterYCount + cy + 1, false);
+            else if (m_WrapsY && m_ClusterYCount > 1)
+                AddPortals(cx * m_ClusterYCount + cy, cx * m_ClusterYCount, false);
+        }
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AddPortals
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Places evenly spaced portal pairs along the border between two clusters.
+
+void PathFinder::AddPortals(int firstCluster, int secondCluster, bool vertical)
+{
+    const PathCluster &first = m_Clusters[firstCluster];
+    const PathCluster &second = m_Clusters[secondCluster];
+
+    // How long the border is, in nodes
+    int borderLength = vertical ? (first.m_LastY - first.m_FirstY + 1) : (first.m_LastX - first.m_FirstX + 1);
+
+    PathPortal firstPortal;
+    PathPortal secondPortal;
+    for (int segment = 0; segment < borderLength; segment += PORTALSPACING)
+    {
+        // Put the portal in the middle of each segment of the border
+        int offset = segment + (min((int)PORTALSPACING, borderLength - segment) / 2);
+        if (vertical)
+        {
+            firstPortal.m_pNode = m_NodeGrid[first.m_LastX][first.m_FirstY + offset];
+            secondPortal.m_pNode = m_NodeGrid[second.m_FirstX][second.m_FirstY + offset];
+        }
+        else
+        {
+            firstPortal.m_pNode = m_NodeGrid[first.m_FirstX + offset][first.m_LastY];
+            secondPortal.m_pNode = m_NodeGrid[second.m_FirstX + offset][second.m_FirstY];
+        }
+
+        int firstIndex = m_Portals.size();
+        firstPortal.m_Cluster = firstCluster;
+        firstPortal.m_IndexInCluster = m_Clusters[firstCluster].m_Portals.size();
+        firstPortal.m_Partner = firstIndex + 1;
+        secondPortal.m_Cluster = secondCluster;
+        secondPortal.m_IndexInCluster = m_Clusters[secondCluster].m_Portals.size();
+        secondPortal.m_Partner = firstIndex;
+
+        m_Portals.push_back(firstPortal);
+        m_Portals.push_back(secondPortal);
+        m_Clusters[firstCluster].m_Portals.push_back(firstIndex);
+        m_Clusters[secondCluster].m_Portals.push_back(firstIndex + 1);
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetIndexInCluster
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the index of a node among the nodes of its cluster.
+
+int PathFinder::GetIndexInCluster(const PathCluster &cluster, const PathNode *pNode) const
+{
+    if (pNode->m_GridX < cluster.m_FirstX || pNode->m_GridX > cluster.m_LastX || pNode->m_GridY < cluster.m_FirstY || pNode->m_GridY > cluster.m_LastY)
+        return -1;
+    return (pNode->m_GridX - cluster.m_FirstX) * (cluster.m_LastY - cluster.m_FirstY + 1) + (pNode->m_GridY - cluster.m_FirstY);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SolveInCluster
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Finds the cheapest costs from a node to every other node of its cluster,
+//                  without leaving the cluster.
+
+void PathFinder::SolveInCluster(int cluster, PathNode *pSource, float digStrength, vector<float> &distances, vector<int> &previous) const
+{
+    const PathCluster &searchCluster = m_Clusters[cluster];
+    int clusterHeight = searchCluster.m_LastY - searchCluster.m_FirstY + 1;
+    int nodeCount = (searchCluster.m_LastX - searchCluster.m_FirstX + 1) * clusterHeight;
+
+    distances.assign(nodeCount, FLT_MAX);
+    previous.assign(nodeCount, -1);
+
+    // Plain Dijkstra; the clusters are small enough that a heuristic wouldn't buy much
+    priority_queue<pair<float, int>, vector<pair<float, int> >, greater<pair<float, int> > > openQueue;
+    int sourceIndex = GetIndexInCluster(searchCluster, pSource);
+    distances[sourceIndex] = 0;
+    openQueue.push(pair<float, int>(0, sourceIndex));
+
+    PathNode *apAdjacent[8];
+    float aCosts[8];
+    while (!openQueue.empty())
+    {
+        float distance = openQueue.top().first;
+        int index = openQueue.top().second;
+        openQueue.pop();
+        if (distance > distances[index])
+            continue;
+
+        PathNode *pNode = m_NodeGrid[searchCluster.m_FirstX + index / clusterHeight][searchCluster.m_FirstY + index % clusterHeight];
+        int adjacentCount = GetAdjacentNodes(pNode, digStrength, apAdjacent, aCosts);
+        for (int i = 0; i < adjacentCount; ++i)
+        {
+            int adjacentIndex = GetIndexInCluster(searchCluster, apAdjacent[i]);
+            if (adjacentIndex >= 0 && distance + aCosts[i] < distances[adjacentIndex])
+            {
+                distances[adjacentIndex] = distance + aCosts[i];
+                previous[adjacentIndex] = index;
+                openQueue.push(pair<float, int>(distances[adjacentIndex], adjacentIndex));
+            }
+        }
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPortalCosts
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the cached costs between all the portals of a cluster for a dig
+//                  strength, recalculating them first if the cluster has changed.
+
+const vector<float> & PathFinder::GetPortalCosts(int cluster, float digStrength)
+{
+    // Find the cached costs of this dig strength and move them to the front as most recently used, or make new ones
+    list<DigClassCosts>::iterator dItr = m_DigClasses.begin();
+    for (; dItr != m_DigClasses.end(); ++dItr)
+    {
+        if ((*dItr).m_DigStrength == digStrength)
+            break;
+    }
+    if (dItr != m_DigClasses.end())
+        m_DigClasses.splice(m_DigClasses.begin(), m_DigClasses, dItr);
+    else
+    {
+        if (m_DigClasses.size() >= MAXDIGCLASSES)
+            m_DigClasses.pop_back();
+        m_DigClasses.push_front(DigClassCosts());
+        m_DigClasses.front().m_DigStrength = digStrength;
+        m_DigClasses.front().m_PortalCosts.resize(m_Clusters.size());
+        m_DigClasses.front().m_Versions.assign(m_Clusters.size(), 0);
+    }
+    DigClassCosts &digClass = m_DigClasses.front();
+
+    const PathCluster &costCluster = m_Clusters[cluster];
+    if (digClass.m_Versions[cluster] != costCluster.m_Version)
+    {
+        int portalCount = costCluster.m_Portals.size();
+        vector<float> &costs = digClass.m_PortalCosts[cluster];
+        costs.assign(portalCount * portalCount, FLT_MAX);
+
+        vector<float> distances;
+        vector<int> previous;
+        for (int from = 0; from < portalCount; ++from)
+        {
+            SolveInCluster(cluster, m_Portals[costCluster.m_Portals[from]].m_pNode, digStrength, distances, previous);
+            for (int to = 0; to < portalCount; ++to)
+                costs[from * portalCount + to] = distances[GetIndexInCluster(costCluster, m_Portals[costCluster.m_Portals[to]].m_pNode)];
+        }
+        digClass.m_Versions[cluster] = costCluster.m_Version;
+    }
+
+    return digClass.m_PortalCosts[cluster];
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SolveHierarchical
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Finds a path by searching the portal graph between the start and end
+//                  clusters, then refining each leg of it within its cluster.
+
+int PathFinder::SolveHierarchical(PathNode *pStart, PathNode *pEnd, float digStrength, vector<void *> &statePath, float &totalCostResult)
+{
+    statePath.clear();
+    totalCostResult = 0;
+
+    int startCluster = GetClusterOf(pStart);
+    int endCluster = GetClusterOf(pEnd);
+    const PathCluster &startPathCluster = m_Clusters[startCluster];
+    const PathCluster &endPathCluster = m_Clusters[endCluster];
+
+    // Costs from the start to each portal of its cluster, and from each portal of the end cluster to the end
+    vector<float> distances;
+    vector<int> previous;
+    SolveInCluster(startCluster, pStart, digStrength, distances, previous);
+    vector<float> startCosts(startPathCluster.m_Portals.size());
+    for (int i = 0; i < (int)startPathCluster.m_Portals.size(); ++i)
+        startCosts[i] = distances[GetIndexInCluster(startPathCluster, m_Portals[startPathCluster.m_Portals[i]].m_pNode)];
+
+    int endIndex = GetIndexInCluster(endPathCluster, pEnd);
+    vector<float> endCosts(endPathCluster.m_Portals.size());
+    for (int i = 0; i < (int)endPathCluster.m_Portals.size(); ++i)
+    {
+        SolveInCluster(endCluster, m_Portals[endPathCluster.m_Portals[i]].m_pNode, digStrength, distances, previous);
+        endCosts[i] = distances[endIndex];
+    }
+
+    // A* over the portals, with two extra states for the start and the end
+    int startState = m_Portals.size();
+    int endState = startState + 1;
+    vector<float> costSoFar(endState + 1, FLT_MAX);
+    vector<int> cameFrom(endState + 1, -1);
+    vector<bool> closed(endState + 1, false);
+    priority_queue<pair<float, int>, vector<pair<float, int> >, greater<pair<float, int> > > openQueue;
+
+    costSoFar[startState] = 0;
+    openQueue.push(pair<float, int>(LeastCostEstimate(pStart, pEnd), startState));
+
+    PathNode *apAdjacent[8];
+    float aCosts[8];
+    while (!openQueue.empty())
+    {
+        int state = openQueue.top().second;
+        openQueue.pop();
+        if (closed[state])
+            continue;
+        closed[state] = true;
+        if (state == endState)
+            break;
+
+        // Gather up where we can go from here and at what cost
+        vector<pair<int, float> > edges;
+        if (state == startState)
+        {
+            for (int i = 0; i < (int)startPathCluster.m_Portals.size(); ++i)
+                edges.push_back(pair<int, float>(startPathCluster.m_Portals[i], startCosts[i]));
+        }
+        else
+        {
+            const PathPortal &portal = m_Portals[state];
+
+            // Across the border to the partner portal
+            const PathPortal &partner = m_Portals[portal.m_Partner];
+            int adjacentCount = GetAdjacentNodes(portal.m_pNode, digStrength, apAdjacent, aCosts);
+            for (int i = 0; i < adjacentCount; ++i)
+            {
+                if (apAdjacent[i] == partner.m_pNode)
+                {
+                    edges.push_back(pair<int, float>(portal.m_Partner, aCosts[i]));
+                    break;
+                }
+            }
+
+            // Through the cluster to its other portals
+            const vector<float> &portalCosts = GetPortalCosts(portal.m_Cluster, digStrength);
+            const vector<int> &clusterPortals = m_Clusters[portal.m_Cluster].m_Portals;
+            for (int i = 0; i < (int)clusterPortals.size(); ++i)
+            {
+                if (i != portal.m_IndexInCluster)
+                    edges.push_back(pair<int, float>(clusterPortals[i], portalCosts[portal.m_IndexInCluster * clusterPortals.size() + i]));
+            }
+
+            // Or straight to the end, if this is in its cluster
+            if (portal.m_Cluster == endCluster)
+                edges.push_back(pair<int, float>(endState, endCosts[portal.m_IndexInCluster]));
+        }
+
+        for (vector<pair<int, float> >::iterator eItr = edges.begin(); eItr != edges.end(); ++eItr)
+        {
+            int nextState = (*eItr).first;
+            if (closed[nextState] || (*eItr).second == FLT_MAX)
+                continue;
+            float nextCost = costSoFar[state] + (*eItr).second;
+            if (nextCost < costSoFar[nextState])
+            {
+                costSoFar[nextState] = nextCost;
+                cameFrom[nextState] = state;
+                PathNode *pNextNode = nextState == endState ? pEnd : m_Portals[nextState].m_pNode;
+                openQueue.push(pair<float, int>(nextCost + LeastCostEstimate(pNextNode, pEnd), nextState));
+            }
+        }
+    }
+
+    if (!closed[endState])
+        return MicroPather::NO_SOLUTION;
+
+    totalCostResult = costSoFar[endState];
+
+    // Walk back to get the portal states in order
+    deque<int> abstractPath;
+    for (int state = endState; state != -1; state = cameFrom[state])
+        abstractPath.push_front(state);
+
+    // Refine each leg into actual nodes; legs between partner portals are single steps, the rest stay within one cluster
+    statePath.push_back((void *)pStart);
+    for (int i = 1; i < (int)abstractPath.size(); ++i)
+    {
+        int fromState = abstractPath[i - 1];
+        int toState = abstractPath[i];
+        PathNode *pFrom = fromState == startState ? pStart : m_Portals[fromState].m_pNode;
+        PathNode *pTo = toState == endState ? pEnd : m_Portals[toState].m_pNode;
+
+        if (fromState != startState && toState != endState && m_Portals[fromState].m_Partner == toState)
+            statePath.push_back((void *)pTo);
+        else
+            AppendClusterPath(toState == endState ? endCluster : m_Portals[toState].m_Cluster, pFrom, pTo, digStrength, statePath);
+    }
+
+    return MicroPather::SOLVED;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AppendClusterPath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Adds the nodes of the cheapest path between two nodes of a cluster to
+//                  a state path, leaving out the first one.
+
+void PathFinder::AppendClusterPath(int cluster, PathNode *pFrom, PathNode *pTo, float digStrength, vector<void *> &statePath) const
+{
+    if (pFrom == pTo)
+        return;
+
+    const PathCluster &pathCluster = m_Clusters[cluster];
+    int clusterHeight = pathCluster.m_LastY - pathCluster.m_FirstY + 1;
+
+    vector<float> distances;
+    vector<int> previous;
+    SolveInCluster(cluster, pFrom, digStrength, distances, previous);
+
+    // Walk back from the destination, then add the nodes in forward order
+    int fromIndex = GetIndexInCluster(pathCluster, pFrom);
+    deque<PathNode *> legNodes;
+    for (int index = GetIndexInCluster(pathCluster, pTo); index != -1 && index != fromIndex; index = previous[index])
+        legNodes.push_front(m_NodeGrid[pathCluster.m_FirstX + index / clusterHeight][pathCluster.m_FirstY + index % clusterHeight]);
+
+    for (deque<PathNode *>::iterator nItr = legNodes.begin(); nItr != legNodes.end(); ++nItr)
+        statePath.push_back((void *)(*nItr));
+}
+
 } // namespace RTE
\ No newline at end of file
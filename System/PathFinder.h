@@ -40,6 +40,9 @@ struct PathNode
 {
     // Absolute position of the center of this node in the scene
     Vector m_Pos;
+    // Indices of this node in the node grid
+    int m_GridX;
+    int m_GridY;
     // Whether this has been updated since last call to Reset the pather
     bool m_IsChanged;
     // Pointers to all adjacent nodes. These are not owned, and may be 0 if adjacent to non-wrapping scene border
@@ -62,12 +65,56 @@ struct PathNode
     float m_LeftUpCost;
 
     PathNode(Vector pos) { m_Pos = pos;
+                           m_GridX = m_GridY = 0;
                            m_pUp = m_pRight = m_pDown = m_pLeft = m_pUpRight = m_pRightDown = m_pDownLeft = m_pLeftUp = 0;
                            // Costs are infinite unless recalculated as otherwise
                            m_UpCost = m_RightCost = m_DownCost = m_LeftCost = m_UpRightCost = m_RightDownCost = m_DownLeftCost = m_LeftUpCost = FLT_MAX; }
 };
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Struct:          PathPortal
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     A node on the border of a PathCluster, paired up with a node on the other
+//                  side of the border. These are the states of the hierarchical search.
+// Parent(s):       None.
+// Class history:   10/19/2026 PathPortal created.
+
+struct PathPortal
+{
+    // The node this portal is on. Not owned
+    PathNode *m_pNode;
+    // Index of the cluster this is in
+    int m_Cluster;
+    // Index of this in its cluster's list of portals
+    int m_IndexInCluster;
+    // Index of the portal on the other side of the border
+    int m_Partner;
+};
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Struct:          PathCluster
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     A rectangular block of PathNodes which the hierarchical search treats as
+//                  a unit, only caring about the costs between the portals on its borders.
+// Parent(s):       None.
+// Class history:   10/19/2026 PathCluster created.
+
+struct PathCluster
+{
+    // The node grid indices covered by this, inclusive
+    int m_FirstX;
+    int m_FirstY;
+    int m_LastX;
+    int m_LastY;
+    // Indices of all the portals on the borders of this
+    std::vector<int> m_Portals;
+    // Bumped every time the cost of any edge going out from a node in this changes
+    unsigned int m_Version;
+};
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Class:           PathFinder
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -95,8 +142,11 @@ public:
 //                  The width and height in scene pixels that of each node should represent.
 //                  The block size that the node cache is allocated from. Should be about
 //                  a fourth of the total number of nodes.
+//                  Whether to set up the node costs, from the cache or by calculating
+//                  them. If not, they have to be set up with LoadCachedCosts or
+//                  RecalculateAllCosts before any paths are calculated.
 
-    PathFinder(Scene *pScene, int nodeDimension = 20, unsigned int allocate = 2000) { Clear(); Create(pScene, nodeDimension, allocate); }
+    PathFinder(Scene *pScene, int nodeDimension = 20, unsigned int allocate = 2000, bool setUpCosts = true) { Clear(); Create(pScene, nodeDimension, allocate, setUpCosts); }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -116,10 +166,13 @@ public:
 //                  The width and height in scene pixels that of each node should represent.
 //                  The block size that the node cache is allocated from. Should be about
 //                  a fourth of the total number of nodes.
+//                  Whether to set up the node costs, from the cache or by calculating
+//                  them. If not, they have to be set up with LoadCachedCosts or
+//                  RecalculateAllCosts before any paths are calculated.
 // Return value:    An error return value signaling sucess or any particular failure.
 //                  Anything below 0 is an error signal.
 
-    virtual int Create(Scene *pScene, int nodeDimension = 20, unsigned int allocate = 2000);
+    virtual int Create(Scene *pScene, int nodeDimension = 20, unsigned int allocate = 2000, bool setUpCosts = true);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -175,6 +228,30 @@ public:
     void RecalculateAllCosts();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          LoadCachedCosts
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Loads all the node costs from the cache file for the current terrain,
+//                  if there is a valid one. Also resets the pather itself. Does file I/O,
+//                  so should be called from the main thread.
+// Arguments:       None.
+// Return value:    Whether the costs were loaded.
+
+    bool LoadCachedCosts();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SaveCachedCosts
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Saves all the node costs to the cache file for the terrain they were
+//                  set up for, and trims old cache files. Does file I/O, so should be
+//                  called from the main thread.
+// Arguments:       None.
+// Return value:    Whether the file was written.
+
+    bool SaveCachedCosts() const;
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RecalculateAreaCosts
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -186,6 +263,19 @@ public:
     void RecalculateAreaCosts(const std::list<Box> &boxList);
 
 
+    // Number of nodes along each side of a cluster used by the hierarchical search
+    enum { CLUSTERSIZE = 10 };
+    // Each cluster border gets a portal every this many nodes
+    enum { PORTALSPACING = 5 };
+    // Paths between nodes in clusters at least this many clusters apart are solved hierarchically
+    enum { HIERARCHICALDISTANCE = 2 };
+    // How many different dig strengths to keep portal costs cached for
+    enum { MAXDIGCLASSES = 8 };
+    // Identifies the node cost cache files, and their format version
+    // The oldest cache files get deleted once they add up to more than COSTCACHEMAXSIZE bytes
+    enum { COSTCACHEMAGIC = 0x50434331, COSTCACHEVERSION = 1, COSTCACHEMAXSIZE = 64 * 1024 * 1024 };
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          CalculatePath
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -287,6 +377,186 @@ protected:
     void UpdateNodeCostsInBox(Box &box);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastNodeCostsInBand
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts the cost lines going out from every node in a band of columns of
+//                  the grid. The costs of the directions that also depend on the adjacent
+//                  node are put aside for RecalculateAllCosts to finish. Only reads the
+//                  terrain and writes to the nodes of the band, so bands can run in parallel.
+// Arguments:       The first column of the band, and the one after its last.
+//                  Four line costs per node for up, left, up-right and left-up, column by
+//                  column.
+// Return value:    None.
+
+    void CastNodeCostsInBand(int firstX, int endX, std::vector<float> *pCastCosts);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CalculateCostCacheKey
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Hashes everything the node costs depend on: the terrain material
+//                  bitmap, the material strengths and the layout of the node grid.
+// Arguments:       None.
+// Return value:    The key of the cost cache file for the current terrain.
+
+    unsigned long long CalculateCostCacheKey() const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetCostCachePath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the path of the cost cache file for a cache key.
+// Arguments:       The cache key.
+// Return value:    The file path.
+
+    std::string GetCostCachePath(unsigned long long cacheKey) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          LoadCostCache
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Loads all the node costs from the cache file of a key, if there is a
+//                  valid one. Also resets the pather itself.
+// Arguments:       The cache key.
+// Return value:    Whether the costs were loaded.
+
+    bool LoadCostCache(unsigned long long cacheKey);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SaveCostCache
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Saves all the node costs to the cache file of a key.
+// Arguments:       The cache key.
+// Return value:    Whether the file was written.
+
+    bool SaveCostCache(unsigned long long cacheKey) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetAdjacentNodes
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets all the nodes adjacent to one and the cost of moving to each, as
+//                  seen by an actor of a specific dig strength.
+// Arguments:       The node to get the adjacents of. OINT.
+//                  The dig strength to calculate the costs for.
+//                  Array of at least 8 which will be filled out with the adjacent nodes.
+//                  Array of at least 8 which will be filled out with the cost to each.
+// Return value:    The number of adjacent nodes filled out.
+
+    int GetAdjacentNodes(PathNode *pNode, float digStrength, PathNode **apAdjacent, float *aCosts) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CreateClusters
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Divides the node grid into clusters and places the portals on all the
+//                  borders between them, for the hierarchical search.
+// Arguments:       Whether the scene wraps horizontally and vertically.
+// Return value:    None.
+
+    void CreateClusters(bool wrapsX, bool wrapsY);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AddPortals
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Places evenly spaced portal pairs along the border between two clusters.
+// Arguments:       The two clusters. The second is to the right of or below the first.
+//                  Whether the border is vertical, ie the clusters are side by side.
+// Return value:    None.
+
+    void AddPortals(int firstCluster, int secondCluster, bool vertical);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetClusterOf
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the index of the cluster a node is in.
+// Arguments:       The node. OINT.
+// Return value:    The cluster index.
+
+    int GetClusterOf(const PathNode *pNode) const { return (pNode->m_GridX / CLUSTERSIZE) * m_ClusterYCount + (pNode->m_GridY / CLUSTERSIZE); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SolveInCluster
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Finds the cheapest costs from a node to every other node of its cluster,
+//                  without leaving the cluster.
+// Arguments:       The cluster to search in.
+//                  The node to search from. Must be in the cluster. OINT.
+//                  The dig strength to calculate the costs for.
+//                  Vector filled out with the cost to each node of the cluster.
+//                  Vector filled out with the previous node on the way to each node.
+//                  Both are indexed by GetIndexInCluster.
+// Return value:    None.
+
+    void SolveInCluster(int cluster, PathNode *pSource, float digStrength, std::vector<float> &distances, std::vector<int> &previous) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetIndexInCluster
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the index of a node among the nodes of its cluster.
+// Arguments:       The cluster and the node. OINT.
+// Return value:    The index, or -1 if the node isn't in the cluster.
+
+    int GetIndexInCluster(const PathCluster &cluster, const PathNode *pNode) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPortalCosts
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the cached costs between all the portals of a cluster for a dig
+//                  strength, recalculating them first if the cluster has changed.
+// Arguments:       The cluster.
+//                  The dig strength.
+// Return value:    The costs, portal count by portal count, from row to column.
+
+    const std::vector<float> & GetPortalCosts(int cluster, float digStrength);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SolveHierarchical
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Finds a path by searching the portal graph between the start and end
+//                  clusters, then refining each leg of it within its cluster.
+// Arguments:       The start and end nodes. OINT.
+//                  The dig strength to calculate the costs for.
+//                  Vector filled out with the nodes of the path.
+//                  The total cost of the path.
+// Return value:    Success or failure, expressed as SOLVED or NO_SOLUTION.
+
+    int SolveHierarchical(PathNode *pStart, PathNode *pEnd, float digStrength, std::vector<void *> &statePath, float &totalCostResult);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AppendClusterPath
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Adds the nodes of the cheapest path between two nodes of a cluster to
+//                  a state path, leaving out the first one.
+// Arguments:       The cluster.
+//                  The nodes to go between. OINT.
+//                  The dig strength to calculate the costs for.
+//                  The state path to add to.
+// Return value:    None.
+
+    void AppendClusterPath(int cluster, PathNode *pFrom, PathNode *pTo, float digStrength, std::vector<void *> &statePath) const;
+
+
+    // The portal costs of all the clusters for one dig strength
+    struct DigClassCosts
+    {
+        float m_DigStrength;
+        // Portal to portal costs for each cluster
+        std::vector<std::vector<float> > m_PortalCosts;
+        // The version of each cluster the costs were calculated for, 0 if never
+        std::vector<unsigned int> m_Versions;
+    };
+
+
     // The array of PathNodes representing the grid on the scene. The nodes are owned by this
     std::vector<std::vector<PathNode *> > m_NodeGrid;
     // The width and height of each node, in pixels on the scene
@@ -295,6 +565,19 @@ protected:
     float m_DigStrenght;
     // The actual pathing object that does the pathfinding work. Owned.
     MicroPather *m_pPather;
+    // The clusters the node grid is divided into for the hierarchical search, column by column
+    std::vector<PathCluster> m_Clusters;
+    int m_ClusterXCount;
+    int m_ClusterYCount;
+    // All the portals on the cluster borders
+    std::vector<PathPortal> m_Portals;
+    // Cached portal costs for the most recently used dig strengths, most recent first
+    std::list<DigClassCosts> m_DigClasses;
+    // Whether the scene wraps, for measuring distances between clusters
+    bool m_WrapsX;
+    bool m_WrapsY;
+    // The key of the cost cache file for the terrain the costs were set up for
+    unsigned long long m_CostCacheKey;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// File:            RotatedSpriteCache.cpp
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Source file for the RotatedSpriteCache class.
+// Project:         Retro Terrain Engine
+// Author(s):
+//
+//
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Inclusions of header files
+
+#include "RotatedSpriteCache.h"
+#include "allegro.h"
+#include <cmath>
+
+using namespace std;
+
+namespace RTE
+{
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CacheKey::operator<
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Orders the keys for the lookup map.
+
+bool RotatedSpriteCache::CacheKey::operator<(const CacheKey &rhs) const
+{
+    if (m_pSprite != rhs.m_pSprite)
+        return m_pSprite < rhs.m_pSprite;
+    if (m_AngleStep != rhs.m_AngleStep)
+        return m_AngleStep < rhs.m_AngleStep;
+    if (m_Scale != rhs.m_Scale)
+        return m_Scale < rhs.m_Scale;
+    if (m_PivotX != rhs.m_PivotX)
+        return m_PivotX < rhs.m_PivotX;
+    if (m_PivotY != rhs.m_PivotY)
+        return m_PivotY < rhs.m_PivotY;
+    return m_HFlipped < rhs.m_HFlipped;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Clear
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys all the cached bitmaps.
+
+void RotatedSpriteCache::Clear()
+{
+    Evict(0);
+    m_Hits = 0;
+    m_Misses = 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Evict
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys the least recently used entries until usage fits the limit.
+
+void RotatedSpriteCache::Evict(long limit)
+{
+    while (m_Usage > limit && !m_Entries.empty())
+    {
+        CacheEntry &oldest = m_Entries.back();
+        m_Usage -= oldest.m_Size;
+        destroy_bitmap(oldest.m_pBitmap);
+        m_Lookup.erase(oldest.m_Key);
+        m_Entries.pop_back();
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetRotated
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a flipped, rotated and scaled copy of an 8bpp sprite frame,
+//                  rendering and caching it if it isn't in the cache yet.
+
+BITMAP * RotatedSpriteCache::GetRotated(BITMAP *pSprite, bool hFlipped, int pivotX, int pivotY, float allegroAngle, float scale)
+{
+    if (m_Budget <= 0 || !pSprite || bitmap_color_depth(pSprite) != 8)
+        return 0;
+
+    CacheKey key;
+    key.m_pSprite = pSprite;
+    key.m_AngleStep = (int)floor(allegroAngle * (ANGLESTEPS / 256.0F) + 0.5F) % ANGLESTEPS;
+    if (key.m_AngleStep < 0)
+        key.m_AngleStep += ANGLESTEPS;
+    key.m_Scale = ftofix(scale);
+    key.m_PivotX = pivotX;
+    key.m_PivotY = pivotY;
+    key.m_HFlipped = hFlipped;
+
+    map<CacheKey, list<CacheEntry>::iterator>::iterator lItr = m_Lookup.find(key);
+    if (lItr != m_Lookup.end())
+    {
+        // Move to the front as the most recently used
+        m_Entries.splice(m_Entries.begin(), m_Entries, lItr->second);
+        m_Hits++;
+        return m_Entries.front().m_pBitmap;
+    }
+    m_Misses++;
+
+    // Make it big enough to hold the frame rotated any which way around the pivot, with the pivot in the middle
+    float maxDistSqr = 0;
+    int cornerX[4] = { 0, pSprite->w, 0, pSprite->w };
+    int cornerY[4] = { 0, 0, pSprite->h, pSprite->h };
+    for (int i = 0; i < 4; ++i)
+    {
+        float distX = cornerX[i] - pivotX;
+        float distY = cornerY[i] - pivotY;
+        if (distX * distX + distY * distY > maxDistSqr)
+            maxDistSqr = distX * distX + distY * distY;
+    }
+    int halfSize = (int)ceil(sqrt(maxDistSqr) * fabs(scale)) + 1;
+    long size = (long)(halfSize * 2) * (long)(halfSize * 2);
+
+    if (size > m_Budget)
+        return 0;
+    Evict(m_Budget - size);
+
+    BITMAP *pRotated = create_bitmap_ex(8, halfSize * 2, halfSize * 2);
+    if (!pRotated)
+        return 0;
+    clear_to_color(pRotated, bitmap_mask_color(pRotated));
+
+    fixed angle = ftofix(key.m_AngleStep * (256.0F / ANGLESTEPS));
+    if (hFlipped)
+    {
+        BITMAP *pFlipped = create_bitmap_ex(8, pSprite->w, pSprite->h);
+        clear_to_color(pFlipped, bitmap_mask_color(pFlipped));
+        draw_sprite_h_flip(pFlipped, pSprite, 0, 0);
+        pivot_scaled_sprite(pRotated, pFlipped, halfSize, halfSize, pivotX, pivotY, angle, key.m_Scale);
+        destroy_bitmap(pFlipped);
+    }
+    else
+        pivot_scaled_sprite(pRotated, pSprite, halfSize, halfSize, pivotX, pivotY, angle, key.m_Scale);
+
+    CacheEntry entry;
+    entry.m_Key = key;
+    entry.m_pBitmap = pRotated;
+    entry.m_Size = size;
+    m_Entries.push_front(entry);
+    m_Lookup[key] = m_Entries.begin();
+    m_Usage += size;
+
+    return pRotated;
+}
+
+} // namespace RTE
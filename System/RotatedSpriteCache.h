@@ -0,0 +1,211 @@
+#ifndef _RTEROTATEDSPRITECACHE_
+#define _RTEROTATEDSPRITECACHE_
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// File:            RotatedSpriteCache.h
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Header file for the RotatedSpriteCache class.
+// Project:         Retro Terrain Engine
+// Author(s):
+//
+//
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Inclusions of header files
+
+#include <list>
+#include <map>
+
+struct BITMAP;
+
+namespace RTE
+{
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Class:           RotatedSpriteCache
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     A least-recently-used cache of 8bpp sprite frames that have already
+//                  been flipped, rotated and scaled, so that many identical objects at
+//                  similar angles don't each redo the pivoting every frame. Angles are
+//                  quantized so that nearby ones share an entry.
+// Parent(s):       None.
+// Class history:   10/19/2026 RotatedSpriteCache created.
+
+class RotatedSpriteCache
+{
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Public member variable, method and friend function declarations
+
+public:
+
+    // How many angle steps a full circle is quantized into
+    enum { ANGLESTEPS = 512 };
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Constructor:     RotatedSpriteCache
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Constructor method used to instantiate a RotatedSpriteCache object in
+//                  system memory. The budget starts out at 0, which disables it.
+// Arguments:       None.
+
+    RotatedSpriteCache() { m_Budget = 0; m_Usage = 0; m_Hits = 0; m_Misses = 0; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Destructor:      ~RotatedSpriteCache
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destructor method used to clean up a RotatedSpriteCache object before
+//                  deletion from system memory.
+// Arguments:       None.
+
+    ~RotatedSpriteCache() { Clear(); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Clear
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys all the cached bitmaps. Needs to be done before the source
+//                  sprites are freed, since they are used as part of the cache keys.
+// Arguments:       None.
+// Return value:    None.
+
+    void Clear();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetBudget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets how much memory the cached bitmaps may take up in total. Evicts
+//                  the least recently used ones if the new budget is already exceeded.
+// Arguments:       The budget in bytes. 0 disables the cache.
+// Return value:    None.
+
+    void SetBudget(long budget) { m_Budget = budget; Evict(m_Budget); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetBudget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how much memory the cached bitmaps may take up in total.
+// Arguments:       None.
+// Return value:    The budget in bytes. 0 means the cache is disabled.
+
+    long GetBudget() const { return m_Budget; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetUsage
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how much memory the cached bitmaps currently take up.
+// Arguments:       None.
+// Return value:    The usage in bytes.
+
+    long GetUsage() const { return m_Usage; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetHitCount
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many lookups were served from the cache so far.
+// Arguments:       None.
+// Return value:    The number of cache hits.
+
+    unsigned long GetHitCount() const { return m_Hits; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetMissCount
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many lookups had to render a new rotated frame so far.
+// Arguments:       None.
+// Return value:    The number of cache misses.
+
+    unsigned long GetMissCount() const { return m_Misses; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetRotated
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a flipped, rotated and scaled copy of an 8bpp sprite frame,
+//                  rendering and caching it if it isn't in the cache yet. The pivot
+//                  point ends up at the exact middle of the returned bitmap.
+// Arguments:       The 8bpp sprite frame to rotate. Not transferred.
+//                  Whether to flip the frame horizontally before rotating it.
+//                  The point in the (flipped) frame to rotate around.
+//                  The angle to rotate by, in Allegro units (256 is a full circle).
+//                  The scale to apply.
+// Return value:    The rotated frame, owned by the cache and only valid until the next
+//                  call. 0 if the cache is disabled or the frame won't fit in it.
+
+    BITMAP * GetRotated(BITMAP *pSprite, bool hFlipped, int pivotX, int pivotY, float allegroAngle, float scale);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Protected member variable and method declarations
+
+protected:
+
+    // What identifies one rotated frame
+    struct CacheKey
+    {
+        BITMAP *m_pSprite;
+        int m_AngleStep;
+        int m_Scale;
+        int m_PivotX;
+        int m_PivotY;
+        bool m_HFlipped;
+
+        bool operator<(const CacheKey &rhs) const;
+    };
+
+    // One rotated frame and what it costs
+    struct CacheEntry
+    {
+        CacheKey m_Key;
+        BITMAP *m_pBitmap;
+        long m_Size;
+    };
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          Evict
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Destroys the least recently used entries until usage fits the limit.
+// Arguments:       The number of bytes the usage should be brought down to.
+// Return value:    None.
+
+    void Evict(long limit);
+
+
+    // The entries, most recently used first
+    std::list<CacheEntry> m_Entries;
+    // Lookup of the entries by key
+    std::map<CacheKey, std::list<CacheEntry>::iterator> m_Lookup;
+    // How many bytes the cached bitmaps may take up in total
+    long m_Budget;
+    // How many bytes the cached bitmaps take up now
+    long m_Usage;
+    // Lookup statistics
+    unsigned long m_Hits;
+    unsigned long m_Misses;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Private member variable and method declarations
+
+private:
+
+    // Disallow the use of some implicit methods.
+    RotatedSpriteCache(const RotatedSpriteCache &reference);
+    RotatedSpriteCache & operator=(const RotatedSpriteCache &rhs);
+
+};
+
+} // namespace RTE
+
+#endif // File
@@ -1,4 +1,8 @@
 #include "System.h"
+#include "allegro.h"
+
+#include <vector>
+#include <algorithm>
 
 #ifdef _WIN32
     #include <direct.h>
@@ -61,5 +65,34 @@ int System::MakeDirectory(const std::string& path)
 	return  mkdir(path.c_str(), S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
 #endif 
 }
+
+// Orders files found in a directory newest first
+static bool NewerFile(const std::pair<time_t, std::pair<long long, std::string> > &lhs, const std::pair<time_t, std::pair<long long, std::string> > &rhs) { return lhs.first > rhs.first; }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:  TrimDirectory
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Deletes the oldest files matching a pattern in a directory, until the
+//					ones left add up to no more than a certain size.
+int System::TrimDirectory(const std::string& path, const std::string& pattern, long long maxSize)
+{
+	std::vector<std::pair<time_t, std::pair<long long, std::string> > > files;
+	al_ffblk fileInfo;
+	for (int result = al_findfirst((path + "/" + pattern).c_str(), &fileInfo, FA_ALL & ~FA_DIREC); result == 0; result = al_findnext(&fileInfo))
+		files.push_back(std::make_pair(fileInfo.time, std::make_pair((long long)fileInfo.size, path + "/" + fileInfo.name)));
+	al_findclose(&fileInfo);
+
+	// Keep the newest ones that fit
+	std::stable_sort(files.begin(), files.end(), NewerFile);
+	long long keptSize = 0;
+	int deleted = 0;
+	for (std::vector<std::pair<time_t, std::pair<long long, std::string> > >::iterator fItr = files.begin(); fItr != files.end(); ++fItr)
+	{
+		keptSize += fItr->second.first;
+		if (keptSize > maxSize && delete_file(fItr->second.second.c_str()) == 0)
+			deleted++;
+	}
+	return deleted;
+}
 	
 }
@@ -58,6 +58,16 @@ public:
 // Return value:    Returns 0 if successful, POSIX compliant errorcode if error.	
 	int MakeDirectory(const std::string& path);
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:  TrimDirectory
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Deletes the oldest files matching a pattern in a directory, until the
+//					ones left add up to no more than a certain size. Meant for caches.
+// Arguments:       Path of the directory, the file pattern in it, and the size in bytes
+//					the files may add up to.
+// Return value:    The number of files deleted.
+	int TrimDirectory(const std::string& path, const std::string& pattern, long long maxSize);
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Private member variable and method declarations
 